@@ -0,0 +1,82 @@
+// cli/include/opende.h
+#ifndef OPENDE_H
+#define OPENDE_H
+
+// libopende: the OpenDE settings engine as a C library.
+//
+// Keys are "<category>.<setting>" as in `opende get`, e.g.
+// "effects.shadows", "panel.position", "wm.workspaces". Values are text:
+// on/off settings read back as "enabled"/"disabled" and accept
+// enabled/disabled, on/off, true/false or yes/no.
+//
+// Reads are served from the shared settings snapshot and cost a memory
+// copy. Calls are not thread-safe; serialize them.
+
+#include <stddef.h>
+
+// The library is built with hidden visibility; only these are exported
+#if defined(__GNUC__)
+#define OPENDE_EXPORT __attribute__((visibility("default")))
+#else
+#define OPENDE_EXPORT
+#endif
+
+#define OPENDE_API_VERSION 1
+
+#define OPENDE_KEY_MAX   48
+#define OPENDE_VALUE_MAX 464
+
+// Return codes
+#define OPENDE_OK            0
+#define OPENDE_ERR_UNKNOWN   (-1)  // No such key
+#define OPENDE_ERR_INVALID   (-2)  // Value not accepted for the key
+#define OPENDE_ERR_FAILED    (-3)  // Backend could not apply it
+#define OPENDE_ERR_READONLY  (-4)  // Key can be read but not set
+#define OPENDE_ERR_SYSTEM    (-5)  // Snapshot or watch unavailable
+
+typedef struct {
+    char key[OPENDE_KEY_MAX];
+    char value[OPENDE_VALUE_MAX];
+} OpendeSetting;
+
+// OPENDE_API_VERSION the library was built with
+OPENDE_EXPORT int opende_api_version(void);
+
+// Message for the last failed call ("" if none)
+OPENDE_EXPORT const char *opende_last_error(void);
+
+// Current value of one setting
+OPENDE_EXPORT int opende_get(const char *key, char *value, size_t size);
+
+// Change one setting and apply it to the running components
+OPENDE_EXPORT int opende_set(const char *key, const char *value);
+
+// Apply several settings, publishing the snapshot once at the end.
+// Stops at the first failure and stores its index in *failed (if not
+// NULL). Returns OPENDE_OK or the failing setting's error.
+OPENDE_EXPORT int opende_apply(const OpendeSetting *settings, int count, int *failed);
+
+// Every setting, consistent as a whole. With refresh, re-read the
+// config files first (picks up hand edits). Returns count or an error.
+OPENDE_EXPORT int opende_status(OpendeSetting *settings, int max, int refresh);
+
+// Re-read every config file and republish the snapshot
+OPENDE_EXPORT int opende_refresh(void);
+
+// Change notifications. Callbacks run inside opende_dispatch() once per
+// changed key, with changes made by any process.
+typedef void (*OpendeCallback)(const char *key, const char *value, void *data);
+
+// Returns a subscription id (> 0) or an error
+OPENDE_EXPORT int opende_subscribe(OpendeCallback callback, void *data);
+OPENDE_EXPORT int opende_unsubscribe(int id);
+
+// File descriptor that becomes readable when settings may have changed,
+// for integration with poll()/select() loops. Valid while subscribed.
+OPENDE_EXPORT int opende_watch_fd(void);
+
+// Deliver pending changes, waiting up to timeout_ms (-1 = forever, 0 =
+// just check). Returns the number of callbacks run or an error.
+OPENDE_EXPORT int opende_dispatch(int timeout_ms);
+
+#endif
@@ -0,0 +1,20 @@
+// cli/src/api/api.h
+#ifndef OPENDE_API_H
+#define OPENDE_API_H
+
+// What the opende CLI and its interactive menu use on top of the public
+// API. Not exported from libopende.so.
+
+typedef enum {
+    API_ENABLE,
+    API_DISABLE,
+    API_SET
+} ApiAction;
+
+// opende_set for a command line verb: enable/disable/set go to the
+// category as given, whatever the key's kind, and the categories report
+// on the terminal instead of into opende_last_error(). Publishes the
+// snapshot on success. Returns OPENDE_OK or an OPENDE_ERR_* code.
+int api_change(const char *key, ApiAction action, const char *value);
+
+#endif
@@ -0,0 +1,415 @@
+// cli/src/api/opende.c
+#define _POSIX_C_SOURCE 200809L
+#include "../../include/opende.h"
+#include "api.h"
+#include "../categories/appmenu.h"
+#include "../categories/category.h"
+#include "../categories/display.h"
+#include "../categories/effects.h"
+#include "../categories/input.h"
+#include "../categories/notifications.h"
+#include "../categories/panel.h"
+#include "../categories/power.h"
+#include "../categories/settings.h"
+#include "../categories/wallpaper.h"
+#include "../categories/wm.h"
+#include "../util/output.h"
+#include "../util/proc.h"
+#include "../util/snapshot.h"
+#include <errno.h>
+#include <libgen.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#define MAX_SUBSCRIPTIONS 16
+
+// OpendeSetting is copied straight out of the snapshot
+typedef char key_size_matches[OPENDE_KEY_MAX == SNAPSHOT_KEY_MAX ? 1 : -1];
+typedef char value_size_matches[OPENDE_VALUE_MAX == SNAPSHOT_VALUE_MAX ? 1 : -1];
+
+typedef struct {
+    const char *name;
+    int (*enable)(const char *setting);
+    int (*disable)(const char *setting);
+    int (*set)(const char *setting, const char *value);
+    void (*list)(void);
+} Category;
+
+static const Category categories[] = {
+    { "effects",       effects_enable,       effects_disable,       effects_set,       effects_list_settings },
+    { "panel",         panel_enable,         panel_disable,         panel_set,         panel_list_settings },
+    { "wallpaper",     wallpaper_enable,     wallpaper_disable,     wallpaper_set,     wallpaper_list_settings },
+    { "wm",            wm_enable,            wm_disable,            wm_set,            wm_list_settings },
+    { "input",         input_enable,         input_disable,         input_set,         input_list_settings },
+    { "notifications", notifications_enable, notifications_disable, notifications_set, notifications_list_settings },
+    { "power",         power_enable,         power_disable,         power_set,         power_list_settings },
+    { "display",       display_enable,       display_disable,       display_set,       display_list_settings },
+    { "menu",          appmenu_enable,       appmenu_disable,       NULL,              NULL },
+};
+
+typedef enum {
+    KEY_TOGGLE,              // enable/disable
+    KEY_VALUE                // set
+} KeyKind;
+
+// The settable keys: the library's stable surface
+static const struct {
+    const char *key;
+    KeyKind kind;
+} keys[] = {
+    { "effects.compositor",               KEY_TOGGLE },
+    { "effects.shadows",                  KEY_TOGGLE },
+    { "effects.animations",               KEY_TOGGLE },
+    { "effects.transparency",             KEY_VALUE },
+    { "effects.governor",                 KEY_TOGGLE },
+    { "panel.position",                   KEY_VALUE },
+    { "panel.autohide",                   KEY_TOGGLE },
+    { "panel.systray",                    KEY_TOGGLE },
+    { "wallpaper.image",                  KEY_VALUE },
+    { "wallpaper.mode",                   KEY_VALUE },
+    { "wallpaper.color",                  KEY_VALUE },
+    { "wm.animations",                    KEY_TOGGLE },
+    { "wm.focus",                         KEY_VALUE },
+    { "wm.workspaces",                    KEY_VALUE },
+    { "input.natural-scrolling",          KEY_TOGGLE },
+    { "input.tap-to-click",               KEY_TOGGLE },
+    { "input.mouse-accel",                KEY_VALUE },
+    { "input.repeat-delay",               KEY_VALUE },
+    { "input.repeat-rate",                KEY_VALUE },
+    { "input.keyboard-layout",            KEY_VALUE },
+    { "input.keyboard-variant",           KEY_VALUE },
+    { "input.keyboard-options",           KEY_VALUE },
+    { "notifications.dnd",                KEY_TOGGLE },
+    { "notifications.history",            KEY_VALUE },
+    { "notifications.timeout",            KEY_VALUE },
+    { "notifications.timeout-low",        KEY_VALUE },
+    { "notifications.timeout-critical",   KEY_VALUE },
+    { "notifications.limit",              KEY_VALUE },
+    { "notifications.stacking",           KEY_TOGGLE },
+    { "notifications.fullscreen-pause",   KEY_TOGGLE },
+    { "power.screensaver",                KEY_VALUE },
+    { "power.dpms",                       KEY_TOGGLE },
+    { "power.dpms-standby",               KEY_VALUE },
+    { "power.dpms-suspend",               KEY_VALUE },
+    { "power.dpms-off",                   KEY_VALUE },
+    { "power.idle-suspend",               KEY_TOGGLE },
+    { "display.hotplug",                  KEY_TOGGLE },
+    { "display.max-refresh",              KEY_TOGGLE },
+    { "display.auto-layout",              KEY_TOGGLE },
+    { "display.layout",                   KEY_VALUE },
+    { "menu.frecency",                    KEY_TOGGLE },
+};
+
+#define KEY_COUNT (int)(sizeof(keys) / sizeof(keys[0]))
+
+static char last_error[256];
+static int verbose;          // api_change: the CLI shows the messages
+
+static int fail(int code, const char *fmt, const char *arg) {
+    snprintf(last_error, sizeof(last_error), fmt, arg);
+    if (verbose) print_error("%s", last_error);
+    return code;
+}
+
+// The categories report through print_*; keep them off the caller's
+// stdout while publishing
+static int publish(void) {
+    output_set_quiet(1);
+    int result = settings_publish();
+    output_set_quiet(0);
+    return result;
+}
+
+int opende_api_version(void) {
+    return OPENDE_API_VERSION;
+}
+
+const char *opende_last_error(void) {
+    return last_error;
+}
+
+int opende_get(const char *key, char *value, size_t size) {
+    last_error[0] = '\0';
+    if (snapshot_get(key, value, size) == 0) return OPENDE_OK;
+
+    // First use in this session: nothing has been published yet
+    if (snapshot_generation() == 0) {
+        if (opende_refresh() != OPENDE_OK) return OPENDE_ERR_SYSTEM;
+        if (snapshot_get(key, value, size) == 0) return OPENDE_OK;
+    }
+    return fail(OPENDE_ERR_UNKNOWN, "Unknown setting '%s'", key);
+}
+
+// 1 for on words, 0 for off words, -1 otherwise
+static int parse_toggle(const char *value) {
+    static const char *on[] = { "enabled", "enable", "on", "true", "yes", "1", NULL };
+    static const char *off[] = { "disabled", "disable", "off", "false", "no", "0", NULL };
+    for (int i = 0; on[i]; i++) {
+        if (strcmp(value, on[i]) == 0) return 1;
+        if (strcmp(value, off[i]) == 0) return 0;
+    }
+    return -1;
+}
+
+// The index of a settable key and its category, or an OPENDE_ERR_* code
+static int lookup(const char *key, const Category **category) {
+    const char *dot = strchr(key, '.');
+    *category = NULL;
+    for (size_t i = 0; dot && i < sizeof(categories) / sizeof(categories[0]); i++) {
+        size_t len = strlen(categories[i].name);
+        if ((size_t)(dot - key) == len && strncmp(key, categories[i].name, len) == 0) {
+            *category = &categories[i];
+        }
+    }
+
+    for (int i = 0; *category && i < KEY_COUNT; i++) {
+        if (strcmp(keys[i].key, key) == 0) return i;
+    }
+
+    char current[OPENDE_VALUE_MAX];
+    if (snapshot_get(key, current, sizeof(current)) == 0) {
+        return fail(OPENDE_ERR_READONLY, "Setting '%s' is read-only", key);
+    }
+    int result = fail(OPENDE_ERR_UNKNOWN, "Unknown setting '%s'", key);
+    if (verbose && *category && (*category)->list) (*category)->list();
+    return result;
+}
+
+// Hand the change to its category, without publishing
+static int run(const Category *category, const char *key, ApiAction action, const char *value) {
+    const char *setting = strchr(key, '.') + 1;
+    if (action == API_SET && !category->set) {
+        return fail(OPENDE_ERR_INVALID, "Setting '%s' does not support 'set', use enable/disable", key);
+    }
+
+    // Library callers get the error message instead of the output
+    output_set_quiet(!verbose);
+    int result = action == API_ENABLE ? category->enable(setting) :
+                 action == API_DISABLE ? category->disable(setting) : category->set(setting, value);
+    output_set_quiet(0);
+
+    if (result == 0) return OPENDE_OK;
+    snprintf(last_error, sizeof(last_error), "%s", output_last_error());
+    if (result == 2) return OPENDE_ERR_UNKNOWN;
+    return result == CATEGORY_INVALID ? OPENDE_ERR_INVALID : OPENDE_ERR_FAILED;
+}
+
+// Apply one setting without publishing
+static int set_one(const char *key, const char *value) {
+    const Category *category;
+    int index = lookup(key, &category);
+    if (index < 0) return index;
+
+    ApiAction action = API_SET;
+    if (keys[index].kind == KEY_TOGGLE) {
+        int on = parse_toggle(value);
+        if (on < 0) return fail(OPENDE_ERR_INVALID, "Expected enabled or disabled, got '%s'", value);
+        action = on ? API_ENABLE : API_DISABLE;
+    }
+    return run(category, key, action, value);
+}
+
+int opende_set(const char *key, const char *value) {
+    last_error[0] = '\0';
+    int result = set_one(key, value);
+    if (result == OPENDE_OK) publish();
+    return result;
+}
+
+int opende_apply(const OpendeSetting *settings, int count, int *failed) {
+    last_error[0] = '\0';
+    int result = OPENDE_OK, applied = 0;
+    for (int i = 0; i < count; i++) {
+        result = set_one(settings[i].key, settings[i].value);
+        if (result != OPENDE_OK) {
+            if (failed) *failed = i;
+            break;
+        }
+        applied++;
+    }
+
+    // Readers see the whole batch at once
+    if (applied > 0) publish();
+    return result;
+}
+
+int api_change(const char *key, ApiAction action, const char *value) {
+    last_error[0] = '\0';
+    verbose = 1;
+    const Category *category;
+    int result = lookup(key, &category);
+    if (result >= 0) result = run(category, key, action, value);
+    verbose = 0;
+
+    if (result == OPENDE_OK) publish();
+    return result;
+}
+
+int opende_refresh(void) {
+    int result = publish();
+    return result == 0 ? OPENDE_OK : fail(OPENDE_ERR_SYSTEM, "%s", "Cannot publish settings snapshot");
+}
+
+static int read_all(SnapshotEntry *entries, int max) {
+    int count = snapshot_read_all(entries, max);
+    if (count < 0 && snapshot_generation() == 0 && opende_refresh() == OPENDE_OK) {
+        count = snapshot_read_all(entries, max);
+    }
+    return count;
+}
+
+int opende_status(OpendeSetting *settings, int max, int refresh) {
+    last_error[0] = '\0';
+    if (refresh && opende_refresh() != OPENDE_OK) return OPENDE_ERR_SYSTEM;
+
+    SnapshotEntry entries[SNAPSHOT_MAX_ENTRIES];
+    int count = read_all(entries, SNAPSHOT_MAX_ENTRIES);
+    if (count < 0) return fail(OPENDE_ERR_SYSTEM, "%s", "Cannot read settings snapshot");
+
+    if (count > max) count = max;
+    for (int i = 0; i < count; i++) {
+        // Same layout: OPENDE_KEY_MAX/VALUE_MAX mirror the snapshot's limits
+        memcpy(settings[i].key, entries[i].key, sizeof(settings[i].key));
+        memcpy(settings[i].value, entries[i].value, sizeof(settings[i].value));
+    }
+    return count;
+}
+
+// --- Subscriptions ------------------------------------------------------
+
+static struct {
+    int id;
+    OpendeCallback callback;
+    void *data;
+} subscriptions[MAX_SUBSCRIPTIONS];
+
+static int next_id = 1;
+static int watch_fd = -1;
+static SnapshotEntry known[SNAPSHOT_MAX_ENTRIES];
+static int known_count;
+static uint64_t known_generation;
+
+// Watch the runtime directory: the snapshot may not exist yet, and
+// publishes only touch it (IN_ATTRIB)
+static int open_watch(void) {
+    char *path = snapshot_path();
+    if (!path) return -1;
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && inotify_add_watch(fd, dirname(path), IN_ATTRIB | IN_CREATE | IN_MOVED_TO) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    free(path);
+    return fd;
+}
+
+int opende_subscribe(OpendeCallback callback, void *data) {
+    last_error[0] = '\0';
+    int slot = -1;
+    for (int i = 0; i < MAX_SUBSCRIPTIONS && slot < 0; i++) {
+        if (subscriptions[i].id == 0) slot = i;
+    }
+    if (!callback || slot < 0) return fail(OPENDE_ERR_INVALID, "%s", "Cannot add subscription");
+
+    if (watch_fd < 0) {
+        watch_fd = open_watch();
+        if (watch_fd < 0) return fail(OPENDE_ERR_SYSTEM, "%s", "Cannot watch settings snapshot");
+
+        // Changes are reported relative to the state at subscription
+        known_generation = snapshot_generation();
+        known_count = read_all(known, SNAPSHOT_MAX_ENTRIES);
+        if (known_count < 0) known_count = 0;
+    }
+
+    subscriptions[slot].id = next_id++;
+    subscriptions[slot].callback = callback;
+    subscriptions[slot].data = data;
+    return subscriptions[slot].id;
+}
+
+int opende_unsubscribe(int id) {
+    int active = 0, found = 0;
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++) {
+        if (id > 0 && subscriptions[i].id == id) {
+            subscriptions[i].id = 0;
+            found = 1;
+        }
+        if (subscriptions[i].id) active++;
+    }
+
+    if (!active && watch_fd >= 0) {
+        close(watch_fd);
+        watch_fd = -1;
+    }
+    return found ? OPENDE_OK : OPENDE_ERR_INVALID;
+}
+
+int opende_watch_fd(void) {
+    return watch_fd;
+}
+
+static void notify(const char *key, const char *value) {
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++) {
+        if (subscriptions[i].id) subscriptions[i].callback(key, value, subscriptions[i].data);
+    }
+}
+
+// Compare the snapshot with what subscribers last saw
+static int deliver(void) {
+    SnapshotEntry current[SNAPSHOT_MAX_ENTRIES];
+    uint64_t generation = snapshot_generation();
+    int count = snapshot_read_all(current, SNAPSHOT_MAX_ENTRIES);
+    if (count < 0) return 0;
+
+    int delivered = 0;
+    for (int i = 0; i < count; i++) {
+        int same = 0;
+        for (int j = 0; j < known_count && !same; j++) {
+            same = strcmp(known[j].key, current[i].key) == 0 &&
+                   strcmp(known[j].value, current[i].value) == 0;
+        }
+        if (!same) {
+            notify(current[i].key, current[i].value);
+            delivered++;
+        }
+    }
+
+    memcpy(known, current, sizeof(SnapshotEntry) * (size_t)count);
+    known_count = count;
+    known_generation = generation;
+    return delivered;
+}
+
+int opende_dispatch(int timeout_ms) {
+    if (watch_fd < 0) return fail(OPENDE_ERR_INVALID, "%s", "No subscriptions");
+
+    double deadline = timeout_ms >= 0 ? proc_now_ms() + timeout_ms : 0;
+    for (;;) {
+        // A single load tells whether anything was published
+        if (snapshot_generation() != known_generation) {
+            int delivered = deliver();
+            if (delivered > 0) return delivered;
+        }
+
+        int wait = -1;
+        if (timeout_ms >= 0) {
+            double left = deadline - proc_now_ms();
+            if (left <= 0) return 0;
+            wait = (int)left + 1;
+        }
+
+        struct pollfd pfd = { .fd = watch_fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, wait);
+        if (ready < 0 && errno != EINTR) return fail(OPENDE_ERR_SYSTEM, "%s", strerror(errno));
+
+        // Drain; the snapshot itself says what changed
+        char buf[4096];
+        while (read(watch_fd, buf, sizeof(buf)) > 0) {}
+    }
+}
@@ -0,0 +1,263 @@
+// cli/src/backends/autostart.c
+#define _DEFAULT_SOURCE
+#include "autostart.h"
+#include "components.h"
+#include "frecency.h"
+#include "../util/config.h"
+#include "../util/proc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#define MAX_ENTRIES 128
+
+// ioprio_set(2) has no glibc wrapper
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_CLASS_BE    2
+#define IOPRIO_CLASS_IDLE  3
+#define IOPRIO_WHO_PROCESS 1
+
+static const char *plan_names[] = {
+    [AUTOSTART_NOW]     = "now",
+    [AUTOSTART_DELAYED] = "delayed",
+    [AUTOSTART_IDLE]    = "when idle",
+    [AUTOSTART_SKIP]    = "skipped",
+};
+
+const char *autostart_plan_name(AutostartPlan plan) {
+    return plan_names[plan];
+}
+
+// autostart.low lists desktop ids to treat as low priority without
+// editing the (often system-owned) .desktop file
+static int listed_low(const char *id) {
+    char *list = config_get_setting("autostart.low");
+    if (!list) return 0;
+
+    int found = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(list, " ,", &save); tok && !found; tok = strtok_r(NULL, " ,", &save)) {
+        size_t n = strlen(tok);
+        found = strcmp(tok, id) == 0 ||
+                (strncmp(tok, id, n) == 0 && strcmp(id + n, ".desktop") == 0);
+    }
+    free(list);
+    return found;
+}
+
+static void plan_item(AutostartItem *item) {
+    DesktopEntry *e = &item->entry;
+    item->plan = AUTOSTART_SKIP;
+
+    if (e->hidden) {
+        item->reason = "Hidden=true";
+        return;
+    }
+    if (e->autostart_disabled) {
+        item->reason = "disabled";
+        return;
+    }
+    if (!e->application || !e->exec[0]) {
+        item->reason = "not an application";
+        return;
+    }
+    if (!desktop_entry_shown_in_current(e)) {
+        item->reason = "OnlyShowIn/NotShowIn";
+        return;
+    }
+    if (!desktop_entry_try_exec_ok(e)) {
+        item->reason = "TryExec not found";
+        return;
+    }
+
+    char *argv[64];
+    int argc = desktop_exec_argv(e->exec, argv, 64);
+    if (argc < 1) {
+        item->reason = "bad Exec";
+        if (argc == 0) desktop_free_argv(argv);
+        return;
+    }
+
+    // The session starts these itself (system entries exist for nm-applet,
+    // blueman and friends)
+    const char *base = strrchr(argv[0], '/');
+    const SessionComponent *c = components_find(base ? base + 1 : argv[0]);
+    char *exec = desktop_find_executable(argv[0]);
+    desktop_free_argv(argv);
+
+    if (c && c->command) {
+        item->reason = "session component";
+    } else if (!exec) {
+        item->reason = "not installed";
+    } else if (e->low_priority || listed_low(e->id)) {
+        item->plan = AUTOSTART_IDLE;
+    } else if (e->autostart_delay > 0) {
+        item->plan = AUTOSTART_DELAYED;
+    } else {
+        item->plan = AUTOSTART_NOW;
+    }
+    free(exec);
+}
+
+int autostart_collect(AutostartItem *items, int max) {
+    static DesktopEntry entries[MAX_ENTRIES];
+    int count = desktop_autostart_list(entries, max < MAX_ENTRIES ? max : MAX_ENTRIES);
+
+    for (int i = 0; i < count; i++) {
+        items[i].entry = entries[i];
+        items[i].reason = NULL;
+        plan_item(&items[i]);
+    }
+    return count;
+}
+
+static void lower_priority(void) {
+    // Failures are not fatal; the entry still starts
+    setpriority(PRIO_PROCESS, 0, config_get_setting_int("autostart.nice", 10));
+
+    char *io = config_get_setting("autostart.ioprio");
+    int ioprio = -1;
+    if (!io || strcmp(io, "low") == 0) {
+        ioprio = (IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT) | 7;
+    } else if (strcmp(io, "idle") == 0) {
+        ioprio = IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT;
+    }
+    free(io);
+
+    if (ioprio >= 0) syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, ioprio);
+}
+
+// Ids launched so far, for the launch history
+static const char *launched_ids[MAX_ENTRIES];
+static int launched_count;
+
+static int launch(const AutostartItem *item) {
+    char *argv[64];
+    if (desktop_exec_argv(item->entry.exec, argv, 64) < 1) return -1;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Ignored SIGCHLD survives exec and would stop the application
+        // from ever seeing its own children's exit status
+        signal(SIGCHLD, SIG_DFL);
+
+        // Own session: not killed with us, and not tied to our terminal
+        setsid();
+        if (item->plan == AUTOSTART_IDLE) lower_priority();
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+
+    desktop_free_argv(argv);
+    if (pid > 0 && launched_count < MAX_ENTRIES) launched_ids[launched_count++] = item->entry.id;
+    return pid > 0 ? 0 : -1;
+}
+
+typedef struct {
+    unsigned long long idle;
+    unsigned long long total;
+} CpuSample;
+
+static int read_cpu(CpuSample *s) {
+    FILE *fp = fopen("/proc/stat", "r");
+    if (!fp) return -1;
+
+    unsigned long long v[8] = { 0 };
+    int n = fscanf(fp, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+                   &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]);
+    fclose(fp);
+    if (n < 4) return -1;
+
+    s->idle = v[3] + v[4];  // idle + iowait
+    s->total = 0;
+    for (int i = 0; i < 8; i++) s->total += v[i];
+    return 0;
+}
+
+// "some avg10=" from /proc/pressure/io; -1 without PSI
+static double read_io_pressure(void) {
+    char *text = config_read_file("/proc/pressure/io");
+    if (!text) return -1;
+
+    double avg = -1;
+    const char *p = strstr(text, "some avg10=");
+    if (p) avg = strtod(p + 11, NULL);
+    free(text);
+    return avg;
+}
+
+void autostart_wait_for_idle(int timeout_s) {
+    CpuSample prev, cur;
+    if (read_cpu(&prev) != 0) {
+        sleep((unsigned int)timeout_s);
+        return;
+    }
+
+    int quiet = 0;
+    for (int waited = 0; waited < timeout_s && quiet < AUTOSTART_IDLE_SAMPLES; waited++) {
+        sleep(1);
+        if (read_cpu(&cur) != 0) break;
+
+        unsigned long long total = cur.total - prev.total;
+        double idle = total ? (double)(cur.idle - prev.idle) / (double)total : 1;
+        double io = read_io_pressure();
+        prev = cur;
+
+        quiet = (idle >= AUTOSTART_IDLE_CPU && io < AUTOSTART_IDLE_IO_PSI) ? quiet + 1 : 0;
+    }
+}
+
+int autostart_run(void) {
+    static AutostartItem items[MAX_ENTRIES];
+    int count = autostart_collect(items, MAX_ENTRIES);
+
+    // Children are independent applications; never leave zombies
+    signal(SIGCHLD, SIG_IGN);
+
+    int launched = 0, pending = 0;
+    for (int i = 0; i < count; i++) {
+        if (items[i].plan == AUTOSTART_NOW) {
+            if (launch(&items[i]) == 0) launched++;
+        } else if (items[i].plan != AUTOSTART_SKIP) {
+            pending++;
+        }
+    }
+    frecency_record(launched_ids, launched_count);
+    launched_count = 0;
+    if (!pending) return launched;
+
+    // Delayed entries, in order of their delay
+    double start = proc_now_ms();
+    for (;;) {
+        int next = -1;
+        for (int i = 0; i < count; i++) {
+            if (items[i].plan != AUTOSTART_DELAYED) continue;
+            if (next < 0 || items[i].entry.autostart_delay < items[next].entry.autostart_delay) next = i;
+        }
+        if (next < 0) break;
+
+        double due = start + items[next].entry.autostart_delay * 1000.0;
+        double now = proc_now_ms();
+        if (due > now) usleep((useconds_t)((due - now) * 1000));
+        if (launch(&items[next]) == 0) launched++;
+        items[next].plan = AUTOSTART_SKIP;
+    }
+
+    // Low-priority entries once the desktop has settled
+    int has_idle = 0;
+    for (int i = 0; i < count; i++) has_idle |= items[i].plan == AUTOSTART_IDLE;
+    if (has_idle) {
+        autostart_wait_for_idle(config_get_setting_int("autostart.idle_timeout", 60));
+        for (int i = 0; i < count; i++) {
+            if (items[i].plan == AUTOSTART_IDLE && launch(&items[i]) == 0) launched++;
+        }
+    }
+
+    frecency_record(launched_ids, launched_count);
+    launched_count = 0;
+    return launched;
+}
@@ -0,0 +1,40 @@
+// cli/src/backends/autostart.h
+#ifndef OPENDE_AUTOSTART_H
+#define OPENDE_AUTOSTART_H
+
+#include "../util/desktop.h"
+
+// XDG autostart: what happens to each entry at login
+typedef enum {
+    AUTOSTART_NOW,           // Launched immediately, in parallel
+    AUTOSTART_DELAYED,       // X-GNOME-Autostart-Delay seconds after login
+    AUTOSTART_IDLE,          // Low priority: once the session is idle
+    AUTOSTART_SKIP           // Not launched (see reason)
+} AutostartPlan;
+
+typedef struct {
+    DesktopEntry entry;
+    AutostartPlan plan;
+    const char *reason;      // Why it is skipped, or NULL
+} AutostartItem;
+
+// Idle detection: CPU at least this idle and IO pressure below this
+#define AUTOSTART_IDLE_CPU      0.80
+#define AUTOSTART_IDLE_IO_PSI   5.0
+#define AUTOSTART_IDLE_SAMPLES  3       // Consecutive one-second samples
+
+// Decide the plan for every effective autostart entry
+// Returns number of items (at most max)
+int autostart_collect(AutostartItem *items, int max);
+
+const char *autostart_plan_name(AutostartPlan plan);
+
+// Block until the CPU is mostly idle and nobody is waiting on the disk,
+// or until the timeout. Sampling stops as soon as the session settles.
+void autostart_wait_for_idle(int timeout_s);
+
+// Launch everything per plan. Returns once the last deferred entry has
+// been started. Returns number launched, -1 on error.
+int autostart_run(void);
+
+#endif
@@ -0,0 +1,255 @@
+// cli/src/backends/components.c
+#define _POSIX_C_SOURCE 200809L
+#include "components.h"
+#include "dunst.h"
+#include "picom.h"
+#include "supervisor.h"
+#include "units.h"
+#include "../util/config.h"
+#include "../util/proc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COMPONENTS_STATE_FILE "components.state"
+
+const SessionComponent session_components[] = {
+    { "picom",          "picom",          NULL, 0, "picom --config {picom-config}", ACTIVATE_ALWAYS, NULL },
+    { "dunst",          "dunst",          NULL, 0, "dunst -config {dunst-config}",
+      ACTIVATE_DBUS, "org.freedesktop.Notifications" },
+    // Polkit agents must be registered before a request arrives, so this
+    // one can only be moved off the login path, not activated on demand
+    { "lxpolkit",       "lxpolkit",       NULL, 0, "lxpolkit", ACTIVATE_DEFERRED, NULL },
+    { "nm-applet",      "nm-applet",      NULL, 0, "nm-applet", ACTIVATE_ALWAYS, NULL },
+    { "pasystray",      "pasystray",      NULL, 0, "pasystray", ACTIVATE_ALWAYS, NULL },
+    { "blueman-applet", "blueman-applet", NULL, 0, "blueman-applet", ACTIVATE_BLUETOOTH, NULL },
+    { "pcmanfm",        "pcmanfm",        "-d", 0, "pcmanfm -d", ACTIVATE_REMOVABLE, NULL },  // Only the automount daemon
+    { "tint2",          "tint2",          NULL, 0, "tint2", ACTIVATE_ALWAYS, NULL },
+    { "openbox",        "openbox",        NULL, 1, NULL, ACTIVATE_ALWAYS, NULL },
+    { "fluxbox",        "fluxbox",        NULL, 1, NULL, ACTIVATE_ALWAYS, NULL },
+    { "icewm",          "icewm",          NULL, 1, NULL, ACTIVATE_ALWAYS, NULL },
+    { "i3",             "i3",             NULL, 1, NULL, ACTIVATE_ALWAYS, NULL },
+    { NULL, NULL, NULL, 0, NULL, ACTIVATE_ALWAYS, NULL }
+};
+
+const SessionComponent *components_find(const char *name) {
+    for (int i = 0; session_components[i].name; i++) {
+        if (strcmp(session_components[i].name, name) == 0) {
+            return &session_components[i];
+        }
+    }
+    return NULL;
+}
+
+#define OPENDE_DEFAULT_DIR "/usr/local/share/opende"
+
+// Substitute {opende}, {picom-config} and {dunst-config} in one argument
+static char *expand_arg(const char *arg) {
+    const char *opende = getenv("OPENDE_DIR");
+    if (!opende || !*opende) opende = OPENDE_DEFAULT_DIR;
+
+    if (strcmp(arg, "{picom-config}") == 0) {
+        return picom_config_path();
+    }
+    if (strcmp(arg, "{dunst-config}") == 0) {
+        return dunst_config_path();
+    }
+
+    const char *mark = strstr(arg, "{opende}");
+    if (!mark) return strdup(arg);
+
+    size_t len = strlen(arg) - 8 + strlen(opende) + 1;
+    char *out = malloc(len);
+    if (!out) return NULL;
+    snprintf(out, len, "%.*s%s%s", (int)(mark - arg), arg, opende, mark + 8);
+    return out;
+}
+
+int components_build_argv(const SessionComponent *component, char **argv, int max) {
+    if (!component->command) return -1;
+
+    char *copy = strdup(component->command);
+    if (!copy) return -1;
+
+    int argc = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(copy, " ", &save); tok && argc < max - 1;
+         tok = strtok_r(NULL, " ", &save)) {
+        argv[argc] = expand_arg(tok);
+        if (!argv[argc]) break;
+        argc++;
+    }
+    argv[argc] = NULL;
+
+    free(copy);
+    return argc;
+}
+
+void components_free_argv(char **argv) {
+    for (int i = 0; argv[i]; i++) free(argv[i]);
+}
+
+int components_control(const SessionComponent *component, int start) {
+    if (!component || !component->command) return 1;
+    int result = units_control(component->name, start);
+    if (result != 1) return result;
+    return supervisor_control(component->name, start);
+}
+
+static int has_arg(pid_t pid, const char *arg) {
+    char cmdline[1024];
+    if (proc_read_cmdline(pid, cmdline, sizeof(cmdline)) != 0) return 0;
+
+    size_t len = strlen(arg);
+    for (char *p = strstr(cmdline, arg); p; p = strstr(p + 1, arg)) {
+        int starts = p == cmdline || p[-1] == ' ';
+        int ends = p[len] == '\0' || p[len] == ' ';
+        if (starts && ends) return 1;
+    }
+    return 0;
+}
+
+int components_find_pids(const SessionComponent *component, pid_t *pids, int max) {
+    pid_t found[64];
+    int count = proc_find_by_name(component->comm, found, 64);
+    int matched = 0;
+
+    // With several sessions per user (e.g. Xvfb, nested X), only count ours
+    const char *display = getenv("DISPLAY");
+
+    for (int i = 0; i < count && matched < max; i++) {
+        if (component->match_arg && !has_arg(found[i], component->match_arg)) continue;
+        if (display && *display && !proc_on_display(found[i], display)) continue;
+        pids[matched++] = found[i];
+    }
+    return matched;
+}
+
+// Restart bookkeeping: "<name> <pid> <start_time> <restarts>" per line
+typedef struct {
+    char name[32];
+    long pid;
+    unsigned long long start_time;
+    int restarts;
+} InstanceRecord;
+
+static int load_records(InstanceRecord *records, int max) {
+    char *path = config_get_runtime_path(COMPONENTS_STATE_FILE);
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return 0;
+
+    int count = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line && count < max;
+         line = strtok_r(NULL, "\n", &save)) {
+        InstanceRecord *r = &records[count];
+        if (sscanf(line, "%31s %ld %llu %d", r->name, &r->pid,
+                   &r->start_time, &r->restarts) == 4) {
+            count++;
+        }
+    }
+
+    free(text);
+    return count;
+}
+
+static void save_records(const InstanceRecord *records, int count) {
+    char *path = config_get_runtime_path(COMPONENTS_STATE_FILE);
+    if (!path) return;
+
+    char content[4096];
+    size_t len = 0;
+    for (int i = 0; i < count && len < sizeof(content); i++) {
+        len += (size_t)snprintf(content + len, sizeof(content) - len, "%s %ld %llu %d\n",
+                                records[i].name, records[i].pid,
+                                records[i].start_time, records[i].restarts);
+    }
+    if (len < sizeof(content)) config_write_file(path, content);
+    free(path);
+}
+
+static int track_restarts(InstanceRecord *records, int *count, int max,
+                          const char *name, const ProcStat *st) {
+    for (int i = 0; i < *count; i++) {
+        InstanceRecord *r = &records[i];
+        if (strcmp(r->name, name) != 0) continue;
+
+        if (r->pid != (long)st->pid || r->start_time != st->start_time) {
+            r->pid = (long)st->pid;
+            r->start_time = st->start_time;
+            r->restarts++;
+        }
+        return r->restarts;
+    }
+
+    if (*count < max) {
+        InstanceRecord *r = &records[(*count)++];
+        snprintf(r->name, sizeof(r->name), "%s", name);
+        r->pid = (long)st->pid;
+        r->start_time = st->start_time;
+        r->restarts = 0;
+    }
+    return 0;
+}
+
+int components_collect_stats(ComponentStats *stats, int max) {
+    InstanceRecord records[32];
+    int record_count = load_records(records, 32);
+    int count = 0;
+
+    for (int i = 0; session_components[i].name && count < max; i++) {
+        const SessionComponent *c = &session_components[i];
+        pid_t pids[16];
+        int n = components_find_pids(c, pids, 16);
+        if (n == 0 && c->window_manager) continue;
+
+        ComponentStats *s = &stats[count++];
+        memset(s, 0, sizeof(*s));
+        s->component = c;
+        s->pss_kb = n > 0 ? 0 : -1;
+
+        for (int j = 0; j < n; j++) {
+            ProcStat st;
+            long rss, pss;
+            if (proc_read_stat(pids[j], &st) != 0 ||
+                proc_read_memory(pids[j], &rss, &pss) != 0) {
+                continue;  // Exited while we looked
+            }
+
+            if (s->instances == 0) {
+                s->pid = pids[j];
+                s->restarts = track_restarts(records, &record_count, 32, c->name, &st);
+            }
+            s->instances++;
+            s->rss_kb += rss;
+            if (pss < 0 || s->pss_kb < 0) s->pss_kb = -1;
+            else s->pss_kb += pss;
+            s->cpu_seconds += proc_cpu_seconds(&st);
+
+            long long wakeups = proc_read_wakeups(pids[j]);
+            if (wakeups > 0) s->wakeups += wakeups;
+        }
+
+        // A component that is down keeps its restart count for next time
+        if (s->instances == 0) {
+            for (int r = 0; r < record_count; r++) {
+                if (strcmp(records[r].name, c->name) == 0) s->restarts = records[r].restarts;
+            }
+        }
+    }
+    save_records(records, record_count);
+
+    // The supervisor sees every crash, also between two calls; PID changes
+    // only count for components it doesn't manage
+    SupervisorEntry entries[32];
+    int managed = supervisor_read_state(entries, 32);
+    for (int e = 0; e < managed; e++) {
+        for (int i = 0; i < count; i++) {
+            if (strcmp(stats[i].component->name, entries[e].name) == 0) {
+                stats[i].restarts = entries[e].restarts;
+            }
+        }
+    }
+    return count;
+}
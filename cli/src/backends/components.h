@@ -0,0 +1,69 @@
+// cli/src/backends/components.h
+#ifndef OPENDE_COMPONENTS_H
+#define OPENDE_COMPONENTS_H
+
+#include <sys/types.h>
+
+// When a component starts in lazy mode (session.lazy)
+typedef enum {
+    ACTIVATE_ALWAYS,         // At login
+    ACTIVATE_DEFERRED,       // Shortly after login, off the critical path
+    ACTIVATE_DBUS,           // By the session bus on first use of its name
+    ACTIVATE_BLUETOOTH,      // Once a Bluetooth adapter exists
+    ACTIVATE_REMOVABLE       // On the first removable-media event
+} ComponentActivation;
+
+// A long-running component started by scripts/opende-common.sh
+typedef struct {
+    const char *name;        // Name used on the command line and in settings
+    const char *comm;        // Process name as in /proc/<pid>/comm
+    const char *match_arg;   // Argument identifying the session instance, or NULL
+    int window_manager;      // One of the alternative WMs; only one runs
+    const char *command;     // Command line, NULL if not supervised. {opende} is
+                             // the install dir, {picom-config} picom's config
+    ComponentActivation activation;
+    const char *dbus_name;   // Bus name it owns, for ACTIVATE_DBUS
+} SessionComponent;
+
+// All session components, terminated by an entry with name == NULL
+extern const SessionComponent session_components[];
+
+const SessionComponent *components_find(const char *name);
+
+// Expand a component's command into argv (NULL terminated)
+// Returns argc, or -1 if the component has no command. Free with
+// components_free_argv().
+int components_build_argv(const SessionComponent *component, char **argv, int max);
+void components_free_argv(char **argv);
+
+// Start or stop a component through its systemd unit or the session
+// supervisor, so a deliberate stop isn't restarted as a crash and a start
+// stays supervised.
+// Returns 0 when handled, 1 if nothing supervises the component (the
+// caller starts or stops it itself), -1 on error
+int components_control(const SessionComponent *component, int start);
+
+// Find running instances owned by the current user on the current $DISPLAY
+// Returns number found (at most max)
+int components_find_pids(const SessionComponent *component, pid_t *pids, int max);
+
+// Resource usage of one component, summed over its running instances
+typedef struct {
+    const SessionComponent *component;
+    int instances;
+    pid_t pid;               // First instance found
+    long rss_kb;
+    long pss_kb;             // -1 if unavailable
+    double cpu_seconds;
+    long long wakeups;       // Voluntary context switches
+    int restarts;            // Supervisor restarts, else PID changes seen
+} ComponentStats;
+
+// Fill one entry per component (skipping window managers that aren't
+// running). Restarts are the session supervisor's count when it manages
+// the component; otherwise PID changes tracked in a runtime file across
+// calls.
+// Returns number of entries written.
+int components_collect_stats(ComponentStats *stats, int max);
+
+#endif
@@ -0,0 +1,113 @@
+// cli/src/backends/dunst.c
+#define _POSIX_C_SOURCE 200809L
+#include "dunst.h"
+#include "components.h"
+#include "../util/config.h"
+#include "../util/ini.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DUNST_CONFIG_NAME "dunstrc"
+#define OPENDE_DEFAULT_DIR "/usr/local/share/opende"
+
+int dunst_is_installed(void) {
+    return system("which dunst > /dev/null 2>&1") == 0;
+}
+
+int dunst_is_running(void) {
+    pid_t pid;
+    return components_find_pids(components_find("dunst"), &pid, 1) == 1;
+}
+
+static char *system_config_path(void) {
+    const char *opende = getenv("OPENDE_DIR");
+    if (!opende || !*opende) opende = OPENDE_DEFAULT_DIR;
+
+    size_t len = strlen(opende) + sizeof("/config/" DUNST_CONFIG_NAME);
+    char *path = malloc(len);
+    if (path) snprintf(path, len, "%s/config/" DUNST_CONFIG_NAME, opende);
+    return path;
+}
+
+char *dunst_config_path(void) {
+    char *user_config = config_get_user_path(DUNST_CONFIG_NAME);
+    if (user_config && config_file_exists(user_config)) return user_config;
+    free(user_config);
+    return system_config_path();
+}
+
+char *dunst_get(const char *section, const char *key) {
+    char *path = dunst_config_path();
+    char *text = path ? config_read_file(path) : NULL;
+    char *value = text ? ini_get(text, section, key) : NULL;
+    free(text);
+    free(path);
+    return value;
+}
+
+// Seed the user copy from the template; without one, start empty
+static char *user_config(void) {
+    char *path = config_get_user_path(DUNST_CONFIG_NAME);
+    if (!path) return NULL;
+    if (config_file_exists(path)) return path;
+
+    char *source = system_config_path();
+    char *content = source ? config_read_file(source) : NULL;
+    free(source);
+
+    int result = config_ensure_dir(path) == 0 ? config_create_file(path, content ? content : "") : -1;
+    free(content);
+    if (result != 0) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+typedef struct {
+    const char *section;
+    const char *key;
+    const char *value;
+} IniEdit;
+
+static char *edit_ini(const char *text, void *data) {
+    const IniEdit *edit = data;
+    return ini_set(text, edit->section, edit->key, edit->value);
+}
+
+int dunst_set(const char *section, const char *key, const char *value) {
+    char *path = user_config();
+    if (!path) return -1;
+
+    IniEdit edit = { section, key, value };
+    int result = config_update_file(path, edit_ini, &edit);
+    free(path);
+    return result;
+}
+
+int dunst_reload(void) {
+    if (!dunst_is_running()) return 1;
+    return system("dunstctl reload > /dev/null 2>&1") == 0 ? 0 : -1;
+}
+
+int dunst_is_paused(void) {
+    if (!dunst_is_running()) return -1;
+
+    FILE *fp = popen("dunstctl is-paused 2>/dev/null", "r");
+    if (!fp) return -1;
+
+    char line[32];
+    int result = -1;
+    if (fgets(line, sizeof(line), fp)) {
+        result = strncmp(line, "true", 4) == 0;
+    }
+    pclose(fp);
+    return result;
+}
+
+// dunstctl goes through D-Bus, which starts a dunst that is not running yet
+int dunst_set_paused(int paused) {
+    return system(paused ? "dunstctl set-paused true > /dev/null 2>&1"
+                         : "dunstctl set-paused false > /dev/null 2>&1") == 0 ? 0 : -1;
+}
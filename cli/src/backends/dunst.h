@@ -0,0 +1,29 @@
+// cli/src/backends/dunst.h
+#ifndef OPENDE_DUNST_H
+#define OPENDE_DUNST_H
+
+// dunstrc is edited in a per-user copy (~/.config/opende/dunstrc), seeded
+// from the installed template on the first change
+
+int dunst_is_installed(void);
+int dunst_is_running(void);
+
+// Path of the config dunst is started with (user copy or system default)
+// Returns allocated string, caller frees
+char *dunst_config_path(void);
+
+// Value of key in [section] of the effective config (allocated) or NULL
+char *dunst_get(const char *section, const char *key);
+
+// Set key in [section] of the user copy. Returns 0 on success, -1 on error
+int dunst_set(const char *section, const char *key, const char *value);
+
+// Make a running dunst re-read its config. Returns 0 on success, 1 if
+// dunst is not running, -1 if it could not be reloaded
+int dunst_reload(void);
+
+// Do-not-disturb through dunstctl: 1 paused, 0 not, -1 unknown/not running
+int dunst_is_paused(void);
+int dunst_set_paused(int paused);
+
+#endif
@@ -0,0 +1,75 @@
+// cli/src/backends/fluxbox.c
+#define _POSIX_C_SOURCE 200809L
+#include "wm.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The session copies the template here on first login
+#define FLUXBOX_INIT     ".fluxbox/init"
+#define FLUXBOX_TEMPLATE "fluxbox/init"
+
+#define KEY_FOCUS       "session.screen0.focusModel"
+#define KEY_WORKSPACES  "session.screen0.workspaces"
+#define KEY_NAMES       "session.screen0.workspaceNames"
+
+static int fluxbox_get(WmSetting setting, char *buf, size_t size) {
+    if (setting == WM_SETTING_ANIMATIONS) return WM_UNSUPPORTED;
+
+    char *path = wm_home_config(FLUXBOX_INIT, FLUXBOX_TEMPLATE);
+    if (!path) return -1;
+
+    char value[128];
+    int result = wm_line_get(path, setting == WM_SETTING_FOCUS ? KEY_FOCUS : KEY_WORKSPACES,
+                             ':', value, sizeof(value));
+    free(path);
+    if (result != 0) return -1;
+
+    if (setting == WM_SETTING_FOCUS) {
+        // MouseFocus, StrictMouseFocus and ClickFocus
+        snprintf(buf, size, "%s", strstr(value, "Mouse") ? "mouse" : "click");
+    } else {
+        snprintf(buf, size, "%s", value);
+    }
+    return 0;
+}
+
+static int fluxbox_set(WmSetting setting, const char *value) {
+    if (setting == WM_SETTING_ANIMATIONS) return WM_UNSUPPORTED;
+
+    char *path = wm_home_config(FLUXBOX_INIT, FLUXBOX_TEMPLATE);
+    if (!path) return -1;
+
+    int result;
+    if (setting == WM_SETTING_FOCUS) {
+        result = wm_line_set(path, KEY_FOCUS, ": ",
+                             strcmp(value, "mouse") == 0 ? "MouseFocus" : "ClickFocus");
+    } else {
+        // Name every workspace so none shows up as a blank label
+        char names[WM_MAX_WORKSPACES * 4] = "";
+        int count = atoi(value);
+        for (int i = 1; i <= count; i++) {
+            size_t len = strlen(names);
+            snprintf(names + len, sizeof(names) - len, "%s%d", i > 1 ? "," : "", i);
+        }
+        result = wm_line_set(path, KEY_WORKSPACES, ": ", value);
+        if (result == 0) result = wm_line_set(path, KEY_NAMES, ": ", names);
+    }
+
+    free(path);
+    return result;
+}
+
+static int fluxbox_apply(pid_t pid, WmSetting setting, const char *value) {
+    // SIGUSR2 is fluxbox's reconfigure: it re-reads init and re-applies
+    // it to the running screens. SIGHUP would restart the whole WM.
+    if (kill(pid, SIGUSR2) != 0) return -1;
+
+    if (setting == WM_SETTING_WORKSPACES) wm_request_desktops(atoi(value));
+    return WM_APPLIED_LIVE;
+}
+
+const WmBackend wm_fluxbox = {
+    "fluxbox", "fluxbox", fluxbox_get, fluxbox_set, fluxbox_apply
+};
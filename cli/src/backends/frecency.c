@@ -0,0 +1,115 @@
+// cli/src/backends/frecency.c
+#define _DEFAULT_SOURCE
+#include "frecency.h"
+#include "../util/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+#define FRECENCY_LOCK_FILE "frecency.lock"
+
+char *frecency_path(void) {
+    const char *data = getenv("XDG_DATA_HOME");
+    const char *home = getenv("HOME");
+    char path[512];
+
+    if (data && *data) snprintf(path, sizeof(path), "%s/opende/launches", data);
+    else if (home) snprintf(path, sizeof(path), "%s/.local/share/opende/launches", home);
+    else return NULL;
+
+    return strdup(path);
+}
+
+static double decay(double score, long long last, long long now) {
+    double days = now > last ? (double)(now - last) / 86400.0 : 0;
+    return score * pow(0.5, days / FRECENCY_HALF_LIFE_DAYS);
+}
+
+static int by_score(const void *a, const void *b) {
+    double sa = ((const FrecencyEntry *)a)->score, sb = ((const FrecencyEntry *)b)->score;
+    return sa < sb ? 1 : sa > sb ? -1 : 0;
+}
+
+// Lines of "<score> <epoch> <desktop id>", the score as of that time
+int frecency_load(FrecencyEntry *entries, int max) {
+    char *path = frecency_path();
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return 0;
+
+    long long now = (long long)time(NULL);
+    int count = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line && count < max; line = strtok_r(NULL, "\n", &save)) {
+        FrecencyEntry *e = &entries[count];
+        double score;
+        if (sscanf(line, "%lf %lld %127s", &score, &e->last, e->id) != 3) continue;
+        e->score = decay(score, e->last, now);
+        count++;
+    }
+    free(text);
+
+    qsort(entries, (size_t)count, sizeof(FrecencyEntry), by_score);
+    return count;
+}
+
+double frecency_score(const FrecencyEntry *entries, int count, const char *id) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(entries[i].id, id) == 0) return entries[i].score;
+    }
+    return 0;
+}
+
+int frecency_record(const char *const *ids, int count) {
+    if (count <= 0) return 0;
+
+    // Launches can race (menu and autostart); serialize read-modify-write
+    char *lock_path = config_get_runtime_path(FRECENCY_LOCK_FILE);
+    int lock_fd = lock_path ? open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600) : -1;
+    free(lock_path);
+    if (lock_fd >= 0) flock(lock_fd, LOCK_EX);
+
+    static FrecencyEntry entries[FRECENCY_MAX_ENTRIES + 1];
+    int n = frecency_load(entries, FRECENCY_MAX_ENTRIES);
+    long long now = (long long)time(NULL);
+
+    for (int i = 0; i < count; i++) {
+        int found = -1;
+        for (int j = 0; j < n && found < 0; j++) {
+            if (strcmp(entries[j].id, ids[i]) == 0) found = j;
+        }
+        if (found < 0) {
+            // Full: the least used entry makes room
+            found = n < FRECENCY_MAX_ENTRIES ? n++ : n - 1;
+            snprintf(entries[found].id, sizeof(entries[found].id), "%s", ids[i]);
+            entries[found].score = 0;
+        }
+        entries[found].score += 1;
+        entries[found].last = now;
+        qsort(entries, (size_t)n, sizeof(FrecencyEntry), by_score);
+    }
+
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buf, &size);
+    int result = -1;
+    if (fp) {
+        for (int i = 0; i < n; i++) {
+            fprintf(fp, "%.4f %lld %s\n", entries[i].score, now, entries[i].id);
+        }
+        fclose(fp);
+
+        char *path = frecency_path();
+        if (path && buf && config_ensure_dir(path) == 0) result = config_write_file(path, buf);
+        free(path);
+    }
+    free(buf);
+
+    if (lock_fd >= 0) close(lock_fd);
+    return result;
+}
@@ -0,0 +1,31 @@
+// cli/src/backends/frecency.h
+#ifndef OPENDE_FRECENCY_H
+#define OPENDE_FRECENCY_H
+
+// Per-user launch history: one exponentially decaying score per desktop
+// id, bumped by each launch from the menu or autostart
+
+#define FRECENCY_HALF_LIFE_DAYS 7
+#define FRECENCY_MAX_ENTRIES    256
+#define FRECENCY_MIN_SCORE      0.5  // Below this an app counts as unused
+
+typedef struct {
+    char id[128];
+    double score;            // Decayed to the time of loading
+    long long last;          // Epoch seconds the stored score refers to
+} FrecencyEntry;
+
+// $XDG_DATA_HOME/opende/launches (caller must free)
+char *frecency_path(void);
+
+// Load entries sorted by current score, highest first
+// Returns number of entries (at most max)
+int frecency_load(FrecencyEntry *entries, int max);
+
+// Current score of one id in a loaded list, 0 if never launched
+double frecency_score(const FrecencyEntry *entries, int count, const char *id);
+
+// Count one launch of each id. Returns 0 on success, -1 on error
+int frecency_record(const char *const *ids, int count);
+
+#endif
@@ -0,0 +1,153 @@
+// cli/src/backends/i3.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "wm.h"
+#include "../util/config.h"
+#include "../util/proc.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// The session runs i3 on this copy once it exists
+#define I3_CONFIG_NAME "i3-config"
+#define I3_TEMPLATE    "i3/config"
+
+#define KEY_FOCUS "focus_follows_mouse"
+
+#define I3_IPC_MAGIC       "i3-ipc"
+#define I3_IPC_RUN_COMMAND 0
+
+static int i3_get(WmSetting setting, char *buf, size_t size) {
+    // i3 has no animations, and creates workspaces on demand
+    if (setting != WM_SETTING_FOCUS) return WM_UNSUPPORTED;
+
+    char *path = wm_user_config(I3_CONFIG_NAME, I3_TEMPLATE);
+    if (!path) return -1;
+
+    // Unset means i3's default, which follows the mouse
+    char value[32] = "yes";
+    wm_line_get(path, KEY_FOCUS, ' ', value, sizeof(value));
+    free(path);
+
+    snprintf(buf, size, "%s", strcmp(value, "no") == 0 ? "click" : "mouse");
+    return 0;
+}
+
+static int i3_set(WmSetting setting, const char *value) {
+    if (setting != WM_SETTING_FOCUS) return WM_UNSUPPORTED;
+
+    char *path = wm_user_config(I3_CONFIG_NAME, I3_TEMPLATE);
+    if (!path) return -1;
+
+    int result = wm_line_set(path, KEY_FOCUS, " ", strcmp(value, "mouse") == 0 ? "yes" : "no");
+    free(path);
+    return result;
+}
+
+// i3 publishes its IPC socket on the root window; $I3SOCK is the fallback
+static int socket_path(char *buf, size_t size) {
+    Display *dpy = XOpenDisplay(NULL);
+    if (dpy) {
+        Atom prop = XInternAtom(dpy, "I3_SOCKET_PATH", True);
+        Atom type;
+        int format;
+        unsigned long items, remaining;
+        unsigned char *data = NULL;
+
+        int found = prop != None &&
+                    XGetWindowProperty(dpy, DefaultRootWindow(dpy), prop, 0, 1024, False,
+                                       AnyPropertyType, &type, &format, &items,
+                                       &remaining, &data) == Success &&
+                    data && format == 8 && items > 0;
+        if (found) snprintf(buf, size, "%.*s", (int)items, (char *)data);
+        if (data) XFree(data);
+        XCloseDisplay(dpy);
+        if (found) return 0;
+    }
+
+    const char *env = getenv("I3SOCK");
+    if (!env || !*env) return -1;
+    snprintf(buf, size, "%s", env);
+    return 0;
+}
+
+// Send one RUN_COMMAND message and check the reply
+static int ipc_command(const char *command) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path(addr.sun_path, sizeof(addr.sun_path)) != 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // Header: magic, payload length, message type (native byte order)
+    char message[256];
+    uint32_t len = (uint32_t)strlen(command);
+    uint32_t type = I3_IPC_RUN_COMMAND;
+    size_t header = strlen(I3_IPC_MAGIC);
+    if (header + 8 + len > sizeof(message)) {
+        close(fd);
+        return -1;
+    }
+    memcpy(message, I3_IPC_MAGIC, header);
+    memcpy(message + header, &len, 4);
+    memcpy(message + header + 4, &type, 4);
+    memcpy(message + header + 8, command, len);
+
+    int ok = write(fd, message, header + 8 + len) == (ssize_t)(header + 8 + len);
+
+    // Reply: same header, then [{"success":true}]
+    char reply[512];
+    size_t got = 0;
+    while (ok && got < sizeof(reply) - 1) {
+        ssize_t n = read(fd, reply + got, sizeof(reply) - 1 - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+
+        uint32_t reply_len;
+        if (got >= header + 8) {
+            memcpy(&reply_len, reply + header, 4);
+            if (got >= header + 8 + reply_len) break;
+        }
+    }
+    reply[got] = '\0';
+    close(fd);
+
+    return ok && got > header + 8 && strstr(reply + header + 8, "\"success\":true") ? 0 : -1;
+}
+
+static int uses_config(pid_t pid) {
+    char cmdline[1024];
+    char *path = config_get_user_path(I3_CONFIG_NAME);
+    int uses = path && proc_read_cmdline(pid, cmdline, sizeof(cmdline)) == 0 &&
+               strstr(cmdline, path) != NULL;
+    free(path);
+    return uses;
+}
+
+static int i3_apply(pid_t pid, WmSetting setting, const char *value) {
+    (void)setting;
+    (void)value;
+
+    // reload re-reads the config file i3 was started with, in place
+    if (!uses_config(pid)) return WM_APPLIED_LATER;
+
+    if (ipc_command("reload") == 0) return WM_APPLIED_LIVE;
+    if (system("i3-msg reload > /dev/null 2>&1") == 0) return WM_APPLIED_LIVE;
+    return -1;
+}
+
+const WmBackend wm_i3 = {
+    "i3", "i3", i3_get, i3_set, i3_apply
+};
@@ -0,0 +1,76 @@
+// cli/src/backends/icewm.c
+#define _POSIX_C_SOURCE 200809L
+#include "wm.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The session copies the template here on first login
+#define ICEWM_PREFERENCES ".icewm/preferences"
+#define ICEWM_TEMPLATE    "icewm/preferences"
+
+#define KEY_FOCUS       "ClickToFocus"
+#define KEY_WORKSPACES  "WorkspaceCount"
+#define KEY_NAMES       "WorkspaceNames"
+
+static int icewm_get(WmSetting setting, char *buf, size_t size) {
+    if (setting == WM_SETTING_ANIMATIONS) return WM_UNSUPPORTED;
+
+    char *path = wm_home_config(ICEWM_PREFERENCES, ICEWM_TEMPLATE);
+    if (!path) return -1;
+
+    char value[128];
+    int result = wm_line_get(path, setting == WM_SETTING_FOCUS ? KEY_FOCUS : KEY_WORKSPACES,
+                             '=', value, sizeof(value));
+    free(path);
+    if (result != 0) return -1;
+
+    if (setting == WM_SETTING_FOCUS) {
+        snprintf(buf, size, "%s", atoi(value) ? "click" : "mouse");
+    } else {
+        snprintf(buf, size, "%s", value);
+    }
+    return 0;
+}
+
+static int icewm_set(WmSetting setting, const char *value) {
+    if (setting == WM_SETTING_ANIMATIONS) return WM_UNSUPPORTED;
+
+    char *path = wm_home_config(ICEWM_PREFERENCES, ICEWM_TEMPLATE);
+    if (!path) return -1;
+
+    int result;
+    if (setting == WM_SETTING_FOCUS) {
+        result = wm_line_set(path, KEY_FOCUS, "=", strcmp(value, "click") == 0 ? "1" : "0");
+    } else {
+        // IceWM derives the count from the names list
+        char names[WM_MAX_WORKSPACES * 8] = "";
+        int count = atoi(value);
+        for (int i = 1; i <= count; i++) {
+            size_t len = strlen(names);
+            snprintf(names + len, sizeof(names) - len, "%s\" %d \"", i > 1 ? ", " : "", i);
+        }
+        result = wm_line_set(path, KEY_WORKSPACES, "=", value);
+        if (result == 0) result = wm_line_set(path, KEY_NAMES, "=", names);
+    }
+
+    free(path);
+    return result;
+}
+
+static int icewm_apply(pid_t pid, WmSetting setting, const char *value) {
+    // The workspace count can change over EWMH without touching anything
+    // else; the file keeps it for the next start
+    if (setting == WM_SETTING_WORKSPACES && wm_request_desktops(atoi(value)) == 0) {
+        return WM_APPLIED_LIVE;
+    }
+
+    // IceWM has no reload: SIGHUP re-executes it in place, which keeps
+    // the X connection's windows but redraws frames and the taskbar
+    return kill(pid, SIGHUP) == 0 ? WM_APPLIED_LIVE : -1;
+}
+
+const WmBackend wm_icewm = {
+    "icewm", "icewm", icewm_get, icewm_set, icewm_apply
+};
@@ -0,0 +1,866 @@
+// cli/src/backends/icons.c
+#define _DEFAULT_SOURCE
+#include "icons.h"
+#include "../util/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_BASES   8
+#define MAX_THEMES  8
+#define MAX_DIRS    256
+#define MAX_SIZES   16
+#define PIXMAPS_DIR "/usr/share/pixmaps"
+#define DEFAULT_SIZES "16 22 24 32 48"
+
+#define CACHE_MAGIC "OPENDEIC"
+#define CACHE_VERSION 2
+
+typedef enum {
+    DIR_FIXED,
+    DIR_SCALABLE,
+    DIR_THRESHOLD
+} IconDirType;
+
+typedef struct {
+    char name[96];           // Relative to the theme, e.g. "48x48/apps"
+    IconDirType type;
+    int size, min, max, threshold;
+} IconDir;
+
+typedef struct {
+    char name[64];
+    IconDir *dirs;
+    int dir_count;
+    char inherits[256];
+} IconTheme;
+
+static const char *icon_exts[] = { "png", "svg", "xpm", NULL };
+
+static int base_dirs(char bases[][256], int max) {
+    int count = 0;
+    const char *home = getenv("HOME");
+    const char *data_home = getenv("XDG_DATA_HOME");
+
+    if (home) snprintf(bases[count++], 256, "%s/.icons", home);
+    if (data_home && *data_home) snprintf(bases[count++], 256, "%s/icons", data_home);
+    else if (home) snprintf(bases[count++], 256, "%s/.local/share/icons", home);
+
+    const char *env = getenv("XDG_DATA_DIRS");
+    char *dirs = strdup(env && *env ? env : "/usr/local/share:/usr/share");
+    char *save = NULL;
+    for (char *d = dirs ? strtok_r(dirs, ":", &save) : NULL; d && count < max;
+         d = strtok_r(NULL, ":", &save)) {
+        snprintf(bases[count++], 256, "%s/icons", d);
+    }
+    free(dirs);
+    return count;
+}
+
+char *icons_theme_name(void) {
+    const char *home = getenv("HOME");
+    if (!home) return strdup("hicolor");
+
+    static const struct {
+        const char *file;
+        const char *key;
+    } sources[] = {
+        { ".config/gtk-3.0/settings.ini", "gtk-icon-theme-name" },
+        { ".gtkrc-2.0", "gtk-icon-theme-name" },
+    };
+
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", home, sources[i].file);
+        char *text = config_read_file(path);
+        if (!text) continue;
+
+        char *p = strstr(text, sources[i].key);
+        if (p) {
+            p += strlen(sources[i].key);
+            p += strspn(p, " =\"");
+            size_t len = strcspn(p, "\"\n ");
+            if (len > 0) {
+                char *name = strndup(p, len);
+                free(text);
+                return name;
+            }
+        }
+        free(text);
+    }
+    return strdup("hicolor");
+}
+
+// Parse index.theme (found in any base dir) into a theme
+static int load_theme(const char *name, char bases[][256], int base_count, IconTheme *theme) {
+    char *text = NULL;
+    for (int b = 0; b < base_count && !text; b++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%.255s/%.200s/index.theme", bases[b], name);
+        text = config_read_file(path);
+    }
+    if (!text) return -1;
+
+    memset(theme, 0, sizeof(*theme));
+    snprintf(theme->name, sizeof(theme->name), "%.63s", name);
+    theme->dirs = calloc(MAX_DIRS, sizeof(IconDir));
+    if (!theme->dirs) {
+        free(text);
+        return -1;
+    }
+
+    IconDir *current = NULL;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        if (line[0] == '[') {
+            current = NULL;
+            char *close = strchr(line, ']');
+            if (!close || strcmp(line, "[Icon Theme]") == 0) continue;
+            *close = '\0';
+            for (int i = 0; i < theme->dir_count; i++) {
+                if (strcmp(theme->dirs[i].name, line + 1) == 0) current = &theme->dirs[i];
+            }
+            continue;
+        }
+
+        char *eq = strchr(line, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        const char *value = eq + 1;
+
+        if (!current && strcmp(line, "Directories") == 0) {
+            char *dsave = NULL;
+            char *list = strdup(value);
+            for (char *d = list ? strtok_r(list, ",", &dsave) : NULL; d && theme->dir_count < MAX_DIRS;
+                 d = strtok_r(NULL, ",", &dsave)) {
+                IconDir *dir = &theme->dirs[theme->dir_count++];
+                snprintf(dir->name, sizeof(dir->name), "%s", d);
+                dir->type = DIR_THRESHOLD;
+                dir->threshold = 2;
+            }
+            free(list);
+        } else if (!current && strcmp(line, "Inherits") == 0) {
+            snprintf(theme->inherits, sizeof(theme->inherits), "%s", value);
+        } else if (current && strcmp(line, "Size") == 0) {
+            current->size = atoi(value);
+        } else if (current && strcmp(line, "MinSize") == 0) {
+            current->min = atoi(value);
+        } else if (current && strcmp(line, "MaxSize") == 0) {
+            current->max = atoi(value);
+        } else if (current && strcmp(line, "Threshold") == 0) {
+            current->threshold = atoi(value);
+        } else if (current && strcmp(line, "Type") == 0) {
+            current->type = strcmp(value, "Fixed") == 0 ? DIR_FIXED :
+                            strcmp(value, "Scalable") == 0 ? DIR_SCALABLE : DIR_THRESHOLD;
+        }
+    }
+
+    // Defaults from the spec for keys that were left out
+    for (int i = 0; i < theme->dir_count; i++) {
+        IconDir *d = &theme->dirs[i];
+        if (!d->min) d->min = d->size;
+        if (!d->max) d->max = d->size;
+    }
+
+    free(text);
+    return 0;
+}
+
+static int dir_matches(const IconDir *d, int size) {
+    switch (d->type) {
+        case DIR_FIXED:    return d->size == size;
+        case DIR_SCALABLE: return d->min <= size && size <= d->max;
+        default:           return d->size - d->threshold <= size && size <= d->size + d->threshold;
+    }
+}
+
+static int dir_distance(const IconDir *d, int size) {
+    switch (d->type) {
+        case DIR_FIXED:
+            return abs(d->size - size);
+        case DIR_SCALABLE:
+            return size < d->min ? d->min - size : size > d->max ? size - d->max : 0;
+        default:
+            if (size < d->size - d->threshold) return d->min - size;
+            if (size > d->size + d->threshold) return size - d->max;
+            return 0;
+    }
+}
+
+static char *find_in_dir(char bases[][256], int base_count, const char *theme,
+                         const char *dir, const char *name) {
+    for (int b = 0; b < base_count; b++) {
+        for (int e = 0; icon_exts[e]; e++) {
+            char path[768];
+            snprintf(path, sizeof(path), "%s/%s/%s/%s.%s", bases[b], theme, dir, name, icon_exts[e]);
+            if (access(path, R_OK) == 0) return strdup(path);
+        }
+    }
+    return NULL;
+}
+
+// The spec's FindIconHelper for one theme
+static char *find_in_theme(char bases[][256], int base_count, const IconTheme *theme,
+                           const char *name, int size) {
+    for (int i = 0; i < theme->dir_count; i++) {
+        if (!dir_matches(&theme->dirs[i], size)) continue;
+        char *path = find_in_dir(bases, base_count, theme->name, theme->dirs[i].name, name);
+        if (path) return path;
+    }
+
+    char *best = NULL;
+    int best_distance = INT_MAX;
+    for (int i = 0; i < theme->dir_count; i++) {
+        int distance = dir_distance(&theme->dirs[i], size);
+        if (distance >= best_distance) continue;
+        char *path = find_in_dir(bases, base_count, theme->name, theme->dirs[i].name, name);
+        if (path) {
+            free(best);
+            best = path;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+// Theme chain: current theme, what it inherits (breadth first), hicolor
+static int load_chain(char bases[][256], int base_count, IconTheme *themes) {
+    char chain[MAX_THEMES][64];
+    int chain_count = 0, count = 0;
+    char *current = icons_theme_name();
+    snprintf(chain[chain_count++], sizeof(chain[0]), "%.63s", current);
+    free(current);
+
+    for (int t = 0; t < chain_count; t++) {
+        if (load_theme(chain[t], bases, base_count, &themes[count]) == 0) {
+            char *save = NULL;
+            for (char *p = strtok_r(themes[count].inherits, ",", &save); p && chain_count < MAX_THEMES - 1;
+                 p = strtok_r(NULL, ",", &save)) {
+                int seen = 0;
+                for (int i = 0; i < chain_count; i++) seen |= strcmp(chain[i], p) == 0;
+                if (!seen) snprintf(chain[chain_count++], sizeof(chain[0]), "%.63s", p);
+            }
+            count++;
+        }
+
+        // hicolor always comes last
+        if (t == chain_count - 1 && strcmp(chain[t], "hicolor") != 0) {
+            snprintf(chain[chain_count++], sizeof(chain[0]), "hicolor");
+        }
+    }
+    return count;
+}
+
+static void free_chain(IconTheme *themes, int count) {
+    for (int i = 0; i < count; i++) free(themes[i].dirs);
+}
+
+// Lookup without the cache: one access() per candidate file
+static char *lookup_uncached(const char *name, int size) {
+    char bases[MAX_BASES][256];
+    int base_count = base_dirs(bases, MAX_BASES);
+    IconTheme themes[MAX_THEMES];
+    int theme_count = load_chain(bases, base_count, themes);
+
+    char *result = NULL;
+    for (int t = 0; t < theme_count && !result; t++) {
+        result = find_in_theme(bases, base_count, &themes[t], name, size);
+    }
+    free_chain(themes, theme_count);
+
+    // Unthemed fallback
+    for (int e = 0; !result && icon_exts[e]; e++) {
+        char path[512];
+        snprintf(path, sizeof(path), PIXMAPS_DIR "/%s.%s", name, icon_exts[e]);
+        if (access(path, R_OK) == 0) result = strdup(path);
+    }
+    return result;
+}
+
+// ---- Cache ----
+//
+// Every icon name in the theme chain resolved at a fixed set of sizes, as
+// an open-addressing hash table that lookups read straight from the mmapped
+// file. Sections are 8-byte aligned; string offsets are relative to the
+// string section, whose offset 0 is "".
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t theme;          // String offsets
+    uint32_t key;
+    uint32_t stamp_count;
+    uint32_t stamps;         // File offsets of the sections
+    uint32_t size_count;
+    uint32_t sizes;
+    uint32_t bucket_count;   // Power of two
+    uint32_t buckets;        // Record index + 1, 0 if empty
+    uint32_t name_count;
+    uint32_t record_count;
+    uint32_t records;
+    uint32_t strings;
+    uint32_t strings_len;
+} CacheHeader;
+
+// Directory whose mtime must be unchanged for the cache to be valid
+typedef struct {
+    int64_t mtime;
+    uint32_t path;
+    uint32_t pad;
+} CacheStamp;
+
+typedef struct {
+    uint32_t name;
+    uint32_t size;
+    uint32_t path;
+} CacheRecord;
+
+static struct {
+    char *data;
+    size_t len;
+    int checked;
+    int rebuilt;
+} cache;
+
+char *icons_cache_path(void) {
+    const char *dir = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    char path[512];
+
+    if (dir && *dir) snprintf(path, sizeof(path), "%s/opende/icons.cache", dir);
+    else if (home) snprintf(path, sizeof(path), "%s/.cache/opende/icons.cache", home);
+    else return NULL;
+
+    return strdup(path);
+}
+
+static int64_t path_mtime(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    return (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+static uint32_t hash_key(const char *name, uint32_t size) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    return (h ^ size) * 16777619u;
+}
+
+// Search path the cache was built for; a different one means a rebuild
+static void cache_key(char *key, size_t len) {
+    char bases[MAX_BASES][256];
+    int base_count = base_dirs(bases, MAX_BASES);
+    size_t pos = 0;
+    key[0] = '\0';
+    for (int b = 0; b < base_count && pos < len; b++) {
+        pos += (size_t)snprintf(key + pos, len - pos, "%s%s", b ? ":" : "", bases[b]);
+    }
+}
+
+static int section_ok(size_t len, uint32_t offset, uint32_t count, size_t elem) {
+    return offset % 8 == 0 && offset <= len && (uint64_t)count * elem <= len - offset;
+}
+
+static const char *cache_string(const CacheHeader *h, uint32_t offset) {
+    return offset < h->strings_len ? (const char *)h + h->strings + offset : NULL;
+}
+
+static int cache_valid(const char *data, size_t len) {
+    const CacheHeader *h = (const CacheHeader *)data;
+    if (len < sizeof(*h) || memcmp(h->magic, CACHE_MAGIC, 8) != 0 || h->version != CACHE_VERSION) {
+        return 0;
+    }
+    if (!section_ok(len, h->stamps, h->stamp_count, sizeof(CacheStamp)) ||
+        !section_ok(len, h->sizes, h->size_count, sizeof(uint32_t)) ||
+        !section_ok(len, h->buckets, h->bucket_count, sizeof(uint32_t)) ||
+        !section_ok(len, h->records, h->record_count, sizeof(CacheRecord)) ||
+        !section_ok(len, h->strings, h->strings_len, 1) ||
+        h->strings_len == 0 || data[h->strings + h->strings_len - 1] != '\0' ||
+        h->bucket_count == 0 || (h->bucket_count & (h->bucket_count - 1)) != 0) {
+        return 0;
+    }
+
+    char key[MAX_BASES * 256];
+    cache_key(key, sizeof(key));
+    const char *stored = cache_string(h, h->key);
+    if (!stored || strcmp(stored, key) != 0) return 0;
+
+    const CacheStamp *stamps = (const CacheStamp *)(data + h->stamps);
+    for (uint32_t i = 0; i < h->stamp_count; i++) {
+        const char *path = cache_string(h, stamps[i].path);
+        if (!path || path_mtime(path) != stamps[i].mtime) return 0;
+    }
+    return 1;
+}
+
+static void cache_unmap(void) {
+    if (cache.data) munmap(cache.data, cache.len);
+    cache.data = NULL;
+    cache.len = 0;
+}
+
+// Map the cache file if it is still valid. Returns 0 if mapped.
+static int cache_map(void) {
+    cache_unmap();
+
+    char *path = icons_cache_path();
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    free(path);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            cache.data = data;
+            cache.len = (size_t)st.st_size;
+        }
+    }
+    close(fd);
+
+    if (cache.data && !cache_valid(cache.data, cache.len)) cache_unmap();
+    return cache.data ? 0 : -1;
+}
+
+void icons_cache_reset(void) {
+    cache_unmap();
+    cache.checked = 0;
+    cache.rebuilt = 0;
+}
+
+static int cache_has_size(const CacheHeader *h, int size) {
+    const uint32_t *sizes = (const uint32_t *)((const char *)h + h->sizes);
+    for (uint32_t i = 0; i < h->size_count; i++) {
+        if (sizes[i] == (uint32_t)size) return 1;
+    }
+    return 0;
+}
+
+// Returns the path, "" if the icon does not exist, NULL if not cached
+static const char *cache_find(const CacheHeader *h, const char *name, int size) {
+    if (!cache_has_size(h, size)) return NULL;
+
+    const char *data = (const char *)h;
+    const uint32_t *buckets = (const uint32_t *)(data + h->buckets);
+    const CacheRecord *records = (const CacheRecord *)(data + h->records);
+    uint32_t mask = h->bucket_count - 1;
+    uint32_t i = hash_key(name, (uint32_t)size) & mask;
+
+    for (uint32_t probes = 0; probes < h->bucket_count; probes++, i = (i + 1) & mask) {
+        uint32_t r = buckets[i];
+        if (r == 0 || r > h->record_count) break;
+        const CacheRecord *rec = &records[r - 1];
+        const char *rec_name = cache_string(h, rec->name);
+        if (rec->size == (uint32_t)size && rec_name && strcmp(rec_name, name) == 0) {
+            const char *path = cache_string(h, rec->path);
+            return path ? path : "";
+        }
+    }
+    return "";  // Every name in the theme chain is in the table
+}
+
+static int parse_sizes(const char *text, int *sizes, int max) {
+    int count = 0;
+    char *copy = strdup(text ? text : "");
+    char *save = NULL;
+    for (char *p = copy ? strtok_r(copy, " ,", &save) : NULL; p && count < max;
+         p = strtok_r(NULL, " ,", &save)) {
+        int size = atoi(p);
+        int seen = 0;
+        for (int i = 0; i < count; i++) seen |= sizes[i] == size;
+        if (size > 0 && size <= 1024 && !seen) sizes[count++] = size;
+    }
+    free(copy);
+    return count;
+}
+
+int icons_cache_sizes(int *sizes, int max) {
+    char *value = config_get_setting("icons.sizes");
+    int count = parse_sizes(value ? value : DEFAULT_SIZES, sizes, max);
+    free(value);
+    return count;
+}
+
+// ---- Cache build ----
+
+typedef struct {
+    char *name;
+    short theme;             // Index into the chain; theme_count for pixmaps
+    short dir;
+    short base;
+    short ext;
+} FoundIcon;
+
+typedef struct {
+    FoundIcon *items;
+    int count;
+    int capacity;
+} FoundList;
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t capacity;
+} Buffer;
+
+static int buffer_reserve(Buffer *b, size_t extra) {
+    if (b->len + extra <= b->capacity) return 0;
+    size_t grown = b->capacity ? b->capacity : 4096;
+    while (grown < b->len + extra) grown *= 2;
+    char *data = realloc(b->data, grown);
+    if (!data) return -1;
+    b->data = data;
+    b->capacity = grown;
+    return 0;
+}
+
+static uint32_t buffer_add_string(Buffer *b, const char *s) {
+    size_t len = strlen(s) + 1;
+    if (buffer_reserve(b, len) != 0) return 0;
+    uint32_t offset = (uint32_t)b->len;
+    memcpy(b->data + b->len, s, len);
+    b->len += len;
+    return offset;
+}
+
+static void buffer_align(Buffer *b) {
+    while (b->len % 8 && buffer_reserve(b, 1) == 0) b->data[b->len++] = '\0';
+}
+
+static uint32_t buffer_add(Buffer *b, const void *data, size_t len) {
+    buffer_align(b);
+    if (buffer_reserve(b, len) != 0) return 0;
+    uint32_t offset = (uint32_t)b->len;
+    if (len) memcpy(b->data + b->len, data, len);
+    b->len += len;
+    return offset;
+}
+
+static int ext_index(const char *filename, size_t *stem) {
+    const char *dot = strrchr(filename, '.');
+    if (!dot || dot == filename) return -1;
+    for (int e = 0; icon_exts[e]; e++) {
+        if (strcmp(dot + 1, icon_exts[e]) == 0) {
+            *stem = (size_t)(dot - filename);
+            return e;
+        }
+    }
+    return -1;
+}
+
+// One readdir per theme directory instead of a stat per candidate
+static void scan_icons(FoundList *list, const char *path, int theme, int dir, int base) {
+    DIR *dp = opendir(path);
+    if (!dp) return;
+
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        size_t stem;
+        int ext = ext_index(de->d_name, &stem);
+        if (ext < 0) continue;
+
+        if (list->count == list->capacity) {
+            int grown = list->capacity ? list->capacity * 2 : 4096;
+            FoundIcon *items = realloc(list->items, (size_t)grown * sizeof(FoundIcon));
+            if (!items) break;
+            list->items = items;
+            list->capacity = grown;
+        }
+        FoundIcon *f = &list->items[list->count];
+        f->name = strndup(de->d_name, stem);
+        if (!f->name) break;
+        f->theme = (short)theme;
+        f->dir = (short)dir;
+        f->base = (short)base;
+        f->ext = (short)ext;
+        list->count++;
+    }
+    closedir(dp);
+}
+
+static int by_name(const void *a, const void *b) {
+    return strcmp(((const FoundIcon *)a)->name, ((const FoundIcon *)b)->name);
+}
+
+// The lookup algorithm over the candidates for one name: per theme, the
+// first matching directory, else the closest one; then pixmaps
+static const FoundIcon *pick_icon(const FoundIcon *c, int n, const IconTheme *themes,
+                                  int theme_count, int size) {
+    for (int t = 0; t <= theme_count; t++) {
+        const FoundIcon *best = NULL;
+        long long best_key = LLONG_MAX;
+
+        for (int pass = 0; pass < 2 && !best; pass++) {
+            for (int i = 0; i < n; i++) {
+                if (c[i].theme != t) continue;
+                long long key = c[i].ext;
+                if (t < theme_count) {
+                    const IconDir *d = &themes[t].dirs[c[i].dir];
+                    if (pass == 0 && !dir_matches(d, size)) continue;
+                    long long distance = pass == 0 ? 0 : dir_distance(d, size);
+                    key = ((distance * MAX_DIRS + c[i].dir) * MAX_BASES + c[i].base) * 4 + c[i].ext;
+                }
+                if (key < best_key) {
+                    best_key = key;
+                    best = &c[i];
+                }
+            }
+        }
+        if (best) return best;
+    }
+    return NULL;
+}
+
+static void icon_path(const FoundIcon *f, char bases[][256], const IconTheme *themes,
+                      int theme_count, char *out, size_t len) {
+    if (f->theme == theme_count) {
+        snprintf(out, len, PIXMAPS_DIR "/%s.%s", f->name, icon_exts[f->ext]);
+    } else {
+        snprintf(out, len, "%s/%s/%s/%s.%s", bases[f->base], themes[f->theme].name,
+                 themes[f->theme].dirs[f->dir].name, f->name, icon_exts[f->ext]);
+    }
+}
+
+static void add_stamp(Buffer *stamps, Buffer *strings, const char *path) {
+    CacheStamp stamp = { path_mtime(path), buffer_add_string(strings, path), 0 };
+    if (buffer_reserve(stamps, sizeof(stamp)) != 0) return;
+    memcpy(stamps->data + stamps->len, &stamp, sizeof(stamp));
+    stamps->len += sizeof(stamp);
+}
+
+int icons_cache_update(const int *sizes, int size_count) {
+    int configured[MAX_SIZES];
+    if (size_count <= 0) {
+        size_count = icons_cache_sizes(configured, MAX_SIZES);
+        sizes = configured;
+    }
+    if (size_count > MAX_SIZES) size_count = MAX_SIZES;
+
+    char bases[MAX_BASES][256];
+    int base_count = base_dirs(bases, MAX_BASES);
+    IconTheme themes[MAX_THEMES];
+    int theme_count = load_chain(bases, base_count, themes);
+
+    Buffer strings = { 0 }, stamps = { 0 };
+    buffer_add_string(&strings, "");
+
+    // Theme directories (and the GTK settings naming the theme) are
+    // rewritten by package installs and theme changes. An icon added to an
+    // existing size directory only changes that directory's mtime, so
+    // every scanned directory is stamped, including ones that don't exist
+    // yet.
+    char path[1024];
+    FoundList found = { 0 };
+    for (int t = 0; t < theme_count; t++) {
+        for (int b = 0; b < base_count; b++) {
+            snprintf(path, sizeof(path), "%.255s/%.63s", bases[b], themes[t].name);
+            add_stamp(&stamps, &strings, path);
+            for (int d = 0; d < themes[t].dir_count; d++) {
+                snprintf(path, sizeof(path), "%.255s/%.63s/%.95s", bases[b], themes[t].name, themes[t].dirs[d].name);
+                add_stamp(&stamps, &strings, path);
+                scan_icons(&found, path, t, d, b);
+            }
+        }
+    }
+    add_stamp(&stamps, &strings, PIXMAPS_DIR);
+    scan_icons(&found, PIXMAPS_DIR, theme_count, 0, 0);
+
+    const char *home = getenv("HOME");
+    if (home) {
+        snprintf(path, sizeof(path), "%s/.config/gtk-3.0/settings.ini", home);
+        add_stamp(&stamps, &strings, path);
+        snprintf(path, sizeof(path), "%s/.gtkrc-2.0", home);
+        add_stamp(&stamps, &strings, path);
+    }
+
+    qsort(found.items, (size_t)found.count, sizeof(FoundIcon), by_name);
+
+    int names = 0;
+    for (int i = 0; i < found.count; i++) {
+        names += i == 0 || strcmp(found.items[i].name, found.items[i - 1].name) != 0;
+    }
+
+    uint32_t record_count = (uint32_t)names * (uint32_t)size_count;
+    uint32_t bucket_count = 64;
+    while (bucket_count < record_count * 2) bucket_count *= 2;
+    CacheRecord *records = calloc(record_count ? record_count : 1, sizeof(CacheRecord));
+    uint32_t *buckets = calloc(bucket_count, sizeof(uint32_t));
+    uint32_t record = 0;
+
+    for (int i = 0; records && buckets && i < found.count;) {
+        int n = 1;
+        while (i + n < found.count && strcmp(found.items[i + n].name, found.items[i].name) == 0) n++;
+
+        uint32_t name = buffer_add_string(&strings, found.items[i].name);
+        const FoundIcon *previous = NULL;
+        uint32_t previous_path = 0;
+        for (int s = 0; s < size_count; s++) {
+            const FoundIcon *f = pick_icon(&found.items[i], n, themes, theme_count, sizes[s]);
+            if (!f) continue;
+            if (f != previous) {
+                // Scalable icons resolve to the same file at every size
+                icon_path(f, bases, themes, theme_count, path, sizeof(path));
+                previous_path = buffer_add_string(&strings, path);
+                previous = f;
+            }
+
+            CacheRecord *rec = &records[record++];
+            rec->name = name;
+            rec->size = (uint32_t)sizes[s];
+            rec->path = previous_path;
+
+            uint32_t mask = bucket_count - 1;
+            uint32_t b = hash_key(found.items[i].name, rec->size) & mask;
+            while (buckets[b]) b = (b + 1) & mask;
+            buckets[b] = record;
+        }
+        i += n;
+    }
+
+    char key[MAX_BASES * 256];
+    cache_key(key, sizeof(key));
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, 8);
+    header.version = CACHE_VERSION;
+    header.theme = buffer_add_string(&strings, theme_count ? themes[0].name : "hicolor");
+    header.key = buffer_add_string(&strings, key);
+
+    uint32_t size_table[MAX_SIZES];
+    for (int s = 0; s < size_count; s++) size_table[s] = (uint32_t)sizes[s];
+
+    int result = -1;
+    Buffer out = { 0 };
+    if (records && buckets && buffer_add(&out, &header, sizeof(header)) == 0) {
+        header.stamp_count = (uint32_t)(stamps.len / sizeof(CacheStamp));
+        header.stamps = buffer_add(&out, stamps.data, stamps.len);
+        header.size_count = (uint32_t)size_count;
+        header.sizes = buffer_add(&out, size_table, (size_t)size_count * sizeof(uint32_t));
+        header.bucket_count = bucket_count;
+        header.buckets = buffer_add(&out, buckets, (size_t)bucket_count * sizeof(uint32_t));
+        header.name_count = (uint32_t)names;
+        header.record_count = record;
+        header.records = buffer_add(&out, records, (size_t)record * sizeof(CacheRecord));
+        header.strings = buffer_add(&out, strings.data, strings.len);
+        header.strings_len = (uint32_t)strings.len;
+
+        if (out.data && out.len >= sizeof(header)) {
+            memcpy(out.data, &header, sizeof(header));
+            char *cache_path = icons_cache_path();
+            if (cache_path && config_ensure_dir(cache_path) == 0 &&
+                config_write_data(cache_path, out.data, out.len) == 0) {
+                result = names;
+            }
+            free(cache_path);
+        }
+    }
+
+    for (int i = 0; i < found.count; i++) free(found.items[i].name);
+    free(found.items);
+    free(records);
+    free(buckets);
+    free(strings.data);
+    free(stamps.data);
+    free(out.data);
+    free_chain(themes, theme_count);
+
+    icons_cache_reset();
+    return result;
+}
+
+// Map the cache once per process; build it if missing or stale, and
+// rebuild once with the size added if a lookup asks for a new size
+static const CacheHeader *cache_open(int size) {
+    if (!cache.checked) {
+        cache.checked = 1;
+        cache_map();
+    }
+    if (cache.data && cache_has_size((const CacheHeader *)cache.data, size)) {
+        return (const CacheHeader *)cache.data;
+    }
+    if (cache.rebuilt) return cache.data ? (const CacheHeader *)cache.data : NULL;
+
+    int sizes[MAX_SIZES];
+    int count = 0;
+    if (cache.data) {
+        const CacheHeader *h = (const CacheHeader *)cache.data;
+        const uint32_t *stored = (const uint32_t *)(cache.data + h->sizes);
+        for (uint32_t i = 0; i < h->size_count && count < MAX_SIZES; i++) sizes[count++] = (int)stored[i];
+    } else {
+        count = icons_cache_sizes(sizes, MAX_SIZES);
+    }
+    if (count < MAX_SIZES && size > 0 && size <= 1024) {
+        int seen = 0;
+        for (int i = 0; i < count; i++) seen |= sizes[i] == size;
+        if (!seen) sizes[count++] = size;
+    }
+
+    icons_cache_update(sizes, count);
+    cache.checked = 1;
+    cache.rebuilt = 1;
+    cache_map();
+    return cache.data ? (const CacheHeader *)cache.data : NULL;
+}
+
+char *icons_lookup(const char *name, int size) {
+    if (!name || !*name) return NULL;
+    if (name[0] == '/') return access(name, R_OK) == 0 ? strdup(name) : NULL;
+
+    const CacheHeader *h = cache_open(size);
+    const char *cached = h ? cache_find(h, name, size) : NULL;
+    if (cached) return *cached ? strdup(cached) : NULL;
+
+    return lookup_uncached(name, size);
+}
+
+int icons_cache_info(IconCacheInfo *info) {
+    memset(info, 0, sizeof(*info));
+    icons_cache_reset();
+
+    char *path = icons_cache_path();
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    free(path);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    char *data = NULL;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(CacheHeader)) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+    }
+    close(fd);
+    if (!data) return -1;
+
+    const CacheHeader *h = (const CacheHeader *)data;
+    info->bytes = (long)st.st_size;
+    info->fresh = cache_valid(data, (size_t)st.st_size);
+    if (info->fresh) {
+        snprintf(info->theme, sizeof(info->theme), "%s", cache_string(h, h->theme));
+        info->names = (int)h->name_count;
+        info->records = (int)h->record_count;
+        const uint32_t *sizes = (const uint32_t *)(data + h->sizes);
+        for (uint32_t i = 0; i < h->size_count && info->size_count < MAX_SIZES; i++) {
+            info->sizes[info->size_count++] = (int)sizes[i];
+        }
+    }
+    munmap(data, (size_t)st.st_size);
+    return 0;
+}
+
+int icons_cache_clear(void) {
+    icons_cache_reset();
+    char *path = icons_cache_path();
+    int result = path && (unlink(path) == 0 || errno == ENOENT) ? 0 : -1;
+    free(path);
+    return result;
+}
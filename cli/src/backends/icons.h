@@ -0,0 +1,48 @@
+// cli/src/backends/icons.h
+#ifndef OPENDE_ICONS_BACKEND_H
+#define OPENDE_ICONS_BACKEND_H
+
+// Freedesktop icon theme lookup for the user's current theme, following
+// Inherits= down to hicolor and finally /usr/share/pixmaps. Lookups are
+// answered from ~/.cache/opende/icons.cache, a table of every icon name in
+// the theme chain resolved at a set of sizes, rebuilt when a theme
+// directory's mtime changes.
+
+typedef struct {
+    char theme[64];
+    int fresh;               // Theme directories unchanged since the build
+    int names;
+    int records;
+    int sizes[16];
+    int size_count;
+    long bytes;
+} IconCacheInfo;
+
+// Resolve an icon name (or absolute path) to a file for the given pixel size
+// Returns allocated path (caller must free) or NULL if not found
+char *icons_lookup(const char *name, int size);
+
+// Current icon theme from GTK settings, "hicolor" if unset
+// Returns allocated string (caller must free)
+char *icons_theme_name(void);
+
+// Path of the cache file (caller must free)
+char *icons_cache_path(void);
+
+// Sizes from the icons.sizes setting. Returns the count.
+int icons_cache_sizes(int *sizes, int max);
+
+// Rebuild the cache for the given sizes (configured sizes if count is 0)
+// Returns number of icon names, -1 on error
+int icons_cache_update(const int *sizes, int count);
+
+// Describe the cache file. Returns -1 if there is none.
+int icons_cache_info(IconCacheInfo *info);
+
+// Delete the cache file. Returns 0 on success, -1 on error
+int icons_cache_clear(void);
+
+// Drop this process's mapping so the next lookup revalidates the cache
+void icons_cache_reset(void);
+
+#endif
@@ -0,0 +1,184 @@
+// cli/src/backends/keyboard.c
+#define _POSIX_C_SOURCE 200809L
+#include "keyboard.h"
+#include "xkb_rules.h"
+#include "../util/config.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/XKBlib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RULES_NAMES_PROP "_XKB_RULES_NAMES"
+#define DEFAULT_RULES    "evdev"
+
+static int x_error;
+
+static int record_x_error(Display *dpy, XErrorEvent *ev) {
+    (void)dpy;
+    x_error = ev->error_code;
+    return 0;
+}
+
+// A connection with XKB, or NULL
+static Display *open_xkb(void) {
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) return NULL;
+
+    int opcode, event_base, error_base, major = XkbMajorVersion, minor = XkbMinorVersion;
+    if (!XkbQueryExtension(dpy, &opcode, &event_base, &error_base, &major, &minor)) {
+        XCloseDisplay(dpy);
+        return NULL;
+    }
+    return dpy;
+}
+
+int keyboard_get_repeat(int *delay_ms, int *rate) {
+    Display *dpy = open_xkb();
+    if (!dpy) return -1;
+
+    unsigned int delay, interval;
+    int ok = XkbGetAutoRepeatRate(dpy, XkbUseCoreKbd, &delay, &interval);
+    XCloseDisplay(dpy);
+    if (!ok) return -1;
+
+    *delay_ms = (int)delay;
+    *rate = interval > 0 ? (int)((1000 + interval / 2) / interval) : 0;
+    return 0;
+}
+
+int keyboard_set_repeat(int delay_ms, int rate) {
+    if (delay_ms <= 0 || rate <= 0) return -1;
+    Display *dpy = open_xkb();
+    if (!dpy) return -1;
+
+    int (*previous)(Display *, XErrorEvent *) = XSetErrorHandler(record_x_error);
+    x_error = 0;
+
+    // The rate is a per-key interval on the wire
+    unsigned int interval = (unsigned int)((1000 + rate / 2) / rate);
+    int ok = XkbSetAutoRepeatRate(dpy, XkbUseCoreKbd, (unsigned int)delay_ms, interval) &&
+             XkbChangeEnabledControls(dpy, XkbUseCoreKbd, XkbRepeatKeysMask, XkbRepeatKeysMask);
+    XSync(dpy, False);
+
+    XSetErrorHandler(previous);
+    XCloseDisplay(dpy);
+    return ok && !x_error ? 0 : -1;
+}
+
+// The property holds rules, model, layout, variant and options, each
+// NUL-terminated
+static int read_names(Display *dpy, KeyboardNames *out) {
+    memset(out, 0, sizeof(*out));
+    Atom prop = XInternAtom(dpy, RULES_NAMES_PROP, True);
+    if (prop == None) return -1;
+
+    Atom type;
+    int format;
+    unsigned long count, after;
+    unsigned char *data = NULL;
+    if (XGetWindowProperty(dpy, DefaultRootWindow(dpy), prop, 0, 1024, False, XA_STRING,
+                           &type, &format, &count, &after, &data) != Success || !data) return -1;
+    if (type != XA_STRING || format != 8) {
+        XFree(data);
+        return -1;
+    }
+
+    char *fields[] = { out->rules, out->model, out->layout, out->variant, out->options };
+    size_t sizes[] = { sizeof(out->rules), sizeof(out->model), sizeof(out->layout),
+                       sizeof(out->variant), sizeof(out->options) };
+    unsigned long pos = 0;
+    for (int i = 0; i < 5 && pos < count; i++) {
+        size_t len = strnlen((const char *)data + pos, count - pos);
+        snprintf(fields[i], sizes[i], "%.*s", (int)len, (const char *)data + pos);
+        pos += len + 1;
+    }
+    XFree(data);
+    return 0;
+}
+
+int keyboard_get_names(KeyboardNames *out) {
+    Display *dpy = open_xkb();
+    if (!dpy) return -1;
+    int result = read_names(dpy, out);
+    XCloseDisplay(dpy);
+    return result;
+}
+
+static void write_names(Display *dpy, const KeyboardNames *names) {
+    const char *fields[] = { names->rules, names->model, names->layout, names->variant, names->options };
+    char data[sizeof(KeyboardNames) + 5];
+    size_t len = 0;
+    for (int i = 0; i < 5; i++) {
+        size_t n = strlen(fields[i]);
+        memcpy(data + len, fields[i], n + 1);
+        len += n + 1;
+    }
+
+    Atom prop = XInternAtom(dpy, RULES_NAMES_PROP, False);
+    XChangeProperty(dpy, DefaultRootWindow(dpy), prop, XA_STRING, 8, PropModeReplace,
+                    (unsigned char *)data, (int)len);
+}
+
+static int resolve(const KeyboardNames *names, KeymapComponents *out) {
+    char *path = xkb_rules_path(names->rules[0] ? names->rules : DEFAULT_RULES);
+    char *text = path ? config_read_file(path) : NULL;
+    int result = text ? xkb_rules_resolve(text, names->model, names->layout, names->variant,
+                                          names->options, out) : -1;
+    free(text);
+    free(path);
+    return result;
+}
+
+int keyboard_set_names(const KeyboardNames *names) {
+    KeymapComponents components;
+    if (resolve(names, &components) != 0) return -1;
+
+    Display *dpy = open_xkb();
+    if (!dpy) return -1;
+
+    // The server builds the keymap from these components and pushes it to
+    // every client, as setxkbmap has it do; geometry is only needed for
+    // drawing keyboards and is not loaded
+    XkbComponentNamesRec request = {
+        .keymap = NULL,
+        .keycodes = components.keycodes,
+        .types = components.types,
+        .compat = components.compat,
+        .symbols = components.symbols,
+        .geometry = components.geometry,
+    };
+    XkbDescPtr xkb = XkbGetKeyboardByName(dpy, XkbUseCoreKbd, &request, XkbGBN_AllComponentsMask,
+                                          XkbGBN_AllComponentsMask & ~XkbGBN_GeometryMask, True);
+    if (!xkb) {
+        XCloseDisplay(dpy);
+        return -1;
+    }
+    XkbFreeKeyboard(xkb, XkbAllComponentsMask, True);
+
+    KeyboardNames recorded = *names;
+    if (!recorded.rules[0]) snprintf(recorded.rules, sizeof(recorded.rules), DEFAULT_RULES);
+    write_names(dpy, &recorded);
+    XSync(dpy, False);
+    XCloseDisplay(dpy);
+    return 0;
+}
+
+int keyboard_layout_exists(const char *layout) {
+    const char *dir = xkb_rules_data_dir();
+    if (!dir || !layout || !*layout) return 0;
+
+    for (const char *p = layout; ; ) {
+        size_t len = strcspn(p, ",");
+        if (len == 0 || strspn(p, "abcdefghijklmnopqrstuvwxyz0123456789_-") < len) return 0;
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/symbols/%.*s", dir, (int)len, p);
+        if (access(path, R_OK) != 0) return 0;
+
+        if (!p[len]) return 1;
+        p += len + 1;
+    }
+}
@@ -0,0 +1,36 @@
+// cli/src/backends/keyboard.h
+#ifndef OPENDE_KEYBOARD_H
+#define OPENDE_KEYBOARD_H
+
+// Keyboard repeat and layout, set through the XKB extension in-process
+// instead of forking xset and setxkbmap. The server forgets both when it
+// resets, so they are re-applied at login.
+
+#define KEYBOARD_NAME_MAX 256
+
+typedef struct {
+    char rules[64];          // "evdev"
+    char model[64];          // "pc105"
+    char layout[KEYBOARD_NAME_MAX];    // "us,de"
+    char variant[KEYBOARD_NAME_MAX];   // ",nodeadkeys"
+    char options[KEYBOARD_NAME_MAX];   // "grp:alt_shift_toggle,caps:escape"
+} KeyboardNames;
+
+// Auto-repeat delay and rate (keys per second) of the core keyboard.
+// Return 0 on success, -1 without a display or XKB
+int keyboard_get_repeat(int *delay_ms, int *rate);
+int keyboard_set_repeat(int delay_ms, int rate);
+
+// Names the current keymap was built from (the _XKB_RULES_NAMES root
+// property). Returns 0 on success, -1 if unavailable
+int keyboard_get_names(KeyboardNames *out);
+
+// Resolve the names with the rules file, have the server load the keymap
+// and record the names on the root window. Returns 0 on success, -1 if the
+// names don't resolve or the server can't build the keymap
+int keyboard_set_names(const KeyboardNames *names);
+
+// 1 if the XKB data has a symbols file for the layout, 0 otherwise
+int keyboard_layout_exists(const char *layout);
+
+#endif
@@ -0,0 +1,189 @@
+// cli/src/backends/lazy.c
+#define _DEFAULT_SOURCE
+#include "lazy.h"
+#include "units.h"
+#include "../util/config.h"
+#include "../util/desktop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#define DBUS_GENERATED_MARK "# Generated by opende session enable lazy"
+
+int lazy_enabled(void) {
+    return config_get_setting_bool(LAZY_SETTING, 0);
+}
+
+static int dbus_service_path(const SessionComponent *c, char *path, size_t size) {
+    const char *data_home = getenv("XDG_DATA_HOME");
+    const char *home = getenv("HOME");
+
+    // The user's directory is searched before the system ones, so this
+    // file wins over a distribution's activation file for the same name
+    if (data_home && *data_home) {
+        snprintf(path, size, "%s/dbus-1/services/%s.service", data_home, c->dbus_name);
+    } else if (home) {
+        snprintf(path, size, "%s/.local/share/dbus-1/services/%s.service", home, c->dbus_name);
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static int units_installed(void) {
+    char *dir = units_dir();
+    if (!dir) return 0;
+
+    char path[768];
+    snprintf(path, sizeof(path), "%s/" UNITS_TARGET, dir);
+    free(dir);
+    return config_file_exists(path);
+}
+
+static int write_dbus_service(const SessionComponent *c, const char *path) {
+    char *argv[16];
+    int argc = components_build_argv(c, argv, 16);
+    if (argc < 1) return -1;
+
+    // Exec= must be absolute for the bus daemon
+    char *exec = desktop_find_executable(argv[0]);
+    if (!exec) {
+        components_free_argv(argv);
+        return 0;  // Not installed; nothing to activate
+    }
+
+    char content[1024];
+    size_t len = (size_t)snprintf(content, sizeof(content),
+                                  DBUS_GENERATED_MARK "\n[D-BUS Service]\nName=%s\nExec=%s",
+                                  c->dbus_name, exec);
+    for (int i = 1; i < argc && len < sizeof(content); i++) {
+        len += (size_t)snprintf(content + len, sizeof(content) - len, " %s", argv[i]);
+    }
+    if (len < sizeof(content) && units_installed()) {
+        len += (size_t)snprintf(content + len, sizeof(content) - len,
+                                "\nSystemdService=opende-%s.service", c->name);
+    }
+    if (len < sizeof(content)) snprintf(content + len, sizeof(content) - len, "\n");
+
+    free(exec);
+    components_free_argv(argv);
+
+    if (config_ensure_dir(path) != 0) return -1;
+    return config_write_file(path, content);
+}
+
+int lazy_sync_dbus(int enable) {
+    int result = 0;
+
+    for (int i = 0; session_components[i].name; i++) {
+        const SessionComponent *c = &session_components[i];
+        if (c->activation != ACTIVATE_DBUS || !c->command || !c->dbus_name) continue;
+
+        char path[512];
+        if (dbus_service_path(c, path, sizeof(path)) != 0) return -1;
+
+        if (enable) {
+            if (write_dbus_service(c, path) != 0) result = -1;
+            continue;
+        }
+
+        // Only remove what we wrote
+        char *text = config_read_file(path);
+        if (text && strncmp(text, DBUS_GENERATED_MARK, strlen(DBUS_GENERATED_MARK)) == 0) {
+            unlink(path);
+        }
+        free(text);
+    }
+
+    return result;
+}
+
+static int read_sys_int(const char *path) {
+    char *text = config_read_file(path);
+    if (!text) return -1;
+    int value = atoi(text);
+    free(text);
+    return value;
+}
+
+static int bluetooth_adapter_present(void) {
+    DIR *dp = opendir("/sys/class/bluetooth");
+    if (!dp) return 0;
+
+    // hciN are adapters; hciN:M entries are connections
+    int found = 0;
+    struct dirent *de;
+    while ((de = readdir(dp)) && !found) {
+        found = strncmp(de->d_name, "hci", 3) == 0 && !strchr(de->d_name, ':');
+    }
+    closedir(dp);
+    return found;
+}
+
+// USB disks often report removable=0, so anything on a USB bus counts too
+static int disk_is_removable(const char *sys_path, const char *resolved) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/removable", sys_path);
+    return read_sys_int(path) == 1 || strstr(resolved, "/usb") != NULL;
+}
+
+static int removable_media_present(void) {
+    DIR *dp = opendir("/sys/block");
+    if (!dp) return 0;
+
+    int found = 0;
+    struct dirent *de;
+    while ((de = readdir(dp)) && !found) {
+        if (de->d_name[0] == '.' || strncmp(de->d_name, "loop", 4) == 0 ||
+            strncmp(de->d_name, "ram", 3) == 0 || strncmp(de->d_name, "zram", 4) == 0) {
+            continue;
+        }
+
+        char sys_path[300], link[512], size_path[320];
+        snprintf(sys_path, sizeof(sys_path), "/sys/block/%s", de->d_name);
+        ssize_t n = readlink(sys_path, link, sizeof(link) - 1);
+        link[n > 0 ? n : 0] = '\0';
+
+        // Empty card-reader slots and optical drives have size 0
+        snprintf(size_path, sizeof(size_path), "%s/size", sys_path);
+        found = disk_is_removable(sys_path, link) && read_sys_int(size_path) > 0;
+    }
+    closedir(dp);
+    return found;
+}
+
+int lazy_ready(const SessionComponent *component) {
+    switch (component->activation) {
+        case ACTIVATE_BLUETOOTH: return bluetooth_adapter_present();
+        case ACTIVATE_REMOVABLE: return removable_media_present();
+        case ACTIVATE_ALWAYS: return 1;
+        default: return 0;
+    }
+}
+
+int lazy_uevent_triggers(const SessionComponent *component, const UEvent *event) {
+    if (component->activation == ACTIVATE_BLUETOOTH) {
+        return strcmp(event->subsystem, "bluetooth") == 0 &&
+               strcmp(event->action, "add") == 0 && strcmp(event->devtype, "host") == 0;
+    }
+
+    if (component->activation != ACTIVATE_REMOVABLE || strcmp(event->subsystem, "block") != 0) {
+        return 0;
+    }
+
+    int added = strcmp(event->action, "add") == 0 &&
+                (strcmp(event->devtype, "disk") == 0 || strcmp(event->devtype, "partition") == 0);
+    int media = strcmp(event->action, "change") == 0 && event->disk_media_change;
+    if (!added && !media) return 0;
+
+    // A partition's removable attribute lives on its disk
+    char sys_path[300];
+    snprintf(sys_path, sizeof(sys_path), "/sys%s", event->devpath);
+    if (strcmp(event->devtype, "partition") == 0) {
+        char *slash = strrchr(sys_path, '/');
+        if (slash) *slash = '\0';
+    }
+    return disk_is_removable(sys_path, event->devpath);
+}
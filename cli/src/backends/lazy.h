@@ -0,0 +1,30 @@
+// cli/src/backends/lazy.h
+#ifndef OPENDE_LAZY_H
+#define OPENDE_LAZY_H
+
+#include "components.h"
+#include "../util/uevent.h"
+
+// Lazy start (opende session enable lazy): components are started by the
+// event that needs them instead of at login. See ComponentActivation.
+
+#define LAZY_SETTING "session.lazy"
+
+// Delay for ACTIVATE_DEFERRED components, in milliseconds
+#define LAZY_DEFER_MS 10000
+
+int lazy_enabled(void);
+
+// Install (enable) or remove session-bus activation files for the
+// ACTIVATE_DBUS components. With systemd units installed, activation goes
+// through the component's unit. Returns 0 on success, -1 on error.
+int lazy_sync_dbus(int enable);
+
+// Whether the component's trigger is already satisfied (adapter present,
+// removable media inserted), so it should start right away
+int lazy_ready(const SessionComponent *component);
+
+// Whether a hotplug event satisfies the component's trigger
+int lazy_uevent_triggers(const SessionComponent *component, const UEvent *event);
+
+#endif
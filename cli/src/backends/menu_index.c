@@ -0,0 +1,796 @@
+// cli/src/backends/menu_index.c
+#define _DEFAULT_SOURCE
+#include "menu_index.h"
+#include "frecency.h"
+#include "icons.h"
+#include "../util/config.h"
+#include "../util/desktop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define INDEX_MAGIC "OPENDEMI"
+#define INDEX_VERSION 1
+#define DEFAULT_ICON_SIZE 22         // jgmenu's default icon_size
+#define MAX_SUBDIR_DEPTH 3
+
+// Menu sections, in display order; an entry goes to the first of its
+// Categories= that appears here, else "Other"
+static const struct {
+    const char *category;
+    const char *label;
+    const char *icon;
+} sections[] = {
+    { "Utility",     "Accessories", "applications-accessories" },
+    { "Development", "Development", "applications-development" },
+    { "Education",   "Education",   "applications-science" },
+    { "Game",        "Games",       "applications-games" },
+    { "Graphics",    "Graphics",    "applications-graphics" },
+    { "Network",     "Internet",    "applications-internet" },
+    { "AudioVideo",  "Multimedia",  "applications-multimedia" },
+    { "Audio",       "Multimedia",  "applications-multimedia" },
+    { "Video",       "Multimedia",  "applications-multimedia" },
+    { "Office",      "Office",      "applications-office" },
+    { "Science",     "Science",     "applications-science" },
+    { "Settings",    "Settings",    "preferences-desktop" },
+    { "System",      "System",      "applications-system" },
+    { NULL,          "Other",       "applications-other" },
+};
+#define SECTION_COUNT ((int)(sizeof(sections) / sizeof(sections[0])))
+#define SECTION_OTHER (SECTION_COUNT - 1)
+
+char *menu_index_path(void) {
+    const char *cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    char path[512];
+
+    if (cache && *cache) snprintf(path, sizeof(path), "%s/opende/menu.db", cache);
+    else if (home) snprintf(path, sizeof(path), "%s/.cache/opende/menu.db", home);
+    else return NULL;
+
+    return strdup(path);
+}
+
+static int64_t path_mtime(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    return (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+static int icon_size(void) {
+    return config_get_setting_int("menu.icon_size", DEFAULT_ICON_SIZE);
+}
+
+// ---- Directories ----
+
+static void add_dir(MenuDir **dirs, int *count, int *cap, const char *path,
+                    const char *prefix, int root) {
+    if (*count == *cap) {
+        int grown = *cap ? *cap * 2 : 16;
+        MenuDir *d = realloc(*dirs, (size_t)grown * sizeof(MenuDir));
+        if (!d) return;
+        *dirs = d;
+        *cap = grown;
+    }
+
+    MenuDir *d = &(*dirs)[*count];
+    d->path = strdup(path);
+    d->prefix = strdup(prefix);
+    d->root = root;
+    d->mtime = path_mtime(path);
+    if (d->path && d->prefix) (*count)++;
+}
+
+// Subdirectories contribute ids like "kde4-konsole.desktop"
+static void add_tree(MenuDir **dirs, int *count, int *cap, const char *path,
+                     const char *prefix, int root, int depth) {
+    add_dir(dirs, count, cap, path, prefix, root);
+    if (depth >= MAX_SUBDIR_DEPTH) return;
+
+    DIR *dp = opendir(path);
+    if (!dp) return;
+
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (de->d_name[0] == '.' || de->d_type != DT_DIR) continue;
+        char sub[768], sub_prefix[512];
+        snprintf(sub, sizeof(sub), "%s/%s", path, de->d_name);
+        snprintf(sub_prefix, sizeof(sub_prefix), "%s%s-", prefix, de->d_name);
+        add_tree(dirs, count, cap, sub, sub_prefix, root, depth + 1);
+    }
+    closedir(dp);
+}
+
+// XDG applications dirs in precedence order, plus files whose change
+// means re-rendering (jgmenu's prepend/append, the GTK icon theme)
+static int collect_dirs(MenuDir **out) {
+    MenuDir *dirs = NULL;
+    int count = 0, cap = 0, root = 0;
+    char path[512];
+
+    const char *home = getenv("HOME");
+    const char *data_home = getenv("XDG_DATA_HOME");
+    if (data_home && *data_home) snprintf(path, sizeof(path), "%s/applications", data_home);
+    else snprintf(path, sizeof(path), "%s/.local/share/applications", home ? home : "");
+    add_tree(&dirs, &count, &cap, path, "", root++, 0);
+
+    const char *env = getenv("XDG_DATA_DIRS");
+    char *data_dirs = strdup(env && *env ? env : "/usr/local/share:/usr/share");
+    char *save = NULL;
+    for (char *d = data_dirs ? strtok_r(data_dirs, ":", &save) : NULL; d; d = strtok_r(NULL, ":", &save)) {
+        snprintf(path, sizeof(path), "%s/applications", d);
+        add_tree(&dirs, &count, &cap, path, "", root++, 0);
+    }
+    free(data_dirs);
+
+    static const char *tracked[] = {
+        ".config/jgmenu/prepend.csv",
+        ".config/jgmenu/append.csv",
+        ".config/gtk-3.0/settings.ini",
+        NULL
+    };
+    for (int i = 0; home && tracked[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", home, tracked[i]);
+        add_dir(&dirs, &count, &cap, path, "", -1);
+    }
+
+    // Launch history orders the entries
+    char *launches = frecency_path();
+    if (launches) add_dir(&dirs, &count, &cap, launches, "", -1);
+    free(launches);
+
+    *out = dirs;
+    return count;
+}
+
+static void free_dirs(MenuDir *dirs, int count) {
+    for (int i = 0; i < count; i++) {
+        free(dirs[i].path);
+        free(dirs[i].prefix);
+    }
+    free(dirs);
+}
+
+// ---- Entries ----
+
+static void free_entry(MenuEntry *e) {
+    free(e->id);
+    free(e->name);
+    free(e->exec);
+    free(e->icon);
+    memset(e, 0, sizeof(*e));
+}
+
+static MenuEntry *append_entry(MenuIndex *index) {
+    if (index->count == index->capacity) {
+        int grown = index->capacity ? index->capacity * 2 : 128;
+        MenuEntry *e = realloc(index->entries, (size_t)grown * sizeof(MenuEntry));
+        if (!e) return NULL;
+        index->entries = e;
+        index->capacity = grown;
+    }
+    MenuEntry *e = &index->entries[index->count++];
+    memset(e, 0, sizeof(*e));
+    return e;
+}
+
+static int section_for(const char *categories) {
+    char copy[256];
+    snprintf(copy, sizeof(copy), "%s", categories);
+
+    char *save = NULL;
+    for (char *c = strtok_r(copy, ";", &save); c; c = strtok_r(NULL, ";", &save)) {
+        for (int s = 0; s < SECTION_OTHER; s++) {
+            if (strcmp(sections[s].category, c) == 0) return s;
+        }
+    }
+    return SECTION_OTHER;
+}
+
+// Parse one .desktop file into e
+static void parse_entry(MenuEntry *e, const MenuDir *dir, const char *filename,
+                        int64_t mtime, int size) {
+    char path[1024], id[512];
+    snprintf(path, sizeof(path), "%s/%s", dir->path, filename);
+    snprintf(id, sizeof(id), "%s%s", dir->prefix, filename);
+
+    static DesktopEntry de;
+    int ok = desktop_entry_load(path, &de) == 0;
+
+    e->id = strdup(id);
+    e->mtime = mtime;
+    e->visible = ok && de.application && !de.hidden && !de.no_display && de.exec[0] &&
+                 desktop_entry_shown_in_current(&de) && desktop_entry_try_exec_ok(&de);
+
+    if (!e->visible) {
+        // Still indexed: a hidden entry masks the same id further down
+        e->name = strdup("");
+        e->exec = strdup("");
+        e->icon = strdup("");
+        return;
+    }
+
+    char exec[DESKTOP_FIELD_MAX + 16];
+    if (de.terminal) snprintf(exec, sizeof(exec), "^term(%s)", de.exec);
+    else snprintf(exec, sizeof(exec), "%s", de.exec);
+
+    char *icon = icons_lookup(de.icon, size);
+    e->name = strdup(de.name[0] ? de.name : id);
+    e->exec = strdup(exec);
+    e->icon = icon ? icon : strdup(de.icon);
+    e->category = section_for(de.categories);
+}
+
+static int is_desktop_file(const char *name) {
+    size_t len = strlen(name);
+    return len > 8 && strcmp(name + len - 8, ".desktop") == 0;
+}
+
+static int find_dir(const MenuDir *dirs, int count, const char *path) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(dirs[i].path, path) == 0) return i;
+    }
+    return -1;
+}
+
+static int find_entry(const MenuIndex *index, int dir, const char *id) {
+    for (int i = 0; i < index->count; i++) {
+        if (index->entries[i].dir == dir && index->entries[i].id &&
+            strcmp(index->entries[i].id, id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Move old entries of old_dir that are still current into next; parse
+// the rest of dir's files. Returns number of entries that changed.
+static int scan_dir(MenuIndex *old, int old_dir, MenuIndex *next, int dir, int size) {
+    int changed = 0;
+    const MenuDir *d = &next->dirs[dir];
+
+    DIR *dp = opendir(d->path);
+    if (dp) {
+        struct dirent *de;
+        while ((de = readdir(dp))) {
+            if (!is_desktop_file(de->d_name)) continue;
+
+            char path[1024], id[512];
+            snprintf(path, sizeof(path), "%s/%s", d->path, de->d_name);
+            snprintf(id, sizeof(id), "%s%s", d->prefix, de->d_name);
+            int64_t mtime = path_mtime(path);
+
+            int prev = old_dir >= 0 ? find_entry(old, old_dir, id) : -1;
+            MenuEntry *e = append_entry(next);
+            if (!e) break;
+
+            if (prev >= 0 && old->entries[prev].mtime == mtime) {
+                *e = old->entries[prev];
+                memset(&old->entries[prev], 0, sizeof(MenuEntry));
+                old->entries[prev].dir = -1;
+            } else {
+                parse_entry(e, d, de->d_name, mtime, size);
+                changed++;
+            }
+            e->dir = dir;
+        }
+        closedir(dp);
+    }
+
+    // Whatever is left of the old directory was deleted
+    for (int i = 0; old_dir >= 0 && i < old->count; i++) {
+        if (old->entries[i].dir == old_dir && old->entries[i].id) changed++;
+    }
+    return changed;
+}
+
+int menu_index_refresh(MenuIndex *index, int full) {
+    icons_cache_reset();  // Long-running watchers must see theme changes
+    int size = icon_size();
+    char *theme = icons_theme_name();
+    if (!index->theme || strcmp(index->theme, theme) != 0 || index->icon_size != size) {
+        full = 1;  // Every resolved icon may be wrong
+    }
+
+    MenuIndex next;
+    memset(&next, 0, sizeof(next));
+    next.dir_count = collect_dirs(&next.dirs);
+    next.theme = theme;
+    next.icon_size = size;
+
+    int changed = full || next.dir_count != index->dir_count;
+    for (int d = 0; d < next.dir_count; d++) {
+        int old_dir = find_dir(index->dirs, index->dir_count, next.dirs[d].path);
+        int same = old_dir >= 0 && index->dirs[old_dir].mtime == next.dirs[d].mtime;
+
+        if (next.dirs[d].root < 0) {
+            changed += !same;
+            continue;
+        }
+
+        if (same && !full) {
+            // Untouched directory: carry its entries over as they are
+            for (int i = 0; i < index->count; i++) {
+                if (index->entries[i].dir != old_dir || !index->entries[i].id) continue;
+                MenuEntry *e = append_entry(&next);
+                if (!e) break;
+                *e = index->entries[i];
+                e->dir = d;
+                memset(&index->entries[i], 0, sizeof(MenuEntry));
+                index->entries[i].dir = -1;
+            }
+            continue;
+        }
+
+        changed += scan_dir(index, full ? -1 : old_dir, &next, d, size);
+    }
+
+    menu_index_free(index);
+    *index = next;
+    return changed;
+}
+
+int menu_index_update_file(MenuIndex *index, int dir, const char *filename) {
+    if (dir < 0 || dir >= index->dir_count || !is_desktop_file(filename)) return 0;
+
+    MenuDir *d = &index->dirs[dir];
+    d->mtime = path_mtime(d->path);
+
+    char path[1024], id[512];
+    snprintf(path, sizeof(path), "%s/%s", d->path, filename);
+    snprintf(id, sizeof(id), "%s%s", d->prefix, filename);
+    int64_t mtime = path_mtime(path);
+
+    int prev = find_entry(index, dir, id);
+    if (prev >= 0 && index->entries[prev].mtime == mtime && mtime != 0) return 0;
+
+    if (prev >= 0) {
+        free_entry(&index->entries[prev]);
+        index->entries[prev] = index->entries[--index->count];
+    }
+
+    if (mtime != 0) {
+        MenuEntry *e = append_entry(index);
+        if (e) {
+            parse_entry(e, d, filename, mtime, index->icon_size);
+            e->dir = dir;
+        }
+    }
+    return 1;
+}
+
+const MenuEntry *menu_index_find(const MenuIndex *index, const char *id) {
+    const MenuEntry *found = NULL;
+    for (int i = 0; i < index->count; i++) {
+        const MenuEntry *e = &index->entries[i];
+        if (!e->id || strcmp(e->id, id) != 0) continue;
+        if (!found || index->dirs[e->dir].root < index->dirs[found->dir].root) found = e;
+    }
+    return found && found->visible ? found : NULL;
+}
+
+int menu_index_visible_count(const MenuIndex *index) {
+    int count = 0;
+    for (int i = 0; i < index->count; i++) count += index->entries[i].visible;
+    return count;
+}
+
+void menu_index_free(MenuIndex *index) {
+    for (int i = 0; i < index->count; i++) free_entry(&index->entries[i]);
+    free(index->entries);
+    free_dirs(index->dirs, index->dir_count);
+    free(index->theme);
+    free(index->csv);
+    memset(index, 0, sizeof(*index));
+}
+
+// ---- CSV ----
+
+static const MenuDir *sort_dirs;
+static const MenuEntry *sort_entries;
+static const double *sort_scores;
+
+// By id, then precedence, so the first of each id is the effective one
+static int by_id(const void *a, const void *b) {
+    const MenuEntry *ea = &sort_entries[*(const int *)a], *eb = &sort_entries[*(const int *)b];
+    int cmp = strcmp(ea->id, eb->id);
+    return cmp ? cmp : sort_dirs[ea->dir].root - sort_dirs[eb->dir].root;
+}
+
+// Within a section, frequently launched apps first, then by name
+static int by_section_name(const void *a, const void *b) {
+    int ia = *(const int *)a, ib = *(const int *)b;
+    const MenuEntry *ea = &sort_entries[ia], *eb = &sort_entries[ib];
+    if (ea->category != eb->category) return ea->category - eb->category;
+
+    double sa = sort_scores[ia] >= FRECENCY_MIN_SCORE ? sort_scores[ia] : 0;
+    double sb = sort_scores[ib] >= FRECENCY_MIN_SCORE ? sort_scores[ib] : 0;
+    if (sa != sb) return sa < sb ? 1 : -1;
+    return strcasecmp(ea->name, eb->name);
+}
+
+// jgmenu fields containing commas are wrapped in triple quotes
+static void put_field(FILE *fp, const char *field) {
+    if (strchr(field, ',')) fprintf(fp, "\"\"\"%s\"\"\"", field);
+    else fputs(field, fp);
+}
+
+static void put_file(FILE *fp, const MenuIndex *index, const char *suffix) {
+    for (int d = 0; d < index->dir_count; d++) {
+        size_t len = strlen(index->dirs[d].path), slen = strlen(suffix);
+        if (index->dirs[d].root >= 0 || len < slen ||
+            strcmp(index->dirs[d].path + len - slen, suffix) != 0) {
+            continue;
+        }
+        char *text = config_read_file(index->dirs[d].path);
+        if (text) {
+            fputs(text, fp);
+            if (*text && text[strlen(text) - 1] != '\n') fputc('\n', fp);
+        }
+        free(text);
+    }
+}
+
+// Sections with the same label (Audio, Video, AudioVideo) share a submenu
+static int section_label_index(int section) {
+    for (int s = 0; s < section; s++) {
+        if (strcmp(sections[s].label, sections[section].label) == 0) return s;
+    }
+    return section;
+}
+
+static char *render_csv(const MenuIndex *index, size_t *len) {
+    int *order = malloc((size_t)(index->count + 1) * sizeof(int));
+    if (!order) return NULL;
+
+    // Effective entries: first of each id by precedence, and visible
+    for (int i = 0; i < index->count; i++) order[i] = i;
+    sort_dirs = index->dirs;
+    sort_entries = index->entries;
+    qsort(order, (size_t)index->count, sizeof(int), by_id);
+
+    int shown = 0;
+    for (int i = 0; i < index->count; i++) {
+        const MenuEntry *e = &index->entries[order[i]];
+        if (i > 0 && strcmp(e->id, index->entries[order[i - 1]].id) == 0) continue;
+        if (e->visible) order[shown++] = order[i];
+    }
+
+    // Launching through opende counts the launch (terminal apps keep
+    // jgmenu's ^term() around the whole command) and the counts order
+    // entries within a section
+    int logged = config_get_setting_bool("menu.frecency", 1);
+    static FrecencyEntry launches[FRECENCY_MAX_ENTRIES];
+    int launch_count = logged ? frecency_load(launches, FRECENCY_MAX_ENTRIES) : 0;
+
+    // Section labels merge their categories before sorting by name
+    int *section = malloc((size_t)(shown + 1) * sizeof(int));
+    MenuEntry *view = malloc((size_t)(shown + 1) * sizeof(MenuEntry));
+    double *scores = malloc((size_t)(shown + 1) * sizeof(double));
+    if (!section || !view || !scores) {
+        free(order);
+        free(section);
+        free(view);
+        free(scores);
+        return NULL;
+    }
+    for (int i = 0; i < shown; i++) {
+        view[i] = index->entries[order[i]];
+        view[i].category = section_label_index(view[i].category);
+        scores[i] = frecency_score(launches, launch_count, view[i].id);
+        section[i] = i;
+    }
+    sort_entries = view;
+    sort_scores = scores;
+    qsort(section, (size_t)shown, sizeof(int), by_section_name);
+
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buf, &size);
+    if (fp) {
+        put_file(fp, index, "/prepend.csv");
+
+        for (int s = 0; s < SECTION_COUNT; s++) {
+            int used = 0;
+            for (int i = 0; i < shown && !used; i++) used = view[i].category == s;
+            if (!used) continue;
+
+            char *icon = icons_lookup(sections[s].icon, index->icon_size);
+            fprintf(fp, "%s,^checkout(opende-%s),%s\n", sections[s].label,
+                    sections[s].label, icon ? icon : sections[s].icon);
+            free(icon);
+        }
+
+        put_file(fp, index, "/append.csv");
+
+        int current = -1;
+        for (int i = 0; i < shown; i++) {
+            const MenuEntry *e = &view[section[i]];
+            if (e->category != current) {
+                current = e->category;
+                fprintf(fp, "\n^tag(opende-%s)\n", sections[current].label);
+            }
+            put_field(fp, e->name);
+            fputc(',', fp);
+            if (logged) {
+                char exec[600];
+                int term = strncmp(e->exec, "^term(", 6) == 0;
+                snprintf(exec, sizeof(exec), "%sopende menu launch %.400s%s", term ? "^term(" : "",
+                         e->id, term ? ")" : "");
+                put_field(fp, exec);
+            } else {
+                put_field(fp, e->exec);
+            }
+            fputc(',', fp);
+            put_field(fp, e->icon);
+            fputc('\n', fp);
+        }
+        fclose(fp);
+    }
+
+    free(order);
+    free(section);
+    free(view);
+    free(scores);
+    *len = buf ? size : 0;
+    return buf;
+}
+
+// ---- Serialization ----
+
+static void put_u32(FILE *fp, uint32_t v) {
+    fwrite(&v, sizeof(v), 1, fp);
+}
+
+static void put_i64(FILE *fp, int64_t v) {
+    fwrite(&v, sizeof(v), 1, fp);
+}
+
+static void put_str(FILE *fp, const char *s) {
+    uint32_t len = (uint32_t)strlen(s);
+    put_u32(fp, len);
+    fwrite(s, 1, len, fp);
+}
+
+typedef struct {
+    const char *data;
+    size_t len;
+    size_t pos;
+    int failed;
+} Reader;
+
+static uint32_t get_u32(Reader *r) {
+    uint32_t v = 0;
+    if (r->pos + sizeof(v) > r->len) {
+        r->failed = 1;
+        return 0;
+    }
+    memcpy(&v, r->data + r->pos, sizeof(v));
+    r->pos += sizeof(v);
+    return v;
+}
+
+static int64_t get_i64(Reader *r) {
+    int64_t v = 0;
+    if (r->pos + sizeof(v) > r->len) {
+        r->failed = 1;
+        return 0;
+    }
+    memcpy(&v, r->data + r->pos, sizeof(v));
+    r->pos += sizeof(v);
+    return v;
+}
+
+static char *get_str(Reader *r) {
+    uint32_t len = get_u32(r);
+    if (r->failed || r->pos + len > r->len) {
+        r->failed = 1;
+        return NULL;
+    }
+    char *s = malloc(len + 1);
+    if (!s) {
+        r->failed = 1;
+        return NULL;
+    }
+    memcpy(s, r->data + r->pos, len);
+    s[len] = '\0';
+    r->pos += len;
+    return s;
+}
+
+// Layout: magic, version, icon size, theme, csv offset and length, dirs,
+// entries, then the CSV itself
+int menu_index_save(MenuIndex *index) {
+    free(index->csv);
+    index->csv = render_csv(index, &index->csv_len);
+    if (!index->csv) return -1;
+
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buf, &size);
+    if (!fp) return -1;
+
+    fwrite(INDEX_MAGIC, 1, 8, fp);
+    put_u32(fp, INDEX_VERSION);
+    put_u32(fp, (uint32_t)index->icon_size);
+    put_str(fp, index->theme ? index->theme : "");
+    long offset_at = ftell(fp);
+    put_u32(fp, 0);
+    put_u32(fp, (uint32_t)index->csv_len);
+
+    put_u32(fp, (uint32_t)index->dir_count);
+    for (int d = 0; d < index->dir_count; d++) {
+        put_str(fp, index->dirs[d].path);
+        put_str(fp, index->dirs[d].prefix);
+        put_u32(fp, (uint32_t)index->dirs[d].root);
+        put_i64(fp, index->dirs[d].mtime);
+    }
+
+    put_u32(fp, (uint32_t)index->count);
+    for (int i = 0; i < index->count; i++) {
+        const MenuEntry *e = &index->entries[i];
+        put_u32(fp, (uint32_t)e->dir);
+        put_u32(fp, (uint32_t)e->category);
+        put_u32(fp, (uint32_t)e->visible);
+        put_i64(fp, e->mtime);
+        put_str(fp, e->id);
+        put_str(fp, e->name);
+        put_str(fp, e->exec);
+        put_str(fp, e->icon);
+    }
+
+    uint32_t csv_offset = (uint32_t)ftell(fp);
+    fwrite(index->csv, 1, index->csv_len, fp);
+    fclose(fp);
+    if (!buf) return -1;
+    memcpy(buf + offset_at, &csv_offset, sizeof(csv_offset));
+
+    char *path = menu_index_path();
+    int result = path && config_ensure_dir(path) == 0 ? config_write_data(path, buf, size) : -1;
+    free(path);
+    free(buf);
+    return result;
+}
+
+// One read of the whole file
+static char *read_index(size_t *len) {
+    char *path = menu_index_path();
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    free(path);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    char *data = NULL;
+    if (fstat(fd, &st) == 0 && st.st_size > 16) {
+        data = malloc((size_t)st.st_size);
+        size_t got = 0;
+        while (data && got < (size_t)st.st_size) {
+            ssize_t n = read(fd, data + got, (size_t)st.st_size - got);
+            if (n <= 0) break;
+            got += (size_t)n;
+        }
+        if (data && got != (size_t)st.st_size) {
+            free(data);
+            data = NULL;
+        }
+        *len = (size_t)st.st_size;
+    }
+    close(fd);
+    return data;
+}
+
+// Parse the header and directory table; reader is left at the entries
+static int parse_head(Reader *r, MenuIndex *index, uint32_t *csv_offset) {
+    if (r->len < 8 || memcmp(r->data, INDEX_MAGIC, 8) != 0) return -1;
+    r->pos = 8;
+    if (get_u32(r) != INDEX_VERSION) return -1;
+
+    index->icon_size = (int)get_u32(r);
+    index->theme = get_str(r);
+    *csv_offset = get_u32(r);
+    index->csv_len = get_u32(r);
+
+    uint32_t dir_count = get_u32(r);
+    if (r->failed || dir_count > 4096) return -1;
+    index->dirs = calloc(dir_count ? dir_count : 1, sizeof(MenuDir));
+    if (!index->dirs) return -1;
+
+    for (uint32_t d = 0; d < dir_count && !r->failed; d++) {
+        MenuDir *dir = &index->dirs[index->dir_count++];
+        dir->path = get_str(r);
+        dir->prefix = get_str(r);
+        dir->root = (int)get_u32(r);
+        dir->mtime = get_i64(r);
+    }
+
+    if (r->failed || (uint64_t)*csv_offset + index->csv_len > r->len) return -1;
+    return 0;
+}
+
+int menu_index_load(MenuIndex *index) {
+    memset(index, 0, sizeof(*index));
+
+    size_t len = 0;
+    char *data = read_index(&len);
+    if (!data) return -1;
+
+    Reader r = { data, len, 0, 0 };
+    uint32_t csv_offset;
+    if (parse_head(&r, index, &csv_offset) != 0) {
+        free(data);
+        menu_index_free(index);
+        return -1;
+    }
+
+    uint32_t count = get_u32(&r);
+    for (uint32_t i = 0; i < count && !r.failed; i++) {
+        MenuEntry *e = append_entry(index);
+        if (!e) break;
+        e->dir = (int)get_u32(&r);
+        e->category = (int)get_u32(&r);
+        e->visible = (int)get_u32(&r);
+        e->mtime = get_i64(&r);
+        e->id = get_str(&r);
+        e->name = get_str(&r);
+        e->exec = get_str(&r);
+        e->icon = get_str(&r);
+        if (e->dir < 0 || e->dir >= index->dir_count || e->category < 0 ||
+            e->category >= SECTION_COUNT) {
+            r.failed = 1;
+        }
+    }
+
+    if (!r.failed) {
+        index->csv = malloc(index->csv_len + 1);
+        if (index->csv) {
+            memcpy(index->csv, data + csv_offset, index->csv_len);
+            index->csv[index->csv_len] = '\0';
+        }
+    }
+
+    free(data);
+    if (r.failed || !index->csv) {
+        menu_index_free(index);
+        return -1;
+    }
+    return 0;
+}
+
+int menu_index_print_csv(void) {
+    size_t len = 0;
+    char *data = read_index(&len);
+
+    if (data) {
+        Reader r = { data, len, 0, 0 };
+        MenuIndex head;
+        memset(&head, 0, sizeof(head));
+        uint32_t csv_offset;
+
+        // Fresh if no directory or tracked file changed since the last save
+        int fresh = parse_head(&r, &head, &csv_offset) == 0;
+        for (int d = 0; fresh && d < head.dir_count; d++) {
+            fresh = path_mtime(head.dirs[d].path) == head.dirs[d].mtime;
+        }
+
+        if (fresh) {
+            fwrite(data + csv_offset, 1, head.csv_len, stdout);
+        }
+        menu_index_free(&head);
+        free(data);
+        if (fresh) return 0;
+    }
+
+    // Missing or stale: bring the index up to date, then print
+    MenuIndex index;
+    if (menu_index_load(&index) != 0) memset(&index, 0, sizeof(index));
+    menu_index_refresh(&index, 0);
+    int result = menu_index_save(&index);
+    if (index.csv) fwrite(index.csv, 1, index.csv_len, stdout);
+    menu_index_free(&index);
+    return result;
+}
@@ -0,0 +1,73 @@
+// cli/src/backends/menu_index.h
+#ifndef OPENDE_MENU_INDEX_H
+#define OPENDE_MENU_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// On-disk index of the applications menu: parsed .desktop entries with
+// categories and resolved icons, plus the jgmenu CSV rendered from them,
+// so opening the menu is one read of one file
+
+typedef struct {
+    char *path;              // Directory (or tracked file, see root)
+    char *prefix;            // Desktop file id prefix for subdirectories
+    int root;                // Precedence (0 wins); -1 for tracked files
+    int64_t mtime;           // Nanoseconds; 0 if missing
+} MenuDir;
+
+typedef struct {
+    char *id;                // Desktop file id, e.g. "org.gnome.Terminal.desktop"
+    char *name;
+    char *exec;              // Ready for jgmenu (terminal apps wrapped)
+    char *icon;              // Resolved path, or the bare name
+    int dir;                 // Index into dirs
+    int category;            // Index into the menu's category table
+    int visible;             // Hidden/NoDisplay/OnlyShowIn/TryExec allow it
+    int64_t mtime;
+} MenuEntry;
+
+typedef struct {
+    MenuDir *dirs;
+    int dir_count;
+    MenuEntry *entries;
+    int count;
+    int capacity;
+    char *theme;             // Icon theme and size the icons were resolved for
+    int icon_size;
+    char *csv;               // Rendered menu
+    size_t csv_len;
+} MenuIndex;
+
+// Path of the index file (caller must free)
+char *menu_index_path(void);
+
+// Load the index file. Returns 0, or -1 if missing or unreadable.
+int menu_index_load(MenuIndex *index);
+
+// Print the menu CSV with a single read of the index file, refreshing and
+// saving it first only if a watched directory changed since
+// Returns 0 on success, -1 on error
+int menu_index_print_csv(void);
+
+// Rescan changed directories (every directory if full), re-parsing only
+// .desktop files whose mtime changed. Returns number of entries changed.
+int menu_index_refresh(MenuIndex *index, int full);
+
+// Re-read one file in dirs[dir] after an inotify event
+// Returns 1 if the index changed, 0 if not
+int menu_index_update_file(MenuIndex *index, int dir, const char *filename);
+
+// Render the CSV and write the index atomically
+int menu_index_save(MenuIndex *index);
+
+void menu_index_free(MenuIndex *index);
+
+// Effective entry for a desktop id (highest precedence), NULL if it is
+// unknown or not shown
+const MenuEntry *menu_index_find(const MenuIndex *index, const char *id);
+
+// Number of entries that show up in the menu
+int menu_index_visible_count(const MenuIndex *index);
+
+#endif
@@ -0,0 +1,109 @@
+// cli/src/backends/openbox.c
+#define _POSIX_C_SOURCE 200809L
+#include "wm.h"
+#include "../util/config.h"
+#include "../util/proc.h"
+#include "../util/xml.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The session runs openbox on this copy once it exists (the template in
+// $OPENDE_DIR is usually not writable)
+#define OPENBOX_CONFIG_NAME "openbox-rc.xml"
+#define OPENBOX_TEMPLATE    "openbox/rc.xml"
+
+#define PATH_ANIMATE    "openbox_config/theme/animateIconify"
+#define PATH_FOLLOW     "openbox_config/focus/followMouse"
+#define PATH_DESKTOPS   "openbox_config/desktops/number"
+
+static const char *setting_path(WmSetting setting) {
+    switch (setting) {
+        case WM_SETTING_ANIMATIONS: return PATH_ANIMATE;
+        case WM_SETTING_FOCUS:      return PATH_FOLLOW;
+        case WM_SETTING_WORKSPACES: return PATH_DESKTOPS;
+    }
+    return NULL;
+}
+
+static int openbox_get(WmSetting setting, char *buf, size_t size) {
+    char *path = wm_user_config(OPENBOX_CONFIG_NAME, OPENBOX_TEMPLATE);
+    char *doc = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!doc) return -1;
+
+    char *text = xml_get_text(doc, setting_path(setting));
+    free(doc);
+    if (!text) return -1;
+
+    int yes = strcmp(text, "yes") == 0 || strcmp(text, "true") == 0;
+    switch (setting) {
+        case WM_SETTING_ANIMATIONS: snprintf(buf, size, "%s", yes ? "on" : "off"); break;
+        case WM_SETTING_FOCUS:      snprintf(buf, size, "%s", yes ? "mouse" : "click"); break;
+        case WM_SETTING_WORKSPACES: snprintf(buf, size, "%s", text); break;
+    }
+    free(text);
+    return 0;
+}
+
+typedef struct {
+    const char *path;
+    const char *text;
+} XmlEdit;
+
+// A copy seeded without a template starts out empty
+#define OPENBOX_EMPTY_CONFIG \
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" \
+    "<openbox_config xmlns=\"http://openbox.org/3.4/rc\">\n" \
+    "</openbox_config>\n"
+
+static char *edit_xml(const char *doc, void *data) {
+    const XmlEdit *edit = data;
+    if (!strstr(doc, "<openbox_config")) doc = OPENBOX_EMPTY_CONFIG;
+    return xml_set_text(doc, edit->path, edit->text);
+}
+
+static int openbox_set(WmSetting setting, const char *value) {
+    const char *text = value;
+    if (setting == WM_SETTING_ANIMATIONS) text = strcmp(value, "on") == 0 ? "yes" : "no";
+    if (setting == WM_SETTING_FOCUS) text = strcmp(value, "mouse") == 0 ? "yes" : "no";
+
+    char *path = wm_user_config(OPENBOX_CONFIG_NAME, OPENBOX_TEMPLATE);
+    if (!path) return -1;
+
+    XmlEdit edit = { setting_path(setting), text };
+    int result = config_update_file(path, edit_xml, &edit);
+    free(path);
+    return result;
+}
+
+// Reconfigure re-reads the file openbox was started with, which only
+// helps if that is our copy
+static int uses_config(pid_t pid) {
+    char cmdline[1024];
+    char *path = config_get_user_path(OPENBOX_CONFIG_NAME);
+    int uses = path && proc_read_cmdline(pid, cmdline, sizeof(cmdline)) == 0 &&
+               strstr(cmdline, path) != NULL;
+    free(path);
+    return uses;
+}
+
+static int openbox_apply(pid_t pid, WmSetting setting, const char *value) {
+    // Openbox only reads the desktop count at startup, but follows EWMH
+    // requests, and the file keeps the count for the next login
+    if (setting == WM_SETTING_WORKSPACES) {
+        return wm_request_desktops(atoi(value)) == 0 ? WM_APPLIED_LIVE : WM_APPLIED_LATER;
+    }
+
+    if (!uses_config(pid)) return WM_APPLIED_LATER;
+
+    // What `openbox --reconfigure` sends, without spawning it: _OB_CONTROL
+    // with 1 re-reads rc.xml in place, keeping every window mapped
+    if (wm_send_root_message("_OB_CONTROL", 1) == 0) return WM_APPLIED_LIVE;
+    if (system("openbox --reconfigure > /dev/null 2>&1") == 0) return WM_APPLIED_LIVE;
+    return -1;
+}
+
+const WmBackend wm_openbox = {
+    "openbox", "openbox", openbox_get, openbox_set, openbox_apply
+};
@@ -3,22 +3,101 @@
 #define _POSIX_C_SOURCE 200809L
 #include "picom.h"
 #include "../util/config.h"
+#include "../util/liveness.h"
 #include "../util/output.h"
+#include "../util/proc.h"
+#include "components.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
+#include <poll.h>
 #include <sys/types.h>
 
 #define PICOM_CONFIG_NAME "picom.conf"
+#define PICOM_SYSTEM_CONFIG "/usr/local/share/opende/config/picom.conf"
+#define PICOM_SELECTION "_NET_WM_CM_S"
+#define PICOM_KEY_UNREDIR_OWNED "effects.unredir-owned"
+#define PICOM_OVERRIDES_NAME "picom.overrides"
+#define PICOM_OVERLAY_NAME "picom-overlay.conf"
 
 int picom_is_installed(void) {
     return system("which picom > /dev/null 2>&1") == 0;
 }
 
+// The running compositor owns _NET_WM_CM_S<screen> on its display, so
+// asking the X server is both cheaper than scanning processes and scoped to
+// this $DISPLAY when several sessions share a machine
+pid_t picom_get_pid(void) {
+    pid_t pid = liveness_selection_owner_pid(PICOM_SELECTION);
+    if (pid > 0) return pid;
+
+    // No display, or the owner doesn't advertise _NET_WM_PID
+    if (components_find_pids(components_find("picom"), &pid, 1) == 1) return pid;
+    return 0;
+}
+
 int picom_is_running(void) {
-    return system("pgrep -x picom > /dev/null 2>&1") == 0;
+    int owned = liveness_selection_owned(PICOM_SELECTION);
+    if (owned >= 0) return owned;
+    return picom_get_pid() > 0;
+}
+
+// The config the user edits, without any runtime overrides
+static char *base_config_path(void) {
+    // Try user config first, fall back to system
+    char *user_config = config_get_user_path(PICOM_CONFIG_NAME);
+    if (user_config && config_file_exists(user_config)) {
+        return user_config;
+    }
+    free(user_config);
+
+    // Use OpenDE system config
+    return strdup(PICOM_SYSTEM_CONFIG);
+}
+
+// Active overrides, or -1 if none: "pid <owner>" followed by one
+// "key = value" line each. Overrides whose owner died are ignored, so a
+// crashed governor leaves picom on the user's config at its next start.
+typedef struct {
+    PicomOverride items[PICOM_MAX_OVERRIDES];
+    char keys[PICOM_MAX_OVERRIDES][32];
+    char values[PICOM_MAX_OVERRIDES][32];
+} OverrideSet;
+
+static int read_overrides(OverrideSet *set) {
+    char *path = config_get_runtime_path(PICOM_OVERRIDES_NAME);
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return -1;
+
+    long pid = 0;
+    int count = -1;
+    char *save = NULL;
+    char *line = strtok_r(text, "\n", &save);
+    if (line && sscanf(line, "pid %ld", &pid) == 1 && pid > 0 && kill((pid_t)pid, 0) == 0) {
+        count = 0;
+        while ((line = strtok_r(NULL, "\n", &save)) && count < PICOM_MAX_OVERRIDES) {
+            if (sscanf(line, "%31s = %31s", set->keys[count], set->values[count]) != 2) continue;
+            set->items[count].key = set->keys[count];
+            set->items[count].value = set->values[count];
+            count++;
+        }
+    }
+
+    free(text);
+    return count;
+}
+
+char *picom_config_path(void) {
+    OverrideSet set;
+    if (read_overrides(&set) >= 0) {
+        char *overlay = config_get_runtime_path(PICOM_OVERLAY_NAME);
+        if (overlay && config_file_exists(overlay)) return overlay;
+        free(overlay);
+    }
+    return base_config_path();
 }
 
 int picom_start(void) {
@@ -26,208 +105,812 @@ int picom_start(void) {
         return 0;  // Already running
     }
 
+    // Under the session supervisor it must be the one to start picom, or
+    // the new instance isn't restarted if it crashes
+    int managed = components_control(components_find("picom"), 1);
+    if (managed <= 0) return managed;
+
     if (!picom_is_installed()) {
         print_error("picom is not installed");
-        printf("Install with: sudo apt install picom\n");
+        print_line("Install with: sudo apt install picom");
         return -1;
     }
 
-    // Try user config first, fall back to system
-    char *user_config = config_get_user_path(PICOM_CONFIG_NAME);
-    const char *config_path = NULL;
-
-    if (user_config && config_file_exists(user_config)) {
-        config_path = user_config;
-    } else {
-        // Use OpenDE system config
-        config_path = "/usr/local/share/opende/config/picom.conf";
-    }
+    char *config_path = picom_config_path();
+    if (!config_path) return -1;
 
     char cmd[512];
     snprintf(cmd, sizeof(cmd), "picom -b --config '%s'", config_path);
 
     int result = system(cmd);
-    free(user_config);
+    free(config_path);
 
     return result == 0 ? 0 : -1;
 }
 
 int picom_stop(void) {
-    if (!picom_is_running()) {
+    pid_t pid = picom_get_pid();
+    if (pid <= 0) {
         return 0;  // Already stopped
     }
-    return system("pkill -x picom") == 0 ? 0 : -1;
+
+    // Tell the supervisor first, or it restarts picom as if it crashed
+    int managed = components_control(components_find("picom"), 0);
+    if (managed < 0) return -1;
+    if (managed == 1 && kill(pid, SIGTERM) != 0) return -1;
+
+    // Wait for picom to exit so a following start doesn't see it running
+    int fd = liveness_pidfd_open(pid);
+    if (fd >= 0) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        poll(&pfd, 1, 1000);
+        close(fd);
+    } else {
+        usleep(100000);  // 100ms
+    }
+    return 0;
+}
+
+// SIGUSR1 re-reads the file picom was started with, which only helps if
+// that is the config we edit (the session may have used the system one)
+static int uses_config(pid_t pid, const char *config) {
+    char cmdline[1024];
+    if (!config || proc_read_cmdline(pid, cmdline, sizeof(cmdline)) != 0) return 0;
+    return strstr(cmdline, config) != NULL;
 }
 
 int picom_reload(void) {
-    // picom doesn't have a reload signal, so restart
+    // SIGUSR1 makes picom reset its session and re-read the config file,
+    // which is much cheaper than tearing down and redirecting every window
+    pid_t pid = picom_get_pid();
+    char *config = picom_config_path();
+    int live = pid > 0 && uses_config(pid, config);
+    free(config);
+
+    if (live && kill(pid, SIGUSR1) == 0) {
+        return 0;
+    }
+
+    // Fall back to a full restart
     picom_stop();
-    usleep(100000);  // 100ms
     return picom_start();
 }
 
 // Config file helpers
 static char *get_config_path(void) {
     char *user_config = config_get_user_path(PICOM_CONFIG_NAME);
-    if (user_config && config_file_exists(user_config)) {
+    if (!user_config || config_file_exists(user_config)) {
         return user_config;
     }
-    free(user_config);
-
-    // Create user config from system template
-    user_config = config_get_user_path(PICOM_CONFIG_NAME);
-    if (!user_config) return NULL;
 
     if (config_ensure_dir(user_config) != 0) {
         free(user_config);
         return NULL;
     }
 
-    // Copy system config to user location
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "cp /usr/local/share/opende/config/picom.conf '%s' 2>/dev/null",
-             user_config);
-    if (system(cmd) != 0) {
-        // File may not exist yet, that's okay
+    // Create user config from system template (it may not exist yet,
+    // in which case edits start from an empty file)
+    char *text = config_read_file(PICOM_SYSTEM_CONFIG);
+    if (text) {
+        config_create_file(user_config, text);
+        free(text);
     }
-
     return user_config;
 }
 
-int picom_get_shadows(void) {
-    char *config = get_config_path();
-    if (!config) return -1;
+// Forward declarations for the libconfig text helpers below
+static int find_option(const char *text, const char *key,
+                       size_t *start, size_t *value, size_t *end);
+static char *set_option(const char *text, const char *key, const char *value);
+
+// Write the runtime overlay: the user's config with the overrides applied
+static int write_overlay(const PicomOverride *overrides, int count) {
+    char *base = base_config_path();
+    char *text = base ? config_read_file(base) : NULL;
+    free(base);
+
+    char *out = strdup(text ? text : "");
+    free(text);
+    for (int i = 0; i < count && out; i++) {
+        char *next = set_option(out, overrides[i].key, overrides[i].value);
+        free(out);
+        out = next;
+    }
+    if (!out) return -1;
 
-    // Check if shadow = true/false in config
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd), "grep -E '^shadow\\s*=' '%s' 2>/dev/null", config);
+    char *path = config_get_runtime_path(PICOM_OVERLAY_NAME);
+    int result = path ? config_write_file(path, out) : -1;
+    free(path);
+    free(out);
+    return result;
+}
 
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        free(config);
-        return -1;
-    }
+// The user's config changed; carry the change into the overlay
+static void refresh_overlay(void) {
+    OverrideSet set;
+    int count = read_overrides(&set);
+    if (count >= 0) write_overlay(set.items, count);
+}
 
-    char line[256];
-    int result = -1;
-    if (fgets(line, sizeof(line), fp)) {
-        result = (strstr(line, "true") != NULL) ? 1 : 0;
+int picom_set_overrides(const PicomOverride *overrides, int count) {
+    char *path = config_get_runtime_path(PICOM_OVERRIDES_NAME);
+    if (!path) return -1;
+
+    int result = 0;
+    if (count <= 0) {
+        unlink(path);
+        char *overlay = config_get_runtime_path(PICOM_OVERLAY_NAME);
+        if (overlay) unlink(overlay);
+        free(overlay);
+    } else if (count > PICOM_MAX_OVERRIDES || write_overlay(overrides, count) != 0) {
+        result = -1;
+    } else {
+        char content[PICOM_MAX_OVERRIDES * 72 + 32];
+        size_t len = (size_t)snprintf(content, sizeof(content), "pid %ld\n", (long)getpid());
+        for (int i = 0; i < count && len < sizeof(content); i++) {
+            len += (size_t)snprintf(content + len, sizeof(content) - len, "%.31s = %.31s\n",
+                                    overrides[i].key, overrides[i].value);
+        }
+        result = config_write_file(path, content);
     }
+    free(path);
 
-    pclose(fp);
+    // Running on the overlay: SIGUSR1 re-reads it. Switching between the
+    // overlay and the user's config restarts picom with the other file.
+    if (result == 0 && picom_is_running()) result = picom_reload();
+    return result;
+}
+
+// Raw value of `key = value;` in the user config, or NULL
+static char *read_option(const char *key) {
+    char *config = get_config_path();
+    char *text = config ? config_read_file(config) : NULL;
     free(config);
+    if (!text) return NULL;
+
+    size_t start, value, end;
+    char *result = NULL;
+    if (find_option(text, key, &start, &value, &end) == 0) {
+        const char *v = text + value;
+        while (*v == ' ' || *v == '\t') v++;
+        size_t len = strcspn(v, ";\n");
+        while (len > 0 && (v[len - 1] == ' ' || v[len - 1] == '\t')) len--;
+        result = strndup(v, len);
+    }
+
+    free(text);
     return result;
 }
 
-int picom_set_shadows(int enabled) {
+typedef struct {
+    const char *key;
+    const char *value;
+} OptionEdit;
+
+static char *edit_option(const char *text, void *data) {
+    const OptionEdit *edit = data;
+    return set_option(text, edit->key, edit->value);
+}
+
+// Set one option and reload picom. Concurrent `opende effects` runs each
+// edit the file they read and compare-and-swap it in, so none is lost.
+static int write_option(const char *key, const char *value) {
     char *config = get_config_path();
     if (!config) return -1;
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "sed -i 's/^shadow\\s*=.*/shadow = %s/' '%s'",
-             enabled ? "true" : "false", config);
-
-    int result = system(cmd);
+    OptionEdit edit = { key, value };
+    int result = config_update_file(config, edit_option, &edit);
     free(config);
 
+    if (result == 0) refresh_overlay();
     if (result == 0 && picom_is_running()) {
         picom_reload();
     }
+    return result;
+}
 
-    return result == 0 ? 0 : -1;
+static int read_bool_option(const char *key) {
+    char *value = read_option(key);
+    if (!value) return -1;
+
+    int result = strcmp(value, "true") == 0 ? 1 : 0;
+    free(value);
+    return result;
+}
+
+int picom_get_shadows(void) {
+    return read_bool_option("shadow");
+}
+
+int picom_set_shadows(int enabled) {
+    return write_option("shadow", enabled ? "true" : "false");
 }
 
 int picom_get_animations(void) {
-    char *config = get_config_path();
-    if (!config) return -1;
+    return read_bool_option("fading");
+}
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd), "grep -E '^fading\\s*=' '%s' 2>/dev/null", config);
+int picom_set_animations(int enabled) {
+    return write_option("fading", enabled ? "true" : "false");
+}
 
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        free(config);
-        return -1;
+int picom_get_transparency(void) {
+    char *value = read_option("inactive-opacity");
+    if (!value) return -1;
+
+    char *end;
+    double opacity = strtod(value, &end);
+    int result = end != value ? (int)(opacity * 100 + 0.5) : -1;
+    free(value);
+    return result;
+}
+
+int picom_set_transparency(int percent) {
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+
+    char value[16];
+    snprintf(value, sizeof(value), "%.2f", percent / 100.0);
+    return write_option("inactive-opacity", value);
+}
+
+// --- Rule arrays ---------------------------------------------------------
+//
+// picom.conf is libconfig: `key = value;` where arrays look like
+//   shadow-exclude = [ "class_g = 'mpv'", "name = 'Notification'" ];
+// These helpers edit the file text in place so comments and unrelated
+// options survive untouched.
+
+static const char *rule_array_keys[] = {
+    [PICOM_RULE_NO_SHADOW]  = "shadow-exclude",
+    [PICOM_RULE_NO_FADE]    = "fade-exclude",
+    [PICOM_RULE_OPACITY]    = "opacity-rule",
+    [PICOM_RULE_UNREDIRECT] = "unredir-if-possible-exclude",
+};
+
+static const char *rule_type_names[] = {
+    [PICOM_RULE_NO_SHADOW]  = "no-shadow",
+    [PICOM_RULE_NO_FADE]    = "no-fade",
+    [PICOM_RULE_OPACITY]    = "opacity",
+    [PICOM_RULE_UNREDIRECT] = "unredirect",
+};
+
+#define RULE_TYPE_COUNT 4
+
+const char *picom_rule_type_name(PicomRuleType type) {
+    return rule_type_names[type];
+}
+
+int picom_rule_type_parse(const char *name, PicomRuleType *type) {
+    for (int i = 0; i < RULE_TYPE_COUNT; i++) {
+        if (strcmp(name, rule_type_names[i]) == 0) {
+            *type = (PicomRuleType)i;
+            return 0;
+        }
     }
+    return -1;
+}
+
+// Find `key = ...;` at the start of a line. Sets [*start, *end) to the whole
+// statement including its trailing newline, and *value to the text after '='.
+static int find_option(const char *text, const char *key,
+                       size_t *start, size_t *value, size_t *end) {
+    size_t klen = strlen(key);
+    const char *line = text;
+
+    while (*line) {
+        const char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+
+        if (strncmp(p, key, klen) == 0) {
+            const char *q = p + klen;
+            while (*q == ' ' || *q == '\t') q++;
+            if (*q == '=' || *q == ':') {
+                q++;
+                *start = (size_t)(line - text);
+                *value = (size_t)(q - text);
+
+                // Scan to the terminating ';', skipping quoted strings
+                int in_str = 0;
+                while (*q && (in_str || *q != ';')) {
+                    if (in_str && *q == '\\' && q[1]) q++;
+                    else if (*q == '"') in_str = !in_str;
+                    q++;
+                }
+                if (*q == ';') q++;
+                while (*q == ' ' || *q == '\t') q++;
+                if (*q == '\n') q++;
+                *end = (size_t)(q - text);
+                return 0;
+            }
+        }
 
-    char line[256];
-    int result = -1;
-    if (fgets(line, sizeof(line), fp)) {
-        result = (strstr(line, "true") != NULL) ? 1 : 0;
+        const char *nl = strchr(line, '\n');
+        if (!nl) break;
+        line = nl + 1;
     }
+    return -1;
+}
 
-    pclose(fp);
-    free(config);
-    return result;
+// Replace (or append) `key = value;`. Returns newly allocated text.
+static char *set_option(const char *text, const char *key, const char *value) {
+    size_t start, val, end;
+    size_t tlen = strlen(text);
+    size_t len = tlen + strlen(key) + strlen(value) + 8;
+    char *out = malloc(len);
+    if (!out) return NULL;
+
+    if (find_option(text, key, &start, &val, &end) == 0) {
+        snprintf(out, len, "%.*s%s = %s;\n%s",
+                 (int)start, text, key, value, text + end);
+    } else {
+        int need_nl = tlen > 0 && text[tlen - 1] != '\n';
+        snprintf(out, len, "%s%s%s = %s;\n",
+                 text, need_nl ? "\n" : "", key, value);
+    }
+    return out;
 }
 
-int picom_set_animations(int enabled) {
-    char *config = get_config_path();
-    if (!config) return -1;
+// Remove `key = ...;` if present. Returns newly allocated text.
+static char *remove_option(const char *text, const char *key) {
+    size_t start, val, end;
+    if (find_option(text, key, &start, &val, &end) != 0) {
+        return strdup(text);
+    }
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "sed -i 's/^fading\\s*=.*/fading = %s/' '%s'",
-             enabled ? "true" : "false", config);
+    size_t len = strlen(text) - (end - start) + 1;
+    char *out = malloc(len);
+    if (!out) return NULL;
+    snprintf(out, len, "%.*s%s", (int)start, text, text + end);
+    return out;
+}
 
-    int result = system(cmd);
-    free(config);
+static void free_items(char **items, int count) {
+    for (int i = 0; i < count; i++) free(items[i]);
+    free(items);
+}
 
-    if (result == 0 && picom_is_running()) {
-        picom_reload();
+// Parse the string entries of an array option. Returns count or -1.
+static int get_array(const char *text, const char *key, char ***items) {
+    size_t start, val, end;
+    *items = NULL;
+    if (find_option(text, key, &start, &val, &end) != 0) return 0;
+
+    int count = 0;
+    const char *p = text + val;
+    const char *stop = text + end;
+
+    while (p < stop && *p != '[') p++;
+    while (p < stop && *p != ']') {
+        if (*p != '"') {
+            p++;
+            continue;
+        }
+
+        // Unescape one quoted string
+        p++;
+        char *item = malloc((size_t)(stop - p) + 1);
+        if (!item) {
+            free_items(*items, count);
+            *items = NULL;
+            return -1;
+        }
+        size_t n = 0;
+        while (p < stop && *p != '"') {
+            if (*p == '\\' && p + 1 < stop) p++;
+            item[n++] = *p++;
+        }
+        item[n] = '\0';
+        if (p < stop) p++;
+
+        char **grown = realloc(*items, sizeof(char *) * (size_t)(count + 1));
+        if (!grown) {
+            free(item);
+            free_items(*items, count);
+            *items = NULL;
+            return -1;
+        }
+        *items = grown;
+        (*items)[count++] = item;
     }
 
-    return result == 0 ? 0 : -1;
+    return count;
 }
 
-int picom_get_transparency(void) {
-    char *config = get_config_path();
-    if (!config) return -1;
+// Format a string array in the same layout as the shipped picom.conf
+static char *format_array(char **items, int count) {
+    size_t len = 4;
+    for (int i = 0; i < count; i++) len += strlen(items[i]) * 2 + 10;
+
+    char *out = malloc(len);
+    if (!out) return NULL;
+
+    char *p = out;
+    *p++ = '[';
+    for (int i = 0; i < count; i++) {
+        p += sprintf(p, "\n    \"");
+        for (const char *s = items[i]; *s; s++) {
+            if (*s == '"' || *s == '\\') *p++ = '\\';
+            *p++ = *s;
+        }
+        *p++ = '"';
+        if (i < count - 1) *p++ = ',';
+    }
+    p += sprintf(p, "%s]", count > 0 ? "\n" : "");
+    return out;
+}
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "grep -E '^inactive-opacity\\s*=' '%s' 2>/dev/null", config);
+// "class_g = 'mpv'" / "name = 'Foo'"
+static int decode_condition(const char *cond, PicomRule *rule) {
+    const char *prefix;
+    if (strncmp(cond, "class_g = '", 11) == 0) {
+        rule->match = PICOM_MATCH_CLASS;
+        prefix = cond + 11;
+    } else if (strncmp(cond, "name = '", 8) == 0) {
+        rule->match = PICOM_MATCH_NAME;
+        prefix = cond + 8;
+    } else {
+        return -1;
+    }
 
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        free(config);
+    size_t len = strlen(prefix);
+    if (len < 2 || prefix[len - 1] != '\'' || len > PICOM_RULE_PATTERN_MAX) {
         return -1;
     }
+    if (memchr(prefix, '\'', len - 1)) return -1;
+
+    memcpy(rule->pattern, prefix, len - 1);
+    rule->pattern[len - 1] = '\0';
+    return 0;
+}
+
+static void encode_condition(const PicomRule *rule, char *buf, size_t size) {
+    if (rule->match == PICOM_MATCH_CLASS) {
+        snprintf(buf, size, "class_g = '%s'", rule->pattern);
+    } else if (rule->match == PICOM_MATCH_NAME) {
+        snprintf(buf, size, "name = '%s'", rule->pattern);
+    } else {
+        snprintf(buf, size, "%s", rule->pattern);
+    }
+}
+
+static void add_rule_entry(PicomRule **rules, int *count, int *cap,
+                           const PicomRule *rule) {
+    if (*count == *cap) {
+        int new_cap = *cap ? *cap * 2 : 16;
+        PicomRule *grown = realloc(*rules, sizeof(PicomRule) * (size_t)new_cap);
+        if (!grown) return;
+        *rules = grown;
+        *cap = new_cap;
+    }
+    (*rules)[(*count)++] = *rule;
+}
 
-    char line[256];
-    int result = -1;
-    if (fgets(line, sizeof(line), fp)) {
-        float opacity;
-        if (sscanf(line, "inactive-opacity = %f", &opacity) == 1) {
-            result = (int)(opacity * 100);
+// Decode one array entry into one or more rules.
+//
+// unredir-if-possible-exclude lists windows that must NOT be unredirected,
+// so unredirect rules are stored as a single negated entry:
+//   "!(class_g = 'mpv' || class_g = 'steam')"
+static void decode_entry(PicomRuleType type, const char *entry,
+                         PicomRule **rules, int *count, int *cap) {
+    PicomRule rule;
+    memset(&rule, 0, sizeof(rule));
+    rule.type = type;
+    rule.opacity = 100;
+
+    const char *cond = entry;
+    if (type == PICOM_RULE_OPACITY) {
+        char *colon;
+        long pct = strtol(entry, &colon, 10);
+        if (*colon == ':' && colon != entry) {
+            rule.opacity = (int)pct;
+            cond = colon + 1;
         }
     }
 
-    pclose(fp);
-    free(config);
-    return result;
+    size_t len = strlen(entry);
+    if (type == PICOM_RULE_UNREDIRECT && strncmp(entry, "!(", 2) == 0 &&
+        len > 3 && entry[len - 1] == ')') {
+        char *inner = strndup(entry + 2, len - 3);
+        if (inner) {
+            PicomRule parsed[32];
+            int n = 0, ok = 1;
+            char *part = inner;
+            while (part && ok && n < 32) {
+                char *sep = strstr(part, " || ");
+                if (sep) *sep = '\0';
+                parsed[n] = rule;
+                ok = decode_condition(part, &parsed[n]) == 0;
+                n++;
+                part = sep ? sep + 4 : NULL;
+            }
+            free(inner);
+            if (ok && !part) {
+                for (int i = 0; i < n; i++) {
+                    add_rule_entry(rules, count, cap, &parsed[i]);
+                }
+                return;
+            }
+        }
+    } else if (type != PICOM_RULE_UNREDIRECT && decode_condition(cond, &rule) == 0) {
+        add_rule_entry(rules, count, cap, &rule);
+        return;
+    }
+
+    // Anything else is a hand-written condition; keep it verbatim
+    rule.match = PICOM_MATCH_OTHER;
+    rule.opacity = 100;
+    snprintf(rule.pattern, sizeof(rule.pattern), "%s", entry);
+    add_rule_entry(rules, count, cap, &rule);
 }
 
-int picom_set_transparency(int percent) {
-    if (percent < 0) percent = 0;
-    if (percent > 100) percent = 100;
+static int is_other_entry(PicomRuleType type, const char *entry) {
+    PicomRule *parsed = NULL;
+    int count = 0, cap = 0;
+    decode_entry(type, entry, &parsed, &count, &cap);
+    int other = count == 1 && parsed[0].match == PICOM_MATCH_OTHER;
+    free(parsed);
+    return other;
+}
+
+static int parse_rules(const char *text, PicomRule **rules) {
+    int count = 0, cap = 0;
+    *rules = NULL;
+
+    for (int t = 0; t < RULE_TYPE_COUNT; t++) {
+        char **items;
+        int n = get_array(text, rule_array_keys[t], &items);
+        if (n < 0) {
+            free(*rules);
+            *rules = NULL;
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            decode_entry((PicomRuleType)t, items[i], rules, &count, &cap);
+        }
+        free_items(items, n);
+    }
+    return count;
+}
+
+// Rewrite the array for one rule type from the rule list
+static char *store_rules(const char *text, PicomRuleType type,
+                         const PicomRule *rules, int count) {
+    char **items = calloc((size_t)count + 1, sizeof(char *));
+    if (!items) return NULL;
+
+    int n = 0;
+    char cond[PICOM_RULE_PATTERN_MAX + 32];
+    size_t neg_len = 4;
+    int unredirect = 0;
+
+    // Hand-written entries are copied from the original text, in order,
+    // rather than from the (possibly truncated) pattern field
+    char **orig;
+    int orig_count = get_array(text, rule_array_keys[type], &orig);
+    if (orig_count < 0) {
+        free(items);
+        return NULL;
+    }
+    int next_orig = 0;
+
+    for (int i = 0; i < count; i++) {
+        const PicomRule *r = &rules[i];
+        if (r->type != type) continue;
+
+        if (r->match == PICOM_MATCH_OTHER) {
+            while (next_orig < orig_count && !is_other_entry(type, orig[next_orig])) {
+                next_orig++;
+            }
+            if (next_orig < orig_count) {
+                items[n++] = orig[next_orig];
+                orig[next_orig++] = NULL;
+            }
+            continue;
+        }
+
+        if (type == PICOM_RULE_UNREDIRECT) {
+            encode_condition(r, cond, sizeof(cond));
+            neg_len += strlen(cond) + 4;
+            unredirect++;
+            continue;
+        }
+
+        encode_condition(r, cond, sizeof(cond));
+        size_t len = strlen(cond) + 8;
+        items[n] = malloc(len);
+        if (!items[n]) break;
+        if (type == PICOM_RULE_OPACITY) {
+            snprintf(items[n], len, "%d:%s", r->opacity, cond);
+        } else {
+            snprintf(items[n], len, "%s", cond);
+        }
+        n++;
+    }
+
+    if (unredirect > 0) {
+        char *neg = malloc(neg_len);
+        if (neg) {
+            char *p = neg + sprintf(neg, "!(");
+            int first = 1;
+            for (int i = 0; i < count; i++) {
+                const PicomRule *r = &rules[i];
+                if (r->type != type || r->match == PICOM_MATCH_OTHER) continue;
+                encode_condition(r, cond, sizeof(cond));
+                p += sprintf(p, "%s%s", first ? "" : " || ", cond);
+                first = 0;
+            }
+            sprintf(p, ")");
+            items[n++] = neg;
+        }
+    }
+
+    char *out;
+    if (n == 0) {
+        out = remove_option(text, rule_array_keys[type]);
+    } else {
+        char *value = format_array(items, n);
+        out = value ? set_option(text, rule_array_keys[type], value) : NULL;
+        free(value);
+    }
+
+    free_items(items, n);
+    free_items(orig, orig_count);
+    return out;
+}
+
+static int same_target(const PicomRule *a, const PicomRule *b) {
+    return a->type == b->type && a->match == b->match &&
+           strcmp(a->pattern, b->pattern) == 0;
+}
 
+int picom_config_set_option(const char *path, const char *key, const char *value) {
+    OptionEdit edit = { key, value };
+    return config_update_file(path, edit_option, &edit);
+}
+
+int picom_get_rules(PicomRule **rules) {
     char *config = get_config_path();
     if (!config) return -1;
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "sed -i 's/^inactive-opacity\\s*=.*/inactive-opacity = %.2f/' '%s'",
-             percent / 100.0, config);
+    char *text = config_read_file(config);
+    free(config);
+    if (!text) {
+        *rules = NULL;
+        return 0;
+    }
 
-    int result = system(cmd);
+    int count = parse_rules(text, rules);
+    free(text);
+    return count;
+}
+
+typedef struct {
+    const PicomRule *rule;
+    int remove;
+    int changed;             // Set by the edit that got written
+    int unredir_owned;       // unredir-if-possible was turned on by us
+    int unredir_change;      // +1 turned on, -1 turned off by the edit
+} RuleEdit;
+
+// Unredirect rules only take effect with unredir-if-possible enabled. It is
+// turned on when the first rule needs it and only turned back off if we
+// were the ones who turned it on, so a user's own setting is left alone.
+static char *update_unredir(char *text, RuleEdit *edit, int needed) {
+    char *current = NULL;
+    size_t start, value, end;
+    if (find_option(text, "unredir-if-possible", &start, &value, &end) == 0) {
+        const char *v = text + value;
+        while (*v == ' ' || *v == '\t') v++;
+        current = strndup(v, strcspn(v, "; \t\n"));
+    }
+    int enabled = current && strcmp(current, "true") == 0;
+    free(current);
+
+    const char *next_value = NULL;
+    if (needed && !enabled) {
+        next_value = "true";
+        edit->unredir_change = 1;
+    } else if (!needed && enabled && edit->unredir_owned) {
+        next_value = "false";
+        edit->unredir_change = -1;
+    }
+    if (!next_value) return text;
+
+    char *next = set_option(text, "unredir-if-possible", next_value);
+    free(text);
+    return next;
+}
+
+// Add, update or remove one rule in the config text
+static char *edit_rules(const char *text, void *data) {
+    RuleEdit *edit = data;
+    const PicomRule *rule = edit->rule;
+
+    PicomRule *rules;
+    int count = parse_rules(text, &rules);
+    if (count < 0) return NULL;
+
+    edit->changed = 1;
+    if (edit->remove) {
+        int kept = 0;
+        for (int i = 0; i < count; i++) {
+            if (!same_target(&rules[i], rule)) rules[kept++] = rules[i];
+        }
+        edit->changed = kept != count;
+        count = kept;
+    } else {
+        int found = 0;
+        for (int i = 0; i < count; i++) {
+            if (same_target(&rules[i], rule)) {
+                found = 1;
+                edit->changed = rules[i].opacity != rule->opacity &&
+                                rule->type == PICOM_RULE_OPACITY;
+                rules[i].opacity = rule->opacity;
+            }
+        }
+
+        if (!found) {
+            PicomRule *all = realloc(rules, sizeof(PicomRule) * (size_t)(count + 1));
+            if (!all) {
+                free(rules);
+                return NULL;
+            }
+            rules = all;
+            rules[count++] = *rule;
+        }
+    }
+
+    edit->unredir_change = 0;
+    char *updated = edit->changed ? store_rules(text, rule->type, rules, count) : strdup(text);
+    if (updated && edit->changed && rule->type == PICOM_RULE_UNREDIRECT) {
+        int needed = 0;
+        for (int i = 0; i < count; i++) {
+            if (rules[i].type == PICOM_RULE_UNREDIRECT && rules[i].match != PICOM_MATCH_OTHER) {
+                needed = 1;
+            }
+        }
+        updated = update_unredir(updated, edit, needed);
+    }
+    free(rules);
+    return updated;
+}
+
+// Apply a rule edit, then reload picom once
+// Returns 0 on success, 1 if nothing changed, -1 on error
+static int update_rules(RuleEdit *edit) {
+    char *config = get_config_path();
+    if (!config) return -1;
+
+    edit->unredir_owned = config_get_setting_bool(PICOM_KEY_UNREDIR_OWNED, 0);
+    int result = config_update_file(config, edit_rules, edit);
     free(config);
+    if (result != 0) return -1;
+    if (!edit->changed) return 1;
 
-    if (result == 0 && picom_is_running()) {
+    refresh_overlay();
+    if (edit->unredir_change != 0) {
+        config_set_setting(PICOM_KEY_UNREDIR_OWNED, edit->unredir_change > 0 ? "true" : "false");
+    }
+
+    if (picom_is_running()) {
         picom_reload();
     }
+    return 0;
+}
 
-    return result == 0 ? 0 : -1;
+int picom_add_rule(const PicomRule *rule) {
+    if (rule->match == PICOM_MATCH_OTHER || rule->pattern[0] == '\0' ||
+        strpbrk(rule->pattern, "'\"\\")) {
+        print_error("Rule patterns cannot be empty or contain quotes or backslashes");
+        return -1;
+    }
+
+    RuleEdit edit = { rule, 0, 0, 0, 0 };
+    return update_rules(&edit);
+}
+
+int picom_remove_rule(const PicomRule *rule) {
+    RuleEdit edit = { rule, 1, 0, 0, 0 };
+    return update_rules(&edit);
 }
@@ -2,12 +2,17 @@
 #ifndef OPENDE_PICOM_H
 #define OPENDE_PICOM_H
 
+#include <sys/types.h>
+
 // Check if picom is installed
 int picom_is_installed(void);
 
-// Check if picom is currently running
+// Check if picom is currently running on this display
 int picom_is_running(void);
 
+// PID of the compositor on this display, 0 if none
+pid_t picom_get_pid(void);
+
 // Start picom with OpenDE config
 int picom_start(void);
 
@@ -17,6 +22,27 @@ int picom_stop(void);
 // Reload picom config (restart)
 int picom_reload(void);
 
+// Path of the config picom_start() would use (user copy or system
+// default, or the runtime overlay while overrides are set)
+// Returns allocated string, caller frees
+char *picom_config_path(void);
+
+// Temporary option overrides (raw libconfig values) applied on top of the
+// user's config without touching it: picom runs on an overlay copy in the
+// runtime dir for as long as the calling process lives. count 0 drops
+// them. Reloads picom if running. Returns 0 on success, -1 on error.
+#define PICOM_MAX_OVERRIDES 8
+
+typedef struct {
+    const char *key;
+    const char *value;
+} PicomOverride;
+
+int picom_set_overrides(const PicomOverride *overrides, int count);
+
+// Set `key = value;` in an arbitrary picom config file (value is raw libconfig)
+int picom_config_set_option(const char *path, const char *key, const char *value);
+
 // Config file operations
 int picom_get_shadows(void);           // Returns 1=on, 0=off, -1=error
 int picom_set_shadows(int enabled);
@@ -27,4 +53,41 @@ int picom_set_animations(int enabled);
 int picom_get_transparency(void);      // Returns percentage (0-100) or -1
 int picom_set_transparency(int percent);
 
+// Per-window rules, stored in picom's condition arrays
+// (shadow-exclude, fade-exclude, opacity-rule, unredir-if-possible-exclude)
+typedef enum {
+    PICOM_RULE_NO_SHADOW,
+    PICOM_RULE_NO_FADE,
+    PICOM_RULE_OPACITY,
+    PICOM_RULE_UNREDIRECT
+} PicomRuleType;
+
+typedef enum {
+    PICOM_MATCH_CLASS,   // class_g = '<pattern>'
+    PICOM_MATCH_NAME,    // name = '<pattern>'
+    PICOM_MATCH_OTHER    // Hand-written condition, kept verbatim in pattern
+} PicomMatch;
+
+#define PICOM_RULE_PATTERN_MAX 128
+
+typedef struct {
+    PicomRuleType type;
+    PicomMatch match;
+    char pattern[PICOM_RULE_PATTERN_MAX];
+    int opacity;                           // Percent, PICOM_RULE_OPACITY only
+} PicomRule;
+
+// Returns number of rules (caller frees *rules) or -1 on error
+int picom_get_rules(PicomRule **rules);
+
+// Add or update a rule; returns 0 on success, 1 if unchanged, -1 on error
+int picom_add_rule(const PicomRule *rule);
+
+// Remove a rule (opacity is ignored); returns 0 on success, 1 if not found, -1 on error
+int picom_remove_rule(const PicomRule *rule);
+
+// Rule type names used on the command line ("no-shadow", "opacity", ...)
+const char *picom_rule_type_name(PicomRuleType type);
+int picom_rule_type_parse(const char *name, PicomRuleType *type);
+
 #endif
@@ -0,0 +1,409 @@
+// cli/src/backends/picom_bench.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "picom_bench.h"
+#include "picom.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include "../util/proc.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define BENCH_WIDTH        1280
+#define BENCH_HEIGHT       720
+#define BENCH_DECOYS       4
+#define STEP_TIMEOUT_MS    250.0   // Give up waiting for the first frame
+#define SETTLE_MS          60.0    // No change for this long = animation done
+#define POLL_US            500
+#define MAX_SAMPLES        8192
+
+// Probe pixel: the test window covers it when at its home position
+#define PROBE_X 400
+#define PROBE_Y 300
+
+typedef struct {
+    Display *dpy;
+    Window root;
+    Window win;
+    Window decoys[BENCH_DECOYS];
+    Atom opacity_atom;
+    unsigned long last_pixel;
+
+    double latency[MAX_SAMPLES];
+    int latency_count;
+    double frames[MAX_SAMPLES];
+    int frame_count;
+    int steps;
+    int missed;
+} Bench;
+
+int picom_bench_available(void) {
+    return system("which Xvfb > /dev/null 2>&1") == 0 && picom_is_installed();
+}
+
+static void redirect_stdio(void) {
+    int null = open("/dev/null", O_RDWR);
+    if (null >= 0) {
+        dup2(null, STDIN_FILENO);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        if (null > STDERR_FILENO) close(null);
+    }
+}
+
+static void stop_child(pid_t pid) {
+    if (pid <= 0) return;
+    kill(pid, SIGTERM);
+    for (int i = 0; i < 50; i++) {
+        if (waitpid(pid, NULL, WNOHANG) == pid) return;
+        usleep(20000);
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+// Start Xvfb on a free display; -displayfd reports the number once ready
+static pid_t start_xvfb(int *display) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        char fd_arg[16], screen[32];
+        close(fds[0]);
+        snprintf(fd_arg, sizeof(fd_arg), "%d", fds[1]);
+        snprintf(screen, sizeof(screen), "%dx%dx24", BENCH_WIDTH, BENCH_HEIGHT);
+        redirect_stdio();
+        execlp("Xvfb", "Xvfb", "-displayfd", fd_arg, "-screen", "0", screen,
+               "-nolisten", "tcp", "+extension", "GLX", (char *)NULL);
+        _exit(127);
+    }
+
+    close(fds[1]);
+
+    char buf[16] = {0};
+    size_t len = 0;
+    struct pollfd pfd = { .fd = fds[0], .events = POLLIN };
+    while (len < sizeof(buf) - 1 && poll(&pfd, 1, 5000) > 0) {
+        ssize_t n = read(fds[0], buf + len, sizeof(buf) - 1 - len);
+        if (n <= 0) break;
+        len += (size_t)n;
+        if (memchr(buf, '\n', len)) break;
+    }
+    close(fds[0]);
+
+    if (len == 0) {
+        stop_child(pid);
+        return -1;
+    }
+
+    *display = atoi(buf);
+    return pid;
+}
+
+static pid_t start_picom(const char *display, const char *config) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        setenv("DISPLAY", display, 1);
+        // Mesa software rendering: no GPU needed, comparable across machines
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+        setenv("GALLIUM_DRIVER", "llvmpipe", 1);
+        redirect_stdio();
+        execlp("picom", "picom", "--config", config, (char *)NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+// Wait until picom owns the compositing manager selection
+static int wait_for_compositor(Display *dpy, pid_t picom) {
+    char name[32];
+    snprintf(name, sizeof(name), "_NET_WM_CM_S%d", DefaultScreen(dpy));
+    Atom cm = XInternAtom(dpy, name, False);
+
+    for (int i = 0; i < 250; i++) {
+        if (XGetSelectionOwner(dpy, cm) != None) {
+            usleep(200000);  // Let the first full repaint finish
+            return 0;
+        }
+        if (waitpid(picom, NULL, WNOHANG) == picom) return -1;
+        usleep(20000);
+    }
+    return -1;
+}
+
+// Write the user's effective config plus overrides to a temp file
+static char *make_profile_config(const PicomBenchProfile *profile) {
+    char *source = picom_config_path();
+    char *text = source ? config_read_file(source) : NULL;
+    free(source);
+    if (!text) return NULL;
+
+    char *path = strdup("/tmp/opende-bench-XXXXXX");
+    int fd = path ? mkstemp(path) : -1;
+    if (fd < 0) {
+        free(path);
+        free(text);
+        return NULL;
+    }
+    close(fd);
+
+    int ok = config_write_file(path, text) == 0;
+    free(text);
+
+    // Xvfb has no vblank; measure render cost, not a vsync wait
+    if (ok) ok = picom_config_set_option(path, "vsync", "false") == 0;
+
+    if (ok && profile->overrides) {
+        char *list = strdup(profile->overrides);
+        char *save = NULL;
+        for (char *opt = list ? strtok_r(list, ",", &save) : NULL;
+             ok && opt; opt = strtok_r(NULL, ",", &save)) {
+            char *eq = strchr(opt, '=');
+            if (!eq) {
+                print_error("Invalid override '%s' (expected key=value)", opt);
+                ok = 0;
+                break;
+            }
+            *eq = '\0';
+            ok = picom_config_set_option(path, opt, eq + 1) == 0;
+        }
+        free(list);
+    }
+
+    if (!ok) {
+        unlink(path);
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+static unsigned long probe_pixel(Bench *b) {
+    XImage *img = XGetImage(b->dpy, b->root, PROBE_X, PROBE_Y, 1, 1,
+                            AllPlanes, ZPixmap);
+    if (!img) return 0;
+    unsigned long px = XGetPixel(img, 0, 0);
+    XDestroyImage(img);
+    return px;
+}
+
+// Sample the probe after one workload step. The first change is the step's
+// latency; each further change while the animation runs is one frame.
+static void measure_step(Bench *b, double start) {
+    unsigned long px = b->last_pixel;
+    double last_change = -1.0;
+    double deadline = start + STEP_TIMEOUT_MS;
+
+    for (;;) {
+        unsigned long cur = probe_pixel(b);
+        double t = proc_now_ms();
+
+        if (cur != px) {
+            if (last_change < 0) {
+                if (b->latency_count < MAX_SAMPLES) {
+                    b->latency[b->latency_count++] = t - start;
+                }
+            } else if (b->frame_count < MAX_SAMPLES) {
+                b->frames[b->frame_count++] = t - last_change;
+            }
+            last_change = t;
+            px = cur;
+            deadline = t + SETTLE_MS;
+        }
+
+        if (t > deadline) break;
+        usleep(POLL_US);
+    }
+
+    if (last_change < 0) b->missed++;
+    b->steps++;
+    b->last_pixel = px;
+}
+
+static void set_opacity(Bench *b, double opacity) {
+    unsigned long value = (unsigned long)(opacity * 0xffffffffUL);
+    XChangeProperty(b->dpy, b->win, b->opacity_atom, XA_CARDINAL, 32,
+                    PropModeReplace, (unsigned char *)&value, 1);
+}
+
+static Window create_window(Bench *b, int x, int y, unsigned long color,
+                            const char *name) {
+    XSetWindowAttributes attrs;
+    attrs.background_pixel = color;
+    Window w = XCreateWindow(b->dpy, b->root, x, y, 320, 240, 0,
+                             CopyFromParent, InputOutput, CopyFromParent,
+                             CWBackPixel, &attrs);
+
+    XClassHint hint = { (char *)name, (char *)"OpendeBench" };
+    XSetClassHint(b->dpy, w, &hint);
+    XStoreName(b->dpy, w, name);
+    return w;
+}
+
+// Nudge the background windows so every step has some compositing load
+static void move_decoys(Bench *b, int step) {
+    for (int i = 0; i < BENCH_DECOYS; i++) {
+        int x = 700 + (i % 2) * 260 + (step * 7 + i * 13) % 40;
+        int y = 60 + (i / 2) * 300 + (step * 5 + i * 11) % 40;
+        XMoveWindow(b->dpy, b->decoys[i], x, y);
+    }
+}
+
+// One step of the scripted workload
+typedef enum {
+    STEP_MAP,
+    STEP_FADE_OUT,
+    STEP_FADE_IN,
+    STEP_MOVE_AWAY,
+    STEP_MOVE_BACK,
+    STEP_UNMAP,
+    STEP_COUNT
+} StepKind;
+
+static void run_step(Bench *b, StepKind kind, int step) {
+    move_decoys(b, step);
+
+    switch (kind) {
+        case STEP_MAP:       XMapWindow(b->dpy, b->win); break;
+        case STEP_FADE_OUT:  set_opacity(b, 0.5); break;
+        case STEP_FADE_IN:   set_opacity(b, 1.0); break;
+        case STEP_MOVE_AWAY: XMoveWindow(b->dpy, b->win, PROBE_X + 40, 200); break;
+        case STEP_MOVE_BACK: XMoveWindow(b->dpy, b->win, PROBE_X - 160, 200); break;
+        case STEP_UNMAP:     XUnmapWindow(b->dpy, b->win); break;
+        default: break;
+    }
+
+    XSync(b->dpy, False);
+    measure_step(b, proc_now_ms());
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(double *values, int count, double p) {
+    if (count == 0) return 0.0;
+    qsort(values, (size_t)count, sizeof(double), compare_double);
+    int idx = (int)(p * (count - 1) + 0.5);
+    return values[idx];
+}
+
+static int run_profile(const char *display, const PicomBenchProfile *profile,
+                       int iterations, PicomBenchResult *result) {
+    memset(result, 0, sizeof(*result));
+
+    char *config = make_profile_config(profile);
+    if (!config) {
+        print_error("Cannot prepare config for profile '%s'", profile->name);
+        return -1;
+    }
+
+    Bench *b = calloc(1, sizeof(Bench));
+    Display *dpy = XOpenDisplay(display);
+    if (!b || !dpy) {
+        if (dpy) XCloseDisplay(dpy);
+        free(b);
+        unlink(config);
+        free(config);
+        return -1;
+    }
+
+    b->dpy = dpy;
+    b->root = DefaultRootWindow(dpy);
+    b->opacity_atom = XInternAtom(dpy, "_NET_WM_WINDOW_OPACITY", False);
+    XSetWindowBackground(dpy, b->root, 0x336699);
+    XClearWindow(dpy, b->root);
+
+    b->win = create_window(b, PROBE_X - 160, 200, 0xcc3333, "opende-bench");
+    for (int i = 0; i < BENCH_DECOYS; i++) {
+        b->decoys[i] = create_window(b, 700, 60, 0x33cc33 + (unsigned long)i * 0x10,
+                                     "opende-bench-decoy");
+        XMapWindow(dpy, b->decoys[i]);
+    }
+    XSync(dpy, False);
+
+    int rc = -1;
+    pid_t picom = start_picom(display, config);
+    if (picom > 0 && wait_for_compositor(dpy, picom) == 0) {
+        b->last_pixel = probe_pixel(b);
+
+        ProcStat before, after;
+        int have_cpu = proc_read_stat(picom, &before) == 0;
+        double start = proc_now_ms();
+
+        for (int i = 0; i < iterations; i++) {
+            for (int s = 0; s < STEP_COUNT; s++) {
+                run_step(b, (StepKind)s, i * STEP_COUNT + s);
+            }
+        }
+
+        double wall = (proc_now_ms() - start) / 1000.0;
+        if (have_cpu && proc_read_stat(picom, &after) == 0 && wall > 0) {
+            result->cpu_per_sec =
+                (proc_cpu_seconds(&after) - proc_cpu_seconds(&before)) / wall;
+        }
+
+        result->steps = b->steps;
+        result->missed = b->missed;
+        result->frames = b->frame_count;
+        result->latency_p50_ms = percentile(b->latency, b->latency_count, 0.50);
+        result->latency_p99_ms = percentile(b->latency, b->latency_count, 0.99);
+        result->frame_p50_ms = percentile(b->frames, b->frame_count, 0.50);
+        result->frame_p99_ms = percentile(b->frames, b->frame_count, 0.99);
+        rc = 0;
+    } else {
+        print_error("picom did not start for profile '%s'", profile->name);
+    }
+
+    stop_child(picom);
+    XDestroyWindow(dpy, b->win);
+    for (int i = 0; i < BENCH_DECOYS; i++) XDestroyWindow(dpy, b->decoys[i]);
+    XCloseDisplay(dpy);
+    free(b);
+    unlink(config);
+    free(config);
+    return rc;
+}
+
+int picom_bench_run(const PicomBenchProfile *profiles, int count,
+                    int iterations, PicomBenchResult *results) {
+    int display_num;
+    pid_t xvfb = start_xvfb(&display_num);
+    if (xvfb < 0) {
+        print_error("Failed to start Xvfb");
+        return -1;
+    }
+
+    char display[16];
+    snprintf(display, sizeof(display), ":%d", display_num);
+
+    int rc = 0;
+    for (int i = 0; i < count; i++) {
+        print_info("Benchmarking profile '%s'...", profiles[i].name);
+        if (run_profile(display, &profiles[i], iterations, &results[i]) != 0) {
+            results[i].steps = 0;
+            rc = -1;
+        }
+    }
+
+    stop_child(xvfb);
+    return rc;
+}
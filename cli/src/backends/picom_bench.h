@@ -0,0 +1,31 @@
+// cli/src/backends/picom_bench.h
+#ifndef OPENDE_PICOM_BENCH_H
+#define OPENDE_PICOM_BENCH_H
+
+// A named set of config overrides to benchmark
+typedef struct {
+    const char *name;
+    const char *overrides;   // "key=value,key=value" or NULL for the config as-is
+} PicomBenchProfile;
+
+typedef struct {
+    int steps;               // Workload steps issued
+    int missed;              // Steps with no visible screen update
+    int frames;              // Animation frame intervals measured
+    double latency_p50_ms;   // Request -> first updated frame
+    double latency_p99_ms;
+    double frame_p50_ms;     // Interval between consecutive frames
+    double frame_p99_ms;
+    double cpu_per_sec;      // picom CPU seconds per wall second (1.0 = one core)
+} PicomBenchResult;
+
+// Check that Xvfb and picom are available
+int picom_bench_available(void);
+
+// Start a private Xvfb, then for each profile run picom with the user's
+// effective config plus overrides and drive a scripted window workload.
+// Returns 0 on success, -1 if the harness could not start.
+int picom_bench_run(const PicomBenchProfile *profiles, int count,
+                    int iterations, PicomBenchResult *results);
+
+#endif
@@ -0,0 +1,88 @@
+// cli/src/backends/power.c
+#include "power.h"
+#include <X11/Xlib.h>
+#include <X11/extensions/dpms.h>
+#include <stdio.h>
+
+static int x_error;
+
+static int record_x_error(Display *dpy, XErrorEvent *ev) {
+    (void)dpy;
+    x_error = ev->error_code;
+    return 0;
+}
+
+static int has_dpms(Display *dpy) {
+    int event_base, error_base;
+    return DPMSQueryExtension(dpy, &event_base, &error_base) && DPMSCapable(dpy);
+}
+
+static void query(Display *dpy, PowerSettings *out) {
+    int timeout, interval, blanking, exposures;
+    XGetScreenSaver(dpy, &timeout, &interval, &blanking, &exposures);
+    out->screensaver = timeout;
+
+    out->dpms = out->standby = out->suspend = out->off = POWER_UNCHANGED;
+    if (!has_dpms(dpy)) return;
+
+    CARD16 level, standby, suspend, off;
+    BOOL enabled;
+    if (DPMSInfo(dpy, &level, &enabled)) out->dpms = enabled ? 1 : 0;
+    if (DPMSGetTimeouts(dpy, &standby, &suspend, &off)) {
+        out->standby = standby;
+        out->suspend = suspend;
+        out->off = off;
+    }
+}
+
+int power_query(PowerSettings *out) {
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) return -1;
+    query(dpy, out);
+    XCloseDisplay(dpy);
+    return 0;
+}
+
+static int pick(int value, int current) {
+    return value == POWER_UNCHANGED ? current : value;
+}
+
+int power_apply(const PowerSettings *settings) {
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) return -1;
+
+    PowerSettings current;
+    query(dpy, &current);
+
+    int (*previous)(Display *, XErrorEvent *) = XSetErrorHandler(record_x_error);
+    x_error = 0;
+    int result = 0;
+
+    if (settings->screensaver != POWER_UNCHANGED) {
+        int timeout, interval, blanking, exposures;
+        XGetScreenSaver(dpy, &timeout, &interval, &blanking, &exposures);
+        XSetScreenSaver(dpy, settings->screensaver, interval, blanking, exposures);
+    }
+
+    int timeouts = settings->standby != POWER_UNCHANGED || settings->suspend != POWER_UNCHANGED ||
+                   settings->off != POWER_UNCHANGED;
+    if ((timeouts || settings->dpms != POWER_UNCHANGED) && current.dpms == POWER_UNCHANGED) {
+        result = -1;   // No DPMS on this server
+    } else {
+        if (timeouts) {
+            DPMSSetTimeouts(dpy, (CARD16)pick(settings->standby, current.standby),
+                            (CARD16)pick(settings->suspend, current.suspend),
+                            (CARD16)pick(settings->off, current.off));
+        }
+        if (settings->dpms == 1) DPMSEnable(dpy);
+        if (settings->dpms == 0) DPMSDisable(dpy);
+    }
+
+    // Surface BadValue (e.g. standby > suspend) before closing
+    XSync(dpy, False);
+    if (x_error) result = -1;
+
+    XSetErrorHandler(previous);
+    XCloseDisplay(dpy);
+    return result;
+}
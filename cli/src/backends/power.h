@@ -0,0 +1,29 @@
+// cli/src/backends/power.h
+#ifndef OPENDE_POWER_BACKEND_H
+#define OPENDE_POWER_BACKEND_H
+
+// Screen saver and DPMS timeouts, set on the X server directly (core
+// SetScreenSaver request and the DPMS extension) instead of forking xset.
+// The server forgets them when it resets, so they are re-applied at login.
+
+#define POWER_UNCHANGED -1
+#define POWER_MAX_TIMEOUT 86400
+
+typedef struct {
+    int screensaver;         // Seconds of idle before the screen saver, 0 = never
+    int dpms;                // 1 enabled, 0 disabled
+    int standby;             // DPMS timeouts in seconds, 0 = never
+    int suspend;
+    int off;
+} PowerSettings;
+
+// Current server values. Returns 0 on success, -1 without a display;
+// the DPMS fields are POWER_UNCHANGED if the server lacks DPMS
+int power_query(PowerSettings *out);
+
+// Set every field that is not POWER_UNCHANGED. DPMS timeouts must be
+// non-decreasing (standby <= suspend <= off) where non-zero.
+// Returns 0 on success, -1 on error
+int power_apply(const PowerSettings *settings);
+
+#endif
@@ -0,0 +1,234 @@
+// cli/src/backends/prewarm.c
+#define _DEFAULT_SOURCE
+#include "prewarm.h"
+#include "autostart.h"
+#include "frecency.h"
+#include "menu_index.h"
+#include "../util/config.h"
+#include "../util/desktop.h"
+#include "../util/elf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define MAX_FILES 2048
+
+// ioprio_set(2) has no glibc wrapper
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_CLASS_IDLE  3
+#define IOPRIO_WHO_PROCESS 1
+
+// Shared bin directories; anything else is an application's own directory
+static const char *bin_dirs[] = {
+    "/usr/bin", "/bin", "/usr/sbin", "/sbin", "/usr/local/bin", "/usr/games", NULL
+};
+
+typedef struct {
+    PrewarmFile *files;
+    int count;
+} FileList;
+
+static int list_has(const FileList *list, const char *path) {
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->files[i].path, path) == 0) return 1;
+    }
+    return 0;
+}
+
+static void list_add(FileList *list, const char *path, const char *app) {
+    char real[PATH_MAX];
+    struct stat st;
+    if (list->count >= MAX_FILES || !realpath(path, real) || stat(real, &st) != 0 ||
+        !S_ISREG(st.st_mode) || list_has(list, real)) {
+        return;
+    }
+
+    PrewarmFile *f = &list->files[list->count];
+    f->path = strdup(real);
+    if (!f->path) return;
+    snprintf(f->app, sizeof(f->app), "%s", app);
+    f->size = (long long)st.st_size;
+    f->uncached = f->size;
+    list->count++;
+}
+
+static int is_shared_object(const char *name) {
+    size_t len = strlen(name);
+    return (len > 3 && strcmp(name + len - 3, ".so") == 0) || strstr(name, ".so.") != NULL;
+}
+
+// Interpreter of a "#!" script, or 0 if the file is not a script
+static int script_interpreter(const char *path, char *out, size_t len) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+    char line[256];
+    int found = fgets(line, sizeof(line), fp) && line[0] == '#' && line[1] == '!';
+    fclose(fp);
+    if (!found) return 0;
+
+    const char *p = line + 2 + strspn(line + 2, " \t");
+    snprintf(out, len, "%.*s", (int)strcspn(p, " \t\n"), p);
+    return out[0] == '/';
+}
+
+// The binary (through wrapper scripts' interpreters), libraries in the
+// application's own directory, and everything they link against
+static void collect_app(FileList *list, const char *id, const char *exec) {
+    char *argv[64];
+    if (desktop_exec_argv(exec, argv, 64) < 1) return;
+    char *binary = desktop_find_executable(argv[0]);
+    desktop_free_argv(argv);
+    if (!binary) return;
+
+    int first = list->count;
+    list_add(list, binary, id);
+
+    char interpreter[256];
+    if (script_interpreter(binary, interpreter, sizeof(interpreter))) list_add(list, interpreter, id);
+
+    // e.g. /usr/lib/firefox/libxul.so behind /usr/bin/firefox
+    char real[PATH_MAX];
+    if (realpath(binary, real)) {
+        char *slash = strrchr(real, '/');
+        if (slash) *slash = '\0';
+        int shared = 0;
+        for (int i = 0; bin_dirs[i]; i++) shared |= strcmp(real, bin_dirs[i]) == 0;
+
+        DIR *dp = shared ? NULL : opendir(real);
+        struct dirent *de;
+        while (dp && (de = readdir(dp))) {
+            if (!is_shared_object(de->d_name)) continue;
+            char path[PATH_MAX + 256];
+            snprintf(path, sizeof(path), "%s/%s", real, de->d_name);
+            list_add(list, path, id);
+        }
+        if (dp) closedir(dp);
+    }
+    free(binary);
+
+    // Dependencies, breadth first; the list grows as we go
+    for (int i = first; i < list->count; i++) {
+        char *deps[128];
+        int n = elf_dependencies(list->files[i].path, deps, 128);
+        for (int d = 0; d < n; d++) {
+            list_add(list, deps[d], id);
+            free(deps[d]);
+        }
+    }
+}
+
+// Pages not resident in the page cache, via mincore(2)
+static long long uncached_bytes(const char *path, long long size) {
+    if (size <= 0) return 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+
+    long long result = size;
+    void *map = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return result;
+
+    long page = sysconf(_SC_PAGESIZE);
+    size_t pages = (size_t)((size + page - 1) / page);
+    unsigned char *vec = malloc(pages);
+    if (vec && mincore(map, (size_t)size, vec) == 0) {
+        result = 0;
+        for (size_t i = 0; i < pages; i++) {
+            if (!(vec[i] & 1)) result += page;
+        }
+        if (result > size) result = size;
+    }
+    free(vec);
+    munmap(map, (size_t)size);
+    return result;
+}
+
+int prewarm_collect(PrewarmFile **files) {
+    FileList list = { calloc(MAX_FILES, sizeof(PrewarmFile)), 0 };
+    *files = list.files;
+    if (!list.files) return 0;
+
+    static FrecencyEntry launches[FRECENCY_MAX_ENTRIES];
+    int launch_count = frecency_load(launches, FRECENCY_MAX_ENTRIES);
+    int top = config_get_setting_int("prewarm.count", PREWARM_DEFAULT_COUNT);
+
+    MenuIndex index;
+    if (menu_index_load(&index) != 0) memset(&index, 0, sizeof(index));
+
+    for (int i = 0, apps = 0; i < launch_count && apps < top; i++) {
+        if (launches[i].score < FRECENCY_MIN_SCORE) break;
+
+        // Menu entries carry the Exec; autostart-only ids have none here
+        const MenuEntry *e = menu_index_find(&index, launches[i].id);
+        if (!e) continue;
+
+        const char *exec = e->exec;
+        char unwrapped[DESKTOP_FIELD_MAX];
+        if (strncmp(exec, "^term(", 6) == 0) {
+            snprintf(unwrapped, sizeof(unwrapped), "%s", exec + 6);
+            size_t len = strlen(unwrapped);
+            if (len > 0 && unwrapped[len - 1] == ')') unwrapped[len - 1] = '\0';
+            exec = unwrapped;
+        }
+        collect_app(&list, launches[i].id, exec);
+        apps++;
+    }
+    menu_index_free(&index);
+
+    for (int i = 0; i < list.count; i++) {
+        list.files[i].uncached = uncached_bytes(list.files[i].path, list.files[i].size);
+    }
+    return list.count;
+}
+
+void prewarm_free(PrewarmFile *files, int count) {
+    for (int i = 0; files && i < count; i++) free(files[i].path);
+    free(files);
+}
+
+long long prewarm_budget(void) {
+    long long budget = (long long)config_get_setting_int("prewarm.max_mb", PREWARM_DEFAULT_MAX_MB) * 1024 * 1024;
+
+    // Never push out more than a quarter of what is free
+    char *text = config_read_file("/proc/meminfo");
+    const char *p = text ? strstr(text, "MemAvailable:") : NULL;
+    if (p) {
+        long long available = atoll(p + 13) * 1024;
+        if (available / 4 < budget) budget = available / 4;
+    }
+    free(text);
+    return budget > 0 ? budget : 0;
+}
+
+long long prewarm_run(int now) {
+    if (!now) autostart_wait_for_idle(config_get_setting_int("prewarm.idle_timeout", 120));
+
+    // Only spare capacity
+    setpriority(PRIO_PROCESS, 0, 19);
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+
+    PrewarmFile *files;
+    int count = prewarm_collect(&files);
+    if (!files) return -1;
+
+    long long budget = prewarm_budget(), used = 0;
+    for (int i = 0; i < count; i++) {
+        if (files[i].uncached == 0 || used + files[i].uncached > budget) continue;
+
+        int fd = open(files[i].path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0) used += files[i].uncached;
+        close(fd);
+    }
+
+    prewarm_free(files, count);
+    return used;
+}
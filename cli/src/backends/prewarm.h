@@ -0,0 +1,33 @@
+// cli/src/backends/prewarm.h
+#ifndef OPENDE_PREWARM_H
+#define OPENDE_PREWARM_H
+
+// Page-cache prewarm: once the session is idle, read ahead the binaries and
+// libraries of the most launched applications so their first start is warm
+
+#define PREWARM_DEFAULT_COUNT   5
+#define PREWARM_DEFAULT_MAX_MB  256
+
+typedef struct {
+    char *path;
+    char app[128];           // Desktop id that brought the file in
+    long long size;
+    long long uncached;      // Bytes not in the page cache right now
+} PrewarmFile;
+
+// Files for the top prewarm.count applications by launch history, most
+// launched first, each file once. Returns count; *files must be freed with
+// prewarm_free.
+int prewarm_collect(PrewarmFile **files);
+
+void prewarm_free(PrewarmFile *files, int count);
+
+// Memory budget: prewarm.max_mb, at most a quarter of MemAvailable
+long long prewarm_budget(void);
+
+// Wait for idle (unless now), then posix_fadvise(WILLNEED) the uncached
+// files in order until the budget is used, at idle CPU and IO priority
+// Returns bytes requested, -1 on error
+long long prewarm_run(int now);
+
+#endif
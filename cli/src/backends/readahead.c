@@ -0,0 +1,430 @@
+// cli/src/backends/readahead.c
+#define _GNU_SOURCE
+#include "readahead.h"
+#include "../util/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/fanotify.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define LIST_HEADER "# opende readahead 1"
+#define SAMPLE_MS 500
+
+// Package databases: any install, upgrade or removal rewrites one of these
+static const char *package_dbs[] = {
+    "/var/lib/dpkg/status",
+    "/var/lib/pacman/local",
+    "/var/lib/rpm",
+    "/var/lib/apk/db/installed",
+    NULL
+};
+
+// Virtual and volatile filesystems are never worth prefetching
+static const char *skip_prefixes[] = {
+    "/proc/", "/sys/", "/dev/", "/run/", "/tmp/", "/memfd:", NULL
+};
+
+typedef struct {
+    char *path;
+    uint64_t dev;
+    uint64_t block;          // Physical offset of the first extent
+    uint64_t ino;
+    long long size;
+} ReadaheadFile;
+
+typedef struct {
+    char **paths;            // First-seen order
+    int count;
+    int capacity;
+    char **table;            // Open-addressing set over paths
+    int table_size;
+} PathSet;
+
+static char *list_path(void) {
+    const char *cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    char path[512];
+
+    if (cache && *cache) snprintf(path, sizeof(path), "%s/opende/readahead.list", cache);
+    else if (home) snprintf(path, sizeof(path), "%s/.cache/opende/readahead.list", home);
+    else return NULL;
+
+    return strdup(path);
+}
+
+static long long path_mtime(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    return (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+// ---- Path set ----
+
+static uint32_t hash_path(const char *s) {
+    uint32_t h = 2166136261u;
+    for (; *s; s++) h = (h ^ (unsigned char)*s) * 16777619u;
+    return h;
+}
+
+static void set_add(PathSet *set, const char *path) {
+    if (path[0] != '/') return;
+    for (int i = 0; skip_prefixes[i]; i++) {
+        if (strncmp(path, skip_prefixes[i], strlen(skip_prefixes[i])) == 0) return;
+    }
+    if (strstr(path, " (deleted)")) return;
+
+    if (set->count * 2 >= set->table_size) {
+        int size = set->table_size ? set->table_size * 2 : 1024;
+        char **table = calloc((size_t)size, sizeof(char *));
+        if (!table) return;
+        for (int i = 0; i < set->count; i++) {
+            uint32_t h = hash_path(set->paths[i]) & (uint32_t)(size - 1);
+            while (table[h]) h = (h + 1) & (uint32_t)(size - 1);
+            table[h] = set->paths[i];
+        }
+        free(set->table);
+        set->table = table;
+        set->table_size = size;
+    }
+
+    uint32_t mask = (uint32_t)(set->table_size - 1);
+    uint32_t h = hash_path(path) & mask;
+    while (set->table[h]) {
+        if (strcmp(set->table[h], path) == 0) return;
+        h = (h + 1) & mask;
+    }
+
+    if (set->count == set->capacity) {
+        int grown = set->capacity ? set->capacity * 2 : 1024;
+        char **paths = realloc(set->paths, (size_t)grown * sizeof(char *));
+        if (!paths) return;
+        set->paths = paths;
+        set->capacity = grown;
+    }
+    char *copy = strdup(path);
+    if (!copy) return;
+    set->paths[set->count++] = copy;
+    set->table[h] = copy;
+}
+
+static void set_free(PathSet *set) {
+    for (int i = 0; i < set->count; i++) free(set->paths[i]);
+    free(set->paths);
+    free(set->table);
+    memset(set, 0, sizeof(*set));
+}
+
+// ---- Sources ----
+
+// Binaries, libraries, fonts and caches mapped by a process, plus the
+// files it holds open
+static void sample_process(PathSet *set, const char *pid) {
+    char path[64], line[1024];
+    snprintf(path, sizeof(path), "/proc/%s/maps", pid);
+    FILE *fp = fopen(path, "r");
+    if (fp) {
+        while (fgets(line, sizeof(line), fp)) {
+            char *file = strchr(line, '/');
+            if (!file) continue;
+            file[strcspn(file, "\n")] = '\0';
+            set_add(set, file);
+        }
+        fclose(fp);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%s/fd", pid);
+    DIR *dp = opendir(path);
+    if (!dp) return;
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (de->d_name[0] == '.') continue;
+        char link[128], target[1024];
+        snprintf(link, sizeof(link), "/proc/%.20s/fd/%.32s", pid, de->d_name);
+        ssize_t n = readlink(link, target, sizeof(target) - 1);
+        if (n <= 0) continue;
+        target[n] = '\0';
+        set_add(set, target);
+    }
+    closedir(dp);
+}
+
+static void sample_processes(PathSet *set, uid_t uid) {
+    DIR *dp = opendir("/proc");
+    if (!dp) return;
+
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (!isdigit((unsigned char)de->d_name[0])) continue;
+        if (atoi(de->d_name) == getpid()) continue;
+
+        char path[64];
+        struct stat st;
+        snprintf(path, sizeof(path), "/proc/%.32s", de->d_name);
+        if (stat(path, &st) != 0 || st.st_uid != uid) continue;
+        sample_process(set, de->d_name);
+    }
+    closedir(dp);
+}
+
+// fanotify(7) mount marks need CAP_SYS_ADMIN; -1 if unavailable
+static int fanotify_open(void) {
+    int fd = (int)syscall(SYS_fanotify_init, FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK,
+                          O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    static const char *mounts[] = { "/", "/usr", "/opt", NULL };
+    int marked = 0;
+    for (int i = 0; mounts[i]; i++) {
+        if (syscall(SYS_fanotify_mark, fd, FAN_MARK_ADD | FAN_MARK_MOUNT, (uint64_t)FAN_OPEN,
+                    AT_FDCWD, mounts[i]) == 0) {
+            marked++;
+        }
+    }
+    if (!marked) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void read_fanotify(int fd, PathSet *set, uid_t uid) {
+    char buf[8192] __attribute__((aligned(__alignof__(struct fanotify_event_metadata))));
+
+    for (;;) {
+        ssize_t len = read(fd, buf, sizeof(buf));
+        if (len <= 0) break;
+
+        struct fanotify_event_metadata *ev = (struct fanotify_event_metadata *)buf;
+        for (; FAN_EVENT_OK(ev, len); ev = FAN_EVENT_NEXT(ev, len)) {
+            if (ev->vers != FANOTIFY_METADATA_VERSION || ev->fd < 0) continue;
+
+            // Only the session user's processes
+            char path[64];
+            struct stat st;
+            snprintf(path, sizeof(path), "/proc/%d", (int)ev->pid);
+            if (ev->pid != getpid() && stat(path, &st) == 0 && st.st_uid == uid) {
+                char link[64], target[1024];
+                snprintf(link, sizeof(link), "/proc/self/fd/%d", ev->fd);
+                ssize_t n = readlink(link, target, sizeof(target) - 1);
+                if (n > 0) {
+                    target[n] = '\0';
+                    set_add(set, target);
+                }
+            }
+            close(ev->fd);
+        }
+    }
+}
+
+// ---- List ----
+
+static uint64_t first_block(int fd) {
+    union {
+        struct fiemap map;
+        char raw[sizeof(struct fiemap) + sizeof(struct fiemap_extent)];
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.map.fm_length = FIEMAP_MAX_OFFSET;
+    req.map.fm_extent_count = 1;
+
+    if (ioctl(fd, FS_IOC_FIEMAP, &req.map) != 0 || req.map.fm_mapped_extents == 0) return 0;
+    return req.map.fm_extents[0].fe_physical;
+}
+
+// Device, then position on it; inode order where FIEMAP is unsupported
+static int by_disk_order(const void *a, const void *b) {
+    const ReadaheadFile *fa = a, *fb = b;
+    if (fa->dev != fb->dev) return fa->dev < fb->dev ? -1 : 1;
+    if (fa->block != fb->block) return fa->block < fb->block ? -1 : 1;
+    if (fa->ino != fb->ino) return fa->ino < fb->ino ? -1 : 1;
+    return 0;
+}
+
+static long long max_bytes(void) {
+    long long mb = config_get_setting_int("readahead.max_mb", READAHEAD_DEFAULT_MAX_MB);
+    return (mb > 0 ? mb : READAHEAD_DEFAULT_MAX_MB) * 1024 * 1024;
+}
+
+// Keep files in first-seen order until the budget is spent, then sort
+static int save_list(const PathSet *set, int fanotify) {
+    ReadaheadFile *files = calloc((size_t)(set->count + 1), sizeof(ReadaheadFile));
+    if (!files) return -1;
+
+    long long budget = max_bytes(), total = 0;
+    int count = 0;
+    for (int i = 0; i < set->count; i++) {
+        int fd = open(set->paths[i], O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+        if (fd < 0) continue;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+            total + st.st_size <= budget) {
+            ReadaheadFile *f = &files[count++];
+            f->path = set->paths[i];
+            f->dev = (uint64_t)st.st_dev;
+            f->ino = (uint64_t)st.st_ino;
+            f->size = (long long)st.st_size;
+            f->block = first_block(fd);
+            total += f->size;
+        }
+        close(fd);
+    }
+    qsort(files, (size_t)count, sizeof(ReadaheadFile), by_disk_order);
+
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buf, &size);
+    if (!fp) {
+        free(files);
+        return -1;
+    }
+    fprintf(fp, "%s\n", LIST_HEADER);
+    fprintf(fp, "source %s\n", fanotify ? "fanotify" : "proc");
+    for (int i = 0; package_dbs[i]; i++) {
+        fprintf(fp, "stamp %lld %s\n", path_mtime(package_dbs[i]), package_dbs[i]);
+    }
+    for (int i = 0; i < count; i++) {
+        fprintf(fp, "%lld %s\n", files[i].size, files[i].path);
+    }
+    fclose(fp);
+    free(files);
+
+    char *path = list_path();
+    int result = path && buf && config_ensure_dir(path) == 0 &&
+                 config_write_file(path, buf) == 0 ? count : -1;
+
+    // Recorded as root for the fanotify marks: hand the list to the user
+    const char *sudo_uid = getenv("SUDO_UID"), *sudo_gid = getenv("SUDO_GID");
+    if (result >= 0 && getuid() == 0 && sudo_uid && sudo_gid) {
+        if (chown(path, (uid_t)atoi(sudo_uid), (gid_t)atoi(sudo_gid)) != 0) result = -1;
+    }
+
+    free(path);
+    free(buf);
+    return result;
+}
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int readahead_record(int seconds) {
+    const char *sudo_uid = getenv("SUDO_UID");
+    uid_t uid = getuid() == 0 && sudo_uid ? (uid_t)atoi(sudo_uid) : getuid();
+
+    PathSet set;
+    memset(&set, 0, sizeof(set));
+    int fan = fanotify_open();
+
+    long long deadline = now_ms() + (long long)seconds * 1000;
+    for (long long now = now_ms(); now < deadline; now = now_ms()) {
+        sample_processes(&set, uid);
+
+        if (fan >= 0) {
+            struct pollfd pfd = { fan, POLLIN, 0 };
+            long long until = now + SAMPLE_MS < deadline ? now + SAMPLE_MS : deadline;
+            for (long long t = now_ms(); t < until; t = now_ms()) {
+                if (poll(&pfd, 1, (int)(until - t)) > 0) read_fanotify(fan, &set, uid);
+            }
+        } else {
+            struct timespec ts = { 0, SAMPLE_MS * 1000000L };
+            nanosleep(&ts, NULL);
+        }
+    }
+
+    if (fan >= 0) close(fan);
+    int result = save_list(&set, fan >= 0);
+    set_free(&set);
+    return result;
+}
+
+// Parse the list header. Returns the text positioned after it, or NULL.
+static char *read_list(ReadaheadInfo *info) {
+    memset(info, 0, sizeof(*info));
+    char *path = list_path();
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return NULL;
+    if (strncmp(text, LIST_HEADER "\n", strlen(LIST_HEADER) + 1) != 0) {
+        free(text);
+        return NULL;
+    }
+
+    info->exists = 1;
+    info->fresh = 1;
+    for (char *line = text, *next; *line; line = next) {
+        next = line + strcspn(line, "\n");
+        if (*next) *next++ = '\0';
+
+        long long value;
+        char name[512];
+        if (strncmp(line, "source ", 7) == 0) {
+            info->fanotify = strcmp(line + 7, "fanotify") == 0;
+        } else if (sscanf(line, "stamp %lld %511s", &value, name) == 2) {
+            if (path_mtime(name) != value) info->fresh = 0;
+        } else if (isdigit((unsigned char)line[0])) {
+            info->files++;
+            info->bytes += atoll(line);
+        }
+        if (next > line && next[-1] == '\0') next[-1] = '\n';
+    }
+    return text;
+}
+
+int readahead_info(ReadaheadInfo *info) {
+    char *text = read_list(info);
+    free(text);
+    return info->exists ? 0 : -1;
+}
+
+int readahead_replay(long long *bytes) {
+    ReadaheadInfo info;
+    char *text = read_list(&info);
+    *bytes = 0;
+    if (!text || !info.fresh) {
+        free(text);
+        return -1;
+    }
+
+    // readahead(2) blocks until the IO is queued, so reads are issued in
+    // list order and the disk sweeps once instead of seeking per process
+    int count = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        if (!isdigit((unsigned char)line[0])) continue;
+        char *file = strchr(line, ' ');
+        if (!file) continue;
+
+        int fd = open(file + 1, O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+        if (fd < 0) continue;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && readahead(fd, 0, (size_t)st.st_size) == 0) {
+            *bytes += (long long)st.st_size;
+            count++;
+        }
+        close(fd);
+    }
+    free(text);
+    return count;
+}
+
+int readahead_clear(void) {
+    char *path = list_path();
+    int result = path && (unlink(path) == 0 || errno == ENOENT) ? 0 : -1;
+    free(path);
+    return result;
+}
@@ -0,0 +1,34 @@
+// cli/src/backends/readahead.h
+#ifndef OPENDE_READAHEAD_H
+#define OPENDE_READAHEAD_H
+
+// Login readahead: the files the session read while starting, recorded once
+// and prefetched in on-disk order at the next login
+
+#define READAHEAD_DEFAULT_MAX_MB   256
+#define READAHEAD_DEFAULT_SECONDS  30
+
+typedef struct {
+    int exists;
+    int fresh;               // Package databases unchanged since recording
+    int files;
+    long long bytes;
+    int fanotify;            // Recorded with fanotify (else /proc sampling)
+} ReadaheadInfo;
+
+// Record files opened during the next `seconds` seconds: every open on the
+// root and /usr mounts via fanotify when privileged, otherwise the files
+// mapped or held open by the user's processes, sampled twice a second
+// Returns number of files saved, -1 on error
+int readahead_record(int seconds);
+
+// Prefetch the recorded files in list (disk) order
+// Returns number of files read, -1 if there is no current list
+int readahead_replay(long long *bytes);
+
+int readahead_info(ReadaheadInfo *info);
+
+// Delete the recorded list. Returns 0 on success, -1 on error
+int readahead_clear(void);
+
+#endif
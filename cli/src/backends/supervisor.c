@@ -0,0 +1,680 @@
+// cli/src/backends/supervisor.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "supervisor.h"
+#include "components.h"
+#include "lazy.h"
+#include "../util/config.h"
+#include "../util/desktop.h"
+#include "../util/liveness.h"
+#include "../util/output.h"
+#include "../util/proc.h"
+#include "../util/uevent.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define SUPERVISOR_LOCK_FILE  "supervisor.lock"
+#define SUPERVISOR_STATE_FILE "supervisor.state"
+#define SUPERVISOR_SOCKET     "supervisor.sock"
+#define CONTROL_TIMEOUT_MS    2000
+#define MAX_SUPERVISED 32
+#define ADOPTED_POLL_MS 2000        // Liveness check of adopted PIDs without a pidfd
+
+// Restart policy, matching systemd/user/tint2.service
+#define BACKOFF_INITIAL_MS  1000
+#define BACKOFF_MAX_MS      30000
+#define STABLE_MS           30000   // Up this long resets the backoff
+#define START_LIMIT_BURST   5
+#define START_LIMIT_MS      60000.0
+
+typedef struct {
+    const SessionComponent *component;
+    SupervisorState state;
+    pid_t pid;
+    int adopted;               // Not our child: exits arrive through the
+                               // pidfd, or are polled for without one
+    int pidfd;                 // Adopted processes, -1 if unsupported or ours
+    unsigned long long start_time;     // Adopted process, against PID reuse
+    int restarts;
+    int backoff_ms;
+    double started;            // Monotonic ms of the last start
+    double restart_at;         // Monotonic ms when backoff (or a deferred
+                               // lazy start) ends, 0 if none
+    double starts[START_LIMIT_BURST];  // Ring of recent start times
+    int start_count;
+} Supervised;
+
+typedef struct {
+    Supervised items[MAX_SUPERVISED];
+    int count;
+    int sigfd;
+    int timerfd;
+    int ueventfd;              // Hotplug events for lazy starts, or -1
+    int controlfd;             // Listening control socket, or -1
+    int lazy;
+} Supervisor;
+
+static const char *state_names[] = {
+    [SUPERVISOR_RUNNING] = "running",
+    [SUPERVISOR_BACKOFF] = "restarting",
+    [SUPERVISOR_FAILED]  = "failed",
+    [SUPERVISOR_EXITED]  = "exited",
+    [SUPERVISOR_MISSING] = "not installed",
+    [SUPERVISOR_WAITING] = "waiting",
+    [SUPERVISOR_ON_DEMAND] = "on demand",
+    [SUPERVISOR_STOPPED] = "stopped",
+};
+
+const char *supervisor_state_name(SupervisorState state) {
+    return state_names[state];
+}
+
+static void write_state(const Supervisor *sv) {
+    char *path = config_get_runtime_path(SUPERVISOR_STATE_FILE);
+    if (!path) return;
+
+    char content[MAX_SUPERVISED * 64];
+    size_t len = (size_t)snprintf(content, sizeof(content), "supervisor %ld\n",
+                                  (long)getpid());
+    for (int i = 0; i < sv->count && len < sizeof(content); i++) {
+        const Supervised *s = &sv->items[i];
+        len += (size_t)snprintf(content + len, sizeof(content) - len, "%s %d %ld %d\n",
+                                s->component->name, (int)s->state, (long)s->pid, s->restarts);
+    }
+
+    if (len < sizeof(content)) config_write_file(path, content);
+    free(path);
+}
+
+int supervisor_read_state(SupervisorEntry *entries, int max) {
+    char *path = config_get_runtime_path(SUPERVISOR_STATE_FILE);
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return -1;
+
+    long pid = 0;
+    int count = -1;
+    char *save = NULL;
+    char *line = strtok_r(text, "\n", &save);
+
+    if (line && sscanf(line, "supervisor %ld", &pid) == 1 && pid > 0 &&
+        kill((pid_t)pid, 0) == 0) {
+        count = 0;
+        while ((line = strtok_r(NULL, "\n", &save)) && count < max) {
+            SupervisorEntry *e = &entries[count];
+            int state;
+            long epid;
+            if (sscanf(line, "%31s %d %ld %d", e->name, &state, &epid, &e->restarts) == 4) {
+                e->state = (SupervisorState)state;
+                e->pid = (pid_t)epid;
+                count++;
+            }
+        }
+    }
+
+    free(text);
+    return count;
+}
+
+static int is_installed(const SessionComponent *c) {
+    char *argv[8];
+    if (components_build_argv(c, argv, 8) < 1) return 0;
+
+    char *path = desktop_find_executable(argv[0]);
+    components_free_argv(argv);
+    free(path);
+    return path != NULL;
+}
+
+// Start limit: at most START_LIMIT_BURST starts within START_LIMIT_MS
+static int start_limit_hit(Supervised *s, double now) {
+    if (s->start_count < START_LIMIT_BURST) return 0;
+    double oldest = s->starts[s->start_count % START_LIMIT_BURST];
+    return now - oldest < START_LIMIT_MS;
+}
+
+static int spawn(Supervised *s) {
+    char *argv[16];
+    if (components_build_argv(s->component, argv, 16) < 1) return -1;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        sigset_t none;
+        sigemptyset(&none);
+        sigprocmask(SIG_SETMASK, &none, NULL);
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+    components_free_argv(argv);
+
+    if (pid < 0) return -1;
+
+    double now = proc_now_ms();
+    s->starts[s->start_count % START_LIMIT_BURST] = now;
+    s->start_count++;
+    s->pid = pid;
+    s->adopted = 0;
+    s->pidfd = -1;
+    s->started = now;
+    s->state = SUPERVISOR_RUNNING;
+    return 0;
+}
+
+// Watch a process someone else started (WM autostart, a start by hand).
+// Without a pidfd (pre-5.3 kernel) the timer polls its PID instead
+static void adopt(Supervised *s, pid_t pid) {
+    ProcStat st;
+    s->pid = pid;
+    s->adopted = 1;
+    s->pidfd = liveness_pidfd_open(pid);
+    s->start_time = proc_read_stat(pid, &st) == 0 ? st.start_time : 0;
+    s->state = SUPERVISOR_RUNNING;
+    s->started = proc_now_ms();
+}
+
+static int polled(const Supervised *s) {
+    return s->state == SUPERVISOR_RUNNING && s->adopted && s->pidfd < 0 && s->pid > 0;
+}
+
+// A polled process that exited, or whose PID now belongs to another one
+static int polled_gone(const Supervised *s) {
+    ProcStat st;
+    return proc_read_stat(s->pid, &st) != 0 || st.state == 'Z' ||
+           (s->start_time && st.start_time != s->start_time);
+}
+
+static void arm_timer(Supervisor *sv) {
+    double next = 0, now = proc_now_ms();
+    for (int i = 0; i < sv->count; i++) {
+        const Supervised *s = &sv->items[i];
+        int timed = s->state == SUPERVISOR_BACKOFF ||
+                    (s->state == SUPERVISOR_WAITING && s->restart_at > 0);
+        double at = polled(s) ? now + ADOPTED_POLL_MS : timed ? s->restart_at : 0;
+        if (at > 0 && (next == 0 || at < next)) next = at;
+    }
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (next > 0) {
+        double delay = next - proc_now_ms();
+        if (delay < 1) delay = 1;  // A zero it_value would disarm the timer
+        its.it_value.tv_sec = (time_t)(delay / 1000);
+        its.it_value.tv_nsec = (long)((delay - (double)its.it_value.tv_sec * 1000) * 1e6);
+    }
+    timerfd_settime(sv->timerfd, 0, &its, NULL);
+}
+
+// A supervised process went away; decide whether and when to restart it
+static void handle_exit(Supervisor *sv, Supervised *s, int status, int known) {
+    double now = proc_now_ms();
+    const char *name = s->component->name;
+
+    if (s->pidfd >= 0) {
+        close(s->pidfd);
+        s->pidfd = -1;
+    }
+    s->pid = 0;
+    s->adopted = 0;
+
+    // Stopped on request (focus mode, effects disable compositor)
+    if (s->state == SUPERVISOR_STOPPED) {
+        print_info("%s stopped", name);
+        write_state(sv);
+        return;
+    }
+
+    // The bus starts it again when something next needs it
+    if (sv->lazy && s->component->activation == ACTIVATE_DBUS) {
+        s->state = SUPERVISOR_ON_DEMAND;
+        write_state(sv);
+        return;
+    }
+
+    if (known && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        print_info("%s exited cleanly; not restarting", name);
+        s->state = SUPERVISOR_EXITED;
+        write_state(sv);
+        return;
+    }
+
+    if (now - s->started > STABLE_MS) s->backoff_ms = 0;
+
+    if (start_limit_hit(s, now)) {
+        print_warn("%s crashed %d times in %.0fs; giving up",
+                   name, START_LIMIT_BURST, START_LIMIT_MS / 1000);
+        s->state = SUPERVISOR_FAILED;
+        write_state(sv);
+        return;
+    }
+
+    s->backoff_ms = s->backoff_ms ? s->backoff_ms * 2 : BACKOFF_INITIAL_MS;
+    if (s->backoff_ms > BACKOFF_MAX_MS) s->backoff_ms = BACKOFF_MAX_MS;
+    s->restart_at = now + s->backoff_ms;
+    s->state = SUPERVISOR_BACKOFF;
+
+    if (known && WIFSIGNALED(status)) {
+        print_warn("%s killed by signal %d; restarting in %.1fs",
+                   name, WTERMSIG(status), s->backoff_ms / 1000.0);
+    } else if (known) {
+        print_warn("%s exited with status %d; restarting in %.1fs",
+                   name, WEXITSTATUS(status), s->backoff_ms / 1000.0);
+    } else {
+        print_warn("%s exited; restarting in %.1fs", name, s->backoff_ms / 1000.0);
+    }
+
+    write_state(sv);
+    arm_timer(sv);
+}
+
+static void restart_due(Supervisor *sv) {
+    uint64_t expirations;
+    ssize_t ret = read(sv->timerfd, &expirations, sizeof(expirations));
+    (void)ret;  // Only used to clear readiness
+
+    for (int i = 0; i < sv->count; i++) {
+        Supervised *s = &sv->items[i];
+        if (polled(s) && polled_gone(s)) handle_exit(sv, s, 0, 0);
+    }
+
+    double now = proc_now_ms();
+    for (int i = 0; i < sv->count; i++) {
+        Supervised *s = &sv->items[i];
+        int deferred = s->state == SUPERVISOR_WAITING && s->restart_at > 0;
+        if ((s->state != SUPERVISOR_BACKOFF && !deferred) || s->restart_at > now) continue;
+
+        // Someone else may have started it meanwhile (e.g. a WM restart
+        // re-running autostart); adopt rather than spawn a duplicate
+        pid_t pid;
+        if (components_find_pids(s->component, &pid, 1) == 1) {
+            adopt(s, pid);
+            continue;
+        }
+
+        if (spawn(s) != 0) continue;
+        if (deferred) {
+            print_info("%s started (pid %ld)", s->component->name, (long)s->pid);
+        } else {
+            s->restarts++;
+            print_info("%s restarted (pid %ld)", s->component->name, (long)s->pid);
+        }
+    }
+
+    write_state(sv);
+    arm_timer(sv);
+}
+
+// Drain pending signals; returns 1 if asked to stop. SIGCHLDs coalesce,
+// so every exited child is collected with waitpid regardless.
+static int drain_signals(Supervisor *sv) {
+    struct signalfd_siginfo info;
+    int stop = 0;
+    while (read(sv->sigfd, &info, sizeof(info)) == sizeof(info)) {
+        if (info.ssi_signo != SIGCHLD) stop = 1;
+    }
+    return stop;
+}
+
+static void reap_children(Supervisor *sv) {
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        for (int i = 0; i < sv->count; i++) {
+            Supervised *s = &sv->items[i];
+            if (s->pid == pid && !s->adopted) {
+                handle_exit(sv, s, status, 1);
+                break;
+            }
+        }
+    }
+}
+
+// Start lazy components whose device just appeared
+static void handle_uevents(Supervisor *sv) {
+    UEvent event;
+    int changed = 0;
+
+    while (uevent_read(sv->ueventfd, &event) == 1) {
+        for (int i = 0; i < sv->count; i++) {
+            Supervised *s = &sv->items[i];
+            if (s->state != SUPERVISOR_WAITING || s->restart_at > 0 ||
+                !lazy_uevent_triggers(s->component, &event)) {
+                continue;
+            }
+            if (spawn(s) == 0) {
+                print_info("%s started on %s %s (pid %ld)", s->component->name,
+                           event.subsystem, event.action, (long)s->pid);
+                changed = 1;
+            }
+        }
+    }
+
+    if (changed) write_state(sv);
+}
+
+// --- Control socket ------------------------------------------------------
+//
+// One request per connection: "start <name>" or "stop <name>", answered
+// with "ok", "unmanaged" or "failed".
+
+static int control_address(struct sockaddr_un *addr) {
+    char *path = config_get_runtime_path(SUPERVISOR_SOCKET);
+    if (!path) return -1;
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    int fits = strlen(path) < sizeof(addr->sun_path);
+    if (fits) memcpy(addr->sun_path, path, strlen(path) + 1);
+    free(path);
+    return fits ? 0 : -1;
+}
+
+static int open_control(void) {
+    struct sockaddr_un addr;
+    if (control_address(&addr) != 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    // We hold the supervisor lock, so any existing socket is stale
+    unlink(addr.sun_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static Supervised *find_supervised(Supervisor *sv, const char *name) {
+    for (int i = 0; i < sv->count; i++) {
+        if (strcmp(sv->items[i].component->name, name) == 0) return &sv->items[i];
+    }
+    return NULL;
+}
+
+static const char *control_stop(Supervisor *sv, Supervised *s) {
+    int alive = s->state == SUPERVISOR_RUNNING && s->pid > 0;
+    s->state = SUPERVISOR_STOPPED;
+    s->restart_at = 0;
+    if (alive && kill(s->pid, SIGTERM) != 0 && errno != ESRCH) return "failed";
+
+    // Its exit is reported as usual and finds it stopped; until then the
+    // PID stays so stop_all and the state file still see it
+    if (!alive) s->pid = 0;
+    write_state(sv);
+    arm_timer(sv);
+    return "ok";
+}
+
+static const char *control_start(Supervisor *sv, Supervised *s) {
+    if (s->state == SUPERVISOR_RUNNING && s->pid > 0) return "ok";
+    if (s->state == SUPERVISOR_STOPPED && s->pid > 0) return "failed";  // Still exiting
+
+    // Started by hand meanwhile: adopt it
+    pid_t pid;
+    if (components_find_pids(s->component, &pid, 1) == 1) {
+        adopt(s, pid);
+        write_state(sv);
+        arm_timer(sv);
+        return "ok";
+    }
+
+    // A requested start is not a crash: forget the backoff and start limit
+    s->backoff_ms = 0;
+    s->start_count = 0;
+    s->restart_at = 0;
+    if (spawn(s) != 0) return "failed";
+
+    print_info("%s started on request (pid %ld)", s->component->name, (long)s->pid);
+    write_state(sv);
+    arm_timer(sv);
+    return "ok";
+}
+
+static void handle_control(Supervisor *sv) {
+    int fd = accept(sv->controlfd, NULL, NULL);
+    if (fd < 0) return;
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    // A client that connects and says nothing must not hold up supervision
+    char request[64];
+    ssize_t n = -1;
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    if (poll(&pfd, 1, CONTROL_TIMEOUT_MS) == 1) n = read(fd, request, sizeof(request) - 1);
+
+    const char *reply = "failed";
+    char action[16], name[32];
+    if (n > 0) {
+        request[n] = '\0';
+        if (sscanf(request, "%15s %31s", action, name) == 2) {
+            Supervised *s = find_supervised(sv, name);
+            if (!s || s->state == SUPERVISOR_MISSING) reply = "unmanaged";
+            else if (strcmp(action, "start") == 0) reply = control_start(sv, s);
+            else if (strcmp(action, "stop") == 0) reply = control_stop(sv, s);
+        }
+    }
+
+    ssize_t ret = write(fd, reply, strlen(reply));
+    (void)ret;  // The client may have given up
+    close(fd);
+}
+
+int supervisor_control(const char *name, int start) {
+    struct sockaddr_un addr;
+    if (control_address(&addr) != 0) return 1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return 1;  // No supervisor
+    }
+
+    char request[64];
+    int len = snprintf(request, sizeof(request), "%s %s", start ? "start" : "stop", name);
+    char reply[16] = "";
+    ssize_t n = -1;
+    if (write(fd, request, (size_t)len) == len) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, CONTROL_TIMEOUT_MS * 2) == 1) n = read(fd, reply, sizeof(reply) - 1);
+    }
+    close(fd);
+
+    if (n <= 0) return -1;
+    reply[n] = '\0';
+    if (strcmp(reply, "ok") == 0) return 0;
+    return strcmp(reply, "unmanaged") == 0 ? 1 : -1;
+}
+
+static void stop_all(Supervisor *sv) {
+    for (int i = 0; i < sv->count; i++) {
+        Supervised *s = &sv->items[i];
+        if (s->state == SUPERVISOR_RUNNING && s->pid > 0 && !s->adopted) {
+            kill(s->pid, SIGTERM);
+        }
+    }
+
+    // Give children a moment to exit, then reap
+    double deadline = proc_now_ms() + 2000;
+    int remaining = 1;
+    while (remaining && proc_now_ms() < deadline) {
+        remaining = 0;
+        for (int i = 0; i < sv->count; i++) {
+            Supervised *s = &sv->items[i];
+            if (s->pid > 0 && !s->adopted) {
+                if (waitpid(s->pid, NULL, WNOHANG) == s->pid) s->pid = 0;
+                else remaining = 1;
+            }
+        }
+        if (remaining) usleep(50000);
+    }
+}
+
+static void start_all(Supervisor *sv) {
+    int lazy = sv->lazy = lazy_enabled();
+    lazy_sync_dbus(lazy);
+
+    for (int i = 0; session_components[i].name && sv->count < MAX_SUPERVISED; i++) {
+        const SessionComponent *c = &session_components[i];
+        if (!c->command) continue;
+
+        Supervised *s = &sv->items[sv->count++];
+        memset(s, 0, sizeof(*s));
+        s->component = c;
+        s->pidfd = -1;
+
+        if (!is_installed(c)) {
+            s->state = SUPERVISOR_MISSING;
+            continue;
+        }
+
+        // Already running (WM restart, second login script): adopt it
+        pid_t pid;
+        if (components_find_pids(c, &pid, 1) == 1) {
+            adopt(s, pid);
+            print_info("%s already running (pid %ld); adopted", c->name, (long)pid);
+            continue;
+        }
+
+        if (lazy && c->activation == ACTIVATE_DBUS) {
+            s->state = SUPERVISOR_ON_DEMAND;
+            continue;
+        }
+        if (lazy && c->activation == ACTIVATE_DEFERRED) {
+            s->state = SUPERVISOR_WAITING;
+            s->restart_at = proc_now_ms() + LAZY_DEFER_MS;
+            continue;
+        }
+        if (lazy && !lazy_ready(c)) {
+            s->state = SUPERVISOR_WAITING;
+            if (sv->ueventfd < 0) sv->ueventfd = uevent_open();
+            continue;
+        }
+
+        if (spawn(s) != 0) {
+            print_error("Failed to start %s", c->name);
+            s->state = SUPERVISOR_FAILED;
+        }
+    }
+
+    arm_timer(sv);
+}
+
+int supervisor_run(void) {
+    // One supervisor per session
+    char *lock_path = config_get_runtime_path(SUPERVISOR_LOCK_FILE);
+    int lock_fd = lock_path ? open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600) : -1;
+    free(lock_path);
+    if (lock_fd < 0) return 1;
+    if (flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        print_info("Session supervisor already running");
+        close(lock_fd);
+        return 0;
+    }
+
+    Supervisor *sv = calloc(1, sizeof(Supervisor));
+    if (!sv) return 1;
+
+    // Signals arrive as reads on a signalfd; nothing runs in handler context
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGHUP);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+
+    sv->sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    sv->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    sv->ueventfd = -1;
+    sv->controlfd = open_control();
+    if (sv->sigfd < 0 || sv->timerfd < 0) {
+        print_error("Cannot set up event handling: %s", strerror(errno));
+        free(sv);
+        return 1;
+    }
+
+    start_all(sv);
+    write_state(sv);
+
+    int stop = 0;
+    while (!stop) {
+        struct pollfd fds[MAX_SUPERVISED + 4];
+        int owners[MAX_SUPERVISED + 4];
+        int nfds = 0;
+
+        fds[nfds].fd = sv->sigfd;
+        fds[nfds++].events = POLLIN;
+        fds[nfds].fd = sv->timerfd;
+        fds[nfds++].events = POLLIN;
+        fds[nfds].fd = sv->ueventfd;  // poll() skips negative fds
+        fds[nfds++].events = POLLIN;
+        fds[nfds].fd = sv->controlfd;
+        fds[nfds++].events = POLLIN;
+        for (int i = 0; i < sv->count; i++) {
+            if (sv->items[i].pidfd >= 0) {
+                owners[nfds] = i;
+                fds[nfds].fd = sv->items[i].pidfd;
+                fds[nfds++].events = POLLIN;
+            }
+        }
+
+        // Sleeps until a child exits, a backoff expires or we're told to stop
+        if (poll(fds, (nfds_t)nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            stop = drain_signals(sv);
+            reap_children(sv);
+        }
+
+        if (fds[1].revents & POLLIN) {
+            restart_due(sv);
+        }
+
+        if (fds[2].revents & POLLIN) {
+            handle_uevents(sv);
+        }
+
+        if (fds[3].revents & POLLIN) {
+            handle_control(sv);
+        }
+
+        for (int f = 4; f < nfds; f++) {
+            if (fds[f].revents & (POLLIN | POLLHUP)) {
+                handle_exit(sv, &sv->items[owners[f]], 0, 0);
+            }
+        }
+    }
+
+    stop_all(sv);
+
+    char *state_path = config_get_runtime_path(SUPERVISOR_STATE_FILE);
+    if (state_path) unlink(state_path);
+    free(state_path);
+
+    struct sockaddr_un addr;
+    if (sv->controlfd >= 0 && control_address(&addr) == 0) unlink(addr.sun_path);
+    if (sv->controlfd >= 0) close(sv->controlfd);
+
+    close(sv->sigfd);
+    close(sv->timerfd);
+    if (sv->ueventfd >= 0) close(sv->ueventfd);
+    free(sv);
+    close(lock_fd);
+    return 0;
+}
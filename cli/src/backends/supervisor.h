@@ -0,0 +1,42 @@
+// cli/src/backends/supervisor.h
+#ifndef OPENDE_SUPERVISOR_H
+#define OPENDE_SUPERVISOR_H
+
+#include <sys/types.h>
+
+typedef enum {
+    SUPERVISOR_RUNNING,      // Started (or adopted) and alive
+    SUPERVISOR_BACKOFF,      // Crashed, waiting to restart
+    SUPERVISOR_FAILED,       // Hit the start limit; given up
+    SUPERVISOR_EXITED,       // Exited cleanly; not restarted
+    SUPERVISOR_MISSING,      // Not installed
+    SUPERVISOR_WAITING,      // Lazy start: waiting for its trigger
+    SUPERVISOR_ON_DEMAND,    // Lazy start: activated by the session bus
+    SUPERVISOR_STOPPED       // Stopped on request; not restarted
+} SupervisorState;
+
+// Per-component state published by the running supervisor
+typedef struct {
+    char name[32];
+    SupervisorState state;
+    pid_t pid;
+    int restarts;
+} SupervisorEntry;
+
+// Start every supervised session component and keep them alive until
+// SIGTERM/SIGINT. Returns immediately (0) if a supervisor already runs.
+int supervisor_run(void);
+
+// Read the running supervisor's state; returns entry count, -1 if none runs
+int supervisor_read_state(SupervisorEntry *entries, int max);
+
+const char *supervisor_state_name(SupervisorState state);
+
+// Have the running supervisor start or stop a component, so a deliberate
+// stop isn't restarted as a crash and a start stays supervised. A stop
+// returns once the process has been signalled, not when it has exited.
+// Returns 0 when done, 1 if no supervisor runs or it doesn't manage the
+// component, -1 if the request failed
+int supervisor_control(const char *name, int start);
+
+#endif
@@ -2,24 +2,51 @@
 #define _POSIX_C_SOURCE 200809L
 #include "tint2.h"
 #include "../util/config.h"
+#include "../util/liveness.h"
 #include "../util/output.h"
+#include "../util/proc.h"
+#include "components.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
 
 #define TINT2_CONFIG_NAME "tint2rc"
+#define TINT2_TRAY_SELECTION "_NET_SYSTEM_TRAY_S"
+#define TINT2_SYSTEM_CONFIG "/etc/xdg/tint2/tint2rc"
 
 int tint2_is_installed(void) {
     return system("which tint2 > /dev/null 2>&1") == 0;
 }
 
+static int find_tint2(pid_t *pids, int max) {
+    return components_find_pids(components_find("tint2"), pids, max);
+}
+
 int tint2_is_running(void) {
-    return system("pgrep -x tint2 > /dev/null 2>&1") == 0;
+    // When tint2 hosts the systray, the selection owner answers directly
+    pid_t owner = liveness_selection_owner_pid(TINT2_TRAY_SELECTION);
+    if (owner > 0) {
+        ProcStat st;
+        if (proc_read_stat(owner, &st) == 0 && strcmp(st.comm, "tint2") == 0) {
+            return 1;
+        }
+    }
+
+    pid_t pid;
+    return find_tint2(&pid, 1) > 0;
 }
 
 int tint2_reload(void) {
-    if (!tint2_is_running()) return 0;
-    return system("killall -SIGUSR1 tint2") == 0 ? 0 : -1;
+    pid_t pids[8];
+    int count = find_tint2(pids, 8);
+    int result = 0;
+
+    // Only the panels on this display
+    for (int i = 0; i < count; i++) {
+        if (kill(pids[i], SIGUSR1) != 0) result = -1;
+    }
+    return result;
 }
 
 static char *get_config_path(void) {
@@ -34,45 +61,61 @@ static char *get_config_path(void) {
     snprintf(path, len, "%s/.config/tint2/tint2rc", home);
 
     if (!config_file_exists(path)) {
-        // Try to copy from system location if exists
-        config_ensure_dir(path);
-        char cmd[512];
-        snprintf(cmd, sizeof(cmd),
-                 "[ -f /etc/xdg/tint2/tint2rc ] && cp /etc/xdg/tint2/tint2rc '%s'",
-                 path);
-        int ret = system(cmd);
-        (void)ret;  // Best effort, ignore result
+        // Try to copy from system location if exists (best effort)
+        char *text = config_read_file(TINT2_SYSTEM_CONFIG);
+        if (text && config_ensure_dir(path) == 0) config_create_file(path, text);
+        free(text);
     }
 
     return path;
 }
 
-char *tint2_get_position(void) {
+// Value of `key = value` in tint2rc, or NULL
+static char *read_option(const char *key) {
     char *config = get_config_path();
-    if (!config) return NULL;
+    char *text = config ? config_read_file(config) : NULL;
+    free(config);
+    if (!text) return NULL;
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "grep -E '^panel_position\\s*=' '%s' 2>/dev/null | head -1", config);
+    char *value = config_text_get(text, key);
+    free(text);
+    return value;
+}
 
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        free(config);
-        return NULL;
-    }
+typedef struct {
+    const char *key;
+    const char *value;
+} OptionEdit;
 
-    char line[256];
+static char *edit_option(const char *text, void *data) {
+    const OptionEdit *edit = data;
+    return config_text_set(text, edit->key, edit->value);
+}
+
+// Set one option (compare-and-swap, so parallel writers don't lose
+// updates) and reload the panels
+static int write_option(const char *key, const char *value) {
+    char *config = get_config_path();
+    if (!config) return -1;
+
+    OptionEdit edit = { key, value };
+    int result = config_update_file(config, edit_option, &edit);
+    free(config);
+
+    if (result == 0) tint2_reload();
+    return result;
+}
+
+char *tint2_get_position(void) {
+    char *value = read_option("panel_position");
     char *result = NULL;
-    if (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "bottom")) {
-            result = strdup("bottom");
-        } else if (strstr(line, "top")) {
-            result = strdup("top");
-        }
+    if (value && strstr(value, "bottom")) {
+        result = strdup("bottom");
+    } else if (value && strstr(value, "top")) {
+        result = strdup("top");
     }
 
-    pclose(fp);
-    free(config);
+    free(value);
     return result ? result : strdup("unknown");
 }
 
@@ -82,86 +125,32 @@ int tint2_set_position(const char *position) {
         return -1;
     }
 
-    char *config = get_config_path();
-    if (!config) return -1;
-
     // tint2 panel_position format: "bottom center horizontal"
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "sed -i 's/^panel_position\\s*=.*/panel_position = %s center horizontal/' '%s'",
-             position, config);
-
-    int result = system(cmd);
-    free(config);
-
-    if (result == 0) tint2_reload();
-    return result == 0 ? 0 : -1;
+    char value[64];
+    snprintf(value, sizeof(value), "%s center horizontal", position);
+    return write_option("panel_position", value);
 }
 
 int tint2_get_autohide(void) {
-    char *config = get_config_path();
-    if (!config) return -1;
+    char *value = read_option("autohide");
+    if (!value) return -1;
 
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "grep -E '^autohide\\s*=' '%s' 2>/dev/null | head -1", config);
-
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        free(config);
-        return -1;
-    }
-
-    char line[256];
-    int result = -1;
-    if (fgets(line, sizeof(line), fp)) {
-        result = (strstr(line, "1") != NULL) ? 1 : 0;
-    }
-
-    pclose(fp);
-    free(config);
+    int result = atoi(value) != 0 ? 1 : 0;
+    free(value);
     return result;
 }
 
 int tint2_set_autohide(int enabled) {
-    char *config = get_config_path();
-    if (!config) return -1;
-
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "sed -i 's/^autohide\\s*=.*/autohide = %d/' '%s'",
-             enabled ? 1 : 0, config);
-
-    int result = system(cmd);
-    free(config);
-
-    if (result == 0) tint2_reload();
-    return result == 0 ? 0 : -1;
+    return write_option("autohide", enabled ? "1" : "0");
 }
 
 int tint2_get_systray(void) {
-    char *config = get_config_path();
-    if (!config) return -1;
-
     // Check if systray is in panel_items
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-             "grep -E '^panel_items\\s*=' '%s' 2>/dev/null | head -1", config);
-
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        free(config);
-        return -1;
-    }
+    char *value = read_option("panel_items");
+    if (!value) return -1;
 
-    char line[256];
-    int result = -1;
-    if (fgets(line, sizeof(line), fp)) {
-        result = (strstr(line, "S") != NULL) ? 1 : 0;  // S = systray
-    }
-
-    pclose(fp);
-    free(config);
+    int result = strchr(value, 'S') != NULL ? 1 : 0;  // S = systray
+    free(value);
     return result;
 }
 
@@ -174,7 +163,7 @@ int tint2_set_systray(int enabled) {
     // This is tricky - need to add/remove 'S' from panel_items
     // For now, just warn that manual edit is needed
     print_warn("Systray toggle requires manual edit of %s", config);
-    printf("Look for 'panel_items' line and add/remove 'S'\n");
+    print_line("Look for 'panel_items' line and add/remove 'S'");
 
     free(config);
     return -1;
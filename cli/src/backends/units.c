@@ -0,0 +1,406 @@
+// cli/src/backends/units.c
+#define _DEFAULT_SOURCE
+#include "units.h"
+#include "autostart.h"
+#include "components.h"
+#include "lazy.h"
+#include "../util/config.h"
+#include "../util/desktop.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#define GENERATED_MARK "# Generated by opende session install-units"
+#define MAX_AUTOSTART 64
+
+// Built-in limits and ordering. Applets are cheap and must never starve
+// the compositor or panel; a leak in one hits its own MemoryMax.
+typedef struct {
+    const char *name;
+    const char *memory_max;
+    int cpu_weight;
+    int io_weight;
+    const char *after;       // Component to start after (Wants= + After=)
+    int reload_usr1;         // Reloads its config on SIGUSR1
+} UnitDefaults;
+
+static const UnitDefaults unit_defaults[] = {
+    { "picom",          "512M", 200, 100, NULL,    1 },
+    { "dunst",          "128M", 100, 100, NULL,    0 },
+    { "lxpolkit",       "128M", 100, 100, NULL,    0 },
+    { "nm-applet",      "128M",  50,  50, "tint2", 0 },
+    { "pasystray",      "128M",  50,  50, "tint2", 0 },
+    { "blueman-applet", "192M",  50,  50, "tint2", 0 },
+    { "pcmanfm",        "256M",  50, 100, NULL,    0 },
+    { "tint2",          "128M", 150, 100, "picom", 1 },  // ARGB visual needs the compositor
+    { UNITS_AUTOSTART,  "512M", 100, 100, NULL,    0 },
+    { NULL, NULL, 0, 0, NULL, 0 }
+};
+
+static const UnitDefaults *find_defaults(const char *name) {
+    for (int i = 0; unit_defaults[i].name; i++) {
+        if (strcmp(unit_defaults[i].name, name) == 0) return &unit_defaults[i];
+    }
+    return NULL;
+}
+
+static int valid_memory(const char *value) {
+    if (strcmp(value, "infinity") == 0) return 1;
+
+    char *end;
+    if (strtol(value, &end, 10) <= 0 || end == value) return 0;
+    return *end == '\0' || (strchr("KMGT", toupper((unsigned char)*end)) && end[1] == '\0');
+}
+
+int units_get_limits(const char *name, UnitLimits *limits) {
+    const UnitDefaults *d = find_defaults(name);
+    if (!d) return -1;
+
+    char key[64];
+    snprintf(key, sizeof(key), "units.%s.memory_max", name);
+    char *mem = config_get_setting(key);
+    snprintf(limits->memory_max, sizeof(limits->memory_max), "%s",
+             mem && valid_memory(mem) ? mem : d->memory_max);
+    free(mem);
+
+    snprintf(key, sizeof(key), "units.%s.cpu_weight", name);
+    limits->cpu_weight = config_get_setting_int(key, d->cpu_weight);
+    snprintf(key, sizeof(key), "units.%s.io_weight", name);
+    limits->io_weight = config_get_setting_int(key, d->io_weight);
+    return 0;
+}
+
+int units_set_limit(const char *name, const char *limit, const char *value) {
+    if (!find_defaults(name)) return -1;
+
+    const char *setting;
+    if (strcmp(limit, "memory-max") == 0) {
+        if (!valid_memory(value)) return -1;
+        setting = "memory_max";
+    } else if (strcmp(limit, "cpu-weight") == 0 || strcmp(limit, "io-weight") == 0) {
+        char *end;
+        long w = strtol(value, &end, 10);
+        if (*end || w < 1 || w > 10000) return -1;
+        setting = limit[0] == 'c' ? "cpu_weight" : "io_weight";
+    } else {
+        return -1;
+    }
+
+    char key[64];
+    snprintf(key, sizeof(key), "units.%s.%s", name, setting);
+    return config_set_setting(key, value);
+}
+
+char *units_dir(void) {
+    const char *config_home = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    char dir[512];
+
+    if (config_home && *config_home) snprintf(dir, sizeof(dir), "%s/systemd/user", config_home);
+    else if (home) snprintf(dir, sizeof(dir), "%s/.config/systemd/user", home);
+    else return NULL;
+
+    return strdup(dir);
+}
+
+int units_control(const char *name, int start) {
+    char *dir = units_dir();
+    if (!dir) return 1;
+
+    char path[768];
+    snprintf(path, sizeof(path), "%s/opende-%s.service", dir, name);
+    free(dir);
+    if (!config_file_exists(path) ||
+        system("systemctl --user is-active --quiet " UNITS_TARGET " 2>/dev/null") != 0) {
+        return 1;  // The session isn't running on the units
+    }
+
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "systemctl --user %s opende-%s.service > /dev/null 2>&1",
+             start ? "start" : "stop", name);
+    return system(cmd) == 0 ? 0 : -1;
+}
+
+// One ExecStart word. systemd expands % specifiers and $VARS; keep them
+// literal, and quote words that would otherwise be split or unescaped.
+static void append_arg(FILE *fp, const char *arg) {
+    int quote = !*arg || strpbrk(arg, " \t\n\"'\\;") != NULL;
+    if (quote) fputc('"', fp);
+    for (const char *s = arg; *s; s++) {
+        if (*s == '%') fputs("%%", fp);
+        else if (*s == '$') fputs("$$", fp);
+        else if (*s == '\n') fputs("\\n", fp);
+        else if (quote && (*s == '"' || *s == '\\')) fprintf(fp, "\\%c", *s);
+        else fputc(*s, fp);
+    }
+    if (quote) fputc('"', fp);
+}
+
+static int write_unit(const char *dir, const char *unit, char *content) {
+    char path[768];
+    snprintf(path, sizeof(path), "%s/%s", dir, unit);
+    int result = config_write_file(path, content);
+    if (result != 0) print_error("Cannot write %s", path);
+    free(content);
+    return result;
+}
+
+// argv[0] must be an absolute path
+static char *format_service(const char *description, char *const *argv,
+                            const UnitLimits *limits,
+                            const UnitDefaults *d, int restart, const char *condition,
+                            const char *service_extra) {
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buf, &size);
+    if (!fp) return NULL;
+
+    fprintf(fp, GENERATED_MARK "\n[Unit]\nDescription=%s\n", description);
+    fprintf(fp, "PartOf=" UNITS_TARGET "\nAfter=graphical-session-pre.target\n");
+    if (d->after) {
+        fprintf(fp, "Wants=opende-%s.service\nAfter=opende-%s.service\n", d->after, d->after);
+    }
+    if (condition) fprintf(fp, "%s\n", condition);
+    if (restart) {
+        // Same crash-loop guard as the session supervisor
+        fprintf(fp, "StartLimitIntervalSec=60\nStartLimitBurst=5\n");
+    }
+
+    fprintf(fp, "\n[Service]\nType=simple\nSlice=" UNITS_SLICE "\nExecStart=");
+    for (int i = 0; argv[i]; i++) {
+        if (i > 0) fputc(' ', fp);
+        append_arg(fp, argv[i]);
+    }
+    fputc('\n', fp);
+    if (d->reload_usr1) fprintf(fp, "ExecReload=/bin/kill -USR1 $MAINPID\n");
+    if (service_extra) fprintf(fp, "%s\n", service_extra);
+    if (restart) fprintf(fp, "Restart=on-failure\nRestartSec=2\n");
+
+    // Applications launched from the panel or file manager must outlive
+    // a restart of their parent
+    fprintf(fp, "KillMode=process\n");
+    fprintf(fp, "MemoryMax=%s\nCPUWeight=%d\nIOWeight=%d\n",
+            limits->memory_max, limits->cpu_weight, limits->io_weight);
+
+    fprintf(fp, "\n[Install]\nWantedBy=" UNITS_TARGET "\n");
+    fclose(fp);
+    return buf;
+}
+
+// Unit names allow [A-Za-z0-9:_.-]
+static void unit_name_for(const char *id, char *out, size_t size) {
+    size_t len = 0;
+    len += (size_t)snprintf(out, size, "opende-autostart-");
+    for (const char *p = id; *p && len + 1 < size; p++) {
+        if (strcmp(p, ".desktop") == 0) break;
+        out[len++] = (isalnum((unsigned char)*p) || strchr(":_.-", *p)) ? *p : '_';
+    }
+    snprintf(out + len, size - len, ".service");
+}
+
+static int is_written(char names[][128], int count, const char *name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+// Remove generated units from a previous install that no longer apply
+static void remove_stale(const char *dir, char names[][128], int count) {
+    DIR *dp = opendir(dir);
+    if (!dp) return;
+
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (strncmp(de->d_name, "opende-", 7) != 0 || is_written(names, count, de->d_name)) continue;
+
+        char path[768];
+        snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        char *text = config_read_file(path);
+        if (text && strncmp(text, GENERATED_MARK, strlen(GENERATED_MARK)) == 0) {
+            unlink(path);
+        }
+        free(text);
+    }
+    closedir(dp);
+}
+
+// The opende executable units run placeholder commands through: the one
+// on PATH, or this one if it isn't installed
+static char *launcher_path(void) {
+    char *path = desktop_find_executable("opende");
+    if (path && path[0] == '/') return path;
+    free(path);
+
+    char self[512];
+    ssize_t len = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (len <= 0) return NULL;
+    self[len] = '\0';
+    return strdup(self);
+}
+
+int units_install(void) {
+    char *dir = units_dir();
+    if (!dir) return -1;
+
+    char probe[768];
+    snprintf(probe, sizeof(probe), "%s/" UNITS_TARGET, dir);
+    if (config_ensure_dir(probe) != 0) {
+        print_error("Cannot create %s", dir);
+        free(dir);
+        return -1;
+    }
+
+    char *launcher = launcher_path();
+    static char names[MAX_AUTOSTART + 32][128];
+    int written = 0;
+    char wants[4096] = "";
+    size_t wants_len = 0;
+
+    // Session components
+    for (int i = 0; session_components[i].name; i++) {
+        const SessionComponent *c = &session_components[i];
+        const UnitDefaults *d = find_defaults(c->name);
+        if (!c->command || !d) continue;
+
+        char *argv[16];
+        int argc = components_build_argv(c, argv, 16);
+        char *exec = argc > 0 ? desktop_find_executable(argv[0]) : NULL;
+        if (!exec) {
+            if (argc > 0) components_free_argv(argv);
+            continue;  // Not installed
+        }
+
+        // Placeholders such as {picom-config} name whatever file is current
+        // when the component starts, so `opende session exec` expands them
+        // at launch instead of the unit carrying today's path
+        char *launch[] = { launcher, "session", "exec", (char *)c->name, NULL };
+        int deferred = strchr(c->command, '{') != NULL;
+        if (deferred && !launcher) {
+            print_warn("Cannot find the opende executable; skipping %s", c->name);
+            components_free_argv(argv);
+            free(exec);
+            continue;
+        }
+        free(argv[0]);
+        argv[0] = exec;  // systemd needs an absolute path
+
+        UnitLimits limits;
+        units_get_limits(c->name, &limits);
+
+        char description[128];
+        snprintf(description, sizeof(description), "%s for OpenDE", c->name);
+        // Lazy start: the bus activates the unit, and the Bluetooth applet
+        // is skipped on machines without an adapter
+        int lazy = lazy_enabled();
+        const char *condition = lazy && c->activation == ACTIVATE_BLUETOOTH ?
+                                "ConditionPathExistsGlob=/sys/class/bluetooth/hci*" : NULL;
+        char *content = format_service(description, deferred ? launch : argv, &limits, d, 1,
+                                       condition, NULL);
+        components_free_argv(argv);
+
+        snprintf(names[written], sizeof(names[0]), "opende-%s.service", c->name);
+        if (!content || write_unit(dir, names[written], content) != 0) {
+            free(launcher);
+            free(dir);
+            return -1;
+        }
+        if (lazy && c->activation == ACTIVATE_DBUS) {
+            written++;
+            continue;
+        }
+        wants_len += (size_t)snprintf(wants + wants_len, sizeof(wants) - wants_len, " %s", names[written]);
+        written++;
+    }
+    free(launcher);
+
+    // XDG autostart entries, filtered the same way as `opende session autostart`
+    static AutostartItem items[MAX_AUTOSTART];
+    int count = autostart_collect(items, MAX_AUTOSTART);
+    const UnitDefaults *autostart = find_defaults(UNITS_AUTOSTART);
+    UnitLimits autostart_limits;
+    units_get_limits(UNITS_AUTOSTART, &autostart_limits);
+
+    // Low-priority entries can't wait for idle under systemd, but they
+    // can at least yield the CPU and disk
+    char low_priority[128];
+    snprintf(low_priority, sizeof(low_priority),
+             "Nice=%d\nIOSchedulingClass=best-effort\nIOSchedulingPriority=7",
+             config_get_setting_int("autostart.nice", 10));
+
+    for (int i = 0; i < count && wants_len < sizeof(wants); i++) {
+        const DesktopEntry *e = &items[i].entry;
+        if (items[i].plan == AUTOSTART_SKIP) continue;
+
+        // Split with the Desktop Entry quoting rules; each word is re-quoted
+        // for systemd by format_service
+        char *argv[64];
+        if (desktop_exec_argv(e->exec, argv, 64) < 1) continue;
+        char *exec = desktop_find_executable(argv[0]);
+        if (!exec) {
+            desktop_free_argv(argv);
+            continue;
+        }
+        free(argv[0]);
+        argv[0] = exec;
+
+        char description[192];
+        snprintf(description, sizeof(description), "%.150s (autostart)", e->name[0] ? e->name : e->id);
+        char *content = format_service(description, argv, &autostart_limits, autostart, 0, NULL,
+                                       items[i].plan == AUTOSTART_IDLE ? low_priority : NULL);
+        desktop_free_argv(argv);
+
+        unit_name_for(e->id, names[written], sizeof(names[0]));
+        if (!content || write_unit(dir, names[written], content) != 0) {
+            free(dir);
+            return -1;
+        }
+        wants_len += (size_t)snprintf(wants + wants_len, sizeof(wants) - wants_len, " %s", names[written]);
+        written++;
+    }
+
+    // Slice and target tie everything together
+    char *content = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&content, &size);
+    if (!fp) {
+        free(dir);
+        return -1;
+    }
+    fprintf(fp, GENERATED_MARK "\n[Unit]\nDescription=OpenDE session components\n"
+                "Before=slices.target\n\n[Slice]\n");
+    fclose(fp);
+    snprintf(names[written], sizeof(names[0]), UNITS_SLICE);
+    if (write_unit(dir, names[written++], content) != 0) {
+        free(dir);
+        return -1;
+    }
+
+    content = NULL;
+    fp = open_memstream(&content, &size);
+    if (!fp) {
+        free(dir);
+        return -1;
+    }
+    // Wants= rather than Requires=: one missing applet must not hold up
+    // the rest, and nothing is ordered after anything it doesn't need
+    fprintf(fp, GENERATED_MARK "\n[Unit]\nDescription=OpenDE session\n"
+                "PartOf=graphical-session.target\nWants=%s\n", wants + (wants_len ? 1 : 0));
+    fclose(fp);
+    snprintf(names[written], sizeof(names[0]), UNITS_TARGET);
+    if (write_unit(dir, names[written++], content) != 0) {
+        free(dir);
+        return -1;
+    }
+
+    remove_stale(dir, names, written);
+    free(dir);
+
+    // Point bus activation at the new units
+    if (lazy_enabled()) lazy_sync_dbus(1);
+    return written - 2;
+}
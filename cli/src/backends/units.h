@@ -0,0 +1,40 @@
+// cli/src/backends/units.h
+#ifndef OPENDE_UNITS_H
+#define OPENDE_UNITS_H
+
+// Generated systemd user units: one service per session component and
+// autostart entry, all in opende.slice, pulled in by opende-session.target
+
+#define UNITS_TARGET "opende-session.target"
+#define UNITS_SLICE  "opende.slice"
+
+// Name used for the limits shared by every autostart entry
+#define UNITS_AUTOSTART "autostart"
+
+typedef struct {
+    char memory_max[16];     // e.g. "256M", or "infinity"
+    int cpu_weight;          // 1-10000, systemd default 100
+    int io_weight;           // 1-10000, systemd default 100
+} UnitLimits;
+
+// Effective limits for a component (or UNITS_AUTOSTART): settings
+// override built-in defaults. Returns 0, or -1 if the name is unknown.
+int units_get_limits(const char *name, UnitLimits *limits);
+
+// Store one limit ("memory-max", "cpu-weight" or "io-weight") in settings
+// Returns 0 on success, -1 on invalid name/value
+int units_set_limit(const char *name, const char *limit, const char *value);
+
+// Write all units to ~/.config/systemd/user, removing stale generated ones
+// Returns number of services written, -1 on error
+int units_install(void);
+
+// Start or stop a component's unit, when the session was started from the
+// units. Returns 0 when done, 1 if the session doesn't use them, -1 if
+// systemctl failed
+int units_control(const char *name, int start);
+
+// Directory the units are written to (caller must free)
+char *units_dir(void);
+
+#endif
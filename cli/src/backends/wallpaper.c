@@ -0,0 +1,482 @@
+// cli/src/backends/wallpaper.c
+#define _DEFAULT_SOURCE
+#include "wallpaper.h"
+#include "../util/config.h"
+#include "../util/image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+#define CACHE_MAGIC "OPENDEWP"
+#define CACHE_KEEP 4             // Copies kept, e.g. docked and undocked geometries
+#define NITROGEN_CONFIG ".config/nitrogen/bg-saved.cfg"
+
+// Cache file: header followed by width * height host-endian 0x00RRGGBB words
+typedef struct {
+    char magic[8];
+    uint32_t width;
+    uint32_t height;
+} CacheHeader;
+
+static const char *mode_names[] = {
+    [WALLPAPER_FILL]    = "fill",
+    [WALLPAPER_FIT]     = "fit",
+    [WALLPAPER_CENTER]  = "center",
+    [WALLPAPER_STRETCH] = "stretch",
+    [WALLPAPER_TILE]    = "tile",
+};
+
+const char *wallpaper_mode_name(WallpaperMode mode) {
+    return mode_names[mode];
+}
+
+int wallpaper_mode_parse(const char *name) {
+    for (int i = 0; i <= WALLPAPER_TILE; i++) {
+        if (strcmp(mode_names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+static uint32_t parse_color(const char *text, uint32_t def) {
+    if (!text || text[0] != '#' || strlen(text) != 7) return def;
+    char *end;
+    unsigned long value = strtoul(text + 1, &end, 16);
+    return *end ? def : (uint32_t)value;
+}
+
+// nitrogen's bg-saved.cfg: the first head's file=, mode= and bgcolor=
+static int nitrogen_config(WallpaperConfig *config) {
+    const char *home = getenv("HOME");
+    if (!home) return -1;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/" NITROGEN_CONFIG, home);
+    char *text = config_read_file(path);
+    if (!text) return -1;
+
+    // nitrogen modes: 0 scaled, 1 tiled, 2 centered, 3 zoom, 4 auto, 5 zoom-fill
+    static const WallpaperMode nitrogen_modes[] = {
+        WALLPAPER_STRETCH, WALLPAPER_TILE, WALLPAPER_CENTER,
+        WALLPAPER_FIT, WALLPAPER_FIT, WALLPAPER_FILL
+    };
+
+    int sections = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        if (line[0] == '[' && ++sections > 1) break;
+
+        if (strncmp(line, "file=", 5) == 0) {
+            snprintf(config->image, sizeof(config->image), "%s", line + 5);
+        } else if (strncmp(line, "mode=", 5) == 0) {
+            int mode = atoi(line + 5);
+            if (mode >= 0 && mode <= 5) config->mode = nitrogen_modes[mode];
+        } else if (strncmp(line, "bgcolor=", 8) == 0) {
+            config->color = parse_color(line + 8, config->color);
+        }
+    }
+
+    free(text);
+    return config->image[0] ? 0 : -1;
+}
+
+int wallpaper_get_config(WallpaperConfig *config) {
+    memset(config, 0, sizeof(*config));
+    config->mode = WALLPAPER_FILL;
+
+    char *image = config_get_setting("wallpaper.image");
+    if (!image) return nitrogen_config(config);
+
+    snprintf(config->image, sizeof(config->image), "%s", image);
+    free(image);
+
+    char *mode = config_get_setting("wallpaper.mode");
+    if (mode && wallpaper_mode_parse(mode) >= 0) config->mode = (WallpaperMode)wallpaper_mode_parse(mode);
+    free(mode);
+
+    char *color = config_get_setting("wallpaper.color");
+    config->color = parse_color(color, 0);
+    free(color);
+    return 0;
+}
+
+char *wallpaper_cache_dir(void) {
+    const char *cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    char dir[512];
+
+    if (cache && *cache) snprintf(dir, sizeof(dir), "%s/opende/wallpaper", cache);
+    else if (home) snprintf(dir, sizeof(dir), "%s/.cache/opende/wallpaper", home);
+    else return NULL;
+
+    return strdup(dir);
+}
+
+// FNV-1a over the file contents
+static int hash_file(const char *path, uint64_t *hash) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+
+    unsigned char buf[65536];
+    size_t n;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            h ^= buf[i];
+            h *= 0x100000001b3ULL;
+        }
+    }
+
+    int failed = ferror(fp);
+    fclose(fp);
+    if (failed) return -1;
+    *hash = h;
+    return 0;
+}
+
+// Content hash of the source. Re-hashing a large image on every login
+// would cost a full read, so the hash is remembered together with the
+// file's identity and only recomputed when that changes.
+static int source_hash(const char *path, char *out, size_t size) {
+    struct stat st;
+    char *saved_id = config_get_setting("wallpaper.source");
+    char *saved_hash = config_get_setting("wallpaper.hash");
+    char id[128] = "";
+    int result = -1;
+
+    if (stat(path, &st) == 0) {
+        snprintf(id, sizeof(id), "%lu:%lu:%lld:%lld.%09ld",
+                 (unsigned long)st.st_dev, (unsigned long)st.st_ino, (long long)st.st_size,
+                 (long long)st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    }
+
+    if (saved_hash && saved_id && (!id[0] || strcmp(id, saved_id) == 0)) {
+        // Unchanged, or not reachable right now (unmounted share): trust the cache
+        snprintf(out, size, "%s", saved_hash);
+        result = 0;
+    } else if (id[0]) {
+        uint64_t hash;
+        if (hash_file(path, &hash) == 0) {
+            snprintf(out, size, "%016llx", (unsigned long long)hash);
+            config_set_setting("wallpaper.source", id);
+            config_set_setting("wallpaper.hash", out);
+            result = 0;
+        }
+    }
+
+    free(saved_id);
+    free(saved_hash);
+    return result;
+}
+
+// Largest JPEG shrink that still leaves at least the resolution we need
+static int choose_shrink(const WallpaperConfig *config, int w, int h, int sw, int sh) {
+    double sx = (double)w / sw, sy = (double)h / sh;
+    double limit;
+
+    switch (config->mode) {
+        case WALLPAPER_FILL:    limit = sx < sy ? sx : sy; break;
+        case WALLPAPER_FIT:     limit = sx > sy ? sx : sy; break;
+        case WALLPAPER_STRETCH: limit = sx < sy ? sx : sy; break;
+        default:                limit = 1; break;
+    }
+
+    int shrink = 1;
+    while (shrink < 8 && shrink * 2 <= limit) shrink *= 2;
+    return shrink;
+}
+
+static void blit(const Image *src, Image *dst, int dx, int dy) {
+    for (int y = 0; y < src->height; y++) {
+        int ty = dy + y;
+        if (ty < 0 || ty >= dst->height) continue;
+        for (int x = 0; x < src->width; x++) {
+            int tx = dx + x;
+            if (tx >= 0 && tx < dst->width) {
+                dst->pixels[(size_t)ty * (size_t)dst->width + (size_t)tx] =
+                    src->pixels[(size_t)y * (size_t)src->width + (size_t)x];
+            }
+        }
+    }
+}
+
+static int render(const WallpaperConfig *config, int sw, int sh, Image *out) {
+    int w, h;
+    if (image_probe(config->image, &w, &h) != 0) return -1;
+
+    Image src;
+    if (image_load(config->image, choose_shrink(config, w, h, sw, sh), &src) != 0) return -1;
+    w = src.width;
+    h = src.height;
+
+    int result = 0;
+    if (config->mode == WALLPAPER_STRETCH) {
+        result = image_scale(&src, 0, 0, w, h, sw, sh, out);
+    } else if (config->mode == WALLPAPER_FILL) {
+        // Crop the source to the screen's aspect ratio, centered
+        int cw = w, ch = h;
+        if ((double)w / h > (double)sw / sh) cw = (int)((double)h * sw / sh + 0.5);
+        else ch = (int)((double)w * sh / sw + 0.5);
+        if (cw < 1) cw = 1;
+        if (ch < 1) ch = 1;
+        result = image_scale(&src, (w - cw) / 2, (h - ch) / 2, cw, ch, sw, sh, out);
+    } else if (image_new(sw, sh, config->color, out) != 0) {
+        result = -1;
+    } else if (config->mode == WALLPAPER_FIT) {
+        double s = (double)sw / w < (double)sh / h ? (double)sw / w : (double)sh / h;
+        int fw = (int)(w * s + 0.5), fh = (int)(h * s + 0.5);
+        Image scaled;
+        if (image_scale(&src, 0, 0, w, h, fw > 0 ? fw : 1, fh > 0 ? fh : 1, &scaled) == 0) {
+            blit(&scaled, out, (sw - scaled.width) / 2, (sh - scaled.height) / 2);
+            image_free(&scaled);
+        } else {
+            result = -1;
+        }
+    } else if (config->mode == WALLPAPER_CENTER) {
+        blit(&src, out, (sw - w) / 2, (sh - h) / 2);
+    } else {
+        for (int y = 0; y < sh; y += h) {
+            for (int x = 0; x < sw; x += w) blit(&src, out, x, y);
+        }
+    }
+
+    image_free(&src);
+    if (result != 0) image_free(out);
+    return result;
+}
+
+static int write_cache(const char *path, const Image *image) {
+    char tmp[800];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    if (config_ensure_dir(path) != 0) return -1;
+
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) return -1;
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.width = (uint32_t)image->width;
+    header.height = (uint32_t)image->height;
+
+    size_t count = (size_t)image->width * (size_t)image->height;
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             fwrite(image->pixels, sizeof(uint32_t), count, fp) == count;
+    ok = fclose(fp) == 0 && ok;
+
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    char name[256];
+    time_t used;
+} CacheFile;
+
+static int newest_first(const void *a, const void *b) {
+    time_t ta = ((const CacheFile *)a)->used, tb = ((const CacheFile *)b)->used;
+    return ta < tb ? 1 : ta > tb ? -1 : 0;
+}
+
+// Keep the most recently used copies only
+static void prune_cache(const char *dir) {
+    DIR *dp = opendir(dir);
+    if (!dp) return;
+
+    CacheFile files[64];
+    int count = 0;
+    struct dirent *de;
+    while ((de = readdir(dp)) && count < 64) {
+        if (de->d_name[0] == '.') continue;
+        char path[800];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        if (stat(path, &st) != 0) continue;
+        snprintf(files[count].name, sizeof(files[count].name), "%s", de->d_name);
+        files[count++].used = st.st_mtime;
+    }
+    closedir(dp);
+
+    qsort(files, (size_t)count, sizeof(CacheFile), newest_first);
+    for (int i = CACHE_KEEP; i < count; i++) {
+        char path[800];
+        snprintf(path, sizeof(path), "%s/%s", dir, files[i].name);
+        unlink(path);
+    }
+}
+
+// Replace the root pixmap the way Esetroot does, so compositors and
+// pseudo-transparent clients pick it up, and free the previous one
+static void set_root_pixmap(Display *dpy, Window root, Pixmap pixmap) {
+    Atom xrootpmap = XInternAtom(dpy, "_XROOTPMAP_ID", False);
+    Atom esetroot = XInternAtom(dpy, "ESETROOT_PMAP_ID", False);
+
+    Atom type;
+    int format;
+    unsigned long items, after;
+    unsigned char *data = NULL;
+
+    XGrabServer(dpy);
+    if (XGetWindowProperty(dpy, root, esetroot, 0, 1, False, XA_PIXMAP, &type, &format,
+                           &items, &after, &data) == Success && type == XA_PIXMAP && data) {
+        Pixmap old = *(Pixmap *)data;
+        unsigned char *current = NULL;
+        if (XGetWindowProperty(dpy, root, xrootpmap, 0, 1, False, XA_PIXMAP, &type, &format,
+                               &items, &after, &current) == Success && type == XA_PIXMAP &&
+            current && *(Pixmap *)current == old) {
+            // Only kill it if it is still the live root pixmap we'd replace
+            XKillClient(dpy, old);
+        }
+        if (current) XFree(current);
+    }
+    if (data) XFree(data);
+
+    XChangeProperty(dpy, root, xrootpmap, XA_PIXMAP, 32, PropModeReplace,
+                    (unsigned char *)&pixmap, 1);
+    XChangeProperty(dpy, root, esetroot, XA_PIXMAP, 32, PropModeReplace,
+                    (unsigned char *)&pixmap, 1);
+    XSetWindowBackgroundPixmap(dpy, root, pixmap);
+    XClearWindow(dpy, root);
+    XUngrabServer(dpy);
+}
+
+static int upload(Display *dpy, int screen, uint32_t *pixels, int width, int height) {
+    Visual *visual = DefaultVisual(dpy, screen);
+    int depth = DefaultDepth(dpy, screen);
+    Window root = RootWindow(dpy, screen);
+
+    // The cache holds 0x00RRGGBB words: usable as-is on any 24/32-bit
+    // TrueColor visual with the usual masks, which is all we support
+    if ((depth != 24 && depth != 32) || visual->red_mask != 0xFF0000 ||
+        visual->green_mask != 0xFF00 || visual->blue_mask != 0xFF) {
+        return -1;
+    }
+
+    XImage *ximage = XCreateImage(dpy, visual, (unsigned int)depth, ZPixmap, 0, (char *)pixels,
+                                  (unsigned int)width, (unsigned int)height, 32, 0);
+    if (!ximage) return -1;
+
+    // Our words are host-endian; Xlib swaps if the server differs
+    uint32_t probe = 1;
+    ximage->byte_order = *(unsigned char *)&probe ? LSBFirst : MSBFirst;
+
+    Pixmap pixmap = XCreatePixmap(dpy, root, (unsigned int)width, (unsigned int)height,
+                                  (unsigned int)depth);
+    GC gc = XCreateGC(dpy, pixmap, 0, NULL);
+    XPutImage(dpy, pixmap, gc, ximage, 0, 0, 0, 0, (unsigned int)width, (unsigned int)height);
+    XFreeGC(dpy, gc);
+
+    ximage->data = NULL;  // Owned by the caller (possibly an mmap)
+    XDestroyImage(ximage);
+
+    set_root_pixmap(dpy, root, pixmap);
+
+    // Keep the pixmap after we disconnect
+    XSetCloseDownMode(dpy, RetainPermanent);
+    return 0;
+}
+
+static int apply_cached(Display *dpy, int screen, const char *path, int width, int height) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    size_t size = sizeof(CacheHeader) + (size_t)width * (size_t)height * sizeof(uint32_t);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != size) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const CacheHeader *header = map;
+    int result = -1;
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+        header->width == (uint32_t)width && header->height == (uint32_t)height) {
+        result = upload(dpy, screen, (uint32_t *)(header + 1), width, height);
+    }
+
+    munmap(map, size);
+
+    // Touch it so pruning keeps what is in use
+    if (result == 0) utimensat(AT_FDCWD, path, NULL, 0);
+    return result;
+}
+
+int wallpaper_apply(const WallpaperConfig *config, int *cache_hit) {
+    *cache_hit = 0;
+
+    char hash[32];
+    if (source_hash(config->image, hash, sizeof(hash)) != 0) return -1;
+
+    char *dir = wallpaper_cache_dir();
+    if (!dir) return -1;
+
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) {
+        free(dir);
+        return -1;
+    }
+
+    int screen = DefaultScreen(dpy);
+    int width = DisplayWidth(dpy, screen);
+    int height = DisplayHeight(dpy, screen);
+
+    // Keyed by source content, output geometry, mode and border color
+    char path[768];
+    snprintf(path, sizeof(path), "%s/%s-%dx%d-%s-%06x.raw", dir, hash, width, height,
+             wallpaper_mode_name(config->mode), (unsigned int)config->color);
+
+    int result = apply_cached(dpy, screen, path, width, height);
+    if (result == 0) {
+        *cache_hit = 1;
+    } else {
+        Image image;
+        result = render(config, width, height, &image);
+        if (result == 0) {
+            result = upload(dpy, screen, image.pixels, width, height);
+            write_cache(path, &image);
+            image_free(&image);
+            prune_cache(dir);
+        }
+    }
+
+    XCloseDisplay(dpy);
+    free(dir);
+    return result;
+}
+
+int wallpaper_clear_cache(void) {
+    char *dir = wallpaper_cache_dir();
+    if (!dir) return -1;
+
+    DIR *dp = opendir(dir);
+    if (!dp) {
+        free(dir);
+        return 0;
+    }
+
+    int removed = 0;
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (de->d_name[0] == '.') continue;
+        char path[800];
+        snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        if (unlink(path) == 0) removed++;
+    }
+
+    closedir(dp);
+    free(dir);
+    return removed;
+}
@@ -0,0 +1,41 @@
+// cli/src/backends/wallpaper.h
+#ifndef OPENDE_WALLPAPER_BACKEND_H
+#define OPENDE_WALLPAPER_BACKEND_H
+
+#include <stdint.h>
+
+typedef enum {
+    WALLPAPER_FILL,          // Scale to cover the screen, cropping the overflow
+    WALLPAPER_FIT,           // Scale to fit inside, bordered with the color
+    WALLPAPER_CENTER,        // Unscaled, centered
+    WALLPAPER_STRETCH,       // Scale to the screen, ignoring aspect ratio
+    WALLPAPER_TILE           // Unscaled, repeated from the top-left corner
+} WallpaperMode;
+
+typedef struct {
+    char image[512];
+    WallpaperMode mode;
+    uint32_t color;          // 0xRRGGBB background for fit/center
+} WallpaperConfig;
+
+const char *wallpaper_mode_name(WallpaperMode mode);
+
+// Returns the mode, or -1 if unknown
+int wallpaper_mode_parse(const char *name);
+
+// Current wallpaper from settings, falling back to nitrogen's saved one
+// Returns 0 on success, -1 if no wallpaper is configured
+int wallpaper_get_config(WallpaperConfig *config);
+
+// Set the root window background and _XROOTPMAP_ID/ESETROOT_PMAP_ID from
+// a display-resolution copy in the cache, rendering it first on a miss.
+// Returns 0 on success, -1 on error. *cache_hit tells which path ran.
+int wallpaper_apply(const WallpaperConfig *config, int *cache_hit);
+
+// Directory holding pre-scaled copies (caller must free)
+char *wallpaper_cache_dir(void);
+
+// Remove all cached copies. Returns number removed, -1 on error.
+int wallpaper_clear_cache(void);
+
+#endif
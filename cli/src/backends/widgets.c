@@ -0,0 +1,565 @@
+// cli/src/backends/widgets.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "widgets.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include "../util/snapshot.h"
+#include "../util/uevent.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <sound/asound.h>
+
+#define WIDGET_TEXT_MAX 256
+#define POWER_SUPPLY_DIR "/sys/class/power_supply"
+
+static void add_fd(WidgetState *state, int fd) {
+    if (state->fd_count < WIDGET_MAX_FDS) state->fds[state->fd_count++] = fd;
+}
+
+static void close_fds(WidgetState *state) {
+    for (int i = 0; i < state->fd_count; i++) close(state->fds[i]);
+    state->fd_count = 0;
+}
+
+// Re-read a sysfs or procfs file through an fd kept open
+static int read_fd(int fd, char *buf, size_t size) {
+    ssize_t len = pread(fd, buf, size - 1, 0);
+    if (len < 0) return -1;
+    buf[len] = '\0';
+    while (len > 0 && (buf[len - 1] == '\n' || buf[len - 1] == ' ')) buf[--len] = '\0';
+    return 0;
+}
+
+static void drain(int fd) {
+    char buf[4096];
+    while (read(fd, buf, sizeof(buf)) > 0) {}
+}
+
+// --- clock ----------------------------------------------------------------
+
+static int clock_period_s;
+
+// Arm an absolute timer on the next period boundary of the wall clock.
+// TFD_TIMER_CANCEL_ON_SET wakes us early if the clock is stepped.
+static int clock_arm(int fd) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = (now.tv_sec / clock_period_s + 1) * clock_period_s;
+    its.it_interval.tv_sec = clock_period_s;
+    return timerfd_settime(fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, NULL);
+}
+
+static int clock_open(WidgetState *state) {
+    if (!state->arg) state->arg = "%H:%M";
+
+    // Tick once a minute unless the format shows seconds
+    clock_period_s = 60;
+    static const char *second_formats[] = { "%S", "%T", "%s", "%r", "%X", "%c", NULL };
+    for (int i = 0; second_formats[i]; i++) {
+        if (strstr(state->arg, second_formats[i])) clock_period_s = 1;
+    }
+
+    int fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0 || clock_arm(fd) != 0) {
+        print_error("Cannot create clock timer");
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    add_fd(state, fd);
+    return 0;
+}
+
+static int clock_render(WidgetState *state, char *buf, size_t size) {
+    time_t now = time(NULL);
+    struct tm tm;
+    if (!localtime_r(&now, &tm)) return -1;
+    if (strftime(buf, size, state->arg, &tm) == 0) buf[0] = '\0';
+    return 0;
+}
+
+static void clock_event(WidgetState *state, int fd) {
+    (void)state;
+    uint64_t expirations;
+    if (read(fd, &expirations, sizeof(expirations)) < 0 && errno == ECANCELED) {
+        // The clock was set (NTP step, suspend/resume, manual change)
+        tzset();
+        clock_arm(fd);
+    }
+}
+
+static const Widget widget_clock = {
+    "clock", "Local time; argument is a strftime format (default %H:%M)", 0,
+    clock_open, clock_render, clock_event, close_fds
+};
+
+// --- battery --------------------------------------------------------------
+
+static struct {
+    int capacity_fd;
+    int status_fd;
+    int uevent_fd;
+} battery = { -1, -1, -1 };
+
+static int is_battery(const char *name) {
+    char path[512], buf[32];
+    snprintf(path, sizeof(path), POWER_SUPPLY_DIR "/%s/type", name);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    int ok = read_fd(fd, buf, sizeof(buf)) == 0 && strcmp(buf, "Battery") == 0;
+    close(fd);
+
+    // Skip the batteries of mice and headsets
+    snprintf(path, sizeof(path), POWER_SUPPLY_DIR "/%s/scope", name);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        if (read_fd(fd, buf, sizeof(buf)) == 0 && strcmp(buf, "Device") == 0) ok = 0;
+        close(fd);
+    }
+    return ok;
+}
+
+static int open_attribute(const char *supply, const char *attribute) {
+    char path[512];
+    snprintf(path, sizeof(path), POWER_SUPPLY_DIR "/%s/%s", supply, attribute);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+static int battery_open(WidgetState *state) {
+    char name[256] = "";
+    if (state->arg) {
+        snprintf(name, sizeof(name), "%s", state->arg);
+    } else {
+        DIR *dir = opendir(POWER_SUPPLY_DIR);
+        struct dirent *entry;
+        while (dir && !name[0] && (entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] != '.' && is_battery(entry->d_name)) {
+                snprintf(name, sizeof(name), "%s", entry->d_name);
+            }
+        }
+        if (dir) closedir(dir);
+    }
+
+    battery.capacity_fd = name[0] ? open_attribute(name, "capacity") : -1;
+    if (battery.capacity_fd < 0) {
+        print_error("No battery found");
+        return -1;
+    }
+    battery.status_fd = open_attribute(name, "status");
+
+    // Plugging or unplugging the charger and most status changes arrive
+    // as power_supply uevents; capacity is caught by the timer
+    battery.uevent_fd = uevent_open();
+    if (battery.uevent_fd >= 0) add_fd(state, battery.uevent_fd);
+    return 0;
+}
+
+static int battery_render(WidgetState *state, char *buf, size_t size) {
+    (void)state;
+    char capacity[16], status[32] = "";
+    if (read_fd(battery.capacity_fd, capacity, sizeof(capacity)) != 0) return -1;
+    if (battery.status_fd >= 0) read_fd(battery.status_fd, status, sizeof(status));
+
+    for (char *p = status; *p; p++) {
+        if (*p >= 'A' && *p <= 'Z') *p = (char)(*p - 'A' + 'a');
+    }
+    if (!status[0] || strcmp(status, "discharging") == 0 || strcmp(status, "unknown") == 0) {
+        snprintf(buf, size, "%s%%", capacity);
+    } else {
+        snprintf(buf, size, "%s%% %s", capacity, status);
+    }
+    return 0;
+}
+
+static void battery_event(WidgetState *state, int fd) {
+    (void)state;
+    UEvent event;
+    while (uevent_read(fd, &event) > 0) {}
+}
+
+static void battery_close(WidgetState *state) {
+    close(battery.capacity_fd);
+    if (battery.status_fd >= 0) close(battery.status_fd);
+    close_fds(state);
+}
+
+static const Widget widget_battery = {
+    "battery", "Battery charge and state; argument names the supply (default: first battery)", 60000,
+    battery_open, battery_render, battery_event, battery_close
+};
+
+// --- volume ---------------------------------------------------------------
+
+// Read straight from the ALSA control device: subscribing to its events
+// makes the fd readable on every mixer change, with no polling at all
+static struct {
+    int fd;
+    struct snd_ctl_elem_id volume;
+    struct snd_ctl_elem_id mute;      // numid 0 if the card has no switch
+    long min, max;
+    unsigned int channels;
+} mixer;
+
+static int find_element(struct snd_ctl_elem_id *ids, unsigned int count,
+                        const char *name, struct snd_ctl_elem_id *out) {
+    for (unsigned int i = 0; i < count; i++) {
+        if (ids[i].iface == SNDRV_CTL_ELEM_IFACE_MIXER &&
+            strcmp((const char *)ids[i].name, name) == 0) {
+            *out = ids[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int volume_open(WidgetState *state) {
+    char path[64];
+    snprintf(path, sizeof(path), "/dev/snd/controlC%d", state->arg ? atoi(state->arg) : 0);
+    mixer.fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (mixer.fd < 0) {
+        print_error("Cannot open %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct snd_ctl_elem_list list;
+    memset(&list, 0, sizeof(list));
+    struct snd_ctl_elem_id *ids = NULL;
+    if (ioctl(mixer.fd, SNDRV_CTL_IOCTL_ELEM_LIST, &list) == 0 && list.count > 0) {
+        ids = calloc(list.count, sizeof(*ids));
+        list.space = list.count;
+        list.pids = ids;
+        if (ids && ioctl(mixer.fd, SNDRV_CTL_IOCTL_ELEM_LIST, &list) != 0) list.used = 0;
+    }
+
+    static const char *controls[] = { "Master", "PCM", "Speaker", "Headphone", NULL };
+    int found = 0;
+    memset(&mixer.mute, 0, sizeof(mixer.mute));
+    for (int i = 0; ids && controls[i] && !found; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s Playback Volume", controls[i]);
+        found = find_element(ids, list.used, name, &mixer.volume) == 0;
+        if (found) {
+            snprintf(name, sizeof(name), "%s Playback Switch", controls[i]);
+            find_element(ids, list.used, name, &mixer.mute);
+        }
+    }
+    free(ids);
+
+    struct snd_ctl_elem_info info;
+    memset(&info, 0, sizeof(info));
+    info.id = mixer.volume;
+    if (!found || ioctl(mixer.fd, SNDRV_CTL_IOCTL_ELEM_INFO, &info) != 0 ||
+        info.value.integer.max <= info.value.integer.min) {
+        print_error("No playback volume control on %s", path);
+        close(mixer.fd);
+        return -1;
+    }
+    mixer.min = info.value.integer.min;
+    mixer.max = info.value.integer.max;
+    mixer.channels = info.count ? info.count : 1;
+
+    int subscribe = 1;
+    if (ioctl(mixer.fd, SNDRV_CTL_IOCTL_SUBSCRIBE_EVENTS, &subscribe) != 0) {
+        print_warn("Cannot subscribe to mixer events, polling instead");
+        if (state->interval_ms == 0) state->interval_ms = 2000;
+    }
+    add_fd(state, mixer.fd);
+    return 0;
+}
+
+static int volume_render(WidgetState *state, char *buf, size_t size) {
+    (void)state;
+    struct snd_ctl_elem_value value;
+
+    if (mixer.mute.numid) {
+        memset(&value, 0, sizeof(value));
+        value.id = mixer.mute;
+        if (ioctl(mixer.fd, SNDRV_CTL_IOCTL_ELEM_READ, &value) == 0 &&
+            value.value.integer.value[0] == 0) {
+            snprintf(buf, size, "muted");
+            return 0;
+        }
+    }
+
+    memset(&value, 0, sizeof(value));
+    value.id = mixer.volume;
+    if (ioctl(mixer.fd, SNDRV_CTL_IOCTL_ELEM_READ, &value) != 0) return -1;
+
+    long sum = 0;
+    for (unsigned int i = 0; i < mixer.channels; i++) sum += value.value.integer.value[i];
+    long level = sum / (long)mixer.channels;
+    long percent = ((level - mixer.min) * 100 + (mixer.max - mixer.min) / 2) / (mixer.max - mixer.min);
+    snprintf(buf, size, "%ld%%", percent);
+    return 0;
+}
+
+static void volume_event(WidgetState *state, int fd) {
+    (void)state;
+    struct snd_ctl_event events[16];
+    while (read(fd, events, sizeof(events)) > 0) {}
+}
+
+static const Widget widget_volume = {
+    "volume", "ALSA playback volume; argument is the card number (default 0)", 0,
+    volume_open, volume_render, volume_event, close_fds
+};
+
+// --- cpu and memory -------------------------------------------------------
+
+static struct {
+    int fd;
+    unsigned long long total, idle;
+} cpu;
+
+static int cpu_open(WidgetState *state) {
+    cpu.fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    if (cpu.fd < 0) {
+        print_error("Cannot open /proc/stat");
+        return -1;
+    }
+    cpu.total = cpu.idle = 0;
+    (void)state;
+    return 0;
+}
+
+static int cpu_render(WidgetState *state, char *buf, size_t size) {
+    (void)state;
+    char stat[512];
+    if (read_fd(cpu.fd, stat, sizeof(stat)) != 0) return -1;
+
+    unsigned long long v[8] = { 0 };
+    if (sscanf(stat, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+               &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]) < 4) return -1;
+
+    unsigned long long total = 0;
+    for (int i = 0; i < 8; i++) total += v[i];
+    unsigned long long idle = v[3] + v[4];
+
+    // The first sample is the average since boot
+    unsigned long long dt = total - cpu.total, di = idle - cpu.idle;
+    cpu.total = total;
+    cpu.idle = idle;
+    if (dt == 0) return -1;
+
+    snprintf(buf, size, "%llu%%", (100 * (dt - di) + dt / 2) / dt);
+    return 0;
+}
+
+static void cpu_close(WidgetState *state) {
+    (void)state;
+    close(cpu.fd);
+}
+
+static const Widget widget_cpu = {
+    "cpu", "CPU usage over the update interval", 2000,
+    cpu_open, cpu_render, NULL, cpu_close
+};
+
+static int meminfo_fd = -1;
+
+static int memory_open(WidgetState *state) {
+    (void)state;
+    meminfo_fd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    if (meminfo_fd < 0) {
+        print_error("Cannot open /proc/meminfo");
+        return -1;
+    }
+    return 0;
+}
+
+static int memory_render(WidgetState *state, char *buf, size_t size) {
+    (void)state;
+    char info[4096];
+    if (read_fd(meminfo_fd, info, sizeof(info)) != 0) return -1;
+
+    char *total = strstr(info, "MemTotal:");
+    char *available = strstr(info, "MemAvailable:");
+    if (!total || !available) return -1;
+
+    unsigned long long total_kb = strtoull(total + 9, NULL, 10);
+    unsigned long long available_kb = strtoull(available + 13, NULL, 10);
+    if (total_kb == 0 || available_kb > total_kb) return -1;
+
+    snprintf(buf, size, "%llu%%", (100 * (total_kb - available_kb) + total_kb / 2) / total_kb);
+    return 0;
+}
+
+static void memory_close(WidgetState *state) {
+    (void)state;
+    close(meminfo_fd);
+}
+
+static const Widget widget_memory = {
+    "memory", "Memory in use (excluding reclaimable cache)", 5000,
+    memory_open, memory_render, NULL, memory_close
+};
+
+// --- effects --------------------------------------------------------------
+
+// Every publish touches the snapshot (IN_ATTRIB); watch the directory so
+// a snapshot created after we start is seen too
+static int effects_open(WidgetState *state) {
+    char *path = snapshot_path();
+    if (!path || config_ensure_dir(path) != 0) {
+        free(path);
+        print_error("Cannot find the settings snapshot");
+        return -1;
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, dirname(path), IN_ATTRIB | IN_CREATE | IN_MOVED_TO) < 0) {
+        print_error("Cannot watch the settings snapshot");
+        if (fd >= 0) close(fd);
+        free(path);
+        return -1;
+    }
+    free(path);
+    add_fd(state, fd);
+    return 0;
+}
+
+static int effects_render(WidgetState *state, char *buf, size_t size) {
+    (void)state;
+    char level[32], shadows[32], animations[32];
+
+    // The governor's level, when it has stepped in, says the most
+    if (snapshot_get("effects.governor-level", level, sizeof(level)) == 0 &&
+        strcmp(level, "off") != 0) {
+        snprintf(buf, size, "fx %s", level);
+        return 0;
+    }
+
+    if (snapshot_get("effects.shadows", shadows, sizeof(shadows)) != 0 ||
+        snapshot_get("effects.animations", animations, sizeof(animations)) != 0) {
+        snprintf(buf, size, "fx ?");
+        return 0;
+    }
+    int on = strcmp(shadows, "enabled") == 0 || strcmp(animations, "enabled") == 0;
+    snprintf(buf, size, "fx %s", on ? "on" : "off");
+    return 0;
+}
+
+static void effects_event(WidgetState *state, int fd) {
+    (void)state;
+    drain(fd);
+}
+
+static const Widget widget_effects = {
+    "effects", "Compositor effects state from the settings snapshot", 0,
+    effects_open, effects_render, effects_event, close_fds
+};
+
+// --- Runner -----------------------------------------------------------------
+
+const Widget *const widgets[] = {
+    &widget_clock,
+    &widget_battery,
+    &widget_volume,
+    &widget_cpu,
+    &widget_memory,
+    &widget_effects,
+    NULL
+};
+
+const Widget *widget_find(const char *name) {
+    for (int i = 0; widgets[i]; i++) {
+        if (strcmp(widgets[i]->name, name) == 0) return widgets[i];
+    }
+    return NULL;
+}
+
+// Print when the text changed. Returns -1 once stdout is gone (tint2
+// exited or reloaded), which ends the widget
+static int emit(const char *text, char *last) {
+    if (strcmp(text, last) == 0) return 0;
+    snprintf(last, WIDGET_TEXT_MAX, "%s", text);
+    if (printf("%s\n", text) < 0 || fflush(stdout) != 0) return -1;
+    return 0;
+}
+
+int widget_run(const Widget *widget, const char *arg, int interval_ms, int continuous) {
+    WidgetState state;
+    memset(&state, 0, sizeof(state));
+    state.arg = arg;
+    state.interval_ms = interval_ms >= 0 ? interval_ms : widget->interval_ms;
+
+    if (widget->open(&state) != 0) return -1;
+
+    // Timer-only widgets need a period to make progress
+    if (state.fd_count == 0 && state.interval_ms <= 0) state.interval_ms = widget->interval_ms;
+
+    char text[WIDGET_TEXT_MAX], last[WIDGET_TEXT_MAX] = "";
+    if (widget->render(&state, text, sizeof(text)) != 0) snprintf(text, sizeof(text), "?");
+    if (!continuous) {
+        printf("%s\n", text);
+        widget->close(&state);
+        return 0;
+    }
+
+    // A closed pipe ends us through EPIPE, not a signal
+    signal(SIGPIPE, SIG_IGN);
+
+    int timer = -1;
+    if (state.interval_ms > 0) {
+        timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        struct itimerspec its;
+        its.it_interval.tv_sec = state.interval_ms / 1000;
+        its.it_interval.tv_nsec = (long)(state.interval_ms % 1000) * 1000000L;
+        its.it_value = its.it_interval;
+        if (timer >= 0) timerfd_settime(timer, 0, &its, NULL);
+    }
+
+    int result = 0, attached = emit(text, last) == 0;
+    while (attached) {
+        struct pollfd fds[WIDGET_MAX_FDS + 2];
+        int nfds = 0;
+        for (int i = 0; i < state.fd_count; i++) {
+            fds[nfds].fd = state.fds[i];
+            fds[nfds++].events = POLLIN;
+        }
+        if (timer >= 0) {
+            fds[nfds].fd = timer;
+            fds[nfds++].events = POLLIN;
+        }
+
+        // Reports POLLERR when tint2 goes away, even if nothing changes
+        fds[nfds].fd = STDOUT_FILENO;
+        fds[nfds++].events = 0;
+
+        if (poll(fds, (nfds_t)nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            print_error("poll: %s", strerror(errno));
+            result = -1;
+            break;
+        }
+        if (fds[nfds - 1].revents & (POLLERR | POLLHUP | POLLNVAL)) break;
+
+        for (int i = 0; i < nfds - 1; i++) {
+            if (!(fds[i].revents & POLLIN)) continue;
+            if (fds[i].fd == timer) drain(timer);
+            else if (widget->event) widget->event(&state, fds[i].fd);
+        }
+
+        if (widget->render(&state, text, sizeof(text)) == 0) attached = emit(text, last) == 0;
+    }
+
+    if (timer >= 0) close(timer);
+    widget->close(&state);
+    return result;
+}
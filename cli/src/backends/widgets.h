@@ -0,0 +1,49 @@
+// cli/src/backends/widgets.h
+#ifndef OPENDE_WIDGETS_H
+#define OPENDE_WIDGETS_H
+
+#include <stddef.h>
+
+// Data providers for tint2 executors. Each widget keeps its sources open
+// (sysfs/procfs files, netlink, the ALSA control device, the settings
+// snapshot) and is re-rendered only when one of them signals or its
+// timer fires. In continuous mode a line is printed only when the
+// rendered text changes, which is what tint2's execp_continuous expects.
+
+#define WIDGET_MAX_FDS 4
+
+typedef struct {
+    int fds[WIDGET_MAX_FDS];     // Polled; the widget drains them in event()
+    int fd_count;
+    int interval_ms;             // Re-render period, 0 for events only
+    const char *arg;             // Widget argument (clock format, battery, card)
+} WidgetState;
+
+typedef struct {
+    const char *name;
+    const char *description;
+    int interval_ms;             // Default period, 0 if fully event driven
+
+    // Open sources into state. Returns 0 on success, -1 on error (the
+    // reason is reported with print_error)
+    int (*open)(WidgetState *state);
+
+    // Render the current value. Returns 0 on success, -1 on error
+    int (*render)(WidgetState *state, char *buf, size_t size);
+
+    // Drain a readable fd from state->fds (may be NULL)
+    void (*event)(WidgetState *state, int fd);
+
+    void (*close)(WidgetState *state);
+} Widget;
+
+extern const Widget *const widgets[];    // NULL-terminated
+
+const Widget *widget_find(const char *name);
+
+// Render once, or with continuous set keep printing changes until stdout
+// is closed. interval_ms overrides the widget's period when >= 0.
+// Returns 0 on success, -1 on error
+int widget_run(const Widget *widget, const char *arg, int interval_ms, int continuous);
+
+#endif
@@ -0,0 +1,223 @@
+// cli/src/backends/wm.c
+#define _POSIX_C_SOURCE 200809L
+#include "wm.h"
+#include "components.h"
+#include "../util/config.h"
+#include <X11/Xlib.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define OPENDE_DEFAULT_DIR "/usr/local/share/opende"
+
+const WmBackend *const wm_backends[] = {
+    &wm_openbox,
+    &wm_fluxbox,
+    &wm_icewm,
+    &wm_i3,
+    NULL
+};
+
+const WmBackend *wm_find(const char *name) {
+    for (int i = 0; wm_backends[i]; i++) {
+        if (strcmp(wm_backends[i]->name, name) == 0) return wm_backends[i];
+    }
+    return NULL;
+}
+
+int wm_is_installed(const WmBackend *wm) {
+    const char *path = getenv("PATH");
+    if (!path) path = "/usr/local/bin:/usr/bin:/bin";
+
+    char *dirs = strdup(path);
+    if (!dirs) return 0;
+
+    int found = 0;
+    char *save = NULL;
+    for (char *dir = strtok_r(dirs, ":", &save); dir && !found; dir = strtok_r(NULL, ":", &save)) {
+        char candidate[4096];
+        snprintf(candidate, sizeof(candidate), "%s/%s", dir, wm->binary);
+        found = access(candidate, X_OK) == 0;
+    }
+    free(dirs);
+    return found;
+}
+
+const WmBackend *wm_running(pid_t *pid) {
+    for (int i = 0; wm_backends[i]; i++) {
+        const SessionComponent *component = components_find(wm_backends[i]->name);
+        pid_t found;
+        if (component && components_find_pids(component, &found, 1) == 1) {
+            if (pid) *pid = found;
+            return wm_backends[i];
+        }
+    }
+    return NULL;
+}
+
+static char *template_path(const char *relative) {
+    const char *opende = getenv("OPENDE_DIR");
+    if (!opende || !*opende) opende = OPENDE_DEFAULT_DIR;
+
+    size_t len = strlen(opende) + strlen(relative) + 16;
+    char *path = malloc(len);
+    if (path) snprintf(path, len, "%s/config/%s", opende, relative);
+    return path;
+}
+
+// Ensure path exists, seeding it from the template when missing
+static int seed_config(const char *path, const char *relative) {
+    if (config_file_exists(path)) return 0;
+    if (config_ensure_dir(path) != 0) return -1;
+
+    char *source = template_path(relative);
+    char *content = source ? config_read_file(source) : NULL;
+    free(source);
+
+    // Without a template, start empty; the editors add what they set
+    int result = config_create_file(path, content ? content : "");
+    free(content);
+    return result;
+}
+
+char *wm_user_config(const char *name, const char *template_relative) {
+    char *path = config_get_user_path(name);
+    if (!path) return NULL;
+    if (seed_config(path, template_relative) != 0) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+char *wm_home_config(const char *relative, const char *template_relative) {
+    const char *home = getenv("HOME");
+    if (!home) return NULL;
+
+    size_t len = strlen(home) + strlen(relative) + 2;
+    char *path = malloc(len);
+    if (!path) return NULL;
+    snprintf(path, len, "%s/%s", home, relative);
+
+    if (seed_config(path, template_relative) != 0) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+// Does line set key? Returns pointer to the value or NULL
+static const char *match_key(const char *line, const char *key, char sep) {
+    while (*line == ' ' || *line == '\t') line++;
+    size_t len = strlen(key);
+    if (strncmp(line, key, len) != 0) return NULL;
+
+    const char *p = line + len;
+    if (sep == ' ') {
+        if (*p != ' ' && *p != '\t') return NULL;
+    } else {
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p != sep) return NULL;
+        p++;
+    }
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+int wm_line_get(const char *path, const char *key, char sep, char *buf, size_t size) {
+    char *text = config_read_file(path);
+    if (!text) return -1;
+
+    int found = -1;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        const char *value = match_key(line, key, sep);
+        if (!value) continue;
+
+        size_t len = strlen(value);
+        while (len > 0 && isspace((unsigned char)value[len - 1])) len--;
+        snprintf(buf, size, "%.*s", (int)len, value);
+        found = 0;
+        break;
+    }
+
+    free(text);
+    return found;
+}
+
+typedef struct {
+    const char *key;
+    const char *sep;
+    const char *value;
+} LineEdit;
+
+// Rewrite the first assignment, keep everything else as it was
+static char *edit_line(const char *text, void *data) {
+    const LineEdit *edit = data;
+    size_t size = strlen(text) + strlen(edit->key) + strlen(edit->sep) + strlen(edit->value) + 3;
+    char *out = malloc(size);
+    char *copy = strdup(text);
+    if (!out || !copy) {
+        free(out);
+        free(copy);
+        return NULL;
+    }
+
+    size_t len = 0;
+    int done = 0;
+    for (char *line = copy; *line;) {
+        char *end = strchr(line, '\n');
+        size_t line_len = end ? (size_t)(end - line) + 1 : strlen(line);
+
+        if (end) *end = '\0';
+        int hit = !done && match_key(line, edit->key, edit->sep[0]) != NULL;
+        if (end) *end = '\n';
+
+        if (hit) {
+            len += (size_t)sprintf(out + len, "%s%s%s\n", edit->key, edit->sep, edit->value);
+            done = 1;
+        } else {
+            memcpy(out + len, line, line_len);
+            len += line_len;
+        }
+        line += line_len;
+    }
+
+    if (!done) {
+        if (len > 0 && out[len - 1] != '\n') out[len++] = '\n';
+        len += (size_t)sprintf(out + len, "%s%s%s\n", edit->key, edit->sep, edit->value);
+    }
+    out[len] = '\0';
+
+    free(copy);
+    return out;
+}
+
+int wm_line_set(const char *path, const char *key, const char *sep, const char *value) {
+    LineEdit edit = { key, sep, value };
+    return config_update_file(path, edit_line, &edit);
+}
+
+int wm_send_root_message(const char *atom, long l0) {
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) return -1;
+
+    Window root = DefaultRootWindow(dpy);
+    XEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.xclient.type = ClientMessage;
+    ev.xclient.window = root;
+    ev.xclient.message_type = XInternAtom(dpy, atom, False);
+    ev.xclient.format = 32;
+    ev.xclient.data.l[0] = l0;
+
+    XSendEvent(dpy, root, False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
+    XCloseDisplay(dpy);  // Flushes
+    return 0;
+}
+
+int wm_request_desktops(int count) {
+    return wm_send_root_message("_NET_NUMBER_OF_DESKTOPS", count);
+}
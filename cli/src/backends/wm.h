@@ -0,0 +1,79 @@
+// cli/src/backends/wm.h
+#ifndef OPENDE_WM_BACKEND_H
+#define OPENDE_WM_BACKEND_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// Settings shared by the window manager backends. Values are text:
+// animations "on"/"off", focus "click"/"mouse", workspaces a count.
+typedef enum {
+    WM_SETTING_ANIMATIONS,
+    WM_SETTING_FOCUS,
+    WM_SETTING_WORKSPACES
+} WmSetting;
+
+#define WM_UNSUPPORTED   (-2)  // The WM has no such setting
+#define WM_APPLIED_LIVE  0     // Running instance picked up the change
+#define WM_APPLIED_LATER 1     // Takes effect when the WM next starts
+
+#define WM_MAX_WORKSPACES 32
+
+typedef struct {
+    const char *name;        // Component name (see components.c)
+    const char *binary;      // Executable, to tell whether it is installed
+
+    // Current value from the config file
+    // Returns 0, -1 on error, WM_UNSUPPORTED
+    int (*get)(WmSetting setting, char *buf, size_t size);
+
+    // Edit the config file in place; value is already validated
+    // Returns 0, -1 on error, WM_UNSUPPORTED
+    int (*set)(WmSetting setting, const char *value);
+
+    // Push the edited setting into the running instance (pid > 0) through
+    // its cheapest path. Returns WM_APPLIED_LIVE, WM_APPLIED_LATER or -1.
+    int (*apply)(pid_t pid, WmSetting setting, const char *value);
+} WmBackend;
+
+extern const WmBackend wm_openbox;
+extern const WmBackend wm_fluxbox;
+extern const WmBackend wm_icewm;
+extern const WmBackend wm_i3;
+
+// All backends, NULL terminated
+extern const WmBackend *const wm_backends[];
+
+const WmBackend *wm_find(const char *name);
+int wm_is_installed(const WmBackend *wm);
+
+// The window manager running on this $DISPLAY, or NULL
+const WmBackend *wm_running(pid_t *pid);
+
+// Helpers for the backends
+
+// User copy of a config file under ~/.config/opende/, created from the
+// OpenDE template (relative to $OPENDE_DIR/config) on first use
+// Returns allocated path (caller must free) or NULL on error
+char *wm_user_config(const char *name, const char *template_path);
+
+// Copy a template into place if the file doesn't exist yet (the fluxbox
+// and icewm sessions keep their configs in the WM's own directory)
+// Returns allocated path (caller must free) or NULL on error
+char *wm_home_config(const char *relative, const char *template_path);
+
+// Line-oriented "key<sep>value" formats (fluxbox init, icewm preferences,
+// i3 config). sep is the separator written on set; get accepts any
+// whitespace around it. Returns 0 if found, -1 otherwise.
+int wm_line_get(const char *path, const char *key, char sep, char *buf, size_t size);
+int wm_line_set(const char *path, const char *key, const char *sep, const char *value);
+
+// Ask the running WM for a new workspace count via EWMH
+// (_NET_NUMBER_OF_DESKTOPS). Returns 0 if sent, -1 without a display
+int wm_request_desktops(int count);
+
+// Send a 32-bit client message to the root window
+// Returns 0 if sent, -1 without a display
+int wm_send_root_message(const char *atom, long l0);
+
+#endif
@@ -0,0 +1,426 @@
+// cli/src/backends/xkb_rules.c
+#define _POSIX_C_SOURCE 200809L
+#include "xkb_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+
+#define MAX_COLUMNS  4
+#define MAX_SETS     128
+#define MAX_GROUPS   128
+#define MAX_PENDING  256
+#define VALUE_MAX    64
+
+static const char *data_dirs[] = {
+    "/usr/share/X11/xkb",
+    "/usr/local/share/X11/xkb",
+    "/usr/lib/X11/xkb",
+    NULL
+};
+
+const char *xkb_rules_data_dir(void) {
+    static char found[256];
+    if (found[0]) return found;
+
+    const char *env = getenv("XKB_CONFIG_ROOT");
+    for (int i = -1; i < 0 || data_dirs[i]; i++) {
+        const char *dir = i < 0 ? env : data_dirs[i];
+        if (!dir || !*dir) continue;
+
+        char rules[300];
+        snprintf(rules, sizeof(rules), "%s/rules", dir);
+        if (access(rules, R_OK) == 0) {
+            snprintf(found, sizeof(found), "%s", dir);
+            return found;
+        }
+    }
+    return NULL;
+}
+
+char *xkb_rules_path(const char *rules) {
+    const char *dir = xkb_rules_data_dir();
+    if (!dir || !rules || !*rules || strchr(rules, '/')) return NULL;
+
+    size_t size = strlen(dir) + strlen(rules) + 8;
+    char *path = malloc(size);
+    if (!path) return NULL;
+    snprintf(path, size, "%s/rules/%s", dir, rules);
+    if (access(path, R_OK) != 0) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+// --- Rules file ------------------------------------------------------------
+
+typedef enum { COL_MODEL, COL_LAYOUT, COL_VARIANT, COL_OPTION } ColumnType;
+
+typedef enum {
+    COMP_KEYCODES,
+    COMP_TYPES,
+    COMP_COMPAT,
+    COMP_SYMBOLS,
+    COMP_GEOMETRY,
+    COMP_COUNT
+} Component;
+
+static const char *component_names[COMP_COUNT] = {
+    "keycodes", "types", "compat", "symbols", "geometry"
+};
+
+typedef struct {
+    ColumnType types[MAX_COLUMNS];
+    int indexes[MAX_COLUMNS];      // 0 for "layout", N for "layout[N]"
+    int count;
+    Component component;
+    int has_option;
+} RuleSet;
+
+typedef struct {
+    int set;
+    char *patterns[MAX_COLUMNS];
+    char *value;
+} Rule;
+
+typedef struct {
+    const char *name;
+    const char *members;           // Whitespace-separated
+} Group;
+
+// Passes in libxkbfile order: plain values, appended values, options
+typedef enum { PASS_NORMAL, PASS_APPEND, PASS_OPTION } Pass;
+
+typedef struct {
+    RuleSet sets[MAX_SETS];
+    int set_count;
+    Group groups[MAX_GROUPS];
+    int group_count;
+    Rule *rules;
+    int rule_count;
+
+    // Index 0 holds a single layout/variant; 1..N hold several
+    const char *model;
+    char layouts[XKB_RULES_MAX_LAYOUTS + 1][VALUE_MAX];
+    char variants[XKB_RULES_MAX_LAYOUTS + 1][VALUE_MAX];
+    const char *options;
+
+    char results[COMP_COUNT][XKB_COMPONENT_MAX];
+} Resolver;
+
+// "layout[2]" -> COL_LAYOUT, 2. Returns -1 for columns this resolver
+// doesn't know (rule sets using them are skipped)
+static int parse_column(const char *token, ColumnType *type, int *index) {
+    static const struct {
+        const char *name;
+        ColumnType type;
+    } names[] = {
+        { "model", COL_MODEL }, { "layout", COL_LAYOUT }, { "variant", COL_VARIANT }, { "option", COL_OPTION },
+    };
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        size_t len = strlen(names[i].name);
+        if (strncmp(token, names[i].name, len) != 0) continue;
+
+        *type = names[i].type;
+        *index = 0;
+        if (token[len] == '\0') return 0;
+        if (token[len] != '[' || names[i].type == COL_MODEL || names[i].type == COL_OPTION) return -1;
+
+        char *end;
+        long n = strtol(token + len + 1, &end, 10);
+        if (end[0] != ']' || end[1] || n < 1 || n > XKB_RULES_MAX_LAYOUTS) return -1;
+        *index = (int)n;
+        return 0;
+    }
+    return -1;
+}
+
+static int split_words(char *line, char **words, int max) {
+    int count = 0;
+    char *save = NULL;
+    for (char *w = strtok_r(line, " \t", &save); w && count < max; w = strtok_r(NULL, " \t", &save)) {
+        words[count++] = w;
+    }
+    return count;
+}
+
+// "! $name = a b c"
+static void parse_group(Resolver *r, char *line) {
+    char *name = line + 1;
+    char *eq = strchr(name, '=');
+    if (!eq || r->group_count >= MAX_GROUPS) return;
+
+    char *end = name;
+    while (*end && !isspace((unsigned char)*end) && *end != '=') end++;
+    *end = '\0';
+    r->groups[r->group_count].name = name;
+    r->groups[r->group_count].members = eq + 1;
+    r->group_count++;
+}
+
+// "! model layout[1] = symbols". Returns the set, or -1 if unusable
+static int parse_header(Resolver *r, char *line) {
+    char *words[MAX_COLUMNS + 3];
+    int count = split_words(line, words, MAX_COLUMNS + 3);
+    if (count < 3 || strcmp(words[count - 2], "=") != 0 || count - 2 > MAX_COLUMNS ||
+        r->set_count >= MAX_SETS) return -1;
+
+    RuleSet *set = &r->sets[r->set_count];
+    memset(set, 0, sizeof(*set));
+    set->component = COMP_COUNT;
+    for (int i = 0; i < COMP_COUNT; i++) {
+        if (strcmp(words[count - 1], component_names[i]) == 0) set->component = (Component)i;
+    }
+    if (set->component == COMP_COUNT) return -1;   // "keymap" and friends
+
+    set->count = count - 2;
+    for (int i = 0; i < set->count; i++) {
+        if (parse_column(words[i], &set->types[i], &set->indexes[i]) != 0) return -1;
+        if (set->types[i] == COL_OPTION) set->has_option = 1;
+    }
+    return r->set_count++;
+}
+
+static int add_rule(Resolver *r, int set, char *line) {
+    char *words[MAX_COLUMNS + 3];
+    int columns = r->sets[set].count;
+    int count = split_words(line, words, MAX_COLUMNS + 3);
+    if (count != columns + 2 || strcmp(words[columns], "=") != 0) return 0;
+
+    if (r->rule_count % 256 == 0) {
+        Rule *grown = realloc(r->rules, (size_t)(r->rule_count + 256) * sizeof(Rule));
+        if (!grown) return -1;
+        r->rules = grown;
+    }
+    Rule *rule = &r->rules[r->rule_count++];
+    rule->set = set;
+    for (int i = 0; i < columns; i++) rule->patterns[i] = words[i];
+    rule->value = words[columns + 1];
+    return 0;
+}
+
+// Tokens point into text, which is modified in place
+static int parse_rules(Resolver *r, char *text) {
+    // Backslash-newline continues a line
+    for (char *p = strstr(text, "\\\n"); p; p = strstr(p, "\\\n")) {
+        p[0] = p[1] = ' ';
+    }
+
+    int set = -1;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        char *comment = strstr(line, "//");
+        if (comment) *comment = '\0';
+        while (isspace((unsigned char)*line)) line++;
+        if (!*line) continue;
+
+        if (*line != '!') {
+            if (set >= 0 && add_rule(r, set, line) != 0) return -1;
+            continue;
+        }
+
+        line++;
+        while (isspace((unsigned char)*line)) line++;
+        if (*line == '$') {
+            parse_group(r, line);
+        } else {
+            set = parse_header(r, line);   // Also "! include": not used by xkeyboard-config
+        }
+    }
+    return 0;
+}
+
+// --- Matching --------------------------------------------------------------
+
+static int in_list(const char *list, const char *separators, const char *value) {
+    size_t len = strlen(value);
+    for (const char *p = list; *p; ) {
+        p += strspn(p, separators);
+        size_t word = strcspn(p, separators);
+        if (word == len && strncmp(p, value, len) == 0) return 1;
+        p += word;
+    }
+    return 0;
+}
+
+static int in_group(const Resolver *r, const char *group, const char *value) {
+    for (int i = 0; i < r->group_count; i++) {
+        if (strcmp(r->groups[i].name, group) == 0) return in_list(r->groups[i].members, " \t", value);
+    }
+    return 0;
+}
+
+static const char *column_value(const Resolver *r, ColumnType type, int index) {
+    switch (type) {
+        case COL_MODEL:   return r->model;
+        case COL_LAYOUT:  return r->layouts[index];
+        case COL_VARIANT: return r->variants[index];
+        default:          return r->options;
+    }
+}
+
+// 1 if the rule matches; *wildcard is set when a '*' took part
+static int rule_matches(const Resolver *r, const Rule *rule, int *wildcard) {
+    const RuleSet *set = &r->sets[rule->set];
+    *wildcard = 0;
+    for (int i = 0; i < set->count; i++) {
+        const char *pattern = rule->patterns[i];
+        const char *value = column_value(r, set->types[i], set->indexes[i]);
+        if (!value || !*value) return 0;
+
+        if (set->types[i] == COL_OPTION) {
+            if (!in_list(value, ",", pattern)) return 0;
+        } else if (strcmp(pattern, "*") == 0) {
+            *wildcard = 1;
+        } else if (pattern[0] == '$') {
+            if (!in_group(r, pattern + 1, value)) return 0;
+        } else if (strcmp(pattern, value) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void append(char *buf, size_t size, size_t *len, const char *text, size_t n) {
+    if (*len + n >= size) n = size - *len - 1;
+    memcpy(buf + *len, text, n);
+    *len += n;
+    buf[*len] = '\0';
+}
+
+// %m, %l, %v with an optional [N], a +|_- prefix or (parentheses)
+static void substitute(const Resolver *r, const char *value, char *out, size_t size) {
+    size_t len = 0;
+    out[0] = '\0';
+    for (const char *p = value; *p; ) {
+        if (*p != '%') {
+            append(out, size, &len, p++, 1);
+            continue;
+        }
+
+        p++;
+        char prefix = 0, suffix = 0;
+        if (*p == '+' || *p == '|' || *p == '_' || *p == '-') {
+            prefix = *p++;
+        } else if (*p == '(') {
+            prefix = '(';
+            suffix = ')';
+            p++;
+        }
+
+        char var = *p ? *p++ : '\0';
+        int index = 0;
+        if (*p == '[') {
+            char *end;
+            index = (int)strtol(p + 1, &end, 10);
+            p = *end == ']' ? end + 1 : end;
+            if (index < 0 || index > XKB_RULES_MAX_LAYOUTS) index = 0;
+        }
+        if (suffix && *p == ')') p++;
+
+        const char *text = var == 'm' ? r->model : var == 'l' ? r->layouts[index] :
+                           var == 'v' ? r->variants[index] : NULL;
+        if (!text || !*text) continue;
+        if (prefix) append(out, size, &len, &prefix, 1);
+        append(out, size, &len, text, strlen(text));
+        if (suffix) append(out, size, &len, &suffix, 1);
+    }
+}
+
+static void apply_rule(Resolver *r, const Rule *rule) {
+    char value[XKB_COMPONENT_MAX];
+    substitute(r, rule->value, value, sizeof(value));
+
+    char *dst = r->results[r->sets[rule->set].component];
+    if (value[0] == '+' || value[0] == '|') {
+        size_t len = strlen(dst);
+        append(dst, XKB_COMPONENT_MAX, &len, value, strlen(value));
+    } else if (!dst[0]) {
+        snprintf(dst, XKB_COMPONENT_MAX, "%s", value);
+    }
+}
+
+static Pass rule_pass(const Resolver *r, const Rule *rule) {
+    if (r->sets[rule->set].has_option) return PASS_OPTION;
+    return rule->value[0] == '+' || rule->value[0] == '|' ? PASS_APPEND : PASS_NORMAL;
+}
+
+static void run_pass(Resolver *r, Pass pass) {
+    const Rule *pending[MAX_PENDING];
+    int pending_count = 0, matched_set = -1;
+
+    for (int i = 0; i < r->rule_count; i++) {
+        const Rule *rule = &r->rules[i];
+        if (rule_pass(r, rule) != pass) continue;
+        if (pass != PASS_OPTION && rule->set == matched_set) continue;
+
+        int wildcard;
+        if (!rule_matches(r, rule, &wildcard)) continue;
+
+        // Only the first match of a set counts, except for options
+        if (pass != PASS_OPTION) matched_set = rule->set;
+
+        // Wildcard matches give way to exact ones of the same pass
+        if (wildcard && pending_count < MAX_PENDING) pending[pending_count++] = rule;
+        else if (!wildcard) apply_rule(r, rule);
+    }
+    for (int i = 0; i < pending_count; i++) apply_rule(r, pending[i]);
+}
+
+// "us,de" -> [1] us, [2] de; a lone "us" stays in [0]
+static int split_values(const char *list, char values[][VALUE_MAX], int several) {
+    if (!list) return 0;
+    if (!several) {
+        snprintf(values[0], VALUE_MAX, "%s", list);
+        return 1;
+    }
+
+    int count = 0;
+    const char *p = list;
+    for (;;) {
+        size_t len = strcspn(p, ",");
+        if (count >= XKB_RULES_MAX_LAYOUTS) return -1;
+        count++;
+        snprintf(values[count], VALUE_MAX, "%.*s", (int)len, p);
+        if (!p[len]) break;
+        p += len + 1;
+    }
+    return count;
+}
+
+int xkb_rules_resolve(const char *text, const char *model, const char *layout,
+                      const char *variant, const char *options, KeymapComponents *out) {
+    Resolver *r = calloc(1, sizeof(Resolver));
+    char *copy = strdup(text);
+    if (!r || !copy) {
+        free(r);
+        free(copy);
+        return -1;
+    }
+
+    r->model = model && *model ? model : "pc105";
+    r->options = options;
+    int several = layout && strchr(layout, ',') != NULL;
+    int result = -1;
+    if (split_values(layout, r->layouts, several) >= 0 && split_values(variant, r->variants, several) >= 0 &&
+        parse_rules(r, copy) == 0) {
+        run_pass(r, PASS_NORMAL);
+        run_pass(r, PASS_APPEND);
+        run_pass(r, PASS_OPTION);
+
+        snprintf(out->keycodes, sizeof(out->keycodes), "%s", r->results[COMP_KEYCODES]);
+        snprintf(out->types, sizeof(out->types), "%s", r->results[COMP_TYPES]);
+        snprintf(out->compat, sizeof(out->compat), "%s", r->results[COMP_COMPAT]);
+        snprintf(out->symbols, sizeof(out->symbols), "%s", r->results[COMP_SYMBOLS]);
+        snprintf(out->geometry, sizeof(out->geometry), "%s", r->results[COMP_GEOMETRY]);
+        result = out->keycodes[0] && out->types[0] && out->compat[0] && out->symbols[0] ? 0 : -1;
+    }
+
+    free(r->rules);
+    free(r);
+    free(copy);
+    return result;
+}
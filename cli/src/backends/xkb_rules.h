@@ -0,0 +1,34 @@
+// cli/src/backends/xkb_rules.h
+#ifndef OPENDE_XKB_RULES_H
+#define OPENDE_XKB_RULES_H
+
+// Resolves XKB rules names (model, layout, variant, options) to the keymap
+// components the server compiles, the way setxkbmap does with libxkbfile:
+// first match per rule set, wildcards applied after exact matches, '+'
+// and '|' values appended, every matching option applied.
+
+#define XKB_RULES_MAX_LAYOUTS 4
+#define XKB_COMPONENT_MAX     512
+
+typedef struct {
+    char keycodes[XKB_COMPONENT_MAX];
+    char types[XKB_COMPONENT_MAX];
+    char compat[XKB_COMPONENT_MAX];
+    char symbols[XKB_COMPONENT_MAX];
+    char geometry[XKB_COMPONENT_MAX];
+} KeymapComponents;
+
+// Path of the named rules file ("evdev") in the XKB data directory, or NULL.
+// Caller must free
+char *xkb_rules_path(const char *rules);
+
+// Directory holding the XKB data (rules/, symbols/, ...), or NULL
+const char *xkb_rules_data_dir(void);
+
+// Resolve against the rules text. Layouts, variants and options are
+// comma-separated; any may be NULL or "". Returns 0 on success, -1 if a
+// component stays unresolved
+int xkb_rules_resolve(const char *text, const char *model, const char *layout,
+                      const char *variant, const char *options, KeymapComponents *out);
+
+#endif
@@ -1,10 +1,13 @@
 // cli/src/backends/xorg_conf.c
 #define _POSIX_C_SOURCE 200809L
 #include "xorg_conf.h"
+#include "xorg_input.h"
+#include "../util/config.h"
 #include "../util/output.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
 #define XORG_CONF_DIR "/etc/X11/xorg.conf.d"
@@ -20,119 +23,137 @@ static char *get_config_path(void) {
     return path;
 }
 
-static int write_config(const char *content) {
+#define CONFIG_HEADER \
+    "# OpenDE Input Configuration\n" \
+    "# Generated by opende CLI - do not edit manually\n"
+
+// One Option line inside an InputClass section of our file
+typedef struct {
+    const char *identifier;  // Section to edit ("OpenDE touchpad")
+    const char *match;       // Match line for a new section
+    const char *option;
+    const char *value;
+} OptionEdit;
+
+static char *edit_option(const char *text, void *data) {
+    const OptionEdit *edit = data;
+    if (!*text) text = CONFIG_HEADER;
+
+    char identifier[128], option[128], line[256];
+    snprintf(identifier, sizeof(identifier), "Identifier \"%s\"", edit->identifier);
+    snprintf(option, sizeof(option), "Option \"%s\"", edit->option);
+    snprintf(line, sizeof(line), "    Option \"%s\" \"%s\"\n", edit->option, edit->value);
+
+    size_t len = strlen(text) + 512;
+    char *out = malloc(len);
+    if (!out) return NULL;
+
+    const char *section = strstr(text, identifier);
+    const char *end = section ? strstr(section, "EndSection") : NULL;
+    if (!end) {
+        // Add the section, keeping the others
+        size_t tlen = strlen(text);
+        snprintf(out, len,
+                 "%s%s\nSection \"InputClass\"\n"
+                 "    Identifier \"%s\"\n"
+                 "    %s \"on\"\n"
+                 "    Driver \"libinput\"\n"
+                 "%s"
+                 "EndSection\n",
+                 text, tlen > 0 && text[tlen - 1] != '\n' ? "\n" : "",
+                 edit->identifier, edit->match, line);
+        return out;
+    }
+
+    // Replace the option's line within the section, or add it at the end
+    const char *found = strstr(section, option);
+    if (found && found < end) {
+        const char *start = found;
+        while (start > text && start[-1] != '\n') start--;
+        const char *next = strchr(found, '\n');
+        next = next ? next + 1 : found + strlen(found);
+        snprintf(out, len, "%.*s%s%s", (int)(start - text), text, line, next);
+    } else {
+        const char *start = end;
+        while (start > text && start[-1] != '\n') start--;
+        snprintf(out, len, "%.*s%s%s", (int)(start - text), text, line, start);
+    }
+    return out;
+}
+
+// Update one option in place. The file is swapped in atomically, so the
+// X server and other readers never see it half written, and concurrent
+// writers (touchpad and pointer settings) don't drop each other's options.
+static int write_option(const char *identifier, const char *match,
+                        const char *option, const char *value) {
     if (!xorg_can_write()) {
         print_error("Permission denied. Run with sudo.");
         return -1;
     }
 
     char *path = get_config_path();
-    FILE *fp = fopen(path, "w");
-    if (!fp) {
+    OptionEdit edit = { identifier, match, option, value };
+    if (config_update_file(path, edit_option, &edit) != 0) {
         print_error("Cannot write to %s", path);
         return -1;
     }
 
-    fprintf(fp, "%s", content);
-    fclose(fp);
+    // A fragment read after ours (a later name, or /usr/share) wins
+    XorgOption effective;
+    unsigned int kind = strcmp(match, "MatchIsTouchpad") == 0 ? XORG_IS_TOUCHPAD : XORG_IS_POINTER;
+    if (xorg_input_option(kind, option, &effective) == 0 && strcmp(effective.file, path) != 0) {
+        print_warn("%s is overridden by %s (\"%s\" in %s)", option, effective.value,
+                   effective.section, effective.file);
+    }
 
     print_warn("Changes require X restart or re-login to take effect");
     return 0;
 }
 
-// Read current config or return defaults
-static int read_option(const char *option) {
-    char *path = get_config_path();
-    FILE *fp = fopen(path, "r");
-    if (!fp) return -1;  // No config = default
-
-    char line[256];
-    int result = -1;
-
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, option)) {
-            if (strstr(line, "\"true\"") || strstr(line, "\"on\"") || strstr(line, "\"1\"")) {
-                result = 1;
-            } else if (strstr(line, "\"false\"") || strstr(line, "\"off\"") || strstr(line, "\"0\"")) {
-                result = 0;
-            }
-            break;
-        }
-    }
-
-    fclose(fp);
-    return result;
+// The option as the server applies it to devices of the kind: 1 or 0, or
+// -1 when no InputClass section sets it (driver default)
+static int read_option(unsigned int kind, const char *option) {
+    XorgOption effective;
+    if (xorg_input_option(kind, option, &effective) != 0) return -1;
+
+    const char *v = effective.value;
+    if (strcasecmp(v, "true") == 0 || strcasecmp(v, "on") == 0 || strcasecmp(v, "yes") == 0 ||
+        strcmp(v, "1") == 0) return 1;
+    if (strcasecmp(v, "false") == 0 || strcasecmp(v, "off") == 0 || strcasecmp(v, "no") == 0 ||
+        strcmp(v, "0") == 0) return 0;
+    return -1;
 }
 
 int xorg_get_natural_scroll(void) {
-    return read_option("NaturalScrolling");
+    return read_option(XORG_IS_TOUCHPAD, "NaturalScrolling");
 }
 
 int xorg_set_natural_scroll(int enabled) {
-    char content[1024];
-    snprintf(content, sizeof(content),
-        "# OpenDE Input Configuration\n"
-        "# Generated by opende CLI - do not edit manually\n\n"
-        "Section \"InputClass\"\n"
-        "    Identifier \"OpenDE touchpad\"\n"
-        "    MatchIsTouchpad \"on\"\n"
-        "    Driver \"libinput\"\n"
-        "    Option \"NaturalScrolling\" \"%s\"\n"
-        "EndSection\n",
-        enabled ? "true" : "false");
-
-    return write_config(content);
+    return write_option("OpenDE touchpad", "MatchIsTouchpad", "NaturalScrolling",
+                        enabled ? "true" : "false");
 }
 
 int xorg_get_tap_click(void) {
-    return read_option("Tapping");
+    return read_option(XORG_IS_TOUCHPAD, "Tapping");
 }
 
 int xorg_set_tap_click(int enabled) {
-    char content[1024];
-    snprintf(content, sizeof(content),
-        "# OpenDE Input Configuration\n"
-        "# Generated by opende CLI - do not edit manually\n\n"
-        "Section \"InputClass\"\n"
-        "    Identifier \"OpenDE touchpad\"\n"
-        "    MatchIsTouchpad \"on\"\n"
-        "    Driver \"libinput\"\n"
-        "    Option \"Tapping\" \"%s\"\n"
-        "EndSection\n",
-        enabled ? "on" : "off");
-
-    return write_config(content);
+    return write_option("OpenDE touchpad", "MatchIsTouchpad", "Tapping",
+                        enabled ? "on" : "off");
 }
 
 char *xorg_get_mouse_accel(void) {
-    char *path = get_config_path();
-    FILE *fp = fopen(path, "r");
-    if (!fp) return strdup("default");
-
-    char line[256];
-    char *result = strdup("default");
-
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "AccelSpeed")) {
-            if (strstr(line, "\"-1\"")) {
-                free(result);
-                result = strdup("off");
-            } else if (strstr(line, "\"-0.5\"")) {
-                free(result);
-                result = strdup("low");
-            } else if (strstr(line, "\"0\"")) {
-                free(result);
-                result = strdup("medium");
-            } else if (strstr(line, "\"0.5\"")) {
-                free(result);
-                result = strdup("high");
-            }
-            break;
-        }
-    }
-
-    fclose(fp);
-    return result;
+    XorgOption effective;
+    if (xorg_input_option(XORG_IS_POINTER, "AccelSpeed", &effective) != 0) return strdup("default");
+
+    // Nearest of the levels we write (-1, -0.5, 0, 0.5)
+    char *end;
+    double speed = strtod(effective.value, &end);
+    if (end == effective.value) return strdup("default");
+    if (speed <= -0.75) return strdup("off");
+    if (speed < -0.25) return strdup("low");
+    if (speed < 0.25) return strdup("medium");
+    return strdup("high");
 }
 
 int xorg_set_mouse_accel(const char *level) {
@@ -147,17 +168,5 @@ int xorg_set_mouse_accel(const char *level) {
         return -1;
     }
 
-    char content[1024];
-    snprintf(content, sizeof(content),
-        "# OpenDE Input Configuration\n"
-        "# Generated by opende CLI - do not edit manually\n\n"
-        "Section \"InputClass\"\n"
-        "    Identifier \"OpenDE pointer\"\n"
-        "    MatchIsPointer \"on\"\n"
-        "    Driver \"libinput\"\n"
-        "    Option \"AccelSpeed\" \"%s\"\n"
-        "EndSection\n",
-        accel_value);
-
-    return write_config(content);
+    return write_option("OpenDE pointer", "MatchIsPointer", "AccelSpeed", accel_value);
 }
@@ -0,0 +1,597 @@
+// cli/src/backends/xorg_input.c
+#define _POSIX_C_SOURCE 200809L
+#include "xorg_input.h"
+#include "../util/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <linux/input.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+
+#define XORG_CONF        "/etc/X11/xorg.conf"
+#define XORG_CONF_DIR    "/etc/X11/xorg.conf.d"
+#define XORG_SYSCONF_DIR "/usr/share/X11/xorg.conf.d"
+#define PROC_DEVICES     "/proc/bus/input/devices"
+#define CACHE_FILE       "xorg-input.cache"
+
+#define MAX_MATCHES 16
+#define MAX_OPTIONS 24
+#define MAX_DEVICES 64
+
+// --- Configuration -------------------------------------------------------
+
+typedef struct {
+    char keyword[24];        // As written: "MatchProduct", "NoMatchUSBID", ...
+    char value[128];         // '|'-separated alternatives
+} Match;
+
+typedef struct {
+    char name[48];
+    char value[80];
+} Option;
+
+typedef struct {
+    char file[128];
+    char identifier[80];
+    char driver[32];
+    Match matches[MAX_MATCHES];
+    int match_count;
+    Option options[MAX_OPTIONS];
+    int option_count;
+} Section;
+
+typedef struct {
+    Section *sections;
+    int count;
+    int capacity;
+} Config;
+
+// The server compares keywords and option names ignoring case, '_' and blanks
+static int name_equal(const char *a, const char *b) {
+    for (;;) {
+        while (*a == '_' || *a == ' ' || *a == '\t') a++;
+        while (*b == '_' || *b == ' ' || *b == '\t') b++;
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) return 0;
+        if (!*a) return 1;
+        a++;
+        b++;
+    }
+}
+
+static Section *add_section(Config *config, const char *file) {
+    if (config->count == config->capacity) {
+        int capacity = config->capacity ? config->capacity * 2 : 16;
+        Section *grown = realloc(config->sections, (size_t)capacity * sizeof(Section));
+        if (!grown) return NULL;
+        config->sections = grown;
+        config->capacity = capacity;
+    }
+    Section *section = &config->sections[config->count++];
+    memset(section, 0, sizeof(*section));
+    snprintf(section->file, sizeof(section->file), "%s", file);
+    return section;
+}
+
+// A later Option of the same name replaces the earlier one
+static void set_option(Option *options, int *count, int max, const char *name, const char *value) {
+    int i = 0;
+    while (i < *count && !name_equal(options[i].name, name)) i++;
+    if (i == *count) {
+        if (*count >= max) return;
+        (*count)++;
+    }
+    snprintf(options[i].name, sizeof(options[i].name), "%s", name);
+    snprintf(options[i].value, sizeof(options[i].value), "%s", value);
+}
+
+// Words and "quoted strings" up to a '#' comment. Tabs inside quotes
+// become spaces so values survive the tab-separated cache
+static int tokenize(char *line, char **tokens, int max) {
+    int count = 0;
+    char *p = line;
+    while (*p && count < max) {
+        while (isspace((unsigned char)*p)) p++;
+        if (!*p || *p == '#') break;
+
+        if (*p == '"') {
+            tokens[count++] = ++p;
+            while (*p && *p != '"') {
+                if (*p == '\t') *p = ' ';
+                p++;
+            }
+        } else {
+            tokens[count++] = p;
+            while (*p && !isspace((unsigned char)*p) && *p != '#' && *p != '"') p++;
+        }
+        if (!*p) break;
+        char c = *p;
+        *p++ = '\0';
+        if (c == '#') break;
+    }
+    return count;
+}
+
+static void parse_file(Config *config, const char *path) {
+    char *text = config_read_file(path);
+    if (!text) return;
+
+    Section *current = NULL;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        char *tokens[4];
+        int count = tokenize(line, tokens, 4);
+        if (count == 0) continue;
+
+        if (name_equal(tokens[0], "Section")) {
+            current = count > 1 && name_equal(tokens[1], "InputClass") ? add_section(config, path) : NULL;
+            continue;
+        }
+        if (name_equal(tokens[0], "EndSection")) {
+            current = NULL;
+            continue;
+        }
+        if (!current || count < 2) continue;
+
+        if (name_equal(tokens[0], "Identifier")) {
+            snprintf(current->identifier, sizeof(current->identifier), "%s", tokens[1]);
+        } else if (name_equal(tokens[0], "Driver")) {
+            snprintf(current->driver, sizeof(current->driver), "%s", tokens[1]);
+        } else if (name_equal(tokens[0], "Option")) {
+            // A bare Option is a boolean set to true
+            set_option(current->options, &current->option_count, MAX_OPTIONS, tokens[1],
+                       count > 2 ? tokens[2] : "on");
+        } else if ((strncasecmp(tokens[0], "Match", 5) == 0 || strncasecmp(tokens[0], "NoMatch", 7) == 0) &&
+                   current->match_count < MAX_MATCHES) {
+            Match *match = &current->matches[current->match_count++];
+            snprintf(match->keyword, sizeof(match->keyword), "%s", tokens[0]);
+            snprintf(match->value, sizeof(match->value), "%s", tokens[1]);
+        }
+    }
+    free(text);
+}
+
+static int conf_file(const struct dirent *entry) {
+    size_t len = strlen(entry->d_name);
+    return entry->d_name[0] != '.' && len > 5 && strcmp(entry->d_name + len - 5, ".conf") == 0;
+}
+
+static void parse_dir(Config *config, const char *dir) {
+    struct dirent **entries;
+    int count = scandir(dir, &entries, conf_file, alphasort);
+    if (count < 0) return;
+
+    for (int i = 0; i < count; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, entries[i]->d_name);
+        parse_file(config, path);
+        free(entries[i]);
+    }
+    free(entries);
+}
+
+// Changes when a fragment is added, removed or replaced (editors and
+// config_update_file rename over the old file)
+static void cache_key(char *buf, size_t size) {
+    static const char *paths[] = { XORG_CONF, XORG_CONF_DIR, XORG_SYSCONF_DIR };
+    size_t len = 0;
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]) && len < size; i++) {
+        struct stat st;
+        if (stat(paths[i], &st) == 0) {
+            len += (size_t)snprintf(buf + len, size - len, "%lld.%09ld:%lld ", (long long)st.st_mtim.tv_sec,
+                                    (long)st.st_mtim.tv_nsec, (long long)st.st_ino);
+        } else {
+            len += (size_t)snprintf(buf + len, size - len, "- ");
+        }
+    }
+}
+
+static int split_tabs(char *line, char **fields, int max) {
+    int count = 0;
+    while (count < max) {
+        fields[count++] = line;
+        char *tab = strchr(line, '\t');
+        if (!tab) break;
+        *tab = '\0';
+        line = tab + 1;
+    }
+    return count;
+}
+
+// "section\tfile\tidentifier\tdriver", then its "match" and "option" lines
+static void parse_cache(Config *config, char *text) {
+    Section *current = NULL;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        char *fields[4];
+        int count = split_tabs(line, fields, 4);
+
+        if (strcmp(fields[0], "section") == 0 && count == 4) {
+            current = add_section(config, fields[1]);
+            if (!current) return;
+            snprintf(current->identifier, sizeof(current->identifier), "%s", fields[2]);
+            snprintf(current->driver, sizeof(current->driver), "%s", fields[3]);
+        } else if (current && strcmp(fields[0], "match") == 0 && count == 3 &&
+                   current->match_count < MAX_MATCHES) {
+            Match *match = &current->matches[current->match_count++];
+            snprintf(match->keyword, sizeof(match->keyword), "%s", fields[1]);
+            snprintf(match->value, sizeof(match->value), "%s", fields[2]);
+        } else if (current && strcmp(fields[0], "option") == 0 && count == 3) {
+            set_option(current->options, &current->option_count, MAX_OPTIONS, fields[1], fields[2]);
+        }
+    }
+}
+
+static void write_cache(const Config *config, const char *path, const char *key) {
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    if (!out) return;
+
+    fprintf(out, "key\t%s\n", key);
+    for (int i = 0; i < config->count; i++) {
+        const Section *s = &config->sections[i];
+        fprintf(out, "section\t%s\t%s\t%s\n", s->file, s->identifier, s->driver);
+        for (int j = 0; j < s->match_count; j++) {
+            fprintf(out, "match\t%s\t%s\n", s->matches[j].keyword, s->matches[j].value);
+        }
+        for (int j = 0; j < s->option_count; j++) {
+            fprintf(out, "option\t%s\t%s\n", s->options[j].name, s->options[j].value);
+        }
+    }
+    fclose(out);
+
+    if (text) config_write_file(path, text);
+    free(text);
+}
+
+// Every InputClass section in the order the server reads them
+static void load_config(Config *config) {
+    char key[256];
+    cache_key(key, sizeof(key));
+
+    char *cache_path = config_get_runtime_path(CACHE_FILE);
+    char *cached = cache_path ? config_read_file(cache_path) : NULL;
+    size_t key_len = strlen(key);
+    if (cached && strncmp(cached, "key\t", 4) == 0 && strncmp(cached + 4, key, key_len) == 0 &&
+        cached[4 + key_len] == '\n') {
+        parse_cache(config, cached + 5 + key_len);
+    } else {
+        parse_file(config, XORG_CONF);
+        parse_dir(config, XORG_CONF_DIR);
+        parse_dir(config, XORG_SYSCONF_DIR);
+        if (cache_path) write_cache(config, cache_path, key);
+    }
+    free(cached);
+    free(cache_path);
+}
+
+// --- Devices -------------------------------------------------------------
+
+#define BITS_PER_WORD (8 * sizeof(unsigned long))
+#define KEY_WORDS     ((KEY_MAX + BITS_PER_WORD) / BITS_PER_WORD)
+
+typedef struct {
+    char name[128];
+    char path[32];
+    char vendor[64];
+    char usb_id[16];
+    unsigned int kinds;
+} Device;
+
+// "e520 10000 0 0": most significant word first
+static void parse_bits(const char *hex, unsigned long *bits, size_t words) {
+    unsigned long values[KEY_WORDS];
+    size_t count = 0;
+    memset(bits, 0, words * sizeof(unsigned long));
+
+    const char *p = hex;
+    while (*p && count < KEY_WORDS) {
+        char *end;
+        unsigned long value = strtoul(p, &end, 16);
+        if (end == p) break;
+        values[count++] = value;
+        p = end;
+    }
+    for (size_t i = 0; i < count && i < words; i++) bits[i] = values[count - 1 - i];
+}
+
+static int test_bit(const unsigned long *bits, size_t words, unsigned int bit) {
+    size_t word = bit / BITS_PER_WORD;
+    return word < words && (bits[word] >> (bit % BITS_PER_WORD)) & 1;
+}
+
+typedef struct {
+    unsigned long ev[1], key[KEY_WORDS], rel[1], abs[1], prop[1];
+} Capabilities;
+
+// udev's input_id rules, which set the server's MatchIs* attributes
+static unsigned int classify(const Capabilities *c) {
+    unsigned int kinds = 0;
+    int abs = test_bit(c->ev, 1, EV_ABS) && test_bit(c->abs, 1, ABS_X) && test_bit(c->abs, 1, ABS_Y);
+    int rel = test_bit(c->ev, 1, EV_REL) && test_bit(c->rel, 1, REL_X) && test_bit(c->rel, 1, REL_Y);
+    int mouse_button = test_bit(c->key, KEY_WORDS, BTN_MOUSE);
+    int pen = test_bit(c->key, KEY_WORDS, BTN_TOOL_PEN) || test_bit(c->key, KEY_WORDS, BTN_STYLUS);
+    int finger = test_bit(c->key, KEY_WORDS, BTN_TOOL_FINGER);
+    int touch = test_bit(c->key, KEY_WORDS, BTN_TOUCH);
+    int direct = test_bit(c->prop, 1, INPUT_PROP_DIRECT);
+
+    int joystick = 0;
+    for (unsigned int b = BTN_JOYSTICK; b < BTN_DIGI && !joystick; b++) {
+        joystick = test_bit(c->key, KEY_WORDS, b);
+    }
+
+    if (abs) {
+        if (pen) kinds |= XORG_IS_TABLET;
+        else if (finger && !direct) kinds |= XORG_IS_TOUCHPAD;
+        else if (mouse_button) kinds |= XORG_IS_POINTER;
+        else if (touch || direct) kinds |= XORG_IS_TOUCHSCREEN;
+        else if (joystick) kinds |= XORG_IS_JOYSTICK;
+    }
+    if (rel && mouse_button) kinds |= XORG_IS_POINTER;
+
+    // Escape through D: a keyboard, not just a few buttons
+    int keyboard = test_bit(c->ev, 1, EV_KEY);
+    for (unsigned int k = KEY_ESC; k <= KEY_D && keyboard; k++) keyboard = test_bit(c->key, KEY_WORDS, k);
+    if (keyboard) kinds |= XORG_IS_KEYBOARD;
+    return kinds;
+}
+
+// "manufacturer" of the nearest parent that has one (USB devices)
+static void read_vendor(const char *sysfs, char *out, size_t size) {
+    char path[512];
+    snprintf(path, sizeof(path), "/sys%s", sysfs);
+    for (int depth = 0; depth < 8; depth++) {
+        char file[600];
+        snprintf(file, sizeof(file), "%s/manufacturer", path);
+        char *text = config_read_file(file);
+        if (text) {
+            text[strcspn(text, "\n")] = '\0';
+            snprintf(out, size, "%s", text);
+            free(text);
+            return;
+        }
+        char *slash = strrchr(path, '/');
+        if (!slash || slash == path) return;
+        *slash = '\0';
+    }
+}
+
+static int finish_device(Device *device, const Capabilities *caps, const char *sysfs) {
+    if (!device->path[0]) return 0;   // No event node: the server never sees it
+    device->kinds = classify(caps);
+    if (sysfs[0]) read_vendor(sysfs, device->vendor, sizeof(device->vendor));
+    return 1;
+}
+
+static int read_devices(Device *devices, int max) {
+    char *text = config_read_file(PROC_DEVICES);
+    if (!text) return 0;
+
+    int count = 0;
+    Device current;
+    Capabilities caps;
+    char sysfs[256] = "";
+    memset(&current, 0, sizeof(current));
+    memset(&caps, 0, sizeof(caps));
+
+    // Blocks of "X: ..." lines separated by blank lines
+    char *line = text;
+    while (line && count < max) {
+        char *next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        unsigned int bus, vendor, product;
+        if (!*line) {
+            if (finish_device(&current, &caps, sysfs)) devices[count++] = current;
+            memset(&current, 0, sizeof(current));
+            memset(&caps, 0, sizeof(caps));
+            sysfs[0] = '\0';
+        } else if (sscanf(line, "I: Bus=%x Vendor=%x Product=%x", &bus, &vendor, &product) == 3) {
+            snprintf(current.usb_id, sizeof(current.usb_id), "%04x:%04x", vendor & 0xffff, product & 0xffff);
+        } else if (strncmp(line, "N: Name=\"", 9) == 0) {
+            snprintf(current.name, sizeof(current.name), "%.*s", (int)strcspn(line + 9, "\""), line + 9);
+        } else if (strncmp(line, "S: Sysfs=", 9) == 0) {
+            snprintf(sysfs, sizeof(sysfs), "%s", line + 9);
+        } else if (strncmp(line, "H: Handlers=", 12) == 0) {
+            const char *event = strstr(line, "event");
+            int n;
+            if (event && sscanf(event, "event%d", &n) == 1) {
+                snprintf(current.path, sizeof(current.path), "/dev/input/event%d", n);
+            }
+        } else if (strncmp(line, "B: EV=", 6) == 0) {
+            parse_bits(line + 6, caps.ev, 1);
+        } else if (strncmp(line, "B: KEY=", 7) == 0) {
+            parse_bits(line + 7, caps.key, KEY_WORDS);
+        } else if (strncmp(line, "B: REL=", 7) == 0) {
+            parse_bits(line + 7, caps.rel, 1);
+        } else if (strncmp(line, "B: ABS=", 7) == 0) {
+            parse_bits(line + 7, caps.abs, 1);
+        } else if (strncmp(line, "B: PROP=", 8) == 0) {
+            parse_bits(line + 8, caps.prop, 1);
+        }
+        line = next;
+    }
+    if (count < max && finish_device(&current, &caps, sysfs)) devices[count++] = current;
+
+    free(text);
+    return count;
+}
+
+// --- Matching ------------------------------------------------------------
+
+typedef enum { CMP_SUBSTRING, CMP_PATTERN, CMP_CASE, CMP_EXACT } Compare;
+
+static int compare(Compare how, const char *attr, const char *pattern) {
+    switch (how) {
+        case CMP_SUBSTRING: return strstr(attr, pattern) != NULL;
+        case CMP_PATTERN:   return fnmatch(pattern, attr, 0) == 0;
+        case CMP_CASE:      return strcasecmp(attr, pattern) == 0;
+        default:            return strcmp(attr, pattern) == 0;
+    }
+}
+
+// One Match line: any '|' alternative matches (NoMatch: none does). An
+// attribute the device doesn't have rejects either way
+static int match_token(const char *attr, const char *value, Compare how, int negated) {
+    if (!attr || !*attr) return 0;
+
+    int matched = 0;
+    const char *p = value;
+    while (!matched) {
+        size_t len = strcspn(p, "|");
+        char alternative[128];
+        snprintf(alternative, sizeof(alternative), "%.*s", (int)len, p);
+        matched = compare(how, attr, alternative);
+        if (!p[len]) break;
+        p += len + 1;
+    }
+    return negated ? !matched : matched;
+}
+
+static int parse_bool(const char *value) {
+    static const char *on[] = { "on", "true", "yes", "1", NULL };
+    static const char *off[] = { "off", "false", "no", "0", NULL };
+    for (int i = 0; on[i]; i++) {
+        if (strcasecmp(value, on[i]) == 0) return 1;
+        if (strcasecmp(value, off[i]) == 0) return 0;
+    }
+    return -1;
+}
+
+static int section_matches(const Section *s, const Device *d, const char *driver) {
+    static const struct {
+        const char *name;
+        unsigned int kind;
+    } kinds[] = {
+        { "IsKeyboard", XORG_IS_KEYBOARD },       { "IsPointer", XORG_IS_POINTER },
+        { "IsTouchpad", XORG_IS_TOUCHPAD },       { "IsTouchscreen", XORG_IS_TOUCHSCREEN },
+        { "IsTablet", XORG_IS_TABLET },           { "IsJoystick", XORG_IS_JOYSTICK },
+    };
+
+    struct utsname uts;
+    const char *os = uname(&uts) == 0 ? uts.sysname : "Linux";
+
+    for (int i = 0; i < s->match_count; i++) {
+        const Match *m = &s->matches[i];
+        int negated = strncasecmp(m->keyword, "No", 2) == 0;
+        const char *what = m->keyword + (negated ? 7 : 5);   // After "Match"
+
+        int handled = 0, ok = 1;
+        for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]) && !handled; k++) {
+            if (!name_equal(what, kinds[k].name)) continue;
+            handled = 1;
+            int want = parse_bool(m->value);
+            ok = want < 0 || want == ((d->kinds & kinds[k].kind) != 0);
+        }
+        if (handled) {
+            if (!ok) return 0;
+            continue;
+        }
+
+        if (name_equal(what, "Product")) ok = match_token(d->name, m->value, CMP_SUBSTRING, negated);
+        else if (name_equal(what, "Vendor")) ok = match_token(d->vendor, m->value, CMP_SUBSTRING, negated);
+        else if (name_equal(what, "DevicePath")) ok = match_token(d->path, m->value, CMP_PATTERN, negated);
+        else if (name_equal(what, "USBID")) ok = match_token(d->usb_id, m->value, CMP_PATTERN, negated);
+        else if (name_equal(what, "OS")) ok = match_token(os, m->value, CMP_CASE, negated);
+        else if (name_equal(what, "Driver")) ok = match_token(driver, m->value, CMP_EXACT, negated);
+        else if (name_equal(what, "Layout")) ok = 1;   // Only one layout is ever in use
+        else ok = 0;                                    // PnPID, Tag: not known here
+
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+static void set_effective(XorgOption *out, const char *name, const char *value, const Section *s) {
+    snprintf(out->name, sizeof(out->name), "%s", name);
+    snprintf(out->value, sizeof(out->value), "%s", value);
+    snprintf(out->file, sizeof(out->file), "%s", s->file);
+    snprintf(out->section, sizeof(out->section), "%s", s->identifier);
+}
+
+// Merge matching sections in order, later ones winning
+static void resolve(const Config *config, const Device *d, XorgDevice *out) {
+    memset(out, 0, sizeof(*out));
+    snprintf(out->name, sizeof(out->name), "%s", d->name);
+    snprintf(out->path, sizeof(out->path), "%s", d->path);
+    out->kinds = d->kinds;
+
+    for (int i = 0; i < config->count; i++) {
+        const Section *s = &config->sections[i];
+        if (!section_matches(s, d, out->driver.value)) continue;
+
+        if (s->driver[0]) set_effective(&out->driver, "Driver", s->driver, s);
+        for (int j = 0; j < s->option_count; j++) {
+            int k = 0;
+            while (k < out->option_count && !name_equal(out->options[k].name, s->options[j].name)) k++;
+            if (k == out->option_count) {
+                if (k >= XORG_MAX_DEVICE_OPTIONS) continue;
+                out->option_count++;
+            }
+            set_effective(&out->options[k], s->options[j].name, s->options[j].value, s);
+        }
+    }
+}
+
+XorgDevice *xorg_input_devices(int *count) {
+    Device *devices = calloc(MAX_DEVICES, sizeof(Device));
+    if (!devices) return NULL;
+    int n = read_devices(devices, MAX_DEVICES);
+
+    XorgDevice *out = calloc(n > 0 ? (size_t)n : 1, sizeof(XorgDevice));
+    if (out) {
+        Config config = { NULL, 0, 0 };
+        load_config(&config);
+        for (int i = 0; i < n; i++) resolve(&config, &devices[i], &out[i]);
+        free(config.sections);
+        *count = n;
+    }
+    free(devices);
+    return out;
+}
+
+int xorg_input_option(unsigned int kind, const char *option, XorgOption *out) {
+    Device *devices = calloc(MAX_DEVICES, sizeof(Device));
+    XorgDevice *resolved = malloc(sizeof(XorgDevice));
+    if (!devices || !resolved) {
+        free(devices);
+        free(resolved);
+        return -1;
+    }
+
+    int n = read_devices(devices, MAX_DEVICES);
+    const Device *device = NULL;
+    for (int i = 0; i < n && !device; i++) {
+        if (devices[i].kinds & kind) device = &devices[i];
+    }
+
+    // Nothing of that kind plugged in: a device with only the kind set
+    Device generic;
+    if (!device) {
+        memset(&generic, 0, sizeof(generic));
+        generic.kinds = kind;
+        device = &generic;
+    }
+
+    Config config = { NULL, 0, 0 };
+    load_config(&config);
+    resolve(&config, device, resolved);
+    free(config.sections);
+
+    int result = -1;
+    for (int i = 0; i < resolved->option_count; i++) {
+        if (name_equal(resolved->options[i].name, option)) {
+            *out = resolved->options[i];
+            result = 0;
+            break;
+        }
+    }
+    free(resolved);
+    free(devices);
+    return result;
+}
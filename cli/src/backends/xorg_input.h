@@ -0,0 +1,49 @@
+// cli/src/backends/xorg_input.h
+#ifndef OPENDE_XORG_INPUT_H
+#define OPENDE_XORG_INPUT_H
+
+// Effective X server input configuration. Every InputClass section of
+// xorg.conf and the xorg.conf.d fragments (/etc first, then /usr/share,
+// each in lexical order) is evaluated against the input devices present,
+// as the server does when a device is added: sections whose Match* rules
+// fit the device are merged in order, later ones overriding options and
+// the driver set by earlier ones.
+
+// Device kinds, as udev classifies them for the server's MatchIs* rules
+#define XORG_IS_KEYBOARD    (1u << 0)
+#define XORG_IS_POINTER     (1u << 1)
+#define XORG_IS_TOUCHPAD    (1u << 2)
+#define XORG_IS_TOUCHSCREEN (1u << 3)
+#define XORG_IS_TABLET      (1u << 4)
+#define XORG_IS_JOYSTICK    (1u << 5)
+
+#define XORG_MAX_DEVICE_OPTIONS 32
+
+typedef struct {
+    char name[48];           // As written in the section that won
+    char value[80];
+    char file[128];          // Fragment that set it
+    char section[80];        // Its InputClass Identifier
+} XorgOption;
+
+typedef struct {
+    char name[128];          // Product name ("" for a generic device)
+    char path[32];           // /dev/input/eventN
+    unsigned int kinds;      // XORG_IS_* bits
+    XorgOption driver;       // value "" if no section sets a driver
+    XorgOption options[XORG_MAX_DEVICE_OPTIONS];
+    int option_count;
+} XorgDevice;
+
+// Input devices present now with their effective configuration.
+// Returns an allocated array (caller must free) and sets *count, or NULL
+// on error. The parsed configuration is cached in the runtime dir until
+// one of the configuration directories changes.
+XorgDevice *xorg_input_devices(int *count);
+
+// The option as the first present device of the kind gets it, or as a
+// device of that kind would get it if none is plugged in. Returns 0 and
+// fills out, or -1 if no section sets the option
+int xorg_input_option(unsigned int kind, const char *option, XorgOption *out);
+
+#endif
@@ -0,0 +1,276 @@
+// cli/src/backends/xrandr.c
+#define _POSIX_C_SOURCE 200809L
+#include "xrandr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define RATE_TOLERANCE 0.05
+
+int xrandr_is_installed(void) {
+    return system("which xrandr > /dev/null 2>&1") == 0;
+}
+
+static void edid_id(const char *hex, char *out) {
+    // FNV-1a over the hex dump; the EDID carries the serial number, so
+    // two monitors of the same model still differ
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *p = hex; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 1099511628211ULL;
+    }
+    snprintf(out, DISPLAY_EDID_ID_MAX, "%016llx", (unsigned long long)hash);
+}
+
+// "eDP-1 connected primary 1920x1080+0+0 left (normal left ...) 344mm x 194mm"
+static void parse_output_line(char *line, DisplayOutput *out) {
+    memset(out, 0, sizeof(*out));
+    snprintf(out->rotation, sizeof(out->rotation), "normal");
+
+    char *save = NULL;
+    char *tok = strtok_r(line, " ", &save);
+    if (!tok) return;
+    snprintf(out->name, sizeof(out->name), "%s", tok);
+
+    int geometry_w = 0, geometry_h = 0;
+    while ((tok = strtok_r(NULL, " ", &save)) != NULL && tok[0] != '(') {
+        int w, h, x, y;
+        if (strcmp(tok, "connected") == 0 || strcmp(tok, "unknown") == 0) {
+            // "unknown connection" (VMs, some VGA ports) counts as connected,
+            // as it does for xrandr --auto
+            out->connected = 1;
+        } else if (strcmp(tok, "primary") == 0) {
+            out->primary = 1;
+        } else if (sscanf(tok, "%dx%d+%d+%d", &w, &h, &x, &y) == 4) {
+            out->enabled = 1;
+            geometry_w = w;
+            geometry_h = h;
+            out->x = x;
+            out->y = y;
+        } else if (strcmp(tok, "left") == 0 || strcmp(tok, "right") == 0 ||
+                   strcmp(tok, "inverted") == 0 || strcmp(tok, "normal") == 0) {
+            snprintf(out->rotation, sizeof(out->rotation), "%s", tok);
+        }
+    }
+
+    // Until the current mode line says otherwise
+    int sideways = strcmp(out->rotation, "left") == 0 || strcmp(out->rotation, "right") == 0;
+    out->width = sideways ? geometry_h : geometry_w;
+    out->height = sideways ? geometry_w : geometry_h;
+}
+
+// "   1920x1080     60.02*+  60.01    59.97 +"
+static void parse_mode_line(const char *line, DisplayOutput *out) {
+    int width, height, consumed;
+    if (sscanf(line, " %dx%d%n", &width, &height, &consumed) != 2) return;
+
+    const char *p = line + consumed;
+    int interlaced = *p == 'i';
+    while (*p && !isspace((unsigned char)*p)) p++;   // Rest of the mode name
+
+    while (*p) {
+        while (isspace((unsigned char)*p)) p++;
+        if (!*p) break;
+
+        // A lone '+' marks the previous rate as preferred
+        if (*p == '+') {
+            if (out->mode_count > 0) out->modes[out->mode_count - 1].preferred = 1;
+            p++;
+            continue;
+        }
+
+        char *end;
+        double rate = strtod(p, &end);
+        if (end == p) break;
+        p = end;
+
+        int current = 0, preferred = 0;
+        for (; *p == '*' || *p == '+'; p++) {
+            if (*p == '*') current = 1;
+            else preferred = 1;
+        }
+
+        if (out->mode_count < DISPLAY_MAX_MODES) {
+            DisplayMode *mode = &out->modes[out->mode_count++];
+            mode->width = width;
+            mode->height = height;
+            mode->rate = rate;
+            mode->interlaced = interlaced;
+            mode->preferred = preferred;
+        }
+        if (current) {
+            out->width = width;
+            out->height = height;
+            out->rate = rate;
+        }
+    }
+}
+
+int xrandr_parse(const char *text, DisplayOutput *outputs, int max) {
+    char *copy = strdup(text);
+    if (!copy) return 0;
+
+    int count = 0, in_edid = 0;
+    char edid_hex[1024] = "";
+    DisplayOutput *current = NULL;
+
+    char *save = NULL;
+    for (char *line = strtok_r(copy, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        // EDID hex continues on lines indented by two tabs
+        if (in_edid && strncmp(line, "\t\t", 2) == 0) {
+            size_t len = strlen(edid_hex);
+            snprintf(edid_hex + len, sizeof(edid_hex) - len, "%s", line + 2);
+            continue;
+        }
+        if (in_edid) {
+            if (current && edid_hex[0]) edid_id(edid_hex, current->edid);
+            in_edid = 0;
+        }
+
+        if (strncmp(line, "Screen ", 7) == 0) continue;
+
+        if (line[0] == '\t') {
+            in_edid = current && strncmp(line, "\tEDID:", 6) == 0;
+            edid_hex[0] = '\0';
+            continue;
+        }
+
+        if (line[0] == ' ') {
+            if (current) parse_mode_line(line, current);
+            continue;
+        }
+
+        if (count >= max) {
+            current = NULL;
+            continue;
+        }
+        current = &outputs[count++];
+        parse_output_line(line, current);
+    }
+    if (in_edid && current && edid_hex[0]) edid_id(edid_hex, current->edid);
+
+    free(copy);
+    return count;
+}
+
+int xrandr_query(DisplayOutput *outputs, int max) {
+    FILE *fp = popen("xrandr --props 2>/dev/null", "r");
+    if (!fp) return -1;
+
+    size_t size = 0, capacity = 16384;
+    char *text = malloc(capacity);
+    size_t n;
+    while (text && (n = fread(text + size, 1, capacity - size - 1, fp)) > 0) {
+        size += n;
+        if (capacity - size < 4096) {
+            char *grown = realloc(text, capacity * 2);
+            if (!grown) break;
+            text = grown;
+            capacity *= 2;
+        }
+    }
+    int status = pclose(fp);
+    if (!text) return -1;
+    text[size] = '\0';
+
+    int count = status == 0 ? xrandr_parse(text, outputs, max) : -1;
+    free(text);
+    return count;
+}
+
+double xrandr_best_rate(const DisplayOutput *output, int width, int height) {
+    double best = 0;
+    for (int i = 0; i < output->mode_count; i++) {
+        const DisplayMode *m = &output->modes[i];
+        if (m->width == width && m->height == height && !m->interlaced && m->rate > best) {
+            best = m->rate;
+        }
+    }
+    return best;
+}
+
+const DisplayMode *xrandr_preferred_mode(const DisplayOutput *output) {
+    for (int i = 0; i < output->mode_count; i++) {
+        if (output->modes[i].preferred) return &output->modes[i];
+    }
+    return output->mode_count > 0 ? &output->modes[0] : NULL;
+}
+
+static const DisplayConfig *find_config(const DisplayConfig *configs, int count, const char *name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(configs[i].name, name) == 0) return &configs[i];
+    }
+    return NULL;
+}
+
+int xrandr_matches(const DisplayConfig *configs, int count,
+                   const DisplayOutput *outputs, int output_count) {
+    for (int i = 0; i < output_count; i++) {
+        const DisplayOutput *o = &outputs[i];
+        const DisplayConfig *c = find_config(configs, count, o->name);
+        int want = c && c->enabled;
+
+        if (want != o->enabled) return 0;
+        if (!want) continue;
+        if (c->width != o->width || c->height != o->height || c->x != o->x || c->y != o->y ||
+            strcmp(c->rotation, o->rotation) != 0 || c->primary != o->primary) return 0;
+        if (c->rate > 0 && fabs(c->rate - o->rate) > RATE_TOLERANCE) return 0;
+    }
+    return 1;
+}
+
+int xrandr_apply(const DisplayConfig *configs, int count,
+                 const DisplayOutput *outputs, int output_count) {
+    // 13 arguments per output at most, plus "xrandr" and the terminator
+    char *argv[2 + DISPLAY_MAX_OUTPUTS * 13];
+    char values[DISPLAY_MAX_OUTPUTS][3][32];
+    int argc = 0, slot = 0;
+    argv[argc++] = "xrandr";
+
+    for (int i = 0; i < output_count && slot < DISPLAY_MAX_OUTPUTS; i++) {
+        const DisplayOutput *o = &outputs[i];
+        const DisplayConfig *c = find_config(configs, count, o->name);
+        if (!c && !o->enabled) continue;   // Nothing to change
+
+        argv[argc++] = "--output";
+        argv[argc++] = (char *)o->name;
+        if (!c || !c->enabled) {
+            argv[argc++] = "--off";
+            continue;
+        }
+
+        snprintf(values[slot][0], sizeof(values[slot][0]), "%dx%d", c->width, c->height);
+        snprintf(values[slot][1], sizeof(values[slot][1]), "%.2f", c->rate);
+        snprintf(values[slot][2], sizeof(values[slot][2]), "%dx%d", c->x, c->y);
+        argv[argc++] = "--mode";
+        argv[argc++] = values[slot][0];
+        if (c->rate > 0) {
+            argv[argc++] = "--rate";
+            argv[argc++] = values[slot][1];
+        }
+        argv[argc++] = "--pos";
+        argv[argc++] = values[slot][2];
+        argv[argc++] = "--rotate";
+        argv[argc++] = (char *)c->rotation;
+        if (c->primary) argv[argc++] = "--primary";
+        slot++;
+    }
+    argv[argc] = NULL;
+
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0) return -1;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
@@ -0,0 +1,68 @@
+// cli/src/backends/xrandr.h
+#ifndef OPENDE_XRANDR_H
+#define OPENDE_XRANDR_H
+
+// Outputs and modes from `xrandr --props`, and layouts applied with one
+// xrandr invocation: every output of the layout is configured in the same
+// RandR update instead of one modeset per output.
+
+#define DISPLAY_MAX_OUTPUTS 16
+#define DISPLAY_MAX_MODES   96
+#define DISPLAY_NAME_MAX    32
+#define DISPLAY_EDID_ID_MAX 17       // 64-bit hash of the EDID in hex
+
+typedef struct {
+    int width, height;
+    double rate;
+    int interlaced;
+    int preferred;
+} DisplayMode;
+
+typedef struct {
+    char name[DISPLAY_NAME_MAX];
+    int connected;                   // Also for "unknown connection"
+    char edid[DISPLAY_EDID_ID_MAX];  // "" if the monitor has no EDID
+    int enabled;
+    int primary;
+    int x, y;
+    int width, height;               // Current mode, before rotation
+    double rate;                     // Current refresh rate
+    char rotation[12];               // normal, left, right or inverted
+    DisplayMode modes[DISPLAY_MAX_MODES];
+    int mode_count;
+} DisplayOutput;
+
+typedef struct {
+    char name[DISPLAY_NAME_MAX];     // Output to drive
+    int enabled;
+    int width, height;
+    double rate;
+    int x, y;
+    char rotation[12];
+    int primary;
+} DisplayConfig;
+
+int xrandr_is_installed(void);
+
+// Parse `xrandr --props` output. Returns number of outputs
+int xrandr_parse(const char *text, DisplayOutput *outputs, int max);
+
+// Query the X server. Returns number of outputs, -1 on error
+int xrandr_query(DisplayOutput *outputs, int max);
+
+// Highest refresh rate of a progressive mode of that size, 0 if none
+double xrandr_best_rate(const DisplayOutput *output, int width, int height);
+
+// Preferred mode of an output (first listed if none is marked), or NULL
+const DisplayMode *xrandr_preferred_mode(const DisplayOutput *output);
+
+// 1 if the outputs already match the configs, so applying is a no-op
+int xrandr_matches(const DisplayConfig *configs, int count,
+                   const DisplayOutput *outputs, int output_count);
+
+// Apply configs in one xrandr run; enabled outputs that are not listed
+// are switched off. Returns 0 on success, -1 on error
+int xrandr_apply(const DisplayConfig *configs, int count,
+                 const DisplayOutput *outputs, int output_count);
+
+#endif
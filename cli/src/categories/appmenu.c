@@ -0,0 +1,370 @@
+// cli/src/categories/appmenu.c
+#define _DEFAULT_SOURCE
+#include "appmenu.h"
+#include "../backends/frecency.h"
+#include "../backends/menu_index.h"
+#include "../util/config.h"
+#include "../util/desktop.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/inotify.h>
+
+#define MENU_LOCK_FILE "menu.lock"
+#define JGMENU_CSV_CMD "opende menu csv"
+#define COALESCE_MS 200              // Package installs touch many files at once
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | \
+                    IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ATTRIB)
+
+static int menu_update(int argc, char *argv[]) {
+    int full = argc > 0 && strcmp(argv[0], "--full") == 0;
+
+    MenuIndex index;
+    if (menu_index_load(&index) != 0) memset(&index, 0, sizeof(index));
+    int changed = menu_index_refresh(&index, full);
+
+    if (menu_index_save(&index) != 0) {
+        print_error("Failed to write menu index");
+        menu_index_free(&index);
+        return 1;
+    }
+    print_success("Menu index updated (%d changed, %d entries)", changed,
+                  menu_index_visible_count(&index));
+    menu_index_free(&index);
+    return 0;
+}
+
+static int menu_status(void) {
+    MenuIndex index;
+    char *path = menu_index_path();
+
+    print_header("Application menu");
+    if (menu_index_load(&index) != 0) {
+        print_setting("Index", "not built (run 'opende menu update')", 0);
+        free(path);
+        return 0;
+    }
+
+    int dirs = 0;
+    for (int d = 0; d < index.dir_count; d++) dirs += index.dirs[d].root >= 0;
+
+    char value[64];
+    print_setting("Index", path ? path : "", 1);
+    snprintf(value, sizeof(value), "%d", menu_index_visible_count(&index));
+    print_setting("Entries", value, 1);
+    snprintf(value, sizeof(value), "%d", index.count);
+    print_setting("Desktop files", value, 1);
+    snprintf(value, sizeof(value), "%d", dirs);
+    print_setting("Directories", value, 1);
+    snprintf(value, sizeof(value), "%s (%dpx)", index.theme ? index.theme : "", index.icon_size);
+    print_setting("Icon theme", value, 1);
+
+    free(path);
+    menu_index_free(&index);
+    return 0;
+}
+
+// What the menu's entries run: count the launch, then become the app
+static int menu_launch(int argc, char *argv[]) {
+    if (argc != 1) {
+        print_error("Usage: opende menu launch <desktop-id>");
+        return 1;
+    }
+
+    MenuIndex index;
+    if (menu_index_load(&index) != 0) {
+        memset(&index, 0, sizeof(index));
+        menu_index_refresh(&index, 0);
+        menu_index_save(&index);
+    }
+
+    const MenuEntry *e = menu_index_find(&index, argv[0]);
+    if (!e) {
+        print_error("Unknown application '%s'", argv[0]);
+        menu_index_free(&index);
+        return 2;
+    }
+
+    // jgmenu already put the whole command in a terminal
+    char exec[DESKTOP_FIELD_MAX + 16];
+    snprintf(exec, sizeof(exec), "%s", e->exec);
+    if (strncmp(exec, "^term(", 6) == 0) {
+        size_t len = strlen(exec);
+        if (exec[len - 1] == ')') exec[len - 1] = '\0';
+        memmove(exec, exec + 6, strlen(exec + 6) + 1);
+    }
+    menu_index_free(&index);
+
+    const char *ids[] = { argv[0] };
+    frecency_record(ids, 1);
+
+    char *args[64];
+    if (desktop_exec_argv(exec, args, 64) < 1) {
+        print_error("Invalid Exec in %s", argv[0]);
+        return 1;
+    }
+    execvp(args[0], args);
+    print_error("Cannot run %s: %s", args[0], strerror(errno));
+    desktop_free_argv(args);
+    return 1;
+}
+
+// ---- Watch ----
+
+typedef struct {
+    int fd;
+    int *wd;                 // Watch descriptor per index dir (-1 if none)
+    int count;
+} Watches;
+
+// Tracked files are watched through their parent directory
+static void watch_all(Watches *w, const MenuIndex *index) {
+    for (int i = 0; i < w->count; i++) {
+        if (w->wd[i] >= 0) inotify_rm_watch(w->fd, w->wd[i]);
+    }
+    free(w->wd);
+    w->count = index->dir_count;
+    w->wd = malloc((size_t)(w->count ? w->count : 1) * sizeof(int));
+    if (!w->wd) {
+        w->count = 0;
+        return;
+    }
+
+    for (int d = 0; d < index->dir_count; d++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s", index->dirs[d].path);
+        if (index->dirs[d].root < 0) {
+            char *slash = strrchr(path, '/');
+            if (slash) *slash = '\0';
+        }
+        w->wd[d] = inotify_add_watch(w->fd, path, WATCH_MASK | IN_ONLYDIR);
+    }
+}
+
+// Apply queued events to the index. Returns 1 if it changed, 2 if the
+// directory layout changed (needs a rescan and new watches).
+static int read_events(Watches *w, MenuIndex *index) {
+    char buf[8192] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int result = 0;
+
+    for (;;) {
+        ssize_t len = read(w->fd, buf, sizeof(buf));
+        if (len <= 0) break;
+
+        for (char *p = buf; p < buf + len;) {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF | IN_ISDIR)) {
+                result = 2;
+                continue;
+            }
+            for (int d = 0; d < w->count && ev->len > 0; d++) {
+                if (w->wd[d] != ev->wd) continue;
+                if (index->dirs[d].root >= 0) {
+                    if (menu_index_update_file(index, d, ev->name)) result = result ? result : 1;
+                } else {
+                    const char *slash = strrchr(index->dirs[d].path, '/');
+                    if (slash && strcmp(slash + 1, ev->name) == 0) result = 2;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static int menu_watch(void) {
+    // One watcher per session
+    char *lock_path = config_get_runtime_path(MENU_LOCK_FILE);
+    int lock_fd = lock_path ? open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600) : -1;
+    free(lock_path);
+    if (lock_fd < 0) return 1;
+    if (flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        print_info("Menu watcher already running");
+        close(lock_fd);
+        return 0;
+    }
+
+    Watches w = { inotify_init1(IN_NONBLOCK | IN_CLOEXEC), NULL, 0 };
+    if (w.fd < 0) {
+        print_error("inotify: %s", strerror(errno));
+        close(lock_fd);
+        return 1;
+    }
+
+    MenuIndex index;
+    if (menu_index_load(&index) != 0) memset(&index, 0, sizeof(index));
+    if (menu_index_refresh(&index, 0) > 0 || !index.csv) menu_index_save(&index);
+    watch_all(&w, &index);
+
+    int pending = 0;
+    for (;;) {
+        struct pollfd pfd = { w.fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, pending ? COALESCE_MS : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (ready > 0) {
+            int result = read_events(&w, &index);
+            if (result > pending) pending = result;
+            continue;
+        }
+
+        // Quiet for COALESCE_MS: write once for the whole burst
+        if (pending == 2) {
+            menu_index_refresh(&index, 0);
+            watch_all(&w, &index);
+        }
+        menu_index_save(&index);
+        pending = 0;
+    }
+
+    menu_index_free(&index);
+    free(w.wd);
+    close(w.fd);
+    close(lock_fd);
+    return 1;
+}
+
+// ---- jgmenu ----
+
+// Point jgmenu's csv_cmd at the index instead of its own apps module
+static int menu_install(void) {
+    const char *home = getenv("HOME");
+    char rc[512];
+    snprintf(rc, sizeof(rc), "%s/.config/jgmenu/jgmenurc", home ? home : "");
+
+    char *text = config_read_file(rc);
+    size_t len = text ? strlen(text) : 0;
+    char *out = malloc(len + 64);
+    if (!out) {
+        free(text);
+        return 1;
+    }
+
+    size_t pos = 0;
+    int found = 0;
+    const char *line = text ? text : "";
+    while (*line) {
+        size_t n = strcspn(line, "\n");
+        const char *key = line;
+        while (*key == ' ' || *key == '\t') key++;
+
+        if (strncmp(key, "csv_cmd", 7) == 0 && (key[7] == ' ' || key[7] == '=')) {
+            if (!found) pos += (size_t)sprintf(out + pos, "csv_cmd = %s\n", JGMENU_CSV_CMD);
+            found = 1;
+        } else {
+            memcpy(out + pos, line, n);
+            pos += n;
+            out[pos++] = '\n';
+        }
+        line += n;
+        if (*line) line++;
+    }
+    if (!found) pos += (size_t)sprintf(out + pos, "csv_cmd = %s\n", JGMENU_CSV_CMD);
+    out[pos] = '\0';
+
+    int result = config_ensure_dir(rc) == 0 ? config_write_file(rc, out) : -1;
+    free(text);
+    free(out);
+    if (result != 0) {
+        print_error("Failed to write %s", rc);
+        return 1;
+    }
+
+    print_success("jgmenu now reads the menu index (%s)", rc);
+    return 0;
+}
+
+// menu.frecency, the only setting; callers publish the change
+static int menu_toggle(const char *setting, int enable) {
+    if (strcmp(setting, "frecency") != 0) {
+        print_error("Unknown setting '%s'", setting);
+        print_line("Available menu settings:");
+        print_line("  frecency");
+        return 2;
+    }
+    if (config_set_setting("menu.frecency", enable ? "true" : "false") != 0) {
+        print_error("Failed to save setting");
+        return 1;
+    }
+
+    // Entries' commands change with the setting
+    MenuIndex index;
+    if (menu_index_load(&index) != 0) memset(&index, 0, sizeof(index));
+    menu_index_refresh(&index, 0);
+    menu_index_save(&index);
+    menu_index_free(&index);
+
+    print_success("Launch history %s", enable ? "enabled" : "disabled");
+    return 0;
+}
+
+int appmenu_enable(const char *setting) {
+    return menu_toggle(setting, 1);
+}
+
+int appmenu_disable(const char *setting) {
+    return menu_toggle(setting, 0);
+}
+
+static void print_menu_usage(void) {
+    printf("Usage: opende menu csv\n");
+    printf("       opende menu update [--full]\n");
+    printf("       opende menu watch\n");
+    printf("       opende menu launch <desktop-id>\n");
+    printf("       opende menu enable|disable frecency\n");
+    printf("       opende menu install\n");
+    printf("       opende menu status\n");
+    printf("\nCommands:\n");
+    printf("  csv      Print the jgmenu CSV from the index (rebuilt only if stale)\n");
+    printf("  update   Re-parse changed .desktop files (--full: all of them)\n");
+    printf("  watch    Keep the index current as applications are installed\n");
+    printf("  launch   Run an application and count it in the launch history\n");
+    printf("  enable frecency  Order entries by launch history (default)\n");
+    printf("  install  Set csv_cmd in jgmenurc to use the index\n");
+    printf("  status   Show index size and icon theme\n");
+}
+
+int appmenu_command(int argc, char *argv[]) {
+    if (argc < 1) {
+        print_menu_usage();
+        return 0;
+    }
+
+    if (strcmp(argv[0], "csv") == 0) {
+        return menu_index_print_csv() == 0 ? 0 : 1;
+    }
+
+    if (strcmp(argv[0], "update") == 0) {
+        return menu_update(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "watch") == 0) {
+        return menu_watch();
+    }
+
+    if (strcmp(argv[0], "launch") == 0) {
+        return menu_launch(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "install") == 0) {
+        return menu_install();
+    }
+
+    if (strcmp(argv[0], "status") == 0) {
+        return menu_status();
+    }
+
+    print_error("Unknown menu command '%s'", argv[0]);
+    print_menu_usage();
+    return 2;
+}
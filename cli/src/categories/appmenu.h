@@ -0,0 +1,12 @@
+// cli/src/categories/appmenu.h
+#ifndef OPENDE_APPMENU_H
+#define OPENDE_APPMENU_H
+
+// opende menu <command> ...; enable/disable go through the settings API
+int appmenu_command(int argc, char *argv[]);
+
+// menu.frecency: order entries by launch history
+int appmenu_enable(const char *setting);
+int appmenu_disable(const char *setting);
+
+#endif
@@ -0,0 +1,10 @@
+// cli/src/categories/category.h
+#ifndef OPENDE_CATEGORY_H
+#define OPENDE_CATEGORY_H
+
+// Results of the categories' enable/disable/set: 0 on success, 1 if the
+// change could not be applied, 2 for an unknown setting, and
+// CATEGORY_INVALID when the setting doesn't take the value or action
+#define CATEGORY_INVALID 3
+
+#endif
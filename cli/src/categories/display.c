@@ -0,0 +1,650 @@
+// cli/src/categories/display.c
+#define _DEFAULT_SOURCE
+#include "display.h"
+#include "category.h"
+#include "wallpaper.h"
+#include "../backends/xrandr.h"
+#include "../util/config.h"
+#include "../util/ini.h"
+#include "../util/output.h"
+#include "../util/uevent.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+#define DISPLAY_LAYOUTS_FILE "displays.conf"
+#define DISPLAY_MATCH_KEY    "match"
+#define DISPLAY_MAX_LAYOUTS  32
+#define DISPLAY_MATCH_MAX    (DISPLAY_MAX_OUTPUTS * (DISPLAY_NAME_MAX + 8))
+#define HOTPLUG_SETTLE_MS    1000     // Docks report several connectors in a row
+
+void display_list_settings(void) {
+    print_line("Available display settings:");
+    print_line("  %-12s re-apply the matching layout when monitors change", DISPLAY_SETTING_HOTPLUG);
+    print_line("  %-12s drive each monitor at its highest refresh rate", DISPLAY_SETTING_MAX_REFRESH);
+    print_line("  %-12s <name> apply a saved layout", DISPLAY_SETTING_LAYOUT);
+    print_line("  %-12s arrange monitors no saved layout matches automatically", DISPLAY_SETTING_AUTO_LAYOUT);
+}
+
+// The opende.conf key of a toggle setting and its default, or NULL
+static const char *toggle_key(const char *setting, int *fallback) {
+    *fallback = 1;
+    if (strcmp(setting, DISPLAY_SETTING_HOTPLUG) == 0) return DISPLAY_KEY_HOTPLUG;
+    if (strcmp(setting, DISPLAY_SETTING_MAX_REFRESH) == 0) return DISPLAY_KEY_MAX_REFRESH;
+    *fallback = 0;
+    if (strcmp(setting, DISPLAY_SETTING_AUTO_LAYOUT) == 0) return DISPLAY_KEY_AUTO_LAYOUT;
+    return NULL;
+}
+
+static int query(DisplayOutput *outputs) {
+    int count = xrandr_query(outputs, DISPLAY_MAX_OUTPUTS);
+    if (count < 0) {
+        print_error(xrandr_is_installed() ? "Cannot query outputs (no X display?)" :
+                    "xrandr is not installed");
+    }
+    return count;
+}
+
+// The monitor's EDID hash, or the connector for monitors without one
+static void output_id(const DisplayOutput *o, char *buf, size_t size) {
+    if (o->edid[0]) snprintf(buf, size, "%s", o->edid);
+    else snprintf(buf, size, "name:%.*s", DISPLAY_NAME_MAX - 1, o->name);
+}
+
+static int compare_ids(const void *a, const void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+// Sorted ids of the connected monitors: the key layouts are matched on
+static void match_string(const DisplayOutput *outputs, int count, char *buf, size_t size) {
+    char ids[DISPLAY_MAX_OUTPUTS][DISPLAY_NAME_MAX + 8];
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (outputs[i].connected) output_id(&outputs[i], ids[n++], sizeof(ids[0]));
+    }
+    qsort(ids, (size_t)n, sizeof(ids[0]), compare_ids);
+
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < n && len < size; i++) {
+        len += (size_t)snprintf(buf + len, size - len, "%s%s", i ? "," : "", ids[i]);
+    }
+}
+
+// --- Layout file -----------------------------------------------------------
+
+static char *layouts_path(void) {
+    return config_get_user_path(DISPLAY_LAYOUTS_FILE);
+}
+
+static char *read_layouts(void) {
+    char *path = layouts_path();
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    return text ? text : strdup("");
+}
+
+typedef struct {
+    char names[DISPLAY_MAX_LAYOUTS][64];
+    char matches[DISPLAY_MAX_LAYOUTS][DISPLAY_MATCH_MAX];
+    int count;
+} Layouts;
+
+static void collect_layout(const char *section, const char *key, const char *value, void *data) {
+    Layouts *layouts = data;
+    if (strcmp(key, DISPLAY_MATCH_KEY) != 0 || layouts->count >= DISPLAY_MAX_LAYOUTS) return;
+    snprintf(layouts->names[layouts->count], sizeof(layouts->names[0]), "%s", section);
+    snprintf(layouts->matches[layouts->count], sizeof(layouts->matches[0]), "%s", value);
+    layouts->count++;
+}
+
+static void load_layouts(Layouts *layouts) {
+    layouts->count = 0;
+    char *text = read_layouts();
+    if (text) ini_foreach(text, collect_layout, layouts);
+    free(text);
+}
+
+// Layout saved for exactly this set of monitors, or NULL
+static const char *find_matching(const Layouts *layouts, const char *match) {
+    for (int i = 0; i < layouts->count; i++) {
+        if (strcmp(layouts->matches[i], match) == 0) return layouts->names[i];
+    }
+    return NULL;
+}
+
+typedef struct {
+    const char *section;
+    char outputs[DISPLAY_MAX_OUTPUTS][DISPLAY_NAME_MAX];
+    char values[DISPLAY_MAX_OUTPUTS][128];
+    int count;
+    int found;
+} LayoutEntries;
+
+static void collect_entry(const char *section, const char *key, const char *value, void *data) {
+    LayoutEntries *entries = data;
+    if (strcmp(section, entries->section) != 0) return;
+    entries->found = 1;
+    if (strcmp(key, DISPLAY_MATCH_KEY) == 0 || entries->count >= DISPLAY_MAX_OUTPUTS) return;
+    snprintf(entries->outputs[entries->count], sizeof(entries->outputs[0]), "%s", key);
+    snprintf(entries->values[entries->count], sizeof(entries->values[0]), "%s", value);
+    entries->count++;
+}
+
+typedef struct {
+    const char *name;
+    const char *match;
+    char (*outputs)[DISPLAY_NAME_MAX];
+    char (*values)[128];
+    int count;
+    int remove;
+} LayoutEdit;
+
+// Replace (or drop) the whole section
+static char *edit_layout(const char *text, void *data) {
+    const LayoutEdit *edit = data;
+    char *out = ini_remove_section(text, edit->name);
+    if (!out || edit->remove) return out;
+
+    char *next = ini_set(out, edit->name, DISPLAY_MATCH_KEY, edit->match);
+    free(out);
+    out = next;
+    for (int i = 0; out && i < edit->count; i++) {
+        next = ini_set(out, edit->name, edit->outputs[i], edit->values[i]);
+        free(out);
+        out = next;
+    }
+    return out;
+}
+
+static int update_layouts(LayoutEdit *edit) {
+    char *path = layouts_path();
+    if (!path || config_ensure_dir(path) != 0) {
+        free(path);
+        return -1;
+    }
+    int result = config_update_file(path, edit_layout, edit);
+    free(path);
+    return result;
+}
+
+// --- Building a configuration -------------------------------------------
+
+static double pick_rate(const DisplayOutput *o, int width, int height) {
+    if (config_get_setting_bool(DISPLAY_KEY_MAX_REFRESH, 1)) return xrandr_best_rate(o, width, height);
+
+    // The monitor's preferred rate for that size, else let xrandr choose
+    for (int i = 0; i < o->mode_count; i++) {
+        const DisplayMode *m = &o->modes[i];
+        if (m->width == width && m->height == height && m->preferred) return m->rate;
+    }
+    return 0;
+}
+
+static void auto_config(const DisplayOutput *o, int x, DisplayConfig *c) {
+    const DisplayMode *mode = xrandr_preferred_mode(o);
+    memset(c, 0, sizeof(*c));
+    snprintf(c->name, sizeof(c->name), "%s", o->name);
+    snprintf(c->rotation, sizeof(c->rotation), "normal");
+    c->enabled = mode != NULL;
+    if (!mode) return;
+    c->width = mode->width;
+    c->height = mode->height;
+    c->rate = pick_rate(o, mode->width, mode->height);
+    c->x = x;
+}
+
+static int right_edge(const DisplayConfig *c) {
+    if (!c->enabled) return 0;
+    int sideways = strcmp(c->rotation, "left") == 0 || strcmp(c->rotation, "right") == 0;
+    return c->x + (sideways ? c->height : c->width);
+}
+
+// Every connected monitor at its preferred size, left to right
+static int build_auto(const DisplayOutput *outputs, int count, DisplayConfig *configs) {
+    int n = 0, x = 0, primary = -1;
+    for (int i = 0; i < count; i++) {
+        if (!outputs[i].connected) continue;
+        auto_config(&outputs[i], x, &configs[n]);
+        if (!configs[n].enabled) continue;
+        if (outputs[i].primary && primary < 0) primary = n;
+        x = right_edge(&configs[n]);
+        n++;
+    }
+    if (n > 0) configs[primary >= 0 ? primary : 0].primary = 1;
+    return n;
+}
+
+// Switching every output off leaves a black screen nothing can recover
+// from; refuse instead
+static int check_enabled(const DisplayConfig *configs, int n, const char *label) {
+    for (int i = 0; i < n; i++) {
+        if (configs[i].enabled) return 0;
+    }
+    print_error("Layout '%s' would turn off every monitor; not applying it", label);
+    return -1;
+}
+
+static const DisplayOutput *find_output(const DisplayOutput *outputs, int count,
+                                        const char *id, const char *name) {
+    // The monitor wherever it is plugged in now, else the same connector
+    for (int i = 0; i < count; i++) {
+        char current[DISPLAY_NAME_MAX + 8];
+        output_id(&outputs[i], current, sizeof(current));
+        if (outputs[i].connected && strcmp(current, id) == 0) return &outputs[i];
+    }
+    for (int i = 0; i < count; i++) {
+        if (outputs[i].connected && strcmp(outputs[i].name, name) == 0) return &outputs[i];
+    }
+    return NULL;
+}
+
+// "<id> <WxH@rate|WxH@max|off> +X+Y <rotation> [primary]"
+static int parse_entry(const char *output, const char *value, const DisplayOutput *outputs,
+                       int count, DisplayConfig *c) {
+    char id[DISPLAY_NAME_MAX + 8], mode[48], pos[48] = "+0+0", rotation[12] = "normal", flag[16] = "";
+    if (sscanf(value, "%39s %47s %47s %11s %15s", id, mode, pos, rotation, flag) < 2) {
+        print_error("Malformed layout entry for %s: %s", output, value);
+        return -1;
+    }
+
+    const DisplayOutput *o = find_output(outputs, count, id, output);
+    if (!o) return 1;   // Monitor not connected: nothing to drive
+
+    memset(c, 0, sizeof(*c));
+    snprintf(c->name, sizeof(c->name), "%.*s", DISPLAY_NAME_MAX - 1, o->name);
+    snprintf(c->rotation, sizeof(c->rotation), "%s", rotation);
+    if (strcmp(mode, "off") == 0) return 0;
+
+    char rate[16] = "max";
+    if (sscanf(mode, "%dx%d@%15s", &c->width, &c->height, rate) < 2 ||
+        sscanf(pos, "%d%d", &c->x, &c->y) != 2) {
+        print_error("Malformed layout entry for %s: %s", output, value);
+        return -1;
+    }
+    if (xrandr_best_rate(o, c->width, c->height) <= 0) {
+        print_error("%s does not support %dx%d", o->name, c->width, c->height);
+        return -1;
+    }
+
+    c->enabled = 1;
+    c->primary = strcmp(flag, "primary") == 0;
+    c->rate = strcmp(rate, "max") == 0 ? pick_rate(o, c->width, c->height) : atof(rate);
+    return 0;
+}
+
+static int build_layout(const char *name, const DisplayOutput *outputs, int count,
+                        DisplayConfig *configs) {
+    LayoutEntries entries;
+    memset(&entries, 0, sizeof(entries));
+    entries.section = name;
+    char *text = read_layouts();
+    if (text) ini_foreach(text, collect_entry, &entries);
+    free(text);
+
+    if (!entries.found) {
+        print_error("No layout named '%s'", name);
+        return -1;
+    }
+
+    int n = 0, x = 0, driven = 0;
+    for (int i = 0; i < entries.count; i++) {
+        int result = parse_entry(entries.outputs[i], entries.values[i], outputs, count, &configs[n]);
+        if (result < 0) return -1;
+        if (result > 0) continue;
+        driven += configs[n].enabled;
+        if (right_edge(&configs[n]) > x) x = right_edge(&configs[n]);
+        n++;
+    }
+    if (driven == 0) {
+        print_error("None of the monitors in layout '%s' is connected", name);
+        return -1;
+    }
+
+    // Monitors the layout doesn't know go to the right
+    for (int i = 0; i < count && n < DISPLAY_MAX_OUTPUTS; i++) {
+        if (!outputs[i].connected) continue;
+        int known = 0;
+        for (int j = 0; j < n && !known; j++) known = strcmp(configs[j].name, outputs[i].name) == 0;
+        if (known) continue;
+
+        auto_config(&outputs[i], x, &configs[n]);
+        if (configs[n].enabled) x = right_edge(&configs[n]);
+        n++;
+    }
+    return n;
+}
+
+// Apply the named layout, the one saved for these monitors, or, if the
+// user opted in, the automatic arrangement. Returns 0 on success (also
+// when nothing had to change), 1 on error
+static int apply_layout(const char *name, int quiet) {
+    DisplayOutput outputs[DISPLAY_MAX_OUTPUTS];
+    int count = query(outputs);
+    if (count < 0) return 1;
+
+    const char *chosen = name;
+    Layouts layouts;
+    if (!chosen) {
+        char match[DISPLAY_MATCH_MAX];
+        match_string(outputs, count, match, sizeof(match));
+        load_layouts(&layouts);
+        chosen = find_matching(&layouts, match);
+
+        // Unknown monitors may have been arranged some other way (xorg.conf,
+        // an arandr script); leave them alone unless asked not to
+        if (!chosen && !config_get_setting_bool(DISPLAY_KEY_AUTO_LAYOUT, 0)) {
+            if (!quiet) print_info("No saved layout for these monitors; leaving them as they are");
+            return 0;
+        }
+    }
+
+    DisplayConfig configs[DISPLAY_MAX_OUTPUTS];
+    int n = chosen ? build_layout(chosen, outputs, count, configs) : build_auto(outputs, count, configs);
+    if (n < 0) return 1;
+
+    const char *label = chosen ? chosen : "automatic";
+    if (check_enabled(configs, n, label) != 0) return 1;
+    if (xrandr_matches(configs, n, outputs, count)) {
+        if (!quiet) print_info("Layout '%s' is already active", label);
+        return 0;
+    }
+
+    if (xrandr_apply(configs, n, outputs, count) != 0) {
+        print_error("xrandr failed to apply layout '%s'", label);
+        return 1;
+    }
+    print_success("Applied layout '%s'", label);
+
+    // The root window changed size; redraw the wallpaper for it
+    char quiet_arg[] = "--quiet";
+    char *args[] = { quiet_arg, NULL };
+    wallpaper_restore(1, args);
+    return 0;
+}
+
+// --- Commands --------------------------------------------------------------
+
+static int display_save(const char *name) {
+    if (strcmp(name, DISPLAY_MATCH_KEY) == 0 || strchr(name, '[') || strchr(name, ']')) {
+        print_error("Invalid layout name '%s'", name);
+        return 1;
+    }
+
+    DisplayOutput outputs[DISPLAY_MAX_OUTPUTS];
+    int count = query(outputs);
+    if (count < 0) return 1;
+
+    char match[DISPLAY_MATCH_MAX];
+    match_string(outputs, count, match, sizeof(match));
+
+    char names[DISPLAY_MAX_OUTPUTS][DISPLAY_NAME_MAX];
+    char values[DISPLAY_MAX_OUTPUTS][128];
+    int n = 0;
+    int max_refresh = config_get_setting_bool(DISPLAY_KEY_MAX_REFRESH, 1);
+    for (int i = 0; i < count; i++) {
+        const DisplayOutput *o = &outputs[i];
+        if (!o->connected) continue;
+
+        char id[DISPLAY_NAME_MAX + 8], rate[16];
+        output_id(o, id, sizeof(id));
+        snprintf(names[n], sizeof(names[0]), "%s", o->name);
+        if (!o->enabled) {
+            snprintf(values[n++], sizeof(values[0]), "%s off", id);
+            continue;
+        }
+
+        // With max-refresh the rate follows the monitor, not this moment
+        if (max_refresh) snprintf(rate, sizeof(rate), "max");
+        else snprintf(rate, sizeof(rate), "%.2f", o->rate);
+        snprintf(values[n++], sizeof(values[0]), "%s %dx%d@%s +%d+%d %s%s", id, o->width, o->height,
+                 rate, o->x, o->y, o->rotation, o->primary ? " primary" : "");
+    }
+
+    LayoutEdit edit = { name, match, names, values, n, 0 };
+    if (update_layouts(&edit) != 0) {
+        print_error("Failed to save layout '%s'", name);
+        return 1;
+    }
+    print_success("Saved layout '%s' for %d monitor%s", name, n, n == 1 ? "" : "s");
+    return 0;
+}
+
+static int display_remove(const char *name) {
+    Layouts layouts;
+    load_layouts(&layouts);
+    int found = 0;
+    for (int i = 0; i < layouts.count; i++) found |= strcmp(layouts.names[i], name) == 0;
+    if (!found) {
+        print_error("No layout named '%s'", name);
+        return 1;
+    }
+
+    LayoutEdit edit = { name, NULL, NULL, NULL, 0, 1 };
+    if (update_layouts(&edit) != 0) {
+        print_error("Failed to remove layout '%s'", name);
+        return 1;
+    }
+    print_success("Removed layout '%s'", name);
+    return 0;
+}
+
+static int display_list(void) {
+    Layouts layouts;
+    load_layouts(&layouts);
+    if (layouts.count == 0) {
+        print_info("No saved layouts (opende display save <name>)");
+        return 0;
+    }
+
+    DisplayOutput outputs[DISPLAY_MAX_OUTPUTS];
+    char match[DISPLAY_MATCH_MAX] = "";
+    int count = xrandr_query(outputs, DISPLAY_MAX_OUTPUTS);
+    if (count >= 0) match_string(outputs, count, match, sizeof(match));
+
+    for (int i = 0; i < layouts.count; i++) {
+        int matches = strcmp(layouts.matches[i], match) == 0;
+        printf("%s %s\n", matches ? "*" : " ", layouts.names[i]);
+    }
+    return 0;
+}
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int display_watch(void) {
+    int fd = uevent_open();
+    if (fd < 0) {
+        print_error("Cannot listen for hotplug events");
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop;   // No SA_RESTART: poll() returns EINTR
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+
+    // The monitors present at login get their layout too
+    if (config_get_setting_bool(DISPLAY_KEY_HOTPLUG, 1)) apply_layout(NULL, 1);
+
+    int pending = 0;
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    while (!stop_requested) {
+        // Sleep until an event; once one arrived, until things settle
+        int ready = poll(&pfd, 1, pending ? HOTPLUG_SETTLE_MS : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (ready == 0) {
+            pending = 0;
+            if (config_get_setting_bool(DISPLAY_KEY_HOTPLUG, 1)) apply_layout(NULL, 1);
+            continue;
+        }
+
+        UEvent event;
+        int result;
+        while ((result = uevent_read(fd, &event)) > 0) {
+            if (strcmp(event.subsystem, "drm") == 0 && strcmp(event.action, "change") == 0) pending = 1;
+        }
+        if (result < 0) break;
+    }
+
+    close(fd);
+    return 0;
+}
+
+static void print_display_usage(void) {
+    printf("Usage: opende display [status]      Show outputs and the matching layout\n");
+    printf("       opende display save <name>   Save the current arrangement\n");
+    printf("       opende display apply [name]  Apply a layout (default: the one saved\n");
+    printf("                                    for the connected monitors; else auto\n");
+    printf("                                    with auto-layout enabled)\n");
+    printf("       opende display auto          Every monitor at its preferred size\n");
+    printf("       opende display list|remove <name>\n");
+    printf("       opende display watch         Re-apply layouts on hotplug\n");
+}
+
+int display_command(int argc, char *argv[]) {
+    if (argc < 1) {
+        print_display_usage();
+        return 1;
+    }
+
+    const char *cmd = argv[0];
+    if (strcmp(cmd, "save") == 0 && argc == 2) return display_save(argv[1]);
+    if (strcmp(cmd, "remove") == 0 && argc == 2) return display_remove(argv[1]);
+    if (strcmp(cmd, "apply") == 0 && argc <= 2) return apply_layout(argc == 2 ? argv[1] : NULL, 0);
+    if (strcmp(cmd, "list") == 0 && argc == 1) return display_list();
+    if (strcmp(cmd, "watch") == 0 && argc == 1) return display_watch();
+
+    if (strcmp(cmd, "auto") == 0 && argc == 1) {
+        DisplayOutput outputs[DISPLAY_MAX_OUTPUTS];
+        DisplayConfig configs[DISPLAY_MAX_OUTPUTS];
+        int count = query(outputs);
+        if (count < 0) return 1;
+        int n = build_auto(outputs, count, configs);
+        if (check_enabled(configs, n, "automatic") != 0) return 1;
+        if (xrandr_apply(configs, n, outputs, count) != 0) {
+            print_error("xrandr failed to apply the automatic layout");
+            return 1;
+        }
+        print_success("Applied layout 'automatic'");
+        char quiet_arg[] = "--quiet";
+        char *args[] = { quiet_arg, NULL };
+        wallpaper_restore(1, args);
+        return 0;
+    }
+
+    print_display_usage();
+    return 1;
+}
+
+// --- Category interface --------------------------------------------------
+
+static int toggle(const char *setting, int on) {
+    int fallback;
+    const char *key = toggle_key(setting, &fallback);
+    if (!key) {
+        if (strcmp(setting, DISPLAY_SETTING_LAYOUT) == 0) {
+            print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
+            return CATEGORY_INVALID;
+        }
+        print_error("Unknown setting '%s'", setting);
+        display_list_settings();
+        return 2;
+    }
+
+    if (config_set_setting(key, on ? "true" : "false") != 0) {
+        print_error("Failed to save %s", setting);
+        return 1;
+    }
+    print_success("%s %s", setting, on ? "enabled" : "disabled");
+    return 0;
+}
+
+int display_enable(const char *setting) {
+    return toggle(setting, 1);
+}
+
+int display_disable(const char *setting) {
+    return toggle(setting, 0);
+}
+
+int display_set(const char *setting, const char *value) {
+    if (strcmp(setting, DISPLAY_SETTING_LAYOUT) == 0) return apply_layout(value, 0);
+
+    int fallback;
+    if (toggle_key(setting, &fallback)) {
+        print_error("Setting '%s' does not support 'set', use enable/disable", setting);
+        return CATEGORY_INVALID;
+    }
+    print_error("Unknown setting '%s'", setting);
+    display_list_settings();
+    return 2;
+}
+
+int display_status(const char *setting) {
+    if (setting && strcmp(setting, DISPLAY_SETTING_LAYOUT) != 0) {
+        int fallback;
+        const char *key = toggle_key(setting, &fallback);
+        if (!key) {
+            print_error("Unknown setting '%s'", setting);
+            display_list_settings();
+            return 2;
+        }
+        printf("%s\n", config_get_setting_bool(key, fallback) ? "enabled" : "disabled");
+        return 0;
+    }
+
+    DisplayOutput outputs[DISPLAY_MAX_OUTPUTS];
+    int count = xrandr_query(outputs, DISPLAY_MAX_OUTPUTS);
+
+    const char *layout = NULL;
+    Layouts layouts;
+    if (count >= 0) {
+        char match[DISPLAY_MATCH_MAX];
+        match_string(outputs, count, match, sizeof(match));
+        load_layouts(&layouts);
+        layout = find_matching(&layouts, match);
+    }
+
+    if (setting) {
+        printf("%s\n", layout ? layout : "none");
+        return 0;
+    }
+
+    print_header("Display");
+    if (count < 0) {
+        printf("  Outputs:     unknown (no X display or xrandr)\n");
+    }
+    for (int i = 0; i < count; i++) {
+        const DisplayOutput *o = &outputs[i];
+        if (!o->connected) continue;
+        if (!o->enabled) {
+            printf("  %-12s off\n", o->name);
+            continue;
+        }
+        double best = xrandr_best_rate(o, o->width, o->height);
+        printf("  %-12s %dx%d@%.2f +%d+%d %s%s%s\n", o->name, o->width, o->height, o->rate,
+               o->x, o->y, o->rotation, o->primary ? " primary" : "",
+               best > o->rate + 0.05 ? " (faster rate available)" : "");
+    }
+    int auto_layout = config_get_setting_bool(DISPLAY_KEY_AUTO_LAYOUT, 0);
+    if (count >= 0) printf("  Layout:      %s\n", layout ? layout : auto_layout ? "none (automatic)" : "none");
+    printf("  Hotplug:     %s\n", config_get_setting_bool(DISPLAY_KEY_HOTPLUG, 1) ? "enabled" : "disabled");
+    printf("  Max refresh: %s\n", config_get_setting_bool(DISPLAY_KEY_MAX_REFRESH, 1) ? "enabled" : "disabled");
+    printf("  Auto layout: %s\n", auto_layout ? "enabled" : "disabled");
+    return 0;
+}
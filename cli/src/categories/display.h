@@ -0,0 +1,25 @@
+// cli/src/categories/display.h
+#ifndef OPENDE_DISPLAY_H
+#define OPENDE_DISPLAY_H
+
+#define DISPLAY_SETTING_HOTPLUG     "hotplug"
+#define DISPLAY_SETTING_MAX_REFRESH "max-refresh"
+#define DISPLAY_SETTING_LAYOUT      "layout"
+#define DISPLAY_SETTING_AUTO_LAYOUT "auto-layout"
+
+// Settings in opende.conf
+#define DISPLAY_KEY_HOTPLUG     "display.hotplug"
+#define DISPLAY_KEY_MAX_REFRESH "display.max-refresh"
+#define DISPLAY_KEY_AUTO_LAYOUT "display.auto-layout"
+
+int display_enable(const char *setting);
+int display_disable(const char *setting);
+int display_set(const char *setting, const char *value);
+int display_status(const char *setting);
+
+void display_list_settings(void);
+
+// opende display save|apply|auto|list|remove|watch ...
+int display_command(int argc, char *argv[]);
+
+#endif
@@ -1,7 +1,11 @@
 // cli/src/categories/effects.c
 #include "effects.h"
+#include "category.h"
 #include "../backends/picom.h"
+#include "../backends/picom_bench.h"
+#include "../util/config.h"
 #include "../util/output.h"
+#include "governor.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -11,6 +15,7 @@ static const char *valid_settings[] = {
     EFFECTS_SETTING_SHADOWS,
     EFFECTS_SETTING_TRANSPARENCY,
     EFFECTS_SETTING_ANIMATIONS,
+    EFFECTS_SETTING_GOVERNOR,
     NULL
 };
 
@@ -22,9 +27,9 @@ static int is_valid_setting(const char *setting) {
 }
 
 void effects_list_settings(void) {
-    printf("Available effects settings:\n");
+    print_line("Available effects settings:");
     for (int i = 0; valid_settings[i]; i++) {
-        printf("  %s\n", valid_settings[i]);
+        print_line("  %s", valid_settings[i]);
     }
 }
 
@@ -61,6 +66,15 @@ int effects_enable(const char *setting) {
         return 1;
     }
 
+    if (strcmp(setting, EFFECTS_SETTING_GOVERNOR) == 0) {
+        if (config_set_setting(GOVERNOR_KEY_ENABLED, "true") == 0) {
+            print_success("Effects governor enabled (starts with the next session)");
+            return 0;
+        }
+        print_error("Failed to enable effects governor");
+        return 1;
+    }
+
     if (strcmp(setting, EFFECTS_SETTING_TRANSPARENCY) == 0) {
         if (picom_set_transparency(90) == 0) {
             print_success("Transparency enabled (90%%)");
@@ -106,6 +120,15 @@ int effects_disable(const char *setting) {
         return 1;
     }
 
+    if (strcmp(setting, EFFECTS_SETTING_GOVERNOR) == 0) {
+        if (config_set_setting(GOVERNOR_KEY_ENABLED, "false") == 0) {
+            print_success("Effects governor disabled");
+            return 0;
+        }
+        print_error("Failed to disable effects governor");
+        return 1;
+    }
+
     if (strcmp(setting, EFFECTS_SETTING_TRANSPARENCY) == 0) {
         if (picom_set_transparency(100) == 0) {
             print_success("Transparency disabled (100%% opacity)");
@@ -126,13 +149,14 @@ int effects_set(const char *setting, const char *value) {
     }
 
     if (strcmp(setting, EFFECTS_SETTING_TRANSPARENCY) == 0) {
-        int percent = atoi(value);
-        if (percent < 0 || percent > 100) {
+        char *end;
+        long percent = strtol(value, &end, 10);
+        if (end == value || *end || percent < 0 || percent > 100) {
             print_error("Transparency must be 0-100");
-            return 1;
+            return CATEGORY_INVALID;
         }
-        if (picom_set_transparency(percent) == 0) {
-            print_success("Transparency set to %d%%", percent);
+        if (picom_set_transparency((int)percent) == 0) {
+            print_success("Transparency set to %ld%%", percent);
             return 0;
         }
         print_error("Failed to set transparency");
@@ -140,7 +164,7 @@ int effects_set(const char *setting, const char *value) {
     }
 
     print_error("Setting '%s' does not support 'set', use enable/disable", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int effects_status(const char *setting) {
@@ -171,6 +195,13 @@ int effects_status(const char *setting) {
             else printf("unknown\n");
             return 0;
         }
+        if (strcmp(setting, EFFECTS_SETTING_GOVERNOR) == 0) {
+            int level = governor_get_level();
+            if (level >= 0) printf("running (%s)\n", governor_level_name(level));
+            else printf("%s\n", config_get_setting_bool(GOVERNOR_KEY_ENABLED, 0) ?
+                        "enabled" : "disabled");
+            return 0;
+        }
     }
 
     // Show all effects status
@@ -190,5 +221,259 @@ int effects_status(const char *setting) {
         printf("                %d%% inactive window opacity\n", transparency);
     }
 
+    int governor = governor_get_level();
+    if (governor >= 0) {
+        printf("  Governor:     running, effects level '%s'\n", governor_level_name(governor));
+    } else {
+        printf("  Governor:     %s\n",
+               config_get_setting_bool(GOVERNOR_KEY_ENABLED, 0) ? "enabled" : "disabled");
+    }
+
+    return 0;
+}
+
+static void print_rule_usage(void) {
+    printf("Usage: opende effects rule list\n");
+    printf("       opende effects rule add <type> <class|name> <pattern> [opacity]\n");
+    printf("       opende effects rule remove <type> <class|name> <pattern>\n");
+    printf("\nRule types:\n");
+    printf("  no-shadow   Never draw a shadow for the window\n");
+    printf("  no-fade     Never fade the window in or out\n");
+    printf("  opacity     Force window opacity (0-100)\n");
+    printf("  unredirect  Bypass the compositor while the window is fullscreen\n");
+    printf("\nExample:\n");
+    printf("  opende effects rule add unredirect class mpv\n");
+}
+
+static int rule_list(void) {
+    PicomRule *rules;
+    int count = picom_get_rules(&rules);
+    if (count < 0) {
+        print_error("Failed to read compositor rules");
+        return 1;
+    }
+
+    print_header("Compositor window rules");
+
+    if (count == 0) {
+        printf("  (none)\n");
+    }
+
+    for (int i = 0; i < count; i++) {
+        const PicomRule *r = &rules[i];
+        const char *match = r->match == PICOM_MATCH_CLASS ? "class" :
+                            r->match == PICOM_MATCH_NAME ? "name" : "custom";
+
+        printf("  %-11s %-6s %s", picom_rule_type_name(r->type), match, r->pattern);
+        if (r->type == PICOM_RULE_OPACITY && r->match != PICOM_MATCH_OTHER) {
+            printf(" (%d%%)", r->opacity);
+        }
+        printf("\n");
+    }
+
+    free(rules);
+    return 0;
+}
+
+// Parse "<type> <class|name> <pattern>" into a rule
+static int parse_rule_args(int argc, char *argv[], PicomRule *rule) {
+    if (argc < 3) {
+        print_rule_usage();
+        return 1;
+    }
+
+    memset(rule, 0, sizeof(*rule));
+    rule->opacity = 100;
+
+    if (picom_rule_type_parse(argv[0], &rule->type) != 0) {
+        print_error("Unknown rule type '%s'", argv[0]);
+        print_rule_usage();
+        return 2;
+    }
+
+    if (strcmp(argv[1], "class") == 0) {
+        rule->match = PICOM_MATCH_CLASS;
+    } else if (strcmp(argv[1], "name") == 0) {
+        rule->match = PICOM_MATCH_NAME;
+    } else {
+        print_error("Rules match by 'class' or 'name', not '%s'", argv[1]);
+        return 1;
+    }
+
+    if (strlen(argv[2]) >= sizeof(rule->pattern)) {
+        print_error("Pattern too long");
+        return 1;
+    }
+    strcpy(rule->pattern, argv[2]);
     return 0;
 }
+
+int effects_rule(int argc, char *argv[]) {
+    if (argc < 1 || strcmp(argv[0], "list") == 0) {
+        return rule_list();
+    }
+
+    PicomRule rule;
+    int result;
+
+    if (strcmp(argv[0], "add") == 0) {
+        int err = parse_rule_args(argc - 1, argv + 1, &rule);
+        if (err) return err;
+
+        if (rule.type == PICOM_RULE_OPACITY) {
+            if (argc < 5) {
+                print_error("Opacity rules need a value (0-100)");
+                return 1;
+            }
+            // atoi would make "abc" or "5x" a 0, an invisible window
+            char *end;
+            long opacity = strtol(argv[4], &end, 10);
+            if (end == argv[4] || *end || opacity < 0 || opacity > 100) {
+                print_error("Opacity must be 0-100");
+                return CATEGORY_INVALID;
+            }
+            rule.opacity = (int)opacity;
+        }
+
+        result = picom_add_rule(&rule);
+        if (result == 0) {
+            print_success("Added %s rule for %s '%s'", argv[1], argv[2], argv[3]);
+            return 0;
+        }
+        if (result == 1) {
+            print_info("Rule already exists");
+            return 0;
+        }
+        print_error("Failed to add rule");
+        return 1;
+    }
+
+    if (strcmp(argv[0], "remove") == 0) {
+        int err = parse_rule_args(argc - 1, argv + 1, &rule);
+        if (err) return err;
+
+        result = picom_remove_rule(&rule);
+        if (result == 0) {
+            print_success("Removed %s rule for %s '%s'", argv[1], argv[2], argv[3]);
+            return 0;
+        }
+        if (result == 1) {
+            print_error("No %s rule for %s '%s'", argv[1], argv[2], argv[3]);
+            return 2;
+        }
+        print_error("Failed to remove rule");
+        return 1;
+    }
+
+    print_error("Unknown rule command '%s'", argv[0]);
+    print_rule_usage();
+    return 2;
+}
+
+// Built-in benchmark profiles, applied on top of the user's effective config
+static const PicomBenchProfile bench_profiles[] = {
+    { "current",   NULL },
+    { "no-fade",   "fading=false" },
+    { "no-shadow", "shadow=false" },
+    { "minimal",   "fading=false,shadow=false,inactive-opacity=1.0" },
+};
+
+#define BENCH_PROFILE_COUNT (int)(sizeof(bench_profiles) / sizeof(bench_profiles[0]))
+#define BENCH_MAX_PROFILES 16
+
+static void print_benchmark_usage(void) {
+    printf("Usage: opende effects benchmark [--iterations N] [profile|key=value,...]...\n");
+    printf("\nProfiles (default: all):\n");
+    for (int i = 0; i < BENCH_PROFILE_COUNT; i++) {
+        printf("  %-10s %s\n", bench_profiles[i].name,
+               bench_profiles[i].overrides ? bench_profiles[i].overrides : "(config as-is)");
+    }
+    printf("\nAn option set such as 'shadow-radius=4,fade-delta=10' is benchmarked as its own profile.\n");
+}
+
+int effects_benchmark(int argc, char *argv[]) {
+    PicomBenchProfile profiles[BENCH_MAX_PROFILES];
+    int count = 0;
+    int iterations = 10;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+            if (iterations < 1) {
+                print_error("Iterations must be at least 1");
+                return 1;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--help") == 0) {
+            print_benchmark_usage();
+            return 0;
+        }
+        if (count == BENCH_MAX_PROFILES) {
+            print_error("Too many profiles (max %d)", BENCH_MAX_PROFILES);
+            return 1;
+        }
+
+        if (strchr(argv[i], '=')) {
+            profiles[count].name = argv[i];
+            profiles[count].overrides = argv[i];
+            count++;
+            continue;
+        }
+
+        int found = 0;
+        for (int p = 0; p < BENCH_PROFILE_COUNT; p++) {
+            if (strcmp(argv[i], bench_profiles[p].name) == 0) {
+                profiles[count++] = bench_profiles[p];
+                found = 1;
+            }
+        }
+        if (!found) {
+            print_error("Unknown profile '%s'", argv[i]);
+            print_benchmark_usage();
+            return 2;
+        }
+    }
+
+    if (count == 0) {
+        for (int p = 0; p < BENCH_PROFILE_COUNT; p++) profiles[count++] = bench_profiles[p];
+    }
+
+    if (!picom_bench_available()) {
+        print_error("Benchmark needs Xvfb and picom");
+        printf("Install with: sudo apt install xvfb picom\n");
+        return 1;
+    }
+
+    // Profiles that never ran (Xvfb didn't start) show as failed
+    PicomBenchResult results[BENCH_MAX_PROFILES] = {0};
+    int rc = picom_bench_run(profiles, count, iterations, results);
+
+    print_header("Compositor benchmark (Xvfb, software GL)");
+    printf("  %-24s %18s %18s %8s %7s\n",
+           "Profile", "Latency p50/p99", "Frame p50/p99", "CPU/s", "Missed");
+
+    for (int i = 0; i < count; i++) {
+        const PicomBenchResult *r = &results[i];
+        if (r->steps == 0) {
+            printf("  %-24s %18s\n", profiles[i].name, "failed");
+            continue;
+        }
+        printf("  %-24s %7.1f /%6.1f ms %7.1f /%6.1f ms %7.1f%% %3d/%d\n",
+               profiles[i].name,
+               r->latency_p50_ms, r->latency_p99_ms,
+               r->frame_p50_ms, r->frame_p99_ms,
+               r->cpu_per_sec * 100.0, r->missed, r->steps);
+    }
+
+    printf("\n  Latency: workload request to first updated frame\n");
+    printf("  Frame:   interval between frames while a fade or move animates\n");
+    printf("  CPU/s:   picom CPU time per wall second (100%% = one core)\n");
+
+    return rc == 0 ? 0 : 1;
+}
+
+int effects_governor(int argc, char *argv[]) {
+    int force = argc > 0 && strcmp(argv[0], "--force") == 0;
+    return governor_run(force);
+}
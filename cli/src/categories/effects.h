@@ -7,6 +7,7 @@
 #define EFFECTS_SETTING_SHADOWS      "shadows"
 #define EFFECTS_SETTING_TRANSPARENCY "transparency"
 #define EFFECTS_SETTING_ANIMATIONS   "animations"
+#define EFFECTS_SETTING_GOVERNOR     "governor"
 
 // Actions
 int effects_enable(const char *setting);
@@ -14,6 +15,15 @@ int effects_disable(const char *setting);
 int effects_set(const char *setting, const char *value);
 int effects_status(const char *setting);  // NULL = all settings
 
+// Per-window rules: opende effects rule add|remove|list ...
+int effects_rule(int argc, char *argv[]);
+
+// Run the adaptive effects governor: opende effects governor [--force]
+int effects_governor(int argc, char *argv[]);
+
+// Frame-pacing benchmark under Xvfb: opende effects benchmark [profile...]
+int effects_benchmark(int argc, char *argv[]);
+
 // List available settings
 void effects_list_settings(void);
 
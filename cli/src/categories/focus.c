@@ -0,0 +1,374 @@
+// cli/src/categories/focus.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "focus.h"
+#include "notifications.h"
+#include "../backends/dunst.h"
+#include "../backends/picom.h"
+#include "../backends/components.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include "../util/proc.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+#define FOCUS_STATE_FILE "focus.state"
+#define FOCUS_MAX_FROZEN 64
+
+// What focus mode changed, so it can be put back exactly
+typedef struct {
+    int compositor;                  // picom was running and got stopped
+    int dunst;                       // We paused dunst
+    pid_t frozen[FOCUS_MAX_FROZEN];  // Processes we sent SIGSTOP
+    int frozen_count;
+} FocusState;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int write_state(const FocusState *st) {
+    char *path = config_get_runtime_path(FOCUS_STATE_FILE);
+    if (!path) return -1;
+
+    char content[FOCUS_MAX_FROZEN * 12 + 64];
+    int len = snprintf(content, sizeof(content), "compositor = %d\ndunst = %d\nfrozen =",
+                       st->compositor, st->dunst);
+    for (int i = 0; i < st->frozen_count; i++) {
+        len += snprintf(content + len, sizeof(content) - (size_t)len, " %ld",
+                        (long)st->frozen[i]);
+    }
+    snprintf(content + len, sizeof(content) - (size_t)len, "\n");
+
+    int result = config_write_file(path, content);
+    free(path);
+    return result;
+}
+
+// Returns 0 if focus mode is active (state loaded), -1 otherwise
+static int read_state(FocusState *st) {
+    memset(st, 0, sizeof(*st));
+
+    char *path = config_get_runtime_path(FOCUS_STATE_FILE);
+    if (!path) return -1;
+    char *text = config_read_file(path);
+    free(path);
+    if (!text) return -1;
+
+    sscanf(text, "compositor = %d\ndunst = %d", &st->compositor, &st->dunst);
+
+    char *frozen = strstr(text, "frozen =");
+    if (frozen) {
+        char *p = frozen + 8;
+        char *end;
+        long pid;
+        while (st->frozen_count < FOCUS_MAX_FROZEN &&
+               (pid = strtol(p, &end, 10)) > 0 && end != p) {
+            st->frozen[st->frozen_count++] = (pid_t)pid;
+            p = end;
+        }
+    }
+
+    free(text);
+    return 0;
+}
+
+static void clear_state(void) {
+    char *path = config_get_runtime_path(FOCUS_STATE_FILE);
+    if (!path) return;
+    unlink(path);
+    free(path);
+}
+
+int focus_is_active(void) {
+    FocusState st;
+    return read_state(&st) == 0;
+}
+
+static void freeze_components(FocusState *st) {
+    char *list = config_get_setting(FOCUS_KEY_FREEZE);
+    if (!list) list = strdup(FOCUS_DEFAULT_FREEZE);
+    if (!list) return;
+
+    char *save = NULL;
+    for (char *name = strtok_r(list, " ,", &save); name;
+         name = strtok_r(NULL, " ,", &save)) {
+        const SessionComponent *c = components_find(name);
+        if (!c) {
+            print_warn("Unknown component '%s' in %s", name, FOCUS_KEY_FREEZE);
+            continue;
+        }
+
+        pid_t pids[16];
+        int count = components_find_pids(c, pids, 16);
+        for (int i = 0; i < count && st->frozen_count < FOCUS_MAX_FROZEN; i++) {
+            if (kill(pids[i], SIGSTOP) == 0) {
+                st->frozen[st->frozen_count++] = pids[i];
+            }
+        }
+    }
+
+    free(list);
+}
+
+int focus_enter(void) {
+    FocusState st;
+    if (read_state(&st) == 0) return 0;  // Already in focus mode
+
+    // Stopping picom unredirects every window; the fullscreen app then
+    // draws straight to the screen with no compositing cost
+    if (picom_is_running()) {
+        st.compositor = picom_stop() == 0;
+    }
+
+    if (dunst_is_paused() == 0) {
+        st.dunst = dunst_set_paused(1) == 0;
+    }
+
+    freeze_components(&st);
+
+    return write_state(&st);
+}
+
+int focus_leave(void) {
+    FocusState st;
+    if (read_state(&st) != 0) return 0;  // Not in focus mode
+
+    for (int i = 0; i < st.frozen_count; i++) {
+        // Only resume processes that are still stopped (guards against PID reuse)
+        ProcStat ps;
+        if (proc_read_stat(st.frozen[i], &ps) == 0 && ps.state == 'T') {
+            kill(st.frozen[i], SIGCONT);
+        }
+    }
+
+    // Do-not-disturb turned on meanwhile keeps dunst paused
+    if (st.dunst && !config_get_setting_bool(NOTIFY_KEY_DND, 0)) {
+        dunst_set_paused(0);  // Best effort; dunst may have exited
+    }
+
+    int result = 0;
+    if (st.compositor) {
+        result = picom_start();
+    }
+
+    clear_state();
+    return result;
+}
+
+// --- Automatic mode ------------------------------------------------------
+
+typedef struct {
+    Display *dpy;
+    Window root;
+    Window active;
+    Atom net_active_window;
+    Atom net_wm_state;
+    Atom net_wm_state_fullscreen;
+} Watcher;
+
+static int ignore_x_errors(Display *dpy, XErrorEvent *ev) {
+    (void)dpy;
+    (void)ev;
+    return 0;  // Windows can vanish between events; that's fine
+}
+
+static Window get_active_window(Watcher *w) {
+    Atom type;
+    int format;
+    unsigned long count, after;
+    unsigned char *data = NULL;
+    Window result = None;
+
+    if (XGetWindowProperty(w->dpy, w->root, w->net_active_window, 0, 1, False,
+                           XA_WINDOW, &type, &format, &count, &after, &data) == Success &&
+        data && count == 1 && format == 32) {
+        result = (Window)((unsigned long *)data)[0];
+    }
+    if (data) XFree(data);
+    return result;
+}
+
+static int is_fullscreen(Watcher *w, Window win) {
+    if (win == None) return 0;
+
+    Atom type;
+    int format;
+    unsigned long count, after;
+    unsigned char *data = NULL;
+    int result = 0;
+
+    if (XGetWindowProperty(w->dpy, win, w->net_wm_state, 0, 64, False,
+                           XA_ATOM, &type, &format, &count, &after, &data) == Success &&
+        data && format == 32) {
+        Atom *atoms = (Atom *)data;
+        for (unsigned long i = 0; i < count; i++) {
+            if (atoms[i] == w->net_wm_state_fullscreen) result = 1;
+        }
+    }
+    if (data) XFree(data);
+    return result;
+}
+
+// Re-evaluate after _NET_ACTIVE_WINDOW or the active window's state changed
+static void update_focus(Watcher *w) {
+    Window active = get_active_window(w);
+    if (active != w->active) {
+        if (w->active != None) XSelectInput(w->dpy, w->active, NoEventMask);
+        if (active != None) XSelectInput(w->dpy, active, PropertyChangeMask);
+        w->active = active;
+    }
+
+    int want = is_fullscreen(w, active);
+    if (want && !focus_is_active()) {
+        print_info("Fullscreen window active, entering focus mode");
+        focus_enter();
+    } else if (!want && focus_is_active()) {
+        print_info("Fullscreen ended, leaving focus mode");
+        focus_leave();
+    }
+}
+
+static int focus_watch(int force) {
+    if (!force && !config_get_setting_bool(FOCUS_KEY_AUTO, 0)) {
+        return 0;  // Opt-in only
+    }
+
+    Watcher w;
+    memset(&w, 0, sizeof(w));
+    w.dpy = XOpenDisplay(NULL);
+    if (!w.dpy) {
+        print_error("Cannot open X display");
+        return 1;
+    }
+
+    XSetErrorHandler(ignore_x_errors);
+    w.root = DefaultRootWindow(w.dpy);
+    w.net_active_window = XInternAtom(w.dpy, "_NET_ACTIVE_WINDOW", False);
+    w.net_wm_state = XInternAtom(w.dpy, "_NET_WM_STATE", False);
+    w.net_wm_state_fullscreen = XInternAtom(w.dpy, "_NET_WM_STATE_FULLSCREEN", False);
+    XSelectInput(w.dpy, w.root, PropertyChangeMask);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop;   // No SA_RESTART: poll() returns EINTR
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+
+    update_focus(&w);
+
+    // Block on the X connection; property changes are the only wakeups
+    struct pollfd pfd = { .fd = ConnectionNumber(w.dpy), .events = POLLIN };
+    while (!stop_requested) {
+        int changed = 0;
+        while (XPending(w.dpy)) {
+            XEvent ev;
+            XNextEvent(w.dpy, &ev);
+            if (ev.type != PropertyNotify) continue;
+            if ((ev.xproperty.window == w.root && ev.xproperty.atom == w.net_active_window) ||
+                (ev.xproperty.window == w.active && ev.xproperty.atom == w.net_wm_state)) {
+                changed = 1;
+            }
+        }
+        if (changed) {
+            // Its replies may have queued more events; drain them before
+            // blocking, or poll() would sleep with events unread
+            update_focus(&w);
+            continue;
+        }
+
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) break;
+        if (pfd.revents & (POLLERR | POLLHUP)) break;
+    }
+
+    focus_leave();
+    XCloseDisplay(w.dpy);
+    return 0;
+}
+
+// --- Command line --------------------------------------------------------
+
+static void print_focus_usage(void) {
+    printf("Usage: opende focus [status]        Show focus mode state\n");
+    printf("       opende focus on|off          Enter or leave focus mode\n");
+    printf("       opende focus watch [--force] Follow fullscreen windows automatically\n");
+    printf("       opende focus enable|disable auto\n");
+    printf("       opende focus set freeze \"<component> ...\"\n");
+    printf("\nFocus mode stops the compositor, pauses dunst and freezes background\n");
+    printf("components (default: %s).\n", FOCUS_DEFAULT_FREEZE);
+}
+
+static int focus_status(void) {
+    print_header("Focus mode");
+
+    char *freeze = config_get_setting(FOCUS_KEY_FREEZE);
+    printf("  State:  %s\n", focus_is_active() ? "active" : "inactive");
+    printf("  Auto:   %s\n", config_get_setting_bool(FOCUS_KEY_AUTO, 0) ?
+           "enabled (on fullscreen)" : "disabled");
+    printf("  Freeze: %s\n", freeze ? freeze : FOCUS_DEFAULT_FREEZE);
+    free(freeze);
+    return 0;
+}
+
+int focus_command(int argc, char *argv[]) {
+    if (argc < 1 || strcmp(argv[0], "status") == 0) {
+        return focus_status();
+    }
+
+    if (strcmp(argv[0], "on") == 0) {
+        if (focus_enter() != 0) {
+            print_error("Failed to enter focus mode");
+            return 1;
+        }
+        print_success("Focus mode on");
+        return 0;
+    }
+
+    if (strcmp(argv[0], "off") == 0) {
+        if (focus_leave() != 0) {
+            print_error("Focus mode left, but the compositor did not restart");
+            return 1;
+        }
+        print_success("Focus mode off");
+        return 0;
+    }
+
+    if (strcmp(argv[0], "watch") == 0) {
+        return focus_watch(argc > 1 && strcmp(argv[1], "--force") == 0);
+    }
+
+    if ((strcmp(argv[0], "enable") == 0 || strcmp(argv[0], "disable") == 0) &&
+        argc > 1 && strcmp(argv[1], FOCUS_SETTING_AUTO) == 0) {
+        int enable = strcmp(argv[0], "enable") == 0;
+        if (config_set_setting(FOCUS_KEY_AUTO, enable ? "true" : "false") != 0) {
+            print_error("Failed to save setting");
+            return 1;
+        }
+        print_success("Automatic focus mode %s", enable ? "enabled (starts with the next session)" : "disabled");
+        return 0;
+    }
+
+    if (strcmp(argv[0], "set") == 0 && argc > 2 &&
+        strcmp(argv[1], FOCUS_SETTING_FREEZE) == 0) {
+        if (config_set_setting(FOCUS_KEY_FREEZE, argv[2]) != 0) {
+            print_error("Failed to save setting");
+            return 1;
+        }
+        print_success("Focus mode will freeze: %s", argv[2]);
+        return 0;
+    }
+
+    print_focus_usage();
+    return 2;
+}
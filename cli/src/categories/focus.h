@@ -0,0 +1,23 @@
+// cli/src/categories/focus.h
+#ifndef OPENDE_FOCUS_H
+#define OPENDE_FOCUS_H
+
+#define FOCUS_SETTING_AUTO    "auto"
+#define FOCUS_SETTING_FREEZE  "freeze"
+
+// Settings in opende.conf
+#define FOCUS_KEY_AUTO    "focus.auto"
+#define FOCUS_KEY_FREEZE  "focus.freeze"
+
+// Components frozen unless focus.freeze says otherwise
+#define FOCUS_DEFAULT_FREEZE "nm-applet pasystray blueman-applet pcmanfm"
+
+// opende focus on|off|status|watch|enable|disable|set ...
+int focus_command(int argc, char *argv[]);
+
+// Enter/leave focus mode; returns 0 on success
+int focus_enter(void);
+int focus_leave(void);
+int focus_is_active(void);
+
+#endif
@@ -0,0 +1,273 @@
+// cli/src/categories/governor.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "governor.h"
+#include "settings.h"
+#include "../backends/picom.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include "../util/proc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#define GOVERNOR_STATE_FILE "governor.state"
+
+// Consecutive samples needed before changing level. Stepping up needs a
+// longer quiet period than stepping down so the two don't oscillate.
+#define DOWN_SAMPLES 3
+#define UP_SAMPLES   6
+
+typedef struct {
+    int level;
+    int high, low, interval;
+
+    // Effects as configured by the user at the last level change
+    int fading;
+    int shadows;
+    int transparency;
+
+    pid_t picom;
+    double last_cpu;
+    double last_wall;
+} Governor;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static const char *level_names[] = {
+    "full", "no-fade", "no-shadow", "opaque"
+};
+
+const char *governor_level_name(int level) {
+    if (level < 0 || level > GOVERNOR_LEVEL_MAX) return "unknown";
+    return level_names[level];
+}
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static void log_transition(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void log_transition(const char *fmt, ...) {
+    char msg[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+
+    syslog(LOG_NOTICE, "%s", msg);
+    print_info("%s", msg);
+}
+
+static void write_state(const Governor *g) {
+    char *path = config_get_runtime_path(GOVERNOR_STATE_FILE);
+    if (!path) return;
+
+    char content[128];
+    snprintf(content, sizeof(content), "pid = %ld\nlevel = %d\n",
+             (long)getpid(), g->level);
+    config_write_file(path, content);
+    free(path);
+
+    // Effects just changed under the user; tell snapshot readers
+    settings_publish();
+}
+
+static void clear_state(void) {
+    char *path = config_get_runtime_path(GOVERNOR_STATE_FILE);
+    if (!path) return;
+    unlink(path);
+    free(path);
+    settings_publish();
+}
+
+int governor_get_level(void) {
+    char *path = config_get_runtime_path(GOVERNOR_STATE_FILE);
+    if (!path) return -1;
+
+    char *text = config_read_file(path);
+    free(path);
+    if (!text) return -1;
+
+    long pid = 0;
+    int level = -1;
+    if (sscanf(text, "pid = %ld\nlevel = %d", &pid, &level) != 2 ||
+        pid <= 0 || kill((pid_t)pid, 0) != 0) {
+        level = -1;  // Stale state from a governor that died
+    }
+
+    free(text);
+    return level;
+}
+
+// Is the feature that `level` turns off enabled in the user's config?
+static int level_has_effect(const Governor *g, int level) {
+    switch (level) {
+        case GOVERNOR_LEVEL_NO_FADE:   return g->fading == 1;
+        case GOVERNOR_LEVEL_NO_SHADOW: return g->shadows == 1;
+        case GOVERNOR_LEVEL_OPAQUE:    return g->transparency >= 0 && g->transparency < 100;
+        default:                       return 0;
+    }
+}
+
+// Run picom with every feature up to `level` turned off. The overrides
+// live in a runtime overlay, never in the user's picom.conf, and are
+// dropped if the governor dies.
+static int apply_level(const Governor *g, int level) {
+    PicomOverride overrides[GOVERNOR_LEVEL_MAX];
+    int count = 0;
+
+    if (level >= GOVERNOR_LEVEL_NO_FADE && level_has_effect(g, GOVERNOR_LEVEL_NO_FADE)) {
+        overrides[count++] = (PicomOverride){ "fading", "false" };
+    }
+    if (level >= GOVERNOR_LEVEL_NO_SHADOW && level_has_effect(g, GOVERNOR_LEVEL_NO_SHADOW)) {
+        overrides[count++] = (PicomOverride){ "shadow", "false" };
+    }
+    if (level >= GOVERNOR_LEVEL_OPAQUE && level_has_effect(g, GOVERNOR_LEVEL_OPAQUE)) {
+        overrides[count++] = (PicomOverride){ "inactive-opacity", "1.00" };
+    }
+    return picom_set_overrides(overrides, count);
+}
+
+// The user may change effects while the governor runs
+static void read_user_effects(Governor *g) {
+    g->fading = picom_get_animations();
+    g->shadows = picom_get_shadows();
+    g->transparency = picom_get_transparency();
+}
+
+// Move one effective step; levels whose feature is already off in the
+// user's config are passed through so every transition changes something.
+// Stepping up ends at full effects, without the overlay, even if none of
+// the features on the way is on any more
+static void change_level(Governor *g, int direction, double cpu) {
+    int from = g->level;
+    int level = from, target = -1;
+
+    read_user_effects(g);
+    while (target < 0 && level + direction >= GOVERNOR_LEVEL_FULL &&
+           level + direction <= GOVERNOR_LEVEL_MAX) {
+        int feature = direction > 0 ? level + direction : level;
+        level += direction;
+        if (level_has_effect(g, feature)) target = level;
+    }
+    if (target < 0 && direction < 0 && from > GOVERNOR_LEVEL_FULL) target = GOVERNOR_LEVEL_FULL;
+    if (target < 0) return;
+
+    int result = target == GOVERNOR_LEVEL_FULL ? picom_set_overrides(NULL, 0) : apply_level(g, target);
+    if (result != 0) {
+        log_transition("failed to switch effects to %s", governor_level_name(target));
+        return;
+    }
+
+    g->level = target;
+    log_transition("picom at %.0f%% CPU: effects %s -> %s",
+                   cpu, governor_level_name(from), governor_level_name(target));
+    write_state(g);
+}
+
+static void restore_effects(Governor *g) {
+    if (g->level > GOVERNOR_LEVEL_FULL) picom_set_overrides(NULL, 0);
+    g->level = GOVERNOR_LEVEL_FULL;
+}
+
+// CPU usage of picom since the previous sample, as percent of one core
+// Returns -1 when there is no baseline yet (new or restarted picom)
+static double sample_cpu(Governor *g) {
+    ProcStat st;
+    double now = proc_now_ms();
+
+    if (g->picom <= 0 || proc_read_stat(g->picom, &st) != 0 ||
+        strcmp(st.comm, "picom") != 0) {
+        g->picom = picom_get_pid();
+        g->last_wall = 0;
+        if (g->picom <= 0 || proc_read_stat(g->picom, &st) != 0) return -1;
+    }
+
+    double cpu = proc_cpu_seconds(&st);
+    double result = -1;
+    if (g->last_wall > 0 && now > g->last_wall) {
+        result = (cpu - g->last_cpu) * 100000.0 / (now - g->last_wall);
+    }
+
+    g->last_cpu = cpu;
+    g->last_wall = now;
+    return result;
+}
+
+int governor_run(int force) {
+    if (!force && !config_get_setting_bool(GOVERNOR_KEY_ENABLED, 0)) {
+        return 0;  // Opt-in only
+    }
+
+    if (governor_get_level() >= 0) {
+        print_error("Effects governor is already running");
+        return 1;
+    }
+
+    Governor g;
+    memset(&g, 0, sizeof(g));
+    g.high = config_get_setting_int(GOVERNOR_KEY_HIGH, 50);
+    g.low = config_get_setting_int(GOVERNOR_KEY_LOW, 15);
+    g.interval = config_get_setting_int(GOVERNOR_KEY_INTERVAL, 5);
+    if (g.interval < 1) g.interval = 1;
+    if (g.low >= g.high) g.low = g.high / 2;
+
+    read_user_effects(&g);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+
+    openlog("opende-governor", LOG_PID, LOG_USER);
+    log_transition("started: step down above %d%% CPU, up below %d%%, every %ds",
+                   g.high, g.low, g.interval);
+    write_state(&g);
+
+    int over = 0, under = 0;
+    while (!stop_requested) {
+        struct timespec ts = { g.interval, 0 };
+        nanosleep(&ts, NULL);
+        if (stop_requested) break;
+
+        double cpu = sample_cpu(&g);
+        if (cpu < 0) {
+            over = under = 0;
+            continue;
+        }
+
+        if (cpu > g.high) {
+            under = 0;
+            if (++over >= DOWN_SAMPLES && g.level < GOVERNOR_LEVEL_MAX) {
+                change_level(&g, +1, cpu);
+                over = 0;
+                g.last_wall = 0;  // picom reloaded; start a fresh sample window
+            }
+        } else if (cpu < g.low) {
+            over = 0;
+            if (++under >= UP_SAMPLES && g.level > GOVERNOR_LEVEL_FULL) {
+                change_level(&g, -1, cpu);
+                under = 0;
+                g.last_wall = 0;
+            }
+        } else {
+            over = under = 0;
+        }
+    }
+
+    restore_effects(&g);
+    log_transition("stopped, effects restored");
+    clear_state();
+    closelog();
+    return 0;
+}
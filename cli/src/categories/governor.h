@@ -0,0 +1,27 @@
+// cli/src/categories/governor.h
+#ifndef OPENDE_GOVERNOR_H
+#define OPENDE_GOVERNOR_H
+
+// Effects levels, stepped down one at a time under sustained load
+#define GOVERNOR_LEVEL_FULL         0  // User's configured effects
+#define GOVERNOR_LEVEL_NO_FADE      1  // Fading off
+#define GOVERNOR_LEVEL_NO_SHADOW    2  // Fading and shadows off
+#define GOVERNOR_LEVEL_OPAQUE       3  // ...and inactive windows fully opaque
+#define GOVERNOR_LEVEL_MAX          GOVERNOR_LEVEL_OPAQUE
+
+// Settings in opende.conf
+#define GOVERNOR_KEY_ENABLED   "governor.enabled"
+#define GOVERNOR_KEY_HIGH      "governor.high"       // CPU % that steps down
+#define GOVERNOR_KEY_LOW       "governor.low"        // CPU % that steps up
+#define GOVERNOR_KEY_INTERVAL  "governor.interval"   // Seconds between samples
+
+// Run the governor until SIGTERM/SIGINT, restoring full effects on exit.
+// Exits immediately unless enabled in settings (or force is set).
+int governor_run(int force);
+
+// Level of the running governor, or -1 if none is running
+int governor_get_level(void);
+
+const char *governor_level_name(int level);
+
+#endif
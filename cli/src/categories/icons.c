@@ -0,0 +1,163 @@
+// cli/src/categories/icons.c
+#define _DEFAULT_SOURCE
+#include "icons.h"
+#include "../backends/icons.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_LOOKUP_SIZE 48
+
+static void format_sizes(const int *sizes, int count, char *out, size_t len) {
+    size_t pos = 0;
+    out[0] = '\0';
+    for (int i = 0; i < count && pos < len; i++) {
+        pos += (size_t)snprintf(out + pos, len - pos, "%s%d", i ? " " : "", sizes[i]);
+    }
+}
+
+// opende icons lookup <name>... [--size N]
+static int icons_cmd_lookup(int argc, char *argv[]) {
+    int size = DEFAULT_LOOKUP_SIZE;
+    for (int i = 0; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0) size = atoi(argv[i + 1]);
+    }
+    if (argc < 1 || size <= 0) {
+        print_error("Usage: opende icons lookup <name>... [--size N]");
+        return 1;
+    }
+
+    // One line per name, empty if not found, so callers can zip the output
+    int missing = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0) {
+            i++;
+            continue;
+        }
+        char *path = icons_lookup(argv[i], size);
+        printf("%s\n", path ? path : "");
+        missing += !path;
+        free(path);
+    }
+    return missing ? 1 : 0;
+}
+
+static int icons_cmd_update(void) {
+    int names = icons_cache_update(NULL, 0);
+    if (names < 0) {
+        print_error("Failed to write icon cache");
+        return 1;
+    }
+
+    char *theme = icons_theme_name();
+    print_success("Icon cache rebuilt for %s (%d icons)", theme, names);
+    free(theme);
+    return 0;
+}
+
+static int icons_cmd_set(int argc, char *argv[]) {
+    if (argc < 2 || strcmp(argv[0], "sizes") != 0) {
+        print_error("Usage: opende icons set sizes \"16 22 24 32 48\"");
+        return 1;
+    }
+
+    int sizes[16];
+    char value[128];
+    int count = 0;
+    for (int i = 1; i < argc && count < 16; i++) {
+        int size = atoi(argv[i]);
+        if (size <= 0 || size > 1024) {
+            print_error("Invalid icon size '%s'", argv[i]);
+            return 1;
+        }
+        sizes[count++] = size;
+    }
+    format_sizes(sizes, count, value, sizeof(value));
+
+    if (config_set_setting("icons.sizes", value) != 0) {
+        print_error("Failed to save setting");
+        return 1;
+    }
+    print_success("Icon cache sizes set to %s", value);
+    return icons_cmd_update();
+}
+
+static int icons_cmd_status(void) {
+    IconCacheInfo info;
+    char *theme = icons_theme_name();
+    char *path = icons_cache_path();
+    char value[128];
+
+    print_header("Icon cache");
+    print_setting("Theme", theme, 1);
+
+    if (icons_cache_info(&info) != 0) {
+        print_setting("Cache", "not built (run 'opende icons update')", 0);
+    } else {
+        snprintf(value, sizeof(value), "%s (%ld KB)", info.fresh ? "current" : "stale", info.bytes / 1024);
+        print_setting("Cache", value, info.fresh);
+        print_setting("File", path ? path : "", 1);
+        if (info.fresh) {
+            snprintf(value, sizeof(value), "%d", info.names);
+            print_setting("Icons", value, 1);
+            format_sizes(info.sizes, info.size_count, value, sizeof(value));
+            print_setting("Sizes", value, 1);
+        }
+    }
+
+    free(theme);
+    free(path);
+    return 0;
+}
+
+static void print_icons_usage(void) {
+    printf("Usage: opende icons lookup <name>... [--size N]\n");
+    printf("       opende icons update\n");
+    printf("       opende icons set sizes <size>...\n");
+    printf("       opende icons status\n");
+    printf("       opende icons clear\n");
+    printf("\nCommands:\n");
+    printf("  lookup  Print the file for each icon name (one line each)\n");
+    printf("  update  Resolve every icon in the current theme at the cached sizes\n");
+    printf("  set     Choose the sizes kept in the cache\n");
+    printf("  status  Show the cache's theme, size and freshness\n");
+    printf("  clear   Delete the cache\n");
+}
+
+int icons_command(int argc, char *argv[]) {
+    if (argc < 1) {
+        print_icons_usage();
+        return 0;
+    }
+
+    if (strcmp(argv[0], "lookup") == 0) {
+        return icons_cmd_lookup(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "update") == 0) {
+        return icons_cmd_update();
+    }
+
+    if (strcmp(argv[0], "set") == 0) {
+        return icons_cmd_set(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "status") == 0) {
+        return icons_cmd_status();
+    }
+
+    if (strcmp(argv[0], "clear") == 0) {
+        if (icons_cache_clear() != 0) {
+            print_error("Failed to delete icon cache");
+            return 1;
+        }
+        print_success("Icon cache cleared");
+        return 0;
+    }
+
+    print_error("Unknown icons command '%s'", argv[0]);
+    print_icons_usage();
+    return 2;
+}
@@ -0,0 +1,8 @@
+// cli/src/categories/icons.h
+#ifndef OPENDE_ICONS_H
+#define OPENDE_ICONS_H
+
+// opende icons <command> ...
+int icons_command(int argc, char *argv[]);
+
+#endif
@@ -1,6 +1,10 @@
 // cli/src/categories/input.c
 #include "input.h"
+#include "category.h"
+#include "../backends/keyboard.h"
 #include "../backends/xorg_conf.h"
+#include "../backends/xorg_input.h"
+#include "../util/config.h"
 #include "../util/output.h"
 #include <stdio.h>
 #include <string.h>
@@ -10,9 +14,36 @@ static const char *valid_settings[] = {
     INPUT_SETTING_NATURAL_SCROLL,
     INPUT_SETTING_TAP_CLICK,
     INPUT_SETTING_MOUSE_ACCEL,
+    INPUT_SETTING_REPEAT_DELAY,
+    INPUT_SETTING_REPEAT_RATE,
+    INPUT_SETTING_KB_LAYOUT,
+    INPUT_SETTING_KB_VARIANT,
+    INPUT_SETTING_KB_OPTIONS,
     NULL
 };
 
+#define REPEAT_DELAY_MIN 100
+#define REPEAT_DELAY_MAX 2000
+#define REPEAT_RATE_MIN  1
+#define REPEAT_RATE_MAX  100
+
+// Per-user keyboard settings, applied to the X server (no sudo)
+typedef enum { KB_DELAY, KB_RATE, KB_LAYOUT, KB_VARIANT, KB_OPTIONS } KeyboardField;
+
+static const struct {
+    const char *name;
+    KeyboardField field;
+    const char *key;
+} keyboard_settings[] = {
+    { INPUT_SETTING_REPEAT_DELAY, KB_DELAY,   INPUT_KEY_REPEAT_DELAY },
+    { INPUT_SETTING_REPEAT_RATE,  KB_RATE,    INPUT_KEY_REPEAT_RATE },
+    { INPUT_SETTING_KB_LAYOUT,    KB_LAYOUT,  INPUT_KEY_KB_LAYOUT },
+    { INPUT_SETTING_KB_VARIANT,   KB_VARIANT, INPUT_KEY_KB_VARIANT },
+    { INPUT_SETTING_KB_OPTIONS,   KB_OPTIONS, INPUT_KEY_KB_OPTIONS },
+};
+
+#define KEYBOARD_SETTING_COUNT (int)(sizeof(keyboard_settings) / sizeof(keyboard_settings[0]))
+
 static int is_valid_setting(const char *setting) {
     for (int i = 0; valid_settings[i]; i++) {
         if (strcmp(setting, valid_settings[i]) == 0) return 1;
@@ -21,10 +52,192 @@ static int is_valid_setting(const char *setting) {
 }
 
 void input_list_settings(void) {
-    printf("Available input settings:\n");
+    print_line("Available input settings:");
     for (int i = 0; valid_settings[i]; i++) {
-        printf("  %s\n", valid_settings[i]);
+        print_line("  %s", valid_settings[i]);
+    }
+}
+
+static int keyboard_index(const char *setting) {
+    for (int i = 0; i < KEYBOARD_SETTING_COUNT; i++) {
+        if (strcmp(setting, keyboard_settings[i].name) == 0) return i;
+    }
+    return -1;
+}
+
+static char *names_field(KeyboardNames *names, KeyboardField field) {
+    switch (field) {
+        case KB_LAYOUT:  return names->layout;
+        case KB_VARIANT: return names->variant;
+        case KB_OPTIONS: return names->options;
+        default:         return NULL;
+    }
+}
+
+static int count_items(const char *list) {
+    if (!*list) return 0;
+    int count = 1;
+    for (const char *p = list; *p; p++) count += *p == ',';
+    return count;
+}
+
+// Saved layout, variant and options over the given names ("none" is saved
+// for an explicitly empty value). Returns how many were saved
+static int saved_names(KeyboardNames *names) {
+    int saved = 0;
+    for (int i = 0; i < KEYBOARD_SETTING_COUNT; i++) {
+        char *field = names_field(names, keyboard_settings[i].field);
+        char *value = field ? config_get_setting(keyboard_settings[i].key) : NULL;
+        if (!value) continue;
+        snprintf(field, KEYBOARD_NAME_MAX, "%s", strcmp(value, "none") == 0 ? "" : value);
+        free(value);
+        saved++;
+    }
+    return saved;
+}
+
+static int set_repeat(int index, const char *value) {
+    int delay_field = keyboard_settings[index].field == KB_DELAY;
+    int min = delay_field ? REPEAT_DELAY_MIN : REPEAT_RATE_MIN;
+    int max = delay_field ? REPEAT_DELAY_MAX : REPEAT_RATE_MAX;
+
+    char *end;
+    long n = strtol(value, &end, 10);
+    if (end == value || *end || n < min || n > max) {
+        print_error("Invalid value '%s' for %s (%d-%d %s)", value, keyboard_settings[index].name,
+                    min, max, delay_field ? "ms" : "keys per second");
+        return CATEGORY_INVALID;
+    }
+
+    int delay, rate;
+    if (keyboard_get_repeat(&delay, &rate) == 0) {
+        if (delay_field) delay = (int)n;
+        else rate = (int)n;
+        if (keyboard_set_repeat(delay, rate) != 0) {
+            print_error("The X server rejected %s", keyboard_settings[index].name);
+            return 1;
+        }
+    } else {
+        print_info("No X display; saved for the next login");
     }
+
+    char text[16];
+    snprintf(text, sizeof(text), "%ld", n);
+    if (config_set_setting(keyboard_settings[index].key, text) != 0) {
+        print_error("Failed to save %s", keyboard_settings[index].name);
+        return 1;
+    }
+    print_success("%s set to %ld %s", keyboard_settings[index].name, n, delay_field ? "ms" : "keys per second");
+    return 0;
+}
+
+static int set_names(int index, const char *value) {
+    KeyboardField field = keyboard_settings[index].field;
+    const char *wanted = strcmp(value, "none") == 0 && field != KB_LAYOUT ? "" : value;
+
+    if (field == KB_LAYOUT && (count_items(wanted) > 4 || !keyboard_layout_exists(wanted))) {
+        print_error("Unknown keyboard layout '%s' (up to 4, comma-separated)", value);
+        return CATEGORY_INVALID;
+    }
+
+    KeyboardNames names;
+    int live = keyboard_get_names(&names) == 0;
+    if (!live) memset(&names, 0, sizeof(names));
+    saved_names(&names);
+
+    // A new layout starts with its default variant
+    int reset_variant = field == KB_LAYOUT && strcmp(names.layout, wanted) != 0 && names.variant[0];
+    if (reset_variant) names.variant[0] = '\0';
+    char *target = names_field(&names, field);
+    if (target) snprintf(target, KEYBOARD_NAME_MAX, "%s", wanted);
+
+    if (field == KB_VARIANT && count_items(wanted) > count_items(names.layout)) {
+        print_error("More variants than layouts ('%s')", names.layout);
+        return CATEGORY_INVALID;
+    }
+
+    if (live) {
+        if (keyboard_set_names(&names) != 0) {
+            print_error("Could not build a keymap for layout '%s', variant '%s', options '%s'",
+                        names.layout, names.variant, names.options);
+            return 1;
+        }
+    } else {
+        print_info("No X display; saved for the next login");
+    }
+
+    if (config_set_setting(keyboard_settings[index].key, *wanted ? wanted : "none") != 0 ||
+        (reset_variant && config_set_setting(INPUT_KEY_KB_VARIANT, "none") != 0)) {
+        print_error("Failed to save %s", keyboard_settings[index].name);
+        return 1;
+    }
+    print_success("%s set to '%s'", keyboard_settings[index].name, *wanted ? wanted : "none");
+    return 0;
+}
+
+int input_keyboard_get(const char *setting, char *value, size_t size) {
+    int index = keyboard_index(setting);
+    if (index < 0) return -1;
+
+    KeyboardField field = keyboard_settings[index].field;
+    if (field == KB_DELAY || field == KB_RATE) {
+        int delay, rate;
+        if (keyboard_get_repeat(&delay, &rate) == 0) {
+            snprintf(value, size, "%d", field == KB_DELAY ? delay : rate);
+            return 0;
+        }
+    } else {
+        KeyboardNames names;
+        if (keyboard_get_names(&names) == 0) {
+            const char *live = names_field(&names, field);
+            snprintf(value, size, "%s", *live ? live : "none");
+            return 0;
+        }
+    }
+
+    char *saved = config_get_setting(keyboard_settings[index].key);
+    snprintf(value, size, "%s", saved ? saved : "default");
+    free(saved);
+    return 0;
+}
+
+int input_restore(int argc, char *argv[]) {
+    (void)argv;
+    if (argc > 0) {
+        print_error("Usage: opende input restore");
+        return 1;
+    }
+
+    int delay = config_get_setting_int(INPUT_KEY_REPEAT_DELAY, 0);
+    int rate = config_get_setting_int(INPUT_KEY_REPEAT_RATE, 0);
+    KeyboardNames current, wanted;
+    if (keyboard_get_names(&current) != 0) memset(&current, 0, sizeof(current));
+    wanted = current;
+    int names = saved_names(&wanted);
+    if (delay <= 0 && rate <= 0 && names == 0) return 0;   // Keep the server defaults
+
+    int result = 0;
+    int live_delay, live_rate;
+    if ((delay > 0 || rate > 0) && keyboard_get_repeat(&live_delay, &live_rate) == 0) {
+        if (keyboard_set_repeat(delay > 0 ? delay : live_delay, rate > 0 ? rate : live_rate) != 0) result = -1;
+    } else if (delay > 0 || rate > 0) {
+        result = -1;
+    }
+
+    // Building a keymap is the expensive part: skip it when the server
+    // already has these names (set in xorg.conf, or by a previous login)
+    if (names > 0 && (strcmp(wanted.layout, current.layout) != 0 ||
+                      strcmp(wanted.variant, current.variant) != 0 ||
+                      strcmp(wanted.options, current.options) != 0)) {
+        if (keyboard_set_names(&wanted) != 0) result = -1;
+    }
+
+    if (result != 0) {
+        print_error("Failed to apply saved keyboard settings");
+        return 1;
+    }
+    print_success("Keyboard settings restored");
+    return 0;
 }
 
 int input_enable(const char *setting) {
@@ -51,7 +264,7 @@ int input_enable(const char *setting) {
     }
 
     print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int input_disable(const char *setting) {
@@ -78,7 +291,7 @@ int input_disable(const char *setting) {
     }
 
     print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int input_set(const char *setting, const char *value) {
@@ -88,7 +301,18 @@ int input_set(const char *setting, const char *value) {
         return 2;
     }
 
+    int keyboard = keyboard_index(setting);
+    if (keyboard >= 0) {
+        KeyboardField field = keyboard_settings[keyboard].field;
+        return field == KB_DELAY || field == KB_RATE ? set_repeat(keyboard, value) : set_names(keyboard, value);
+    }
+
     if (strcmp(setting, INPUT_SETTING_MOUSE_ACCEL) == 0) {
+        if (strcmp(value, "off") != 0 && strcmp(value, "low") != 0 &&
+            strcmp(value, "medium") != 0 && strcmp(value, "high") != 0) {
+            print_error("Invalid acceleration level. Use: off, low, medium, high");
+            return CATEGORY_INVALID;
+        }
         if (xorg_set_mouse_accel(value) == 0) {
             print_success("Mouse acceleration set to '%s'", value);
             return 0;
@@ -97,7 +321,7 @@ int input_set(const char *setting, const char *value) {
     }
 
     print_error("Setting '%s' does not support 'set', use enable/disable", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int input_status(const char *setting) {
@@ -124,6 +348,12 @@ int input_status(const char *setting) {
             free(val);
             return 0;
         }
+
+        char value[KEYBOARD_NAME_MAX];
+        if (input_keyboard_get(setting, value, sizeof(value)) == 0) {
+            printf("%s\n", value);
+            return 0;
+        }
     }
 
     // Show all input status
@@ -138,7 +368,66 @@ int input_status(const char *setting) {
     printf("  Tap-to-click:      %s\n",
            tap == 1 ? "enabled" : tap == 0 ? "disabled" : "default");
     printf("  Mouse acceleration: %s\n", accel);
-
     free(accel);
+
+    print_header("Keyboard");
+    for (int i = 0; i < KEYBOARD_SETTING_COUNT; i++) {
+        char value[KEYBOARD_NAME_MAX];
+        input_keyboard_get(keyboard_settings[i].name, value, sizeof(value));
+        printf("  %-17s %s\n", keyboard_settings[i].name, value);
+    }
+    return 0;
+}
+
+static void describe_kinds(unsigned int kinds, char *buf, size_t size) {
+    static const struct {
+        unsigned int kind;
+        const char *name;
+    } names[] = {
+        { XORG_IS_KEYBOARD, "keyboard" },       { XORG_IS_POINTER, "pointer" },
+        { XORG_IS_TOUCHPAD, "touchpad" },       { XORG_IS_TOUCHSCREEN, "touchscreen" },
+        { XORG_IS_TABLET, "tablet" },           { XORG_IS_JOYSTICK, "joystick" },
+    };
+
+    size_t len = 0;
+    buf[0] = '\0';
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]) && len < size; i++) {
+        if (kinds & names[i].kind) len += (size_t)snprintf(buf + len, size - len, "%s%s", len ? ", " : "", names[i].name);
+    }
+    if (!buf[0]) snprintf(buf, size, "other");
+}
+
+static void print_effective(const XorgOption *option) {
+    printf("  %-20s %-12s %s (%s)\n", option->name, option->value, option->file,
+           option->section[0] ? option->section : "unnamed");
+}
+
+int input_devices(int argc, char *argv[]) {
+    (void)argv;
+    if (argc > 0) {
+        print_error("Usage: opende input devices");
+        return 1;
+    }
+
+    int count;
+    XorgDevice *devices = xorg_input_devices(&count);
+    if (!devices) {
+        print_error("Failed to read input devices");
+        return 1;
+    }
+    if (count == 0) print_info("No input devices found");
+
+    for (int i = 0; i < count; i++) {
+        const XorgDevice *d = &devices[i];
+        char kinds[96];
+        describe_kinds(d->kinds, kinds, sizeof(kinds));
+        print_header(d->name);
+        printf("  %s, %s\n", d->path, kinds);
+
+        if (d->driver.value[0]) print_effective(&d->driver);
+        for (int j = 0; j < d->option_count; j++) print_effective(&d->options[j]);
+        if (!d->driver.value[0] && d->option_count == 0) printf("  No InputClass section matches\n");
+    }
+    free(devices);
     return 0;
 }
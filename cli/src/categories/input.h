@@ -2,9 +2,23 @@
 #ifndef OPENDE_INPUT_H
 #define OPENDE_INPUT_H
 
+#include <stddef.h>
+
 #define INPUT_SETTING_NATURAL_SCROLL "natural-scrolling"
 #define INPUT_SETTING_TAP_CLICK      "tap-to-click"
 #define INPUT_SETTING_MOUSE_ACCEL    "mouse-accel"
+#define INPUT_SETTING_REPEAT_DELAY   "repeat-delay"
+#define INPUT_SETTING_REPEAT_RATE    "repeat-rate"
+#define INPUT_SETTING_KB_LAYOUT      "keyboard-layout"
+#define INPUT_SETTING_KB_VARIANT     "keyboard-variant"
+#define INPUT_SETTING_KB_OPTIONS     "keyboard-options"
+
+// Keyboard settings in opende.conf, re-applied by 'opende input restore'
+#define INPUT_KEY_REPEAT_DELAY "input.repeat-delay"
+#define INPUT_KEY_REPEAT_RATE  "input.repeat-rate"
+#define INPUT_KEY_KB_LAYOUT    "input.keyboard-layout"
+#define INPUT_KEY_KB_VARIANT   "input.keyboard-variant"
+#define INPUT_KEY_KB_OPTIONS   "input.keyboard-options"
 
 int input_enable(const char *setting);
 int input_disable(const char *setting);
@@ -13,4 +27,15 @@ int input_status(const char *setting);
 
 void input_list_settings(void);
 
+// Current value of a keyboard setting: the X server's, else the saved one,
+// else "default". Returns 0, or -1 if the setting is not a keyboard one
+int input_keyboard_get(const char *setting, char *value, size_t size);
+
+// opende input restore: apply the saved keyboard settings to the X server
+int input_restore(int argc, char *argv[]);
+
+// opende input devices: each input device with the options the X server
+// gives it and the xorg.conf.d fragment that set each
+int input_devices(int argc, char *argv[]);
+
 #endif
@@ -0,0 +1,191 @@
+// cli/src/categories/notifications.c
+#include "notifications.h"
+#include "category.h"
+#include "../backends/dunst.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    KIND_NUMBER,             // set, integer in [min, max]
+    KIND_TOGGLE,             // enable/disable, written as on_value/off_value
+    KIND_DND                 // enable/disable through dunstctl
+} Kind;
+
+static const struct {
+    const char *name;
+    Kind kind;
+    const char *section;
+    const char *key;
+    int min, max;
+    const char *on_value, *off_value;
+    const char *description;
+} settings[] = {
+    { NOTIFY_SETTING_HISTORY,          KIND_NUMBER, "global", "history_length", 0, 1000,
+      NULL, NULL, "notifications kept in history" },
+    { NOTIFY_SETTING_TIMEOUT,          KIND_NUMBER, "urgency_normal", "timeout", 0, 3600,
+      NULL, NULL, "seconds a normal popup stays (0 = until dismissed)" },
+    { NOTIFY_SETTING_TIMEOUT_LOW,      KIND_NUMBER, "urgency_low", "timeout", 0, 3600,
+      NULL, NULL, "seconds a low-urgency popup stays" },
+    { NOTIFY_SETTING_TIMEOUT_CRITICAL, KIND_NUMBER, "urgency_critical", "timeout", 0, 3600,
+      NULL, NULL, "seconds a critical popup stays (0 = until dismissed)" },
+    { NOTIFY_SETTING_LIMIT,            KIND_NUMBER, "global", "notification_limit", 0, 50,
+      NULL, NULL, "popups on screen at once, the rest queue (0 = no limit)" },
+    { NOTIFY_SETTING_STACKING,         KIND_TOGGLE, "global", "stack_duplicates", 0, 0,
+      "true", "false", "fold identical notifications into one with a count" },
+    { NOTIFY_SETTING_FULLSCREEN_PAUSE, KIND_TOGGLE, "fullscreen_delay_everything", "fullscreen", 0, 0,
+      "delay", "show", "hold non-critical popups while a fullscreen window is focused" },
+    { NOTIFY_SETTING_DND,              KIND_DND, NULL, NULL, 0, 0,
+      NULL, NULL, "do not disturb: hold all popups until turned off" },
+};
+
+#define SETTING_COUNT (int)(sizeof(settings) / sizeof(settings[0]))
+
+void notifications_list_settings(void) {
+    print_line("Available notifications settings:");
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        print_line("  %-17s %s", settings[i].name, settings[i].description);
+    }
+}
+
+static int lookup(const char *setting) {
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (strcmp(setting, settings[i].name) == 0) return i;
+    }
+    print_error("Unknown setting '%s'", setting);
+    notifications_list_settings();
+    return -1;
+}
+
+static void reload(void) {
+    int result = dunst_reload();
+    if (result < 0) print_info("Restart dunst to apply (dunstctl reload needs dunst 1.10)");
+}
+
+static int set_dnd(int on) {
+    if (dunst_set_paused(on) != 0) {
+        print_error("Cannot reach dunst through dunstctl");
+        return 1;
+    }
+    if (config_set_setting(NOTIFY_KEY_DND, on ? "true" : "false") != 0) {
+        print_error("Failed to save do-not-disturb state");
+        return 1;
+    }
+    print_success("Do not disturb %s", on ? "enabled" : "disabled");
+    return 0;
+}
+
+static int toggle(const char *setting, int on) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    if (settings[index].kind == KIND_NUMBER) {
+        print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
+        return CATEGORY_INVALID;
+    }
+    if (settings[index].kind == KIND_DND) return set_dnd(on);
+
+    int failed = dunst_set(settings[index].section, settings[index].key,
+                           on ? settings[index].on_value : settings[index].off_value) != 0;
+
+    // Duplicates show "(N)" so a folded burst still says how big it was;
+    // critical popups always get through a fullscreen pause
+    if (!failed && on && strcmp(setting, NOTIFY_SETTING_STACKING) == 0) {
+        failed = dunst_set("global", "hide_duplicate_count", "false") != 0;
+    }
+    if (!failed && strcmp(setting, NOTIFY_SETTING_FULLSCREEN_PAUSE) == 0) {
+        failed = dunst_set("fullscreen_show_critical", "msg_urgency", "critical") != 0 ||
+                 dunst_set("fullscreen_show_critical", "fullscreen", "show") != 0;
+    }
+    if (failed) {
+        print_error("Failed to update dunstrc");
+        return 1;
+    }
+
+    print_success("%s %s", setting, on ? "enabled" : "disabled");
+    reload();
+    return 0;
+}
+
+int notifications_enable(const char *setting) {
+    return toggle(setting, 1);
+}
+
+int notifications_disable(const char *setting) {
+    return toggle(setting, 0);
+}
+
+int notifications_set(const char *setting, const char *value) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    if (settings[index].kind != KIND_NUMBER) {
+        print_error("Setting '%s' does not support 'set', use enable/disable", setting);
+        return CATEGORY_INVALID;
+    }
+
+    char *end;
+    long number = strtol(value, &end, 10);
+    if (end == value || *end || number < settings[index].min || number > settings[index].max) {
+        print_error("Invalid value '%s' for %s (%d-%d)", value, setting,
+                    settings[index].min, settings[index].max);
+        return CATEGORY_INVALID;
+    }
+
+    char text[16];
+    snprintf(text, sizeof(text), "%ld", number);
+    if (dunst_set(settings[index].section, settings[index].key, text) != 0) {
+        print_error("Failed to update dunstrc");
+        return 1;
+    }
+
+    print_success("%s set to %s", setting, text);
+    reload();
+    return 0;
+}
+
+// Current value as shown by status; dnd asks the running dunst
+static void current_value(int index, char *buf, size_t size) {
+    if (settings[index].kind == KIND_DND) {
+        int paused = dunst_is_paused();
+        if (paused < 0) paused = config_get_setting_bool(NOTIFY_KEY_DND, 0);
+        snprintf(buf, size, "%s", paused ? "enabled" : "disabled");
+        return;
+    }
+
+    char *value = dunst_get(settings[index].section, settings[index].key);
+    if (settings[index].kind == KIND_TOGGLE) {
+        int on = value && (strcmp(value, settings[index].on_value) == 0 ||
+                           strcmp(value, "yes") == 0);
+        snprintf(buf, size, "%s", value ? (on ? "enabled" : "disabled") : "default");
+    } else {
+        snprintf(buf, size, "%s", value ? value : "default");
+    }
+    free(value);
+}
+
+int notifications_status(const char *setting) {
+    if (setting) {
+        int index = lookup(setting);
+        if (index < 0) return 2;
+
+        char value[64];
+        current_value(index, value, sizeof(value));
+        printf("%s\n", value);
+        return 0;
+    }
+
+    print_header(dunst_is_running() ? "Notifications (dunst, running)" : "Notifications (dunst)");
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        char value[64];
+        current_value(i, value, sizeof(value));
+        printf("  %-17s %s\n", settings[i].name, value);
+    }
+
+    char *path = dunst_config_path();
+    printf("  %-17s %s\n", "config", path ? path : "unknown");
+    free(path);
+    return 0;
+}
@@ -0,0 +1,25 @@
+// cli/src/categories/notifications.h
+#ifndef OPENDE_NOTIFICATIONS_H
+#define OPENDE_NOTIFICATIONS_H
+
+#define NOTIFY_SETTING_HISTORY          "history"
+#define NOTIFY_SETTING_TIMEOUT          "timeout"
+#define NOTIFY_SETTING_TIMEOUT_LOW      "timeout-low"
+#define NOTIFY_SETTING_TIMEOUT_CRITICAL "timeout-critical"
+#define NOTIFY_SETTING_LIMIT            "limit"
+#define NOTIFY_SETTING_STACKING         "stacking"
+#define NOTIFY_SETTING_FULLSCREEN_PAUSE "fullscreen-pause"
+#define NOTIFY_SETTING_DND              "dnd"
+
+// Do-not-disturb as last set by the user (opende.conf); focus mode
+// leaves dunst paused when this is on
+#define NOTIFY_KEY_DND "notifications.dnd"
+
+int notifications_enable(const char *setting);
+int notifications_disable(const char *setting);
+int notifications_set(const char *setting, const char *value);
+int notifications_status(const char *setting);
+
+void notifications_list_settings(void);
+
+#endif
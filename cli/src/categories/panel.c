@@ -1,6 +1,8 @@
 // cli/src/categories/panel.c
 #include "panel.h"
+#include "category.h"
 #include "../backends/tint2.h"
+#include "../backends/widgets.h"
 #include "../util/output.h"
 #include <stdio.h>
 #include <string.h>
@@ -21,9 +23,9 @@ static int is_valid_setting(const char *setting) {
 }
 
 void panel_list_settings(void) {
-    printf("Available panel settings:\n");
+    print_line("Available panel settings:");
     for (int i = 0; valid_settings[i]; i++) {
-        printf("  %s\n", valid_settings[i]);
+        print_line("  %s", valid_settings[i]);
     }
 }
 
@@ -52,7 +54,7 @@ int panel_enable(const char *setting) {
     }
 
     print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int panel_disable(const char *setting) {
@@ -80,7 +82,7 @@ int panel_disable(const char *setting) {
     }
 
     print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int panel_set(const char *setting, const char *value) {
@@ -91,6 +93,10 @@ int panel_set(const char *setting, const char *value) {
     }
 
     if (strcmp(setting, PANEL_SETTING_POSITION) == 0) {
+        if (strcmp(value, "top") != 0 && strcmp(value, "bottom") != 0) {
+            print_error("Position must be 'top' or 'bottom'");
+            return CATEGORY_INVALID;
+        }
         if (tint2_set_position(value) == 0) {
             print_success("Panel position set to '%s'", value);
             return 0;
@@ -99,7 +105,7 @@ int panel_set(const char *setting, const char *value) {
     }
 
     print_error("Setting '%s' does not support 'set', use enable/disable", setting);
-    return 1;
+    return CATEGORY_INVALID;
 }
 
 int panel_status(const char *setting) {
@@ -142,3 +148,45 @@ int panel_status(const char *setting) {
     free(position);
     return 0;
 }
+
+static void panel_list_widgets(void) {
+    printf("Available panel widgets:\n");
+    for (int i = 0; widgets[i]; i++) {
+        printf("  %-8s %s\n", widgets[i]->name, widgets[i]->description);
+    }
+}
+
+int panel_widget(int argc, char *argv[]) {
+    if (argc < 1 || strcmp(argv[0], "list") == 0) {
+        panel_list_widgets();
+        return argc < 1 ? 1 : 0;
+    }
+
+    const Widget *widget = widget_find(argv[0]);
+    if (!widget) {
+        print_error("Unknown widget '%s'", argv[0]);
+        panel_list_widgets();
+        return 2;
+    }
+
+    int continuous = 0, interval_ms = -1;
+    const char *arg = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--continuous") == 0) {
+            continuous = 1;
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval_ms = atoi(argv[++i]);
+            if (interval_ms < 100) {
+                print_error("Interval must be at least 100 ms");
+                return 1;
+            }
+        } else if (!arg) {
+            arg = argv[i];
+        } else {
+            print_error("Usage: opende panel widget <name> [--continuous] [--interval ms] [argument]");
+            return 1;
+        }
+    }
+
+    return widget_run(widget, arg, interval_ms, continuous) == 0 ? 0 : 1;
+}
@@ -11,6 +11,10 @@ int panel_disable(const char *setting);
 int panel_set(const char *setting, const char *value);
 int panel_status(const char *setting);
 
+// opende panel widget <name> [--continuous] [--interval ms] [argument]
+// opende panel widget list
+int panel_widget(int argc, char *argv[]);
+
 void panel_list_settings(void);
 
 #endif
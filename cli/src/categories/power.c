@@ -0,0 +1,440 @@
+// cli/src/categories/power.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "power.h"
+#include "category.h"
+#include "../backends/components.h"
+#include "../backends/power.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include "../util/proc.h"
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+#define POWER_STATE_FILE "power.state"
+#define POWER_MAX_STOPPED 64
+
+typedef enum {
+    FIELD_SCREENSAVER,
+    FIELD_DPMS,
+    FIELD_STANDBY,
+    FIELD_SUSPEND,
+    FIELD_OFF,
+    FIELD_IDLE_SUSPEND       // opende's own, not an X server setting
+} Field;
+
+static const struct {
+    const char *name;
+    Field field;
+    int toggle;              // enable/disable rather than set
+    const char *key;
+    const char *description;
+} settings[] = {
+    { POWER_SETTING_SCREENSAVER,  FIELD_SCREENSAVER,  0, "power.screensaver",
+      "seconds of idle before the screen saver (0 = never)" },
+    { POWER_SETTING_DPMS,         FIELD_DPMS,         1, "power.dpms",
+      "monitor power saving" },
+    { POWER_SETTING_STANDBY,      FIELD_STANDBY,      0, "power.dpms-standby",
+      "seconds of idle before monitor standby (0 = never)" },
+    { POWER_SETTING_SUSPEND,      FIELD_SUSPEND,      0, "power.dpms-suspend",
+      "seconds of idle before monitor suspend (0 = never)" },
+    { POWER_SETTING_OFF,          FIELD_OFF,          0, "power.dpms-off",
+      "seconds of idle before monitor off (0 = never)" },
+    { POWER_SETTING_IDLE_SUSPEND, FIELD_IDLE_SUSPEND, 1, POWER_KEY_IDLE_SUSPEND,
+      "stop the panel and its executors while the screen saver is on" },
+};
+
+#define SETTING_COUNT (int)(sizeof(settings) / sizeof(settings[0]))
+
+void power_list_settings(void) {
+    print_line("Available power settings:");
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        print_line("  %-13s %s", settings[i].name, settings[i].description);
+    }
+}
+
+static int lookup(const char *setting) {
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (strcmp(setting, settings[i].name) == 0) return i;
+    }
+    print_error("Unknown setting '%s'", setting);
+    power_list_settings();
+    return -1;
+}
+
+static int *field_of(PowerSettings *ps, Field field) {
+    switch (field) {
+        case FIELD_SCREENSAVER: return &ps->screensaver;
+        case FIELD_DPMS:        return &ps->dpms;
+        case FIELD_STANDBY:     return &ps->standby;
+        case FIELD_SUSPEND:     return &ps->suspend;
+        case FIELD_OFF:         return &ps->off;
+        default:                return NULL;
+    }
+}
+
+static void unchanged(PowerSettings *ps) {
+    ps->screensaver = ps->dpms = ps->standby = ps->suspend = ps->off = POWER_UNCHANGED;
+}
+
+// The server rejects non-zero DPMS timeouts that decrease
+static int timeouts_ordered(const PowerSettings *ps) {
+    int values[3] = { ps->standby, ps->suspend, ps->off };
+    int last = 0;
+    for (int i = 0; i < 3; i++) {
+        if (values[i] <= 0) continue;
+        if (values[i] < last) return 0;
+        last = values[i];
+    }
+    return 1;
+}
+
+// Saved values, POWER_UNCHANGED where nothing is configured
+static void saved_settings(PowerSettings *ps) {
+    unchanged(ps);
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        int *field = field_of(ps, settings[i].field);
+        if (field) *field = config_get_setting_int(settings[i].key, POWER_UNCHANGED);
+    }
+}
+
+// Save, and apply to the server when there is one
+static int apply_field(int index, int value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%d", value);
+
+    if (settings[index].field != FIELD_IDLE_SUSPEND) {
+        PowerSettings current;
+        int live = power_query(&current) == 0;
+        if (!live) saved_settings(&current);
+
+        *field_of(&current, settings[index].field) = value;
+        if (!timeouts_ordered(&current)) {
+            print_error("DPMS timeouts must not decrease (standby <= suspend <= off)");
+            return CATEGORY_INVALID;
+        }
+
+        if (live) {
+            PowerSettings change;
+            unchanged(&change);
+            *field_of(&change, settings[index].field) = value;
+            if (power_apply(&change) != 0) {
+                print_error("The X server rejected %s%s", settings[index].name,
+                            current.dpms == POWER_UNCHANGED && settings[index].field != FIELD_SCREENSAVER ?
+                            " (no DPMS support)" : "");
+                return 1;
+            }
+        } else {
+            print_info("No X display; saved for the next login");
+        }
+    }
+
+    if (config_set_setting(settings[index].key, text) != 0) {
+        print_error("Failed to save %s", settings[index].name);
+        return 1;
+    }
+    return 0;
+}
+
+static int toggle(const char *setting, int on) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    if (!settings[index].toggle) {
+        print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
+        return CATEGORY_INVALID;
+    }
+    int result = apply_field(index, on);
+    if (result != 0) return result;
+
+    print_success("%s %s", setting, on ? "enabled" : "disabled");
+    return 0;
+}
+
+int power_enable(const char *setting) {
+    return toggle(setting, 1);
+}
+
+int power_disable(const char *setting) {
+    return toggle(setting, 0);
+}
+
+int power_set(const char *setting, const char *value) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    if (settings[index].toggle) {
+        print_error("Setting '%s' does not support 'set', use enable/disable", setting);
+        return CATEGORY_INVALID;
+    }
+
+    char *end;
+    long seconds = strtol(value, &end, 10);
+    if (end == value || *end || seconds < 0 || seconds > POWER_MAX_TIMEOUT) {
+        print_error("Invalid value '%s' for %s (0-%d seconds)", value, setting, POWER_MAX_TIMEOUT);
+        return CATEGORY_INVALID;
+    }
+    int result = apply_field(index, (int)seconds);
+    if (result != 0) return result;
+
+    print_success("%s set to %ld seconds", setting, seconds);
+    return 0;
+}
+
+static void format_value(int index, const PowerSettings *live, int have_live, char *buf, size_t size) {
+    if (settings[index].field == FIELD_IDLE_SUSPEND) {
+        snprintf(buf, size, "%s", config_get_setting_bool(POWER_KEY_IDLE_SUSPEND, 1) ? "enabled" : "disabled");
+        return;
+    }
+
+    // The server's value when there is one; otherwise what will be applied
+    PowerSettings copy = *live;
+    int value = have_live ? *field_of(&copy, settings[index].field)
+                          : config_get_setting_int(settings[index].key, POWER_UNCHANGED);
+    if (value == POWER_UNCHANGED) snprintf(buf, size, have_live ? "unavailable" : "default");
+    else if (settings[index].toggle) snprintf(buf, size, "%s", value ? "enabled" : "disabled");
+    else if (value == 0) snprintf(buf, size, "never");
+    else snprintf(buf, size, "%ds", value);
+}
+
+void power_foreach_value(PowerValueFn fn, void *data) {
+    PowerSettings live;
+    unchanged(&live);
+    int have_live = power_query(&live) == 0;
+
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        char value[32];
+        format_value(i, &live, have_live, value, sizeof(value));
+        fn(settings[i].key, value, data);
+    }
+}
+
+static int stopped_count(void);
+
+int power_status(const char *setting) {
+    PowerSettings live;
+    unchanged(&live);
+    int have_live = power_query(&live) == 0;
+
+    if (setting) {
+        int index = lookup(setting);
+        if (index < 0) return 2;
+
+        char value[32];
+        format_value(index, &live, have_live, value, sizeof(value));
+        printf("%s\n", value);
+        return 0;
+    }
+
+    print_header(have_live ? "Power (X server)" : "Power (saved, no X display)");
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        char value[32];
+        format_value(i, &live, have_live, value, sizeof(value));
+        printf("  %-13s %s\n", settings[i].name, value);
+    }
+
+    int stopped = stopped_count();
+    if (stopped > 0) printf("  %-13s %d processes stopped while idle\n", "state", stopped);
+    return 0;
+}
+
+int power_restore(int argc, char *argv[]) {
+    (void)argv;
+    if (argc > 0) {
+        print_error("Usage: opende power restore");
+        return 1;
+    }
+
+    PowerSettings saved;
+    saved_settings(&saved);
+    int any = saved.screensaver != POWER_UNCHANGED || saved.dpms != POWER_UNCHANGED ||
+              saved.standby != POWER_UNCHANGED || saved.suspend != POWER_UNCHANGED ||
+              saved.off != POWER_UNCHANGED;
+    if (!any) return 0;   // Nothing configured: keep the server defaults
+
+    if (power_apply(&saved) != 0) {
+        print_error("Failed to apply saved power settings");
+        return 1;
+    }
+    print_success("Power settings restored");
+    return 0;
+}
+
+// --- Idle suspension -----------------------------------------------------
+
+// Processes stopped while idle, kept in the runtime dir so a watcher that
+// died mid-idle can be cleaned up by the next one
+
+static int write_stopped(const pid_t *pids, int count) {
+    char *path = config_get_runtime_path(POWER_STATE_FILE);
+    if (!path) return -1;
+
+    char content[POWER_MAX_STOPPED * 12 + 16];
+    int len = snprintf(content, sizeof(content), "stopped =");
+    for (int i = 0; i < count; i++) {
+        len += snprintf(content + len, sizeof(content) - (size_t)len, " %ld", (long)pids[i]);
+    }
+    snprintf(content + len, sizeof(content) - (size_t)len, "\n");
+
+    int result = config_write_file(path, content);
+    free(path);
+    return result;
+}
+
+static int read_stopped(pid_t *pids, int max) {
+    char *path = config_get_runtime_path(POWER_STATE_FILE);
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return 0;
+
+    int count = 0;
+    char *p = strstr(text, "stopped =");
+    if (p) {
+        p += 9;
+        char *end;
+        long pid;
+        while (count < max && (pid = strtol(p, &end, 10)) > 0 && end != p) {
+            pids[count++] = (pid_t)pid;
+            p = end;
+        }
+    }
+    free(text);
+    return count;
+}
+
+static int stopped_count(void) {
+    pid_t pids[POWER_MAX_STOPPED];
+    return read_stopped(pids, POWER_MAX_STOPPED);
+}
+
+// Stop one process unless it is already stopped (e.g. frozen by focus
+// mode, which then owns resuming it)
+static void stop(pid_t pid, pid_t *stopped, int *count) {
+    ProcStat st;
+    if (*count >= POWER_MAX_STOPPED || proc_read_stat(pid, &st) != 0 || st.state == 'T') return;
+    if (kill(pid, SIGSTOP) == 0) stopped[(*count)++] = pid;
+}
+
+static void idle_suspend(void) {
+    pid_t stopped[POWER_MAX_STOPPED];
+    int count = 0;
+
+    // Never the compositor: a screen locker starting on this same event
+    // is redirected to it and would stay unpainted, leaving the desktop
+    // on screen
+    pid_t panels[8];
+    int panel_count = components_find_pids(components_find("tint2"), panels, 8);
+    for (int i = 0; i < panel_count; i++) {
+        pid_t executors[POWER_MAX_STOPPED];
+        int executor_count = proc_find_descendants(panels[i], executors, POWER_MAX_STOPPED);
+        for (int j = 0; j < executor_count; j++) stop(executors[j], stopped, &count);
+        stop(panels[i], stopped, &count);
+    }
+
+    write_stopped(stopped, count);
+    print_info("Screen saver on, stopped %d processes", count);
+}
+
+static void idle_resume(void) {
+    pid_t stopped[POWER_MAX_STOPPED];
+    int count = read_stopped(stopped, POWER_MAX_STOPPED);
+
+    for (int i = count - 1; i >= 0; i--) {
+        // Only resume processes that are still stopped (guards against PID reuse)
+        ProcStat st;
+        if (proc_read_stat(stopped[i], &st) == 0 && st.state == 'T') kill(stopped[i], SIGCONT);
+    }
+
+    char *path = config_get_runtime_path(POWER_STATE_FILE);
+    if (path) unlink(path);
+    free(path);
+    if (count > 0) print_info("Activity, resumed %d processes", count);
+}
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+int power_watch(int argc, char *argv[]) {
+    (void)argv;
+    if (argc > 0) {
+        print_error("Usage: opende power watch");
+        return 1;
+    }
+
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) {
+        print_error("Cannot open X display");
+        return 1;
+    }
+
+    int event_base, error_base;
+    if (!XScreenSaverQueryExtension(dpy, &event_base, &error_base)) {
+        print_error("X server has no MIT-SCREEN-SAVER extension");
+        XCloseDisplay(dpy);
+        return 1;
+    }
+
+    // A previous watcher may have died with the session stopped
+    idle_resume();
+
+    Window root = DefaultRootWindow(dpy);
+    XScreenSaverSelectInput(dpy, root, ScreenSaverNotifyMask);
+
+    int timeout, interval, blanking, exposures;
+    XGetScreenSaver(dpy, &timeout, &interval, &blanking, &exposures);
+    if (timeout == 0) print_warn("Screen saver is off; idle suspension waits for it to be set");
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop;   // No SA_RESTART: poll() returns EINTR
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+
+    int suspended = 0;
+    XScreenSaverInfo *info = XScreenSaverAllocInfo();
+    if (info && XScreenSaverQueryInfo(dpy, root, info) && info->state == ScreenSaverOn &&
+        config_get_setting_bool(POWER_KEY_IDLE_SUSPEND, 1)) {
+        idle_suspend();
+        suspended = 1;
+    }
+    if (info) XFree(info);
+
+    // Block on the X connection; screen saver transitions are the only wakeups
+    struct pollfd pfd = { .fd = ConnectionNumber(dpy), .events = POLLIN };
+    while (!stop_requested) {
+        while (XPending(dpy)) {
+            XEvent ev;
+            XNextEvent(dpy, &ev);
+            if (ev.type != event_base + ScreenSaverNotify) continue;
+
+            const XScreenSaverNotifyEvent *notify = (const XScreenSaverNotifyEvent *)&ev;
+            if (notify->state == ScreenSaverOn && !suspended &&
+                config_get_setting_bool(POWER_KEY_IDLE_SUSPEND, 1)) {
+                idle_suspend();
+                suspended = 1;
+            } else if (notify->state == ScreenSaverOff && suspended) {
+                idle_resume();
+                suspended = 0;
+            }
+        }
+
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) break;
+        if (pfd.revents & (POLLERR | POLLHUP)) break;
+    }
+
+    if (suspended) idle_resume();
+    XCloseDisplay(dpy);
+    return 0;
+}
@@ -0,0 +1,35 @@
+// cli/src/categories/power.h
+#ifndef OPENDE_POWER_H
+#define OPENDE_POWER_H
+
+#define POWER_SETTING_SCREENSAVER  "screensaver"
+#define POWER_SETTING_DPMS         "dpms"
+#define POWER_SETTING_STANDBY      "dpms-standby"
+#define POWER_SETTING_SUSPEND      "dpms-suspend"
+#define POWER_SETTING_OFF          "dpms-off"
+#define POWER_SETTING_IDLE_SUSPEND "idle-suspend"
+
+// Settings in opende.conf; the X server values are re-applied from these
+// by 'opende power restore' at login
+#define POWER_KEY_IDLE_SUSPEND "power.idle-suspend"
+
+int power_enable(const char *setting);
+int power_disable(const char *setting);
+int power_set(const char *setting, const char *value);
+int power_status(const char *setting);
+
+void power_list_settings(void);
+
+// Current value of every setting as shown by 'opende power status', keyed
+// "power.<setting>", for the settings snapshot. One X query for all.
+typedef void (*PowerValueFn)(const char *key, const char *value, void *data);
+void power_foreach_value(PowerValueFn fn, void *data);
+
+// opende power restore: apply the saved timeouts to the X server
+int power_restore(int argc, char *argv[]);
+
+// opende power watch: follow the screen saver and, while it is on, stop
+// the panel with its executors
+int power_watch(int argc, char *argv[]);
+
+#endif
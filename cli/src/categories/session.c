@@ -0,0 +1,643 @@
+// cli/src/categories/session.c
+#define _POSIX_C_SOURCE 200809L
+#include "session.h"
+#include "../backends/autostart.h"
+#include "../backends/components.h"
+#include "../backends/lazy.h"
+#include "../backends/prewarm.h"
+#include "../backends/readahead.h"
+#include "../backends/supervisor.h"
+#include "../backends/units.h"
+#include "../util/config.h"
+#include "../util/liveness.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pwd.h>
+#include <unistd.h>
+
+#define SESSION_TIMES_FILE "session.times"
+#define MAX_COMPONENTS 32
+
+// Timestamps written by opende-common.sh ("start = <epoch>", "ready = <epoch>")
+typedef struct {
+    double start;
+    double ready;
+} SessionTimes;
+
+static double parse_epoch(const char *text, const char *key) {
+    const char *p = strstr(text, key);
+    if (!p) return 0;
+    p += strlen(key);
+    while (*p == ' ' || *p == '=') p++;
+
+    // bash's $EPOCHREALTIME uses the locale's decimal separator
+    char buf[32];
+    size_t n = strcspn(p, "\n");
+    if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+    memcpy(buf, p, n);
+    buf[n] = '\0';
+    char *comma = strchr(buf, ',');
+    if (comma) *comma = '.';
+
+    return strtod(buf, NULL);
+}
+
+static void read_session_times(SessionTimes *t) {
+    memset(t, 0, sizeof(*t));
+
+    char *path = config_get_runtime_path(SESSION_TIMES_FILE);
+    char *text = path ? config_read_file(path) : NULL;
+    free(path);
+    if (!text) return;
+
+    t->start = parse_epoch(text, "start");
+    t->ready = parse_epoch(text, "ready");
+    free(text);
+}
+
+static void print_stats(const ComponentStats *stats, int count, const SessionTimes *t) {
+    print_header("Session resources");
+
+    printf("  %-15s %5s %8s %10s %10s %10s %9s %8s\n",
+           "Component", "Up", "PID", "RSS", "PSS", "CPU", "Wakeups", "Restarts");
+
+    for (int i = 0; i < count; i++) {
+        const ComponentStats *s = &stats[i];
+        if (s->instances == 0) {
+            printf("  %-15s %5s %8s %10s %10s %10s %9s %8d\n",
+                   s->component->name, "no", "-", "-", "-", "-", "-", s->restarts);
+            continue;
+        }
+
+        char pss[16];
+        if (s->pss_kb >= 0) snprintf(pss, sizeof(pss), "%.1fM", s->pss_kb / 1024.0);
+        else snprintf(pss, sizeof(pss), "-");
+
+        printf("  %-15s %5s %8ld %9.1fM %10s %9.2fs %9lld %8d\n",
+               s->component->name, s->instances > 1 ? "yes+" : "yes", (long)s->pid,
+               s->rss_kb / 1024.0, pss, s->cpu_seconds, s->wakeups, s->restarts);
+    }
+
+    if (t->start > 0 && t->ready >= t->start) {
+        printf("\n  Login took %.2fs\n", t->ready - t->start);
+    }
+}
+
+static void metric_header(FILE *fp, const char *name, const char *type, const char *help) {
+    fprintf(fp, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// node_exporter textfile collector format
+static char *format_metrics(const ComponentStats *stats, int count, const SessionTimes *t) {
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buf, &size);
+    if (!fp) return NULL;
+
+    struct passwd *pw = getpwuid(getuid());
+    const char *user = pw ? pw->pw_name : "unknown";
+
+    static const struct {
+        const char *name, *type, *help;
+    } metrics[] = {
+        { "opende_component_up", "gauge", "Whether the session component is running." },
+        { "opende_component_instances", "gauge", "Running instances of the session component." },
+        { "opende_component_rss_bytes", "gauge", "Resident set size of the session component." },
+        { "opende_component_pss_bytes", "gauge", "Proportional set size of the session component." },
+        { "opende_component_cpu_seconds_total", "counter", "CPU time used by the session component." },
+        { "opende_component_wakeups_total", "counter", "Voluntary context switches of the session component." },
+        { "opende_component_restarts_total", "counter", "Times the session component was seen restarted." },
+    };
+
+    for (size_t m = 0; m < sizeof(metrics) / sizeof(metrics[0]); m++) {
+        metric_header(fp, metrics[m].name, metrics[m].type, metrics[m].help);
+        for (int i = 0; i < count; i++) {
+            const ComponentStats *s = &stats[i];
+            if (m == 3 && s->pss_kb < 0) continue;  // No smaps_rollup; omit rather than report 0
+            fprintf(fp, "%s{user=\"%s\",component=\"%s\"} ", metrics[m].name, user, s->component->name);
+            switch (m) {
+                case 0: fprintf(fp, "%d\n", s->instances > 0); break;
+                case 1: fprintf(fp, "%d\n", s->instances); break;
+                case 2: fprintf(fp, "%ld\n", s->rss_kb * 1024); break;
+                case 3: fprintf(fp, "%ld\n", s->pss_kb * 1024); break;
+                case 4: fprintf(fp, "%.2f\n", s->cpu_seconds); break;
+                case 5: fprintf(fp, "%lld\n", s->wakeups); break;
+                default: fprintf(fp, "%d\n", s->restarts); break;
+            }
+        }
+    }
+
+    if (t->start > 0) {
+        metric_header(fp, "opende_session_start_time_seconds", "gauge",
+                      "Unix time the OpenDE session started.");
+        fprintf(fp, "opende_session_start_time_seconds{user=\"%s\"} %.3f\n", user, t->start);
+    }
+    if (t->start > 0 && t->ready >= t->start) {
+        metric_header(fp, "opende_session_login_duration_seconds", "gauge",
+                      "Time from session start until the desktop was ready.");
+        fprintf(fp, "opende_session_login_duration_seconds{user=\"%s\"} %.3f\n",
+                user, t->ready - t->start);
+    }
+
+    fclose(fp);
+    return buf;
+}
+
+static int session_status(void) {
+    SupervisorEntry entries[MAX_COMPONENTS];
+    int count = supervisor_read_state(entries, MAX_COMPONENTS);
+    if (count < 0) {
+        print_info("Session supervisor is not running");
+        return 1;
+    }
+
+    print_header("Session supervisor");
+    print_setting("Lazy start", lazy_enabled() ? "on" : "off", lazy_enabled());
+    printf("\n");
+    printf("  %-15s %-14s %8s %8s\n", "Component", "State", "PID", "Restarts");
+    for (int i = 0; i < count; i++) {
+        const SupervisorEntry *e = &entries[i];
+        char pid[16];
+        if (e->pid > 0) snprintf(pid, sizeof(pid), "%ld", (long)e->pid);
+        else snprintf(pid, sizeof(pid), "-");
+        printf("  %-15s %-14s %8s %8d\n", e->name, supervisor_state_name(e->state),
+               pid, e->restarts);
+    }
+    return 0;
+}
+
+static int session_stats(int argc, char *argv[]) {
+    const char *textfile = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--textfile") == 0 && i + 1 < argc) {
+            textfile = argv[++i];
+        } else {
+            print_error("Usage: opende session stats [--textfile <path.prom>]");
+            return 1;
+        }
+    }
+
+    ComponentStats stats[MAX_COMPONENTS];
+    int count = components_collect_stats(stats, MAX_COMPONENTS);
+    SessionTimes times;
+    read_session_times(&times);
+
+    if (!textfile) {
+        print_stats(stats, count, &times);
+        return 0;
+    }
+
+    char *metrics = format_metrics(stats, count, &times);
+    if (!metrics) return 1;
+
+    // Written to a temp file and renamed, so the collector never sees a torn file
+    int result = config_write_file(textfile, metrics);
+    free(metrics);
+    if (result != 0) {
+        print_error("Cannot write %s", textfile);
+        return 1;
+    }
+    return 0;
+}
+
+// Liveness ids for `session watch`
+enum {
+    WATCH_PICOM,
+    WATCH_PICOM_PID,
+    WATCH_TINT2_TRAY,
+    WATCH_TINT2_PID
+};
+
+static void report(const char *name, int running) {
+    printf("%s %s\n", name, running ? "running" : "stopped");
+    fflush(stdout);
+}
+
+static int watch_component_pid(Liveness *lv, int id, const char *name) {
+    pid_t pid;
+    if (components_find_pids(components_find(name), &pid, 1) != 1) return 0;
+    return liveness_watch_pid(lv, id, pid) == 0;
+}
+
+// Print "<component> running|stopped" whenever picom or tint2 changes state.
+// Blocks on XFixes selection events and pidfds; no polling.
+static int session_watch(void) {
+    Liveness *lv = liveness_new();
+    if (!lv) return 1;
+
+    int picom = liveness_watch_selection(lv, WATCH_PICOM, "_NET_WM_CM_S");
+    if (picom < 0) {
+        // No display to ask: follow the process instead
+        picom = watch_component_pid(lv, WATCH_PICOM_PID, "picom");
+    }
+
+    liveness_watch_selection(lv, WATCH_TINT2_TRAY, "_NET_SYSTEM_TRAY_S");
+    int tint2 = watch_component_pid(lv, WATCH_TINT2_PID, "tint2");
+
+    report("picom", picom == LIVENESS_RUNNING);
+    report("tint2", tint2);
+
+    LivenessEvent events[8];
+    int count;
+    while ((count = liveness_wait(lv, events, 8, -1)) >= 0) {
+        for (int i = 0; i < count; i++) {
+            switch (events[i].id) {
+                case WATCH_PICOM:
+                    report("picom", events[i].state == LIVENESS_RUNNING);
+                    break;
+                case WATCH_PICOM_PID:
+                    report("picom", 0);
+                    break;
+                case WATCH_TINT2_TRAY:
+                    // A new tray owner is how a (re)started tint2 shows up
+                    if (events[i].state == LIVENESS_RUNNING && !tint2) {
+                        tint2 = watch_component_pid(lv, WATCH_TINT2_PID, "tint2");
+                        if (tint2) report("tint2", 1);
+                    }
+                    break;
+                case WATCH_TINT2_PID:
+                    tint2 = 0;
+                    report("tint2", 0);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    liveness_free(lv);
+    return 0;
+}
+
+static int session_install_units(void) {
+    int count = units_install();
+    if (count < 0) return 1;
+
+    char *dir = units_dir();
+    print_success("Wrote %d services, " UNITS_SLICE " and " UNITS_TARGET " to %s", count, dir);
+    free(dir);
+
+    if (system("systemctl --user daemon-reload > /dev/null 2>&1") != 0) {
+        print_warn("Could not reload the systemd user manager; run 'systemctl --user daemon-reload'");
+    }
+    print_info("The session starts " UNITS_TARGET " from next login");
+    return 0;
+}
+
+// ExecStart of generated units whose command has placeholders: expand
+// them now, at launch, and become the component
+static int session_exec(int argc, char *argv[]) {
+    const SessionComponent *c = argc == 1 ? components_find(argv[0]) : NULL;
+    char *args[16];
+    if (!c || components_build_argv(c, args, 16) < 1) {
+        print_error("Usage: opende session exec <component>");
+        return 2;
+    }
+
+    execvp(args[0], args);
+    print_error("Cannot run %s: %s", args[0], strerror(errno));
+    components_free_argv(args);
+    return 1;
+}
+
+static void print_limits(const char *name) {
+    UnitLimits limits;
+    if (units_get_limits(name, &limits) != 0) return;
+    printf("  %-15s %10s %10d %10d\n", name, limits.memory_max, limits.cpu_weight, limits.io_weight);
+}
+
+// opende session limit [<component|autostart> <memory-max|cpu-weight|io-weight> <value>]
+static int session_limit(int argc, char *argv[]) {
+    if (argc == 0) {
+        print_header("Unit resource limits");
+        printf("  %-15s %10s %10s %10s\n", "Component", "MemoryMax", "CPUWeight", "IOWeight");
+        for (int i = 0; session_components[i].name; i++) {
+            if (session_components[i].command) print_limits(session_components[i].name);
+        }
+        print_limits(UNITS_AUTOSTART);
+        return 0;
+    }
+
+    if (argc != 3) {
+        print_error("Usage: opende session limit <component|autostart> <memory-max|cpu-weight|io-weight> <value>");
+        return 1;
+    }
+
+    if (units_set_limit(argv[0], argv[1], argv[2]) != 0) {
+        print_error("Invalid limit '%s %s %s' (memory: 256M, 1G or infinity; weights: 1-10000)",
+                    argv[0], argv[1], argv[2]);
+        return 1;
+    }
+
+    print_success("%s %s set to %s", argv[0], argv[1], argv[2]);
+    print_info("Run 'opende session install-units' to apply");
+    return 0;
+}
+
+// opende session enable|disable lazy
+static int session_toggle(int argc, char *argv[], int enable) {
+    if (argc != 1 || strcmp(argv[0], "lazy") != 0) {
+        print_error("Usage: opende session %s lazy", enable ? "enable" : "disable");
+        return 1;
+    }
+
+    if (config_set_setting(LAZY_SETTING, enable ? "true" : "false") != 0 ||
+        lazy_sync_dbus(enable) != 0) {
+        print_error("Cannot update lazy start");
+        return 1;
+    }
+
+    if (enable) {
+        print_success("Lazy start enabled");
+        print_info("dunst starts on the first notification, blueman-applet when a Bluetooth "
+                   "adapter exists, pcmanfm on the first removable media, lxpolkit after login");
+    } else {
+        print_success("Lazy start disabled");
+    }
+    print_info("Takes effect from next login");
+    return 0;
+}
+
+static int session_autostart(int argc, char *argv[]) {
+    if (argc == 0) {
+        int launched = autostart_run();
+        return launched < 0 ? 1 : 0;
+    }
+
+    if (argc != 1 || strcmp(argv[0], "--list") != 0) {
+        print_error("Usage: opende session autostart [--list]");
+        return 1;
+    }
+
+    static AutostartItem items[128];
+    int count = autostart_collect(items, 128);
+
+    print_header("Autostart");
+    printf("  %-36s %-10s %s\n", "Entry", "Start", "Command");
+    for (int i = 0; i < count; i++) {
+        const AutostartItem *it = &items[i];
+        char start[32];
+        if (it->plan == AUTOSTART_DELAYED) snprintf(start, sizeof(start), "+%ds", it->entry.autostart_delay);
+        else snprintf(start, sizeof(start), "%s", autostart_plan_name(it->plan));
+
+        printf("  %-36s %-10s %s\n", it->entry.id, start,
+               it->reason ? it->reason : it->entry.exec);
+    }
+    return 0;
+}
+
+static int readahead_seconds(void) {
+    int seconds = config_get_setting_int("readahead.record_seconds", READAHEAD_DEFAULT_SECONDS);
+    return seconds > 0 ? seconds : READAHEAD_DEFAULT_SECONDS;
+}
+
+static int readahead_status(void) {
+    ReadaheadInfo info;
+    char value[64];
+
+    print_header("Login readahead");
+    if (readahead_info(&info) != 0) {
+        print_setting("List", "not recorded (recorded at next login)", 0);
+        return 0;
+    }
+
+    print_setting("List", info.fresh ? "current" : "stale (packages changed)", info.fresh);
+    snprintf(value, sizeof(value), "%d files, %.1f MB", info.files, info.bytes / 1048576.0);
+    print_setting("Prefetch", value, 1);
+    print_setting("Recorded with", info.fanotify ? "fanotify" : "process maps", 1);
+    snprintf(value, sizeof(value), "%d MB", config_get_setting_int("readahead.max_mb", READAHEAD_DEFAULT_MAX_MB));
+    print_setting("Budget", value, 1);
+    return 0;
+}
+
+// opende session readahead [auto|record|replay|status|clear]
+static int session_readahead(int argc, char *argv[]) {
+    const char *cmd = argc > 0 ? argv[0] : "status";
+    int quiet = argc > 1 && strcmp(argv[1], "--quiet") == 0;
+    long long bytes = 0;
+
+    // What the session runs: replay a current list, else record a new one
+    if (strcmp(cmd, "auto") == 0) {
+        if (readahead_replay(&bytes) >= 0) return 0;
+        return readahead_record(readahead_seconds()) < 0 ? 1 : 0;
+    }
+
+    if (strcmp(cmd, "record") == 0) {
+        int seconds = argc > 2 && strcmp(argv[1], "--seconds") == 0 ? atoi(argv[2]) : readahead_seconds();
+        if (seconds <= 0) {
+            print_error("Usage: opende session readahead record [--seconds N]");
+            return 1;
+        }
+        print_info("Recording files read during the next %d seconds", seconds);
+        int count = readahead_record(seconds);
+        if (count < 0) {
+            print_error("Failed to write readahead list");
+            return 1;
+        }
+        print_success("Recorded %d files", count);
+        return 0;
+    }
+
+    if (strcmp(cmd, "replay") == 0) {
+        int count = readahead_replay(&bytes);
+        if (count < 0) {
+            if (!quiet) print_error("No current readahead list (run 'opende session readahead record')");
+            return 1;
+        }
+        if (!quiet) print_success("Prefetched %d files (%.1f MB)", count, bytes / 1048576.0);
+        return 0;
+    }
+
+    if (strcmp(cmd, "status") == 0) {
+        return readahead_status();
+    }
+
+    if (strcmp(cmd, "clear") == 0) {
+        if (readahead_clear() != 0) {
+            print_error("Failed to delete readahead list");
+            return 1;
+        }
+        print_success("Readahead list cleared");
+        return 0;
+    }
+
+    print_error("Usage: opende session readahead [auto|record|replay|status|clear]");
+    return 1;
+}
+
+// opende session prewarm [--now|--list]
+static int session_prewarm(int argc, char *argv[]) {
+    if (argc == 0 || strcmp(argv[0], "--now") == 0) {
+        long long bytes = prewarm_run(argc > 0);
+        if (bytes < 0) return 1;
+        if (argc > 0) print_success("Prewarmed %.1f MB", bytes / 1048576.0);
+        return 0;
+    }
+
+    if (strcmp(argv[0], "--list") != 0) {
+        print_error("Usage: opende session prewarm [--now|--list]");
+        return 1;
+    }
+
+    PrewarmFile *files;
+    int count = prewarm_collect(&files);
+    long long budget = prewarm_budget(), used = 0, total = 0;
+
+    print_header("Prewarm");
+    printf("  %-28s %9s %9s  %s\n", "Application", "Size", "Uncached", "File");
+    for (int i = 0; i < count; i++) {
+        const PrewarmFile *f = &files[i];
+        int fits = f->uncached > 0 && used + f->uncached <= budget;
+        if (fits) used += f->uncached;
+        total += f->size;
+        printf("  %-28.28s %8.1fM %8.1fM %s %s\n", f->app, f->size / 1048576.0,
+               f->uncached / 1048576.0, fits ? " " : "-", f->path);
+    }
+    printf("\n  %d files, %.1f MB; %.1f MB to read of a %.0f MB budget\n", count,
+           total / 1048576.0, used / 1048576.0, budget / 1048576.0);
+    prewarm_free(files, count);
+    return 0;
+}
+
+// opende session set autostart-*|readahead-*|prewarm-* <value>
+static int session_set(int argc, char *argv[]) {
+    if (argc != 2) {
+        print_error("Usage: opende session set <autostart-low|autostart-nice|autostart-ioprio|"
+                    "readahead-max-mb|readahead-seconds|prewarm-count|prewarm-max-mb> <value>");
+        return 1;
+    }
+
+    const char *key = NULL;
+    if (strcmp(argv[0], "autostart-low") == 0) {
+        key = "autostart.low";
+    } else if (strcmp(argv[0], "autostart-nice") == 0) {
+        char *end;
+        long n = strtol(argv[1], &end, 10);
+        if (*end || n < 0 || n > 19) {
+            print_error("Nice level must be 0-19");
+            return 1;
+        }
+        key = "autostart.nice";
+    } else if (strcmp(argv[0], "autostart-ioprio") == 0) {
+        if (strcmp(argv[1], "idle") != 0 && strcmp(argv[1], "low") != 0 &&
+            strcmp(argv[1], "normal") != 0) {
+            print_error("IO priority must be idle, low or normal");
+            return 1;
+        }
+        key = "autostart.ioprio";
+    } else if (strcmp(argv[0], "readahead-max-mb") == 0 || strcmp(argv[0], "readahead-seconds") == 0) {
+        char *end;
+        long n = strtol(argv[1], &end, 10);
+        if (*end || n < 1 || n > 4096) {
+            print_error("Value must be 1-4096");
+            return 1;
+        }
+        key = argv[0][10] == 'm' ? "readahead.max_mb" : "readahead.record_seconds";
+    } else if (strcmp(argv[0], "prewarm-count") == 0 || strcmp(argv[0], "prewarm-max-mb") == 0) {
+        char *end;
+        long n = strtol(argv[1], &end, 10);
+        if (*end || n < 0 || n > 4096) {
+            print_error("Value must be 0-4096");
+            return 1;
+        }
+        key = argv[0][8] == 'c' ? "prewarm.count" : "prewarm.max_mb";
+    } else {
+        print_error("Unknown session setting '%s'", argv[0]);
+        return 2;
+    }
+
+    if (config_set_setting(key, argv[1]) != 0) return 1;
+    print_success("%s set to '%s'", argv[0], argv[1]);
+    return 0;
+}
+
+static void print_session_usage(void) {
+    printf("Usage: opende session run\n");
+    printf("       opende session status\n");
+    printf("       opende session stats [--textfile <path.prom>]\n");
+    printf("       opende session watch\n");
+    printf("       opende session enable|disable lazy\n");
+    printf("       opende session autostart [--list]\n");
+    printf("       opende session readahead [auto|record|replay|status|clear]\n");
+    printf("       opende session prewarm [--now|--list]\n");
+    printf("       opende session set <autostart-low|autostart-nice|autostart-ioprio|\n");
+    printf("                           readahead-max-mb|readahead-seconds|\n");
+    printf("                           prewarm-count|prewarm-max-mb> <value>\n");
+    printf("       opende session install-units\n");
+    printf("       opende session limit [<component> <memory-max|cpu-weight|io-weight> <value>]\n");
+    printf("       opende session exec <component>\n");
+    printf("\nCommands:\n");
+    printf("  run     Start the session components and restart them if they crash\n");
+    printf("  status  Show what the session supervisor is running\n");
+    printf("  stats   Memory, CPU, wakeups and restarts of every session component\n");
+    printf("  watch   Print compositor/panel state changes as they happen\n");
+    printf("  enable lazy    Start applets and daemons only when first needed\n");
+    printf("  autostart      Launch XDG autostart entries (low priority ones when idle)\n");
+    printf("  readahead      Prefetch the files the last login read, in disk order\n");
+    printf("  prewarm        When idle, cache the most launched applications' files\n");
+    printf("  install-units  Generate systemd user units with resource limits\n");
+    printf("  limit   Show or change the units' MemoryMax/CPUWeight/IOWeight\n");
+    printf("  exec    Run a component's command (used by the generated units)\n");
+}
+
+int session_command(int argc, char *argv[]) {
+    if (argc < 1) {
+        print_session_usage();
+        return 0;
+    }
+
+    if (strcmp(argv[0], "run") == 0) {
+        return supervisor_run();
+    }
+
+    if (strcmp(argv[0], "status") == 0) {
+        return session_status();
+    }
+
+    if (strcmp(argv[0], "stats") == 0) {
+        return session_stats(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "watch") == 0) {
+        return session_watch();
+    }
+
+    if (strcmp(argv[0], "enable") == 0 || strcmp(argv[0], "disable") == 0) {
+        return session_toggle(argc - 1, argv + 1, argv[0][0] == 'e');
+    }
+
+    if (strcmp(argv[0], "autostart") == 0) {
+        return session_autostart(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "prewarm") == 0) {
+        return session_prewarm(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "readahead") == 0) {
+        return session_readahead(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "set") == 0) {
+        return session_set(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "install-units") == 0) {
+        return session_install_units();
+    }
+
+    if (strcmp(argv[0], "limit") == 0) {
+        return session_limit(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[0], "exec") == 0) {
+        return session_exec(argc - 1, argv + 1);
+    }
+
+    print_error("Unknown session command '%s'", argv[0]);
+    print_session_usage();
+    return 2;
+}
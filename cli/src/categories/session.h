@@ -0,0 +1,8 @@
+// cli/src/categories/session.h
+#ifndef OPENDE_SESSION_H
+#define OPENDE_SESSION_H
+
+// opende session <command> ...
+int session_command(int argc, char *argv[]);
+
+#endif
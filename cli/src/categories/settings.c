@@ -0,0 +1,222 @@
+// cli/src/categories/settings.c
+#include "settings.h"
+#include "../../include/opende.h"
+#include "display.h"
+#include "governor.h"
+#include "input.h"
+#include "notifications.h"
+#include "power.h"
+#include "../backends/dunst.h"
+#include "../backends/picom.h"
+#include "../backends/tint2.h"
+#include "../backends/wallpaper.h"
+#include "../backends/wm.h"
+#include "../backends/xorg_conf.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include "../util/snapshot.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    SnapshotEntry entries[SNAPSHOT_MAX_ENTRIES];
+    int count;
+} Settings;
+
+static void add(Settings *s, const char *key, const char *fmt, ...) {
+    if (s->count >= SNAPSHOT_MAX_ENTRIES) return;
+    SnapshotEntry *e = &s->entries[s->count++];
+    snprintf(e->key, sizeof(e->key), "%s", key);
+
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(e->value, sizeof(e->value), fmt, ap);
+    va_end(ap);
+}
+
+static const char *state_name(int value, const char *unset) {
+    return value == 1 ? "enabled" : value == 0 ? "disabled" : unset;
+}
+
+static void collect_effects(Settings *s) {
+    add(s, "effects.shadows", "%s", state_name(picom_get_shadows(), "unknown"));
+    add(s, "effects.animations", "%s", state_name(picom_get_animations(), "unknown"));
+
+    int transparency = picom_get_transparency();
+    if (transparency >= 0) add(s, "effects.transparency", "%d", transparency);
+    else add(s, "effects.transparency", "unknown");
+
+    add(s, "effects.governor", "%s",
+        state_name(config_get_setting_bool(GOVERNOR_KEY_ENABLED, 0), "disabled"));
+    int level = governor_get_level();
+    add(s, "effects.governor-level", "%s", level >= 0 ? governor_level_name(level) : "off");
+}
+
+static void collect_panel(Settings *s) {
+    char *position = tint2_get_position();
+    add(s, "panel.position", "%s", position ? position : "unknown");
+    free(position);
+
+    add(s, "panel.autohide", "%s", state_name(tint2_get_autohide(), "unknown"));
+    add(s, "panel.systray", "%s", state_name(tint2_get_systray(), "unknown"));
+}
+
+static void collect_wallpaper(Settings *s) {
+    WallpaperConfig config;
+    int configured = wallpaper_get_config(&config) == 0;
+    add(s, "wallpaper.image", "%s", configured ? config.image : "none");
+    add(s, "wallpaper.mode", "%s", wallpaper_mode_name(config.mode));
+    add(s, "wallpaper.color", "#%06x", (unsigned int)config.color);
+}
+
+static void collect_wm(Settings *s) {
+    pid_t pid;
+    const WmBackend *wm = wm_running(&pid);
+    for (int i = 0; !wm && wm_backends[i]; i++) {
+        if (wm_is_installed(wm_backends[i])) wm = wm_backends[i];
+    }
+    add(s, "wm.name", "%s", wm ? wm->name : "none");
+    if (!wm) return;
+
+    static const struct {
+        const char *key;
+        WmSetting setting;
+    } keys[] = {
+        { "wm.animations", WM_SETTING_ANIMATIONS },
+        { "wm.focus",      WM_SETTING_FOCUS },
+        { "wm.workspaces", WM_SETTING_WORKSPACES },
+    };
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        char value[64];
+        int result = wm->get(keys[i].setting, value, sizeof(value));
+        add(s, keys[i].key, "%s", result == 0 ? value :
+            result == WM_UNSUPPORTED ? "unsupported" : "unknown");
+    }
+}
+
+static void collect_input(Settings *s) {
+    add(s, "input.natural-scrolling", "%s", state_name(xorg_get_natural_scroll(), "default"));
+    add(s, "input.tap-to-click", "%s", state_name(xorg_get_tap_click(), "default"));
+
+    char *accel = xorg_get_mouse_accel();
+    add(s, "input.mouse-accel", "%s", accel ? accel : "default");
+    free(accel);
+
+    static const struct {
+        const char *key;
+        const char *setting;
+    } keyboard[] = {
+        { INPUT_KEY_REPEAT_DELAY, INPUT_SETTING_REPEAT_DELAY },
+        { INPUT_KEY_REPEAT_RATE,  INPUT_SETTING_REPEAT_RATE },
+        { INPUT_KEY_KB_LAYOUT,    INPUT_SETTING_KB_LAYOUT },
+        { INPUT_KEY_KB_VARIANT,   INPUT_SETTING_KB_VARIANT },
+        { INPUT_KEY_KB_OPTIONS,   INPUT_SETTING_KB_OPTIONS },
+    };
+    for (size_t i = 0; i < sizeof(keyboard) / sizeof(keyboard[0]); i++) {
+        char value[256];
+        if (input_keyboard_get(keyboard[i].setting, value, sizeof(value)) == 0) {
+            add(s, keyboard[i].key, "%s", value);
+        }
+    }
+}
+
+static void add_power(const char *key, const char *value, void *data) {
+    add(data, key, "%s", value);
+}
+
+static void collect_power(Settings *s) {
+    power_foreach_value(add_power, s);
+}
+
+// The active layout needs an xrandr query per publish; `opende display
+// status layout` reports it
+static void collect_display(Settings *s) {
+    add(s, DISPLAY_KEY_HOTPLUG, "%s", state_name(config_get_setting_bool(DISPLAY_KEY_HOTPLUG, 1), "default"));
+    add(s, DISPLAY_KEY_MAX_REFRESH, "%s", state_name(config_get_setting_bool(DISPLAY_KEY_MAX_REFRESH, 1), "default"));
+    add(s, DISPLAY_KEY_AUTO_LAYOUT, "%s", state_name(config_get_setting_bool(DISPLAY_KEY_AUTO_LAYOUT, 0), "default"));
+}
+
+static void collect_notifications(Settings *s) {
+    add(s, "notifications.dnd", "%s", state_name(config_get_setting_bool(NOTIFY_KEY_DND, 0), ""));
+
+    static const struct {
+        const char *key;
+        const char *section;
+        const char *name;
+    } keys[] = {
+        { "notifications.history",          "global",           "history_length" },
+        { "notifications.timeout",          "urgency_normal",   "timeout" },
+        { "notifications.timeout-low",      "urgency_low",      "timeout" },
+        { "notifications.timeout-critical", "urgency_critical", "timeout" },
+        { "notifications.limit",            "global",           "notification_limit" },
+    };
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        char *value = dunst_get(keys[i].section, keys[i].name);
+        add(s, keys[i].key, "%s", value ? value : "default");
+        free(value);
+    }
+
+    char *stacking = dunst_get("global", "stack_duplicates");
+    add(s, "notifications.stacking", "%s", stacking ?
+        state_name(strcmp(stacking, "true") == 0 || strcmp(stacking, "yes") == 0, "") : "default");
+    free(stacking);
+
+    char *fullscreen = dunst_get("fullscreen_delay_everything", "fullscreen");
+    add(s, "notifications.fullscreen-pause", "%s", state_name(fullscreen && strcmp(fullscreen, "delay") == 0, ""));
+    free(fullscreen);
+}
+
+int settings_publish(void) {
+    Settings s;
+    s.count = 0;
+
+    collect_effects(&s);
+    collect_panel(&s);
+    collect_wallpaper(&s);
+    collect_wm(&s);
+    collect_input(&s);
+    collect_power(&s);
+    collect_display(&s);
+    collect_notifications(&s);
+    add(&s, "menu.frecency", "%s", state_name(config_get_setting_bool("menu.frecency", 1), ""));
+
+    return snapshot_publish(s.entries, s.count);
+}
+
+int settings_get_command(int argc, char *argv[]) {
+    // Answered through libopende, exactly as any other client would
+    int first = 0;
+    if (argc > 0 && strcmp(argv[0], "--refresh") == 0) {
+        // Pick up hand edits made behind opende's back
+        if (opende_refresh() != OPENDE_OK) {
+            print_error("%s", opende_last_error());
+            return 1;
+        }
+        first = 1;
+    }
+
+    if (first == argc) {
+        OpendeSetting settings[SNAPSHOT_MAX_ENTRIES];
+        int count = opende_status(settings, SNAPSHOT_MAX_ENTRIES, 0);
+        if (count < 0) {
+            print_error("%s", opende_last_error());
+            return 1;
+        }
+        for (int i = 0; i < count; i++) printf("%s=%s\n", settings[i].key, settings[i].value);
+        return 0;
+    }
+
+    int result = 0;
+    for (int i = first; i < argc; i++) {
+        char value[OPENDE_VALUE_MAX];
+        if (opende_get(argv[i], value, sizeof(value)) != OPENDE_OK) {
+            print_error("%s", opende_last_error());
+            result = 2;
+            continue;
+        }
+        printf("%s\n", value);
+    }
+    return result;
+}
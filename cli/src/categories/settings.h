@@ -0,0 +1,14 @@
+// cli/src/categories/settings.h
+#ifndef OPENDE_SETTINGS_H
+#define OPENDE_SETTINGS_H
+
+// Recompute the effective settings of every category and publish them to
+// the shared-memory snapshot (util/snapshot.h). Called after anything
+// changes a setting. Returns 0 on success, -1 on error
+int settings_publish(void);
+
+// opende get [--refresh] [key...]
+// Keys are "<category>.<setting>", e.g. effects.shadows, panel.position
+int settings_get_command(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,155 @@
+// cli/src/categories/wallpaper.c
+#define _DEFAULT_SOURCE
+#include "wallpaper.h"
+#include "category.h"
+#include "../backends/wallpaper.h"
+#include "../util/config.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+static const char *valid_settings[] = {
+    WALLPAPER_SETTING_IMAGE,
+    WALLPAPER_SETTING_MODE,
+    WALLPAPER_SETTING_COLOR,
+    NULL
+};
+
+static int is_valid_setting(const char *setting) {
+    for (int i = 0; valid_settings[i]; i++) {
+        if (strcmp(setting, valid_settings[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+void wallpaper_list_settings(void) {
+    print_line("Available wallpaper settings:");
+    print_line("  %s <path>                        JPEG or PNG file", WALLPAPER_SETTING_IMAGE);
+    print_line("  %s fill|fit|center|stretch|tile   Scaling mode", WALLPAPER_SETTING_MODE);
+    print_line("  %s #rrggbb                       Border for fit and center", WALLPAPER_SETTING_COLOR);
+}
+
+int wallpaper_enable(const char *setting) {
+    (void)setting;
+    print_error("Wallpaper settings do not support enable/disable, use 'set'");
+    wallpaper_list_settings();
+    return CATEGORY_INVALID;
+}
+
+int wallpaper_disable(const char *setting) {
+    return wallpaper_enable(setting);
+}
+
+// Apply the configured wallpaper, rendering the cached copy if needed
+static int apply(int quiet) {
+    WallpaperConfig config;
+    if (wallpaper_get_config(&config) != 0) {
+        if (!quiet) print_error("No wallpaper configured (opende wallpaper set image <path>)");
+        return 1;
+    }
+
+    int cache_hit;
+    if (wallpaper_apply(&config, &cache_hit) != 0) {
+        if (!quiet) print_error("Cannot set wallpaper from %s", config.image);
+        return 1;
+    }
+
+    if (!quiet) {
+        print_success("Wallpaper set (%s, %s)", wallpaper_mode_name(config.mode),
+                      cache_hit ? "cached" : "rendered and cached");
+    }
+    return 0;
+}
+
+int wallpaper_set(const char *setting, const char *value) {
+    if (!is_valid_setting(setting)) {
+        print_error("Unknown setting '%s'", setting);
+        wallpaper_list_settings();
+        return 2;
+    }
+
+    if (strcmp(setting, WALLPAPER_SETTING_IMAGE) == 0) {
+        char *path = realpath(value, NULL);
+        if (!path) {
+            print_error("Cannot find '%s'", value);
+            return CATEGORY_INVALID;
+        }
+        int result = config_set_setting("wallpaper.image", path);
+        free(path);
+        if (result != 0) return 1;
+    } else if (strcmp(setting, WALLPAPER_SETTING_MODE) == 0) {
+        if (wallpaper_mode_parse(value) < 0) {
+            print_error("Invalid mode '%s' (fill, fit, center, stretch, tile)", value);
+            return CATEGORY_INVALID;
+        }
+        if (config_set_setting("wallpaper.mode", value) != 0) return 1;
+    } else {
+        if (value[0] != '#' || strlen(value) != 7 || strspn(value + 1, "0123456789abcdefABCDEF") != 6) {
+            print_error("Invalid color '%s' (use #rrggbb)", value);
+            return CATEGORY_INVALID;
+        }
+        if (config_set_setting("wallpaper.color", value) != 0) return 1;
+    }
+
+    // Show it now, which also prepares the cached copy for next login
+    if (getenv("DISPLAY")) return apply(0);
+
+    print_success("Wallpaper %s set to '%s'", setting, value);
+    return 0;
+}
+
+int wallpaper_status(const char *setting) {
+    WallpaperConfig config;
+    int configured = wallpaper_get_config(&config) == 0;
+
+    if (setting) {
+        if (!is_valid_setting(setting)) {
+            print_error("Unknown setting '%s'", setting);
+            wallpaper_list_settings();
+            return 2;
+        }
+        if (strcmp(setting, WALLPAPER_SETTING_IMAGE) == 0) {
+            printf("%s\n", configured ? config.image : "none");
+        } else if (strcmp(setting, WALLPAPER_SETTING_MODE) == 0) {
+            printf("%s\n", wallpaper_mode_name(config.mode));
+        } else {
+            printf("#%06x\n", (unsigned int)config.color);
+        }
+        return 0;
+    }
+
+    print_header("Wallpaper");
+
+    char *own = config_get_setting("wallpaper.image");
+    printf("  Image: %s%s\n", configured ? config.image : "none",
+           configured && !own ? " (from nitrogen)" : "");
+    printf("  Mode:  %s\n", wallpaper_mode_name(config.mode));
+    printf("  Color: #%06x\n", (unsigned int)config.color);
+    free(own);
+
+    char *dir = wallpaper_cache_dir();
+    printf("  Cache: %s\n", dir ? dir : "unavailable");
+    free(dir);
+    return 0;
+}
+
+int wallpaper_restore(int argc, char *argv[]) {
+    int quiet = argc > 0 && strcmp(argv[0], "--quiet") == 0;
+    return apply(quiet);
+}
+
+int wallpaper_cache(int argc, char *argv[]) {
+    if (argc != 1 || strcmp(argv[0], "clear") != 0) {
+        print_error("Usage: opende wallpaper cache clear");
+        return 1;
+    }
+
+    int removed = wallpaper_clear_cache();
+    if (removed < 0) {
+        print_error("Cannot clear the wallpaper cache");
+        return 1;
+    }
+    print_success("Removed %d cached wallpaper%s", removed, removed == 1 ? "" : "s");
+    return 0;
+}
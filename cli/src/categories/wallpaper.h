@@ -0,0 +1,22 @@
+// cli/src/categories/wallpaper.h
+#ifndef OPENDE_WALLPAPER_H
+#define OPENDE_WALLPAPER_H
+
+#define WALLPAPER_SETTING_IMAGE "image"
+#define WALLPAPER_SETTING_MODE  "mode"
+#define WALLPAPER_SETTING_COLOR "color"
+
+int wallpaper_enable(const char *setting);
+int wallpaper_disable(const char *setting);
+int wallpaper_set(const char *setting, const char *value);
+int wallpaper_status(const char *setting);
+
+// opende wallpaper restore: set the saved wallpaper (used at login)
+int wallpaper_restore(int argc, char *argv[]);
+
+// opende wallpaper cache clear
+int wallpaper_cache(int argc, char *argv[]);
+
+void wallpaper_list_settings(void);
+
+#endif
@@ -0,0 +1,210 @@
+// cli/src/categories/wm.c
+#include "wm.h"
+#include "category.h"
+#include "../backends/wm.h"
+#include "../util/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct {
+    const char *name;
+    WmSetting setting;
+    const char *values;      // For 'set', NULL if enable/disable only
+} settings[] = {
+    { WM_SETTING_NAME_ANIMATIONS, WM_SETTING_ANIMATIONS, NULL },
+    { WM_SETTING_NAME_FOCUS,      WM_SETTING_FOCUS,      "click|mouse" },
+    { WM_SETTING_NAME_WORKSPACES, WM_SETTING_WORKSPACES, "1-32" },
+};
+
+#define SETTING_COUNT (int)(sizeof(settings) / sizeof(settings[0]))
+
+static int find_setting(const char *name) {
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (strcmp(name, settings[i].name) == 0) return i;
+    }
+    return -1;
+}
+
+void wm_list_settings(void) {
+    print_line("Available wm settings:");
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (settings[i].values) print_line("  %-12s %s", settings[i].name, settings[i].values);
+        else print_line("  %s", settings[i].name);
+    }
+}
+
+// Running WM, or every installed one; returns count
+static int targets(const WmBackend **out, pid_t *pids, int max) {
+    pid_t pid;
+    const WmBackend *running = wm_running(&pid);
+    if (running) {
+        out[0] = running;
+        pids[0] = pid;
+        return 1;
+    }
+
+    int count = 0;
+    for (int i = 0; wm_backends[i] && count < max; i++) {
+        if (!wm_is_installed(wm_backends[i])) continue;
+        out[count] = wm_backends[i];
+        pids[count] = 0;
+        count++;
+    }
+    return count;
+}
+
+static int apply_setting(int index, const char *value) {
+    const WmBackend *wms[8];
+    pid_t pids[8];
+    int count = targets(wms, pids, 8);
+    if (count == 0) {
+        print_error("No supported window manager found (openbox, fluxbox, icewm, i3)");
+        return 1;
+    }
+
+    int failed = 0, changed = 0;
+    for (int i = 0; i < count; i++) {
+        int result = wms[i]->set(settings[index].setting, value);
+        if (result == WM_UNSUPPORTED) {
+            // Only worth mentioning for the WM the user is looking at
+            if (pids[i] > 0) {
+                print_warn("%s has no '%s' setting", wms[i]->name, settings[index].name);
+            }
+            continue;
+        }
+        if (result != 0) {
+            print_error("Failed to update %s config", wms[i]->name);
+            failed = 1;
+            continue;
+        }
+        changed++;
+
+        if (pids[i] <= 0) {
+            print_success("%s: %s set to %s", wms[i]->name, settings[index].name, value);
+            continue;
+        }
+
+        int applied = wms[i]->apply(pids[i], settings[index].setting, value);
+        if (applied == WM_APPLIED_LIVE) {
+            print_success("%s: %s set to %s", wms[i]->name, settings[index].name, value);
+        } else if (applied == WM_APPLIED_LATER) {
+            print_success("%s: %s set to %s", wms[i]->name, settings[index].name, value);
+            print_info("The running %s uses another config file; takes effect at next login",
+                       wms[i]->name);
+        } else {
+            print_warn("%s: %s saved but the running WM did not reload", wms[i]->name,
+                       settings[index].name);
+        }
+    }
+
+    if (failed) return 1;
+    return changed > 0 ? 0 : 1;
+}
+
+static int lookup(const char *setting) {
+    int index = find_setting(setting);
+    if (index < 0) {
+        print_error("Unknown setting '%s'", setting);
+        wm_list_settings();
+    }
+    return index;
+}
+
+int wm_enable(const char *setting) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    if (settings[index].values) {
+        print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
+        return CATEGORY_INVALID;
+    }
+    return apply_setting(index, "on");
+}
+
+int wm_disable(const char *setting) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    if (settings[index].values) {
+        print_error("Setting '%s' does not support enable/disable, use 'set'", setting);
+        return CATEGORY_INVALID;
+    }
+    return apply_setting(index, "off");
+}
+
+int wm_set(const char *setting, const char *value) {
+    int index = lookup(setting);
+    if (index < 0) return 2;
+
+    switch (settings[index].setting) {
+        case WM_SETTING_ANIMATIONS:
+            print_error("Setting '%s' does not support 'set', use enable/disable", setting);
+            return CATEGORY_INVALID;
+        case WM_SETTING_FOCUS:
+            if (strcmp(value, "click") != 0 && strcmp(value, "mouse") != 0) {
+                print_error("Invalid focus mode '%s' (use click or mouse)", value);
+                return CATEGORY_INVALID;
+            }
+            break;
+        case WM_SETTING_WORKSPACES: {
+            char *end;
+            long count = strtol(value, &end, 10);
+            if (*end || count < 1 || count > WM_MAX_WORKSPACES) {
+                print_error("Invalid workspace count '%s' (1-%d)", value, WM_MAX_WORKSPACES);
+                return CATEGORY_INVALID;
+            }
+            break;
+        }
+    }
+    return apply_setting(index, value);
+}
+
+static void show_wm(const WmBackend *wm, pid_t pid) {
+    char title[64];
+    snprintf(title, sizeof(title), "Window Manager (%s%s)", wm->name, pid > 0 ? ", running" : "");
+    print_header(title);
+
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        char value[64];
+        int result = wm->get(settings[i].setting, value, sizeof(value));
+        if (result == WM_UNSUPPORTED) snprintf(value, sizeof(value), "not supported");
+        else if (result != 0) snprintf(value, sizeof(value), "unknown");
+
+        printf("  %-11s %s\n", settings[i].name, value);
+    }
+}
+
+int wm_status(const char *setting) {
+    const WmBackend *wms[8];
+    pid_t pids[8];
+    int count = targets(wms, pids, 8);
+
+    if (setting) {
+        int index = lookup(setting);
+        if (index < 0) return 2;
+        if (count == 0) {
+            printf("unknown\n");
+            return 0;
+        }
+
+        for (int i = 0; i < count; i++) {
+            char value[64];
+            int result = wms[i]->get(settings[index].setting, value, sizeof(value));
+            if (result == WM_UNSUPPORTED) snprintf(value, sizeof(value), "not supported");
+            else if (result != 0) snprintf(value, sizeof(value), "unknown");
+
+            if (count == 1) printf("%s\n", value);
+            else printf("%s: %s\n", wms[i]->name, value);
+        }
+        return 0;
+    }
+
+    if (count == 0) {
+        print_header("Window Manager");
+        printf("  No supported window manager found\n");
+        return 0;
+    }
+    for (int i = 0; i < count; i++) show_wm(wms[i], pids[i]);
+    return 0;
+}
@@ -0,0 +1,18 @@
+// cli/src/categories/wm.h
+#ifndef OPENDE_WM_H
+#define OPENDE_WM_H
+
+#define WM_SETTING_NAME_ANIMATIONS "animations"
+#define WM_SETTING_NAME_FOCUS      "focus"
+#define WM_SETTING_NAME_WORKSPACES "workspaces"
+
+// Settings apply to the running window manager, or to every installed
+// one when none is running (e.g. from a console before login)
+int wm_enable(const char *setting);
+int wm_disable(const char *setting);
+int wm_set(const char *setting, const char *value);
+int wm_status(const char *setting);
+
+void wm_list_settings(void);
+
+#endif
@@ -3,10 +3,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include "util/output.h"
+#include "categories/category.h"
 #include "categories/input.h"
 #include "categories/effects.h"
 #include "categories/panel.h"
+#include "categories/wallpaper.h"
+#include "categories/wm.h"
+#include "categories/notifications.h"
+#include "categories/power.h"
+#include "categories/display.h"
+#include "categories/focus.h"
+#include "categories/session.h"
+#include "categories/appmenu.h"
+#include "categories/icons.h"
+#include "categories/settings.h"
 #include "ui/menu.h"
+#include "api/api.h"
+#include "../include/opende.h"
 
 #define VERSION "0.1.0"
 
@@ -20,7 +33,12 @@ typedef enum {
     CAT_NONE,
     CAT_INPUT,
     CAT_EFFECTS,
-    CAT_PANEL
+    CAT_PANEL,
+    CAT_WALLPAPER,
+    CAT_WM,
+    CAT_NOTIFICATIONS,
+    CAT_POWER,
+    CAT_DISPLAY
 } Category;
 
 typedef enum {
@@ -35,20 +53,45 @@ static void print_usage(void) {
     printf("Usage: opende <category> <action> [setting] [value]\n");
     printf("       opende config           Interactive mode\n");
     printf("       opende status           Show all settings\n");
+    printf("       opende get [key...]     Read settings from the shared snapshot\n");
+    printf("       opende focus [on|off]   Focus mode for fullscreen apps\n");
+    printf("       opende session <cmd>    Session tools (stats)\n");
+    printf("       opende menu <cmd>       Application menu index for jgmenu\n");
+    printf("       opende icons <cmd>      Icon theme lookup cache\n");
     printf("       opende --version        Show version\n");
     printf("\nCategories:\n");
-    printf("  input    Input device settings (scrolling, tap-to-click)\n");
+    printf("  input    Input devices (scrolling, tap-to-click, keyboard)\n");
     printf("  effects  Compositor settings (shadows, transparency)\n");
     printf("  panel    Panel/UI settings (position, autohide)\n");
+    printf("  wallpaper  Desktop background (image, mode, color)\n");
+    printf("  wm       Window manager (animations, focus, workspaces)\n");
+    printf("  notifications  Notification popups (timeouts, stacking, dnd)\n");
+    printf("  power    Screen saver, DPMS and idle suspension\n");
+    printf("  display  Monitor layouts and hotplug\n");
     printf("\nActions:\n");
     printf("  enable <setting>       Turn a setting on\n");
     printf("  disable <setting>      Turn a setting off\n");
     printf("  set <setting> <value>  Set a specific value\n");
     printf("  status [setting]       Show current state\n");
+    printf("\nCategory commands:\n");
+    printf("  display save|apply|list|watch  Monitor layouts keyed by EDID\n");
+    printf("  effects rule add|remove|list   Per-window compositor rules\n");
+    printf("  effects benchmark [profile...] Frame-pacing benchmark under Xvfb\n");
+    printf("  effects governor [--force]     Step effects down under compositor load\n");
+    printf("  input restore                  Apply saved keyboard repeat and layout\n");
+    printf("  input devices                  Effective xorg.conf.d options per device\n");
+    printf("  panel widget <name> [--continuous]  Data provider for tint2 executors\n");
+    printf("  power restore|watch            Apply saved timeouts; stop the panel while idle\n");
+    printf("  wallpaper restore [--quiet]    Set the saved wallpaper from the cache\n");
+    printf("  wallpaper cache clear          Drop pre-scaled wallpaper copies\n");
     printf("\nExamples:\n");
     printf("  opende input enable natural-scrolling\n");
     printf("  opende effects disable shadows\n");
+    printf("  opende effects rule add no-shadow class mpv\n");
     printf("  opende panel set position bottom\n");
+    printf("  opende wallpaper set image ~/Pictures/lake.jpg\n");
+    printf("  opende wm set focus mouse\n");
+    printf("  opende notifications enable dnd\n");
     printf("  opende status\n");
 }
 
@@ -56,6 +99,11 @@ static Category parse_category(const char *str) {
     if (strcmp(str, "input") == 0) return CAT_INPUT;
     if (strcmp(str, "effects") == 0) return CAT_EFFECTS;
     if (strcmp(str, "panel") == 0) return CAT_PANEL;
+    if (strcmp(str, "wallpaper") == 0) return CAT_WALLPAPER;
+    if (strcmp(str, "wm") == 0) return CAT_WM;
+    if (strcmp(str, "notifications") == 0) return CAT_NOTIFICATIONS;
+    if (strcmp(str, "power") == 0) return CAT_POWER;
+    if (strcmp(str, "display") == 0) return CAT_DISPLAY;
     return CAT_NONE;
 }
 
@@ -71,6 +119,14 @@ static int handle_status_all(void) {
     input_status(NULL);
     effects_status(NULL);
     panel_status(NULL);
+    wallpaper_status(NULL);
+    wm_status(NULL);
+    notifications_status(NULL);
+    power_status(NULL);
+    display_status(NULL);
+
+    // Everything was just read from the source files anyway
+    opende_refresh();
     return EXIT_SUCCESS_CODE;
 }
 
@@ -78,41 +134,34 @@ static int handle_config_interactive(void) {
     return menu_run();
 }
 
-static int handle_category(Category cat, Action act, const char *setting, const char *value) {
-    if (cat == CAT_INPUT) {
-        switch (act) {
-            case ACT_ENABLE:  return input_enable(setting);
-            case ACT_DISABLE: return input_disable(setting);
-            case ACT_SET:     return input_set(setting, value);
-            case ACT_STATUS:  return input_status(setting);
-            default:          return EXIT_ERROR;
-        }
-    }
-
-    if (cat == CAT_EFFECTS) {
-        switch (act) {
-            case ACT_ENABLE:  return effects_enable(setting);
-            case ACT_DISABLE: return effects_disable(setting);
-            case ACT_SET:     return effects_set(setting, value);
-            case ACT_STATUS:  return effects_status(setting);
-            default:          return EXIT_ERROR;
-        }
-    }
-
-    if (cat == CAT_PANEL) {
-        switch (act) {
-            case ACT_ENABLE:  return panel_enable(setting);
-            case ACT_DISABLE: return panel_disable(setting);
-            case ACT_SET:     return panel_set(setting, value);
-            case ACT_STATUS:  return panel_status(setting);
-            default:          return EXIT_ERROR;
-        }
+static int handle_status(Category cat, const char *setting) {
+    switch (cat) {
+        case CAT_INPUT:         return input_status(setting);
+        case CAT_EFFECTS:       return effects_status(setting);
+        case CAT_PANEL:         return panel_status(setting);
+        case CAT_WALLPAPER:     return wallpaper_status(setting);
+        case CAT_WM:            return wm_status(setting);
+        case CAT_NOTIFICATIONS: return notifications_status(setting);
+        case CAT_POWER:         return power_status(setting);
+        case CAT_DISPLAY:       return display_status(setting);
+        default:                break;
     }
 
     print_error("Category not yet implemented");
     return EXIT_ERROR;
 }
 
+// enable/disable/set go through libopende like any other client's changes
+static int handle_change(const char *category, Action act, const char *setting, const char *value) {
+    char key[OPENDE_KEY_MAX];
+    snprintf(key, sizeof(key), "%s.%s", category, setting);
+
+    ApiAction action = act == ACT_ENABLE ? API_ENABLE : act == ACT_DISABLE ? API_DISABLE : API_SET;
+    int result = api_change(key, action, value);
+    if (result == OPENDE_OK) return EXIT_SUCCESS_CODE;
+    return result == OPENDE_ERR_UNKNOWN ? EXIT_NOT_FOUND : EXIT_ERROR;
+}
+
 int main(int argc, char *argv[]) {
     output_init();
 
@@ -121,6 +170,11 @@ int main(int argc, char *argv[]) {
         return EXIT_SUCCESS_CODE;
     }
 
+    // Polled by panel executors: answer from the snapshot before anything else
+    if (strcmp(argv[1], "get") == 0) {
+        return settings_get_command(argc - 2, argv + 2);
+    }
+
     // Handle special commands
     if (strcmp(argv[1], "--version") == 0 || strcmp(argv[1], "-v") == 0) {
         printf("opende %s\n", VERSION);
@@ -140,17 +194,82 @@ int main(int argc, char *argv[]) {
         return handle_config_interactive();
     }
 
+    if (strcmp(argv[1], "focus") == 0) {
+        return focus_command(argc - 2, argv + 2);
+    }
+
+    if (strcmp(argv[1], "session") == 0) {
+        return session_command(argc - 2, argv + 2);
+    }
+
+    if (strcmp(argv[1], "menu") == 0) {
+        Action act = argc > 2 ? parse_action(argv[2]) : ACT_NONE;
+        if (act == ACT_ENABLE || act == ACT_DISABLE) {
+            if (argc < 4) {
+                print_error("Usage: opende menu %s frecency", argv[2]);
+                return EXIT_ERROR;
+            }
+            return handle_change("menu", act, argv[3], NULL);
+        }
+        return appmenu_command(argc - 2, argv + 2);
+    }
+
+    if (strcmp(argv[1], "icons") == 0) {
+        return icons_command(argc - 2, argv + 2);
+    }
+
     // Parse category
     Category cat = parse_category(argv[1]);
     if (cat == CAT_NONE) {
         print_error("Unknown category '%s'", argv[1]);
-        printf("Available categories: input, effects, panel\n");
+        printf("Available categories: input, effects, panel, wallpaper, wm, notifications, power, display\n");
         return EXIT_NOT_FOUND;
     }
 
     // If only category given, show status for that category
     if (argc == 2) {
-        return handle_category(cat, ACT_STATUS, NULL, NULL);
+        return handle_status(cat, NULL);
+    }
+
+    // Category-specific commands with their own argument handling
+    if (cat == CAT_EFFECTS && strcmp(argv[2], "rule") == 0) {
+        int result = effects_rule(argc - 3, argv + 3);
+        return result == CATEGORY_INVALID ? EXIT_ERROR : result;
+    }
+    if (cat == CAT_EFFECTS && strcmp(argv[2], "benchmark") == 0) {
+        return effects_benchmark(argc - 3, argv + 3);
+    }
+    if (cat == CAT_EFFECTS && strcmp(argv[2], "governor") == 0) {
+        return effects_governor(argc - 3, argv + 3);
+    }
+
+    if (cat == CAT_INPUT && strcmp(argv[2], "restore") == 0) {
+        return input_restore(argc - 3, argv + 3);
+    }
+    if (cat == CAT_INPUT && strcmp(argv[2], "devices") == 0) {
+        return input_devices(argc - 3, argv + 3);
+    }
+
+    if (cat == CAT_PANEL && strcmp(argv[2], "widget") == 0) {
+        return panel_widget(argc - 3, argv + 3);
+    }
+
+    if (cat == CAT_POWER && strcmp(argv[2], "restore") == 0) {
+        return power_restore(argc - 3, argv + 3);
+    }
+    if (cat == CAT_POWER && strcmp(argv[2], "watch") == 0) {
+        return power_watch(argc - 3, argv + 3);
+    }
+
+    if (cat == CAT_DISPLAY && parse_action(argv[2]) == ACT_NONE) {
+        return display_command(argc - 2, argv + 2);
+    }
+
+    if (cat == CAT_WALLPAPER && strcmp(argv[2], "restore") == 0) {
+        return wallpaper_restore(argc - 3, argv + 3);
+    }
+    if (cat == CAT_WALLPAPER && strcmp(argv[2], "cache") == 0) {
+        return wallpaper_cache(argc - 3, argv + 3);
     }
 
     // Parse action
@@ -176,5 +295,6 @@ int main(int argc, char *argv[]) {
         return EXIT_ERROR;
     }
 
-    return handle_category(cat, act, setting, value);
+    if (act == ACT_STATUS) return handle_status(cat, setting);
+    return handle_change(argv[1], act, setting, value);
 }
@@ -1,8 +1,6 @@
 // cli/src/ui/menu.c
 #include "menu.h"
-#include "../categories/input.h"
-#include "../categories/effects.h"
-#include "../categories/panel.h"
+#include "../api/api.h"
 #include "../backends/picom.h"
 #include "../backends/tint2.h"
 #include "../backends/xorg_conf.h"
@@ -60,19 +58,17 @@ static void show_input_menu(void) {
         switch (choice) {
             case 0: return;
             case 1:
-                if (natural == 1) input_disable("natural-scrolling");
-                else input_enable("natural-scrolling");
+                api_change("input.natural-scrolling", natural == 1 ? API_DISABLE : API_ENABLE, NULL);
                 break;
             case 2:
-                if (tap == 1) input_disable("tap-to-click");
-                else input_enable("tap-to-click");
+                api_change("input.tap-to-click", tap == 1 ? API_DISABLE : API_ENABLE, NULL);
                 break;
             case 3: {
                 printf("\nAcceleration (off/low/medium/high): ");
                 char buf[32];
                 if (fgets(buf, sizeof(buf), stdin)) {
                     buf[strcspn(buf, "\n")] = 0;
-                    input_set("mouse-accel", buf);
+                    api_change("input.mouse-accel", API_SET, buf);
                 }
                 break;
             }
@@ -112,23 +108,20 @@ static void show_effects_menu(void) {
         switch (choice) {
             case 0: return;
             case 1:
-                if (compositor) effects_disable("compositor");
-                else effects_enable("compositor");
+                api_change("effects.compositor", compositor ? API_DISABLE : API_ENABLE, NULL);
                 break;
             case 2:
-                if (shadows == 1) effects_disable("shadows");
-                else effects_enable("shadows");
+                api_change("effects.shadows", shadows == 1 ? API_DISABLE : API_ENABLE, NULL);
                 break;
             case 3:
-                if (animations == 1) effects_disable("animations");
-                else effects_enable("animations");
+                api_change("effects.animations", animations == 1 ? API_DISABLE : API_ENABLE, NULL);
                 break;
             case 4: {
                 printf("\nTransparency (0-100): ");
                 char buf[32];
                 if (fgets(buf, sizeof(buf), stdin)) {
                     buf[strcspn(buf, "\n")] = 0;
-                    effects_set("transparency", buf);
+                    api_change("effects.transparency", API_SET, buf);
                 }
                 break;
             }
@@ -171,17 +164,15 @@ static void show_panel_menu(void) {
                 char buf[32];
                 if (fgets(buf, sizeof(buf), stdin)) {
                     buf[strcspn(buf, "\n")] = 0;
-                    panel_set("position", buf);
+                    api_change("panel.position", API_SET, buf);
                 }
                 break;
             }
             case 2:
-                if (autohide == 1) panel_disable("autohide");
-                else panel_enable("autohide");
+                api_change("panel.autohide", autohide == 1 ? API_DISABLE : API_ENABLE, NULL);
                 break;
             case 3:
-                if (systray == 1) panel_disable("systray");
-                else panel_enable("systray");
+                api_change("panel.systray", systray == 1 ? API_DISABLE : API_ENABLE, NULL);
                 break;
             default:
                 break;
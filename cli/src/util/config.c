@@ -1,14 +1,19 @@
 // cli/src/util/config.c
+#define _DEFAULT_SOURCE
 #define _POSIX_C_SOURCE 200809L
 #include "config.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
 #include <sys/stat.h>
 #include <errno.h>
 #include <libgen.h>
 
+#define CAS_ATTEMPTS 8
+
 char *config_get_user_path(const char *filename) {
     const char *home = getenv("HOME");
     if (!home) return NULL;
@@ -21,6 +26,26 @@ char *config_get_user_path(const char *filename) {
     return path;
 }
 
+char *config_get_runtime_path(const char *filename) {
+    const char *runtime = getenv("XDG_RUNTIME_DIR");
+    char dir[256];
+
+    if (runtime && *runtime) {
+        snprintf(dir, sizeof(dir), "%s/opende", runtime);
+    } else {
+        snprintf(dir, sizeof(dir), "/tmp/opende-%ld", (long)getuid());
+    }
+
+    if (mkdir(dir, 0700) == -1 && errno != EEXIST) return NULL;
+
+    size_t len = strlen(dir) + strlen(filename) + 2;
+    char *path = malloc(len);
+    if (!path) return NULL;
+
+    snprintf(path, len, "%s/%s", dir, filename);
+    return path;
+}
+
 char *config_get_system_path(const char *filename) {
     const char *prefix = "/etc/X11/xorg.conf.d/";
     size_t len = strlen(prefix) + strlen(filename) + 1;
@@ -62,3 +87,362 @@ int config_ensure_dir(const char *filepath) {
 int config_file_exists(const char *path) {
     return access(path, R_OK) == 0;
 }
+
+char *config_read_file(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return NULL;
+
+    size_t cap = 4096, len = 0;
+    char *buf = malloc(cap);
+    if (!buf) {
+        fclose(fp);
+        return NULL;
+    }
+
+    size_t n;
+    while ((n = fread(buf + len, 1, cap - len - 1, fp)) > 0) {
+        len += n;
+        if (cap - len - 1 == 0) {
+            char *grown = realloc(buf, cap * 2);
+            if (!grown) {
+                free(buf);
+                fclose(fp);
+                return NULL;
+            }
+            buf = grown;
+            cap *= 2;
+        }
+    }
+
+    buf[len] = '\0';
+    fclose(fp);
+    return buf;
+}
+
+int config_write_file(const char *path, const char *content) {
+    return config_write_data(path, content, strlen(content));
+}
+
+int config_write_data(const char *path, const void *data, size_t size) {
+    size_t len = strlen(path) + strlen(".tmp.") + 16;
+    char *tmp = malloc(len);
+    if (!tmp) return -1;
+    snprintf(tmp, len, "%s.tmp.%ld", path, (long)getpid());
+
+    FILE *fp = fopen(tmp, "w");
+    if (!fp) {
+        free(tmp);
+        return -1;
+    }
+
+    // Keep the original file's permissions
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        fchmod(fileno(fp), st.st_mode & 07777);
+    }
+
+    int ok = fwrite(data, 1, size, fp) == size;
+    ok = (fflush(fp) == 0) && ok;
+    ok = (fsync(fileno(fp)) == 0) && ok;
+    ok = (fclose(fp) == 0) && ok;
+
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        free(tmp);
+        return -1;
+    }
+
+    free(tmp);
+    return 0;
+}
+
+int config_create_file(const char *path, const char *content) {
+    size_t len = strlen(path) + strlen(".new.") + 16;
+    char *tmp = malloc(len);
+    if (!tmp) return -1;
+    snprintf(tmp, len, "%s.new.%ld", path, (long)getpid());
+
+    // Write it complete under a private name, then link() it into place,
+    // which (unlike rename) fails if the file appeared meanwhile
+    int result = config_write_file(tmp, content);
+    if (result == 0 && link(tmp, path) != 0 && errno != EEXIST) result = -1;
+
+    unlink(tmp);
+    free(tmp);
+    return result;
+}
+
+int config_lock_file(const char *path) {
+    size_t len = strlen(path) + sizeof(".lock");
+    char *lock = malloc(len);
+    if (!lock) return -1;
+    snprintf(lock, len, "%s.lock", path);
+
+    // Read-only is enough for flock, and still works when another user
+    // (e.g. a sudo run) created the lock file
+    int fd = open(lock, O_RDONLY | O_CREAT | O_CLOEXEC, 0644);
+    free(lock);
+    if (fd < 0) return -1;
+
+    while (flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+void config_unlock_file(int fd) {
+    if (fd >= 0) close(fd);  // Releases the flock
+}
+
+// FNV-1a
+static unsigned long long hash_text(const char *text, size_t len) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)text[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+char *config_read_versioned(const char *path, ConfigVersion *version) {
+    memset(version, 0, sizeof(*version));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno == ENOENT ? strdup("") : NULL;
+
+    // Stat and content both come from this fd, so they describe one inode
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t cap = (size_t)st.st_size + 1, len = 0;
+    char *buf = malloc(cap);
+    while (buf) {
+        ssize_t n = read(fd, buf + len, cap - len - 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            free(buf);
+            buf = NULL;
+            break;
+        }
+        if (n == 0) break;
+        len += (size_t)n;
+        if (len == cap - 1) {
+            // Grew since fstat
+            char *grown = realloc(buf, cap * 2);
+            if (!grown) free(buf);
+            buf = grown;
+            cap *= 2;
+        }
+    }
+    close(fd);
+    if (!buf) return NULL;
+    buf[len] = '\0';
+
+    version->exists = 1;
+    version->dev = (unsigned long long)st.st_dev;
+    version->ino = (unsigned long long)st.st_ino;
+    version->size = (long long)st.st_size;
+    version->mtime_ns = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    version->hash = hash_text(buf, len);
+    return buf;
+}
+
+static int same_version(const ConfigVersion *a, const ConfigVersion *b) {
+    if (a->exists != b->exists) return 0;
+    if (!a->exists) return 1;
+    return a->dev == b->dev && a->ino == b->ino && a->size == b->size &&
+           a->mtime_ns == b->mtime_ns && a->hash == b->hash;
+}
+
+int config_write_if_unchanged(const char *path, const char *content,
+                              const ConfigVersion *version) {
+    int lock = config_lock_file(path);
+    if (lock < 0) return -1;
+
+    ConfigVersion current;
+    char *text = config_read_versioned(path, &current);
+    int result;
+    if (!text) {
+        result = -1;
+    } else if (!same_version(&current, version)) {
+        result = CONFIG_CONFLICT;
+    } else {
+        result = config_write_file(path, content);
+    }
+
+    free(text);
+    config_unlock_file(lock);
+    return result;
+}
+
+// One read-edit-write round; returns 0, CONFIG_CONFLICT or -1
+static int update_once(const char *path, ConfigEditFn edit, void *data, int locked) {
+    ConfigVersion version;
+    char *text = config_read_versioned(path, &version);
+    if (!text) return -1;
+
+    char *updated = edit(text, data);
+    int result;
+    if (!updated) {
+        result = -1;
+    } else if (strcmp(updated, text) == 0) {
+        result = 0;  // Already as requested
+    } else if (locked) {
+        result = config_write_file(path, updated);
+    } else {
+        result = config_write_if_unchanged(path, updated, &version);
+    }
+
+    free(updated);
+    free(text);
+    return result;
+}
+
+int config_update_file(const char *path, ConfigEditFn edit, void *data) {
+    for (int attempt = 0; attempt < CAS_ATTEMPTS; attempt++) {
+        int result = update_once(path, edit, data, 0);
+        if (result != CONFIG_CONFLICT) return result;
+
+        // Spread the retries of colliding writers apart
+        usleep((useconds_t)(500 * (attempt + 1) + (getpid() * 7919 + attempt * 104729) % 2000));
+    }
+
+    // Heavily contended: finish under the lock instead of retrying forever
+    int lock = config_lock_file(path);
+    if (lock < 0) return -1;
+    int result = update_once(path, edit, data, 1);
+    config_unlock_file(lock);
+    return result;
+}
+
+#define SETTINGS_FILE "opende.conf"
+
+// Find the value of `key = value` in settings text
+// Sets *line_start/*line_end to the line's extent when found
+static const char *find_setting(const char *text, const char *key,
+                                size_t *line_start, size_t *line_end) {
+    size_t klen = strlen(key);
+    const char *line = text;
+
+    while (*line) {
+        const char *nl = strchr(line, '\n');
+        const char *end = nl ? nl + 1 : line + strlen(line);
+        const char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+
+        if (strncmp(p, key, klen) == 0) {
+            const char *q = p + klen;
+            while (*q == ' ' || *q == '\t') q++;
+            if (*q == '=') {
+                q++;
+                while (*q == ' ' || *q == '\t') q++;
+                *line_start = (size_t)(line - text);
+                *line_end = (size_t)(end - text);
+                return q;
+            }
+        }
+        line = end;
+    }
+    return NULL;
+}
+
+char *config_text_get(const char *text, const char *key) {
+    size_t start, end;
+    const char *value = find_setting(text, key, &start, &end);
+    if (!value) return NULL;
+
+    size_t len = strcspn(value, "\r\n");
+    while (len > 0 && (value[len - 1] == ' ' || value[len - 1] == '\t')) len--;
+    return strndup(value, len);
+}
+
+char *config_text_set(const char *text, const char *key, const char *value) {
+    size_t len = strlen(text) + strlen(key) + strlen(value) + 8;
+    char *updated = malloc(len);
+    if (!updated) return NULL;
+
+    size_t start, end;
+    if (find_setting(text, key, &start, &end)) {
+        snprintf(updated, len, "%.*s%s = %s\n%s",
+                 (int)start, text, key, value, text + end);
+    } else {
+        size_t tlen = strlen(text);
+        int need_nl = tlen > 0 && text[tlen - 1] != '\n';
+        snprintf(updated, len, "%s%s%s = %s\n", text, need_nl ? "\n" : "", key, value);
+    }
+    return updated;
+}
+
+char *config_get_setting(const char *key) {
+    char *path = config_get_user_path(SETTINGS_FILE);
+    if (!path) return NULL;
+
+    char *text = config_read_file(path);
+    free(path);
+    if (!text) return NULL;
+
+    char *result = config_text_get(text, key);
+    free(text);
+    return result;
+}
+
+typedef struct {
+    const char *key;
+    const char *value;
+} SettingEdit;
+
+static char *edit_setting(const char *text, void *data) {
+    const SettingEdit *edit = data;
+    if (!*text) text = "# OpenDE settings - managed by the opende CLI\n";
+    return config_text_set(text, edit->key, edit->value);
+}
+
+int config_set_setting(const char *key, const char *value) {
+    char *path = config_get_user_path(SETTINGS_FILE);
+    if (!path) return -1;
+
+    if (config_ensure_dir(path) != 0) {
+        free(path);
+        return -1;
+    }
+
+    SettingEdit edit = { key, value };
+    int result = config_update_file(path, edit_setting, &edit);
+    free(path);
+    return result;
+}
+
+int config_get_setting_bool(const char *key, int def) {
+    char *value = config_get_setting(key);
+    if (!value) return def;
+
+    int result = def;
+    if (strcmp(value, "true") == 0 || strcmp(value, "1") == 0 ||
+        strcmp(value, "on") == 0 || strcmp(value, "yes") == 0) {
+        result = 1;
+    } else if (strcmp(value, "false") == 0 || strcmp(value, "0") == 0 ||
+               strcmp(value, "off") == 0 || strcmp(value, "no") == 0) {
+        result = 0;
+    }
+
+    free(value);
+    return result;
+}
+
+int config_get_setting_int(const char *key, int def) {
+    char *value = config_get_setting(key);
+    if (!value) return def;
+
+    char *end;
+    long n = strtol(value, &end, 10);
+    int result = (end != value && *end == '\0') ? (int)n : def;
+
+    free(value);
+    return result;
+}
@@ -2,6 +2,8 @@
 #ifndef OPENDE_CONFIG_H
 #define OPENDE_CONFIG_H
 
+#include <stddef.h>
+
 // Get path to user config file, creating directory if needed
 // Returns allocated string (caller must free) or NULL on error
 char *config_get_user_path(const char *filename);
@@ -10,6 +12,11 @@ char *config_get_user_path(const char *filename);
 // Returns allocated string (caller must free) or NULL on error
 char *config_get_system_path(const char *filename);
 
+// Get path to a per-session runtime file under $XDG_RUNTIME_DIR/opende/
+// (falls back to /tmp/opende-<uid>/), creating the directory if needed
+// Returns allocated string (caller must free) or NULL on error
+char *config_get_runtime_path(const char *filename);
+
 // Ensure directory exists for a file path
 // Returns 0 on success, -1 on error
 int config_ensure_dir(const char *filepath);
@@ -17,4 +24,82 @@ int config_ensure_dir(const char *filepath);
 // Check if file exists and is readable
 int config_file_exists(const char *path);
 
+// Read a whole file into memory (NUL-terminated)
+// Returns allocated buffer (caller must free) or NULL on error
+char *config_read_file(const char *path);
+
+// Replace a file's contents atomically (write temp file, then rename)
+// Returns 0 on success, -1 on error
+int config_write_file(const char *path, const char *content);
+
+// Same for binary data
+int config_write_data(const char *path, const void *data, size_t size);
+
+// Create a file with content unless it already exists, atomically: a
+// concurrent writer's version is never overwritten by the seed
+// Returns 0 if created or already present, -1 on error
+int config_create_file(const char *path, const char *content);
+
+// Concurrent writers (the interactive menu, login scripts, a management
+// agent) update shared files with optimistic compare-and-swap: read and
+// edit without holding anything, then under a per-file advisory lock
+// (flock on "<path>.lock") check the file is still the version that was
+// read and rename the new content over it. Readers never need the lock
+// and never see a partial file.
+
+#define CONFIG_CONFLICT 1    // File changed since it was read
+
+// Identity of one version of a file: inode, size and mtime catch writers
+// that rename, content hash catches in-place writes within one mtime tick
+typedef struct {
+    int exists;
+    unsigned long long dev;
+    unsigned long long ino;
+    long long size;
+    long long mtime_ns;
+    unsigned long long hash;
+} ConfigVersion;
+
+// Take the advisory lock for path (blocking)
+// Returns lock fd (pass to config_unlock_file) or -1 on error
+int config_lock_file(const char *path);
+void config_unlock_file(int fd);
+
+// Read a file and record its version; a missing file reads as "" with
+// version->exists == 0. Returns allocated text or NULL on error
+char *config_read_versioned(const char *path, ConfigVersion *version);
+
+// Replace the file only if it is still at version
+// Returns 0 on success, CONFIG_CONFLICT if it changed, -1 on error
+int config_write_if_unchanged(const char *path, const char *content,
+                              const ConfigVersion *version);
+
+// Produce the new file text from the current one ("" if missing)
+// Returns allocated text, or NULL to abort the update
+typedef char *(*ConfigEditFn)(const char *text, void *data);
+
+// Read-edit-CAS loop with retries; the edit may run more than once, so it
+// must be a pure function of text and data. After repeated conflicts the
+// last attempt runs entirely under the lock, so every writer finishes.
+// Returns 0 on success (also when the edit changed nothing), -1 on error
+int config_update_file(const char *path, ConfigEditFn edit, void *data);
+
+// `key = value` lines as used by opende.conf and tint2rc
+// Value of the first assignment (allocated) or NULL
+char *config_text_get(const char *text, const char *key);
+// Replace the first assignment, or append one. Returns allocated text
+char *config_text_set(const char *text, const char *key, const char *value);
+
+// OpenDE's own settings live in ~/.config/opende/opende.conf as
+// `key = value` lines (e.g. "governor.enabled = true")
+// Returns allocated value (caller must free) or NULL if unset
+char *config_get_setting(const char *key);
+
+// Returns 0 on success, -1 on error
+int config_set_setting(const char *key, const char *value);
+
+// Convenience readers with defaults for unset or malformed values
+int config_get_setting_bool(const char *key, int def);
+int config_get_setting_int(const char *key, int def);
+
 #endif
@@ -0,0 +1,275 @@
+// cli/src/util/desktop.c
+#define _DEFAULT_SOURCE
+#include "desktop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+
+static void copy_field(char *dst, size_t size, const char *src) {
+    snprintf(dst, size, "%s", src);
+}
+
+// Drop %f/%F/%u/%U/%i/%c/%k and friends; "%%" is a literal percent
+static void strip_field_codes(char *dst, size_t size, const char *src) {
+    size_t len = 0;
+    for (const char *p = src; *p && len + 1 < size; p++) {
+        if (*p == '%' && p[1]) {
+            p++;
+            if (*p == '%') dst[len++] = '%';
+            continue;
+        }
+        dst[len++] = *p;
+    }
+
+    // Trailing space left by a removed final field code
+    while (len > 0 && dst[len - 1] == ' ') len--;
+    dst[len] = '\0';
+}
+
+// How well a Name[locale] key matches $LANG: 2 for lang_COUNTRY, 1 for
+// lang, 0 for none (the unlocalized Name)
+static int locale_match(const char *key) {
+    const char *lang = getenv("LC_ALL");
+    if (!lang || !*lang) lang = getenv("LC_MESSAGES");
+    if (!lang || !*lang) lang = getenv("LANG");
+    if (!lang || !*lang) return 0;
+
+    const char *open = strchr(key, '[');
+    const char *close = open ? strchr(open, ']') : NULL;
+    if (!open || !close) return 0;
+
+    size_t key_len = (size_t)(close - open - 1);
+    size_t full = strcspn(lang, ".@");       // de_DE
+    size_t short_len = strcspn(lang, "_.@"); // de
+
+    if (key_len == full && strncmp(open + 1, lang, full) == 0) return 2;
+    if (key_len == short_len && strncmp(open + 1, lang, short_len) == 0) return 1;
+    return 0;
+}
+
+int desktop_entry_load(const char *path, DesktopEntry *entry) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    memset(entry, 0, sizeof(*entry));
+    copy_field(entry->path, sizeof(entry->path), path);
+    const char *base = strrchr(path, '/');
+    copy_field(entry->id, sizeof(entry->id), base ? base + 1 : path);
+
+    char line[1024];
+    int in_entry = 0, seen = 0, name_rank = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '[') {
+            in_entry = strcmp(line, "[Desktop Entry]") == 0;
+            seen |= in_entry;
+            continue;
+        }
+        if (!in_entry || line[0] == '#') continue;
+
+        char *eq = strchr(line, '=');
+        if (!eq) continue;
+
+        // Other localized keys (Comment[de]=) are skipped by the exact
+        // compares below
+        char *key = line, *value = eq + 1;
+        char *end = eq;
+        while (end > key && end[-1] == ' ') end--;
+        *end = '\0';
+        while (*value == ' ') value++;
+
+        if (strcmp(key, "Name") == 0 || strncmp(key, "Name[", 5) == 0) {
+            int rank = key[4] ? locale_match(key) : 0;
+            if ((key[4] == '\0' || rank > 0) && rank > name_rank) {
+                copy_field(entry->name, sizeof(entry->name), value);
+                name_rank = rank;
+            }
+        } else if (strcmp(key, "Icon") == 0) {
+            copy_field(entry->icon, sizeof(entry->icon), value);
+        } else if (strcmp(key, "Categories") == 0) {
+            copy_field(entry->categories, sizeof(entry->categories), value);
+        } else if (strcmp(key, "NoDisplay") == 0) {
+            entry->no_display = strcmp(value, "true") == 0;
+        } else if (strcmp(key, "Terminal") == 0) {
+            entry->terminal = strcmp(value, "true") == 0;
+        } else if (strcmp(key, "Exec") == 0) {
+            strip_field_codes(entry->exec, sizeof(entry->exec), value);
+        } else if (strcmp(key, "TryExec") == 0) {
+            copy_field(entry->try_exec, sizeof(entry->try_exec), value);
+        } else if (strcmp(key, "OnlyShowIn") == 0) {
+            copy_field(entry->only_show_in, sizeof(entry->only_show_in), value);
+        } else if (strcmp(key, "NotShowIn") == 0) {
+            copy_field(entry->not_show_in, sizeof(entry->not_show_in), value);
+        } else if (strcmp(key, "Hidden") == 0) {
+            entry->hidden = strcmp(value, "true") == 0;
+        } else if (strcmp(key, "Type") == 0) {
+            entry->application = strcmp(value, "Application") == 0;
+        } else if (strcmp(key, "X-GNOME-Autostart-enabled") == 0) {
+            entry->autostart_disabled = strcmp(value, "false") == 0;
+        } else if (strcmp(key, "X-GNOME-Autostart-Delay") == 0) {
+            entry->autostart_delay = atoi(value);
+        } else if (strcmp(key, "X-OpenDE-Priority") == 0) {
+            entry->low_priority = strcmp(value, "low") == 0;
+        }
+    }
+
+    fclose(fp);
+    return seen ? 0 : -1;
+}
+
+// Is any of the ':'-separated desktops in the ';'-separated list?
+static int list_contains(const char *list, const char *desktops) {
+    char copy[256];
+    copy_field(copy, sizeof(copy), desktops);
+
+    char *save = NULL;
+    for (char *d = strtok_r(copy, ":", &save); d; d = strtok_r(NULL, ":", &save)) {
+        size_t n = strlen(d);
+        for (const char *p = list; *p; ) {
+            size_t item = strcspn(p, ";");
+            if (item == n && strncmp(p, d, n) == 0) return 1;
+            p += item;
+            if (*p == ';') p++;
+        }
+    }
+    return 0;
+}
+
+int desktop_entry_shown_in_current(const DesktopEntry *entry) {
+    const char *desktops = getenv("XDG_CURRENT_DESKTOP");
+    if (!desktops || !*desktops) desktops = "OpenDE";
+
+    if (entry->only_show_in[0] && !list_contains(entry->only_show_in, desktops)) return 0;
+    if (entry->not_show_in[0] && list_contains(entry->not_show_in, desktops)) return 0;
+    return 1;
+}
+
+int desktop_exec_argv(const char *exec, char **argv, int max) {
+    char word[DESKTOP_FIELD_MAX];
+    int argc = 0;
+    const char *p = exec;
+
+    while (*p && argc < max - 1) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (!*p) break;
+
+        // Inside double quotes, \ escapes " ` $ and \; elsewhere words
+        // are split on spaces only
+        size_t len = 0;
+        int quoted = 0;
+        while (*p && (quoted || (*p != ' ' && *p != '\t')) && len + 1 < sizeof(word)) {
+            if (*p == '"') {
+                quoted = !quoted;
+                p++;
+            } else if (quoted && *p == '\\' && p[1] && strchr("\"`$\\", p[1])) {
+                word[len++] = p[1];
+                p += 2;
+            } else {
+                word[len++] = *p++;
+            }
+        }
+        if (quoted) {
+            argv[argc] = NULL;
+            desktop_free_argv(argv);
+            return -1;
+        }
+
+        word[len] = '\0';
+        argv[argc] = strdup(word);
+        if (!argv[argc]) break;
+        argc++;
+    }
+
+    argv[argc] = NULL;
+    return argc;
+}
+
+void desktop_free_argv(char **argv) {
+    for (int i = 0; argv[i]; i++) free(argv[i]);
+}
+
+char *desktop_find_executable(const char *name) {
+    if (!name || !*name) return NULL;
+    if (strchr(name, '/')) return access(name, X_OK) == 0 ? strdup(name) : NULL;
+
+    const char *env = getenv("PATH");
+    char *path = strdup(env && *env ? env : "/usr/local/bin:/usr/bin:/bin");
+    if (!path) return NULL;
+
+    char *found = NULL;
+    char *save = NULL;
+    for (char *dir = strtok_r(path, ":", &save); dir && !found; dir = strtok_r(NULL, ":", &save)) {
+        char full[512];
+        snprintf(full, sizeof(full), "%s/%s", dir, name);
+        if (access(full, X_OK) == 0) found = strdup(full);
+    }
+
+    free(path);
+    return found;
+}
+
+int desktop_entry_try_exec_ok(const DesktopEntry *entry) {
+    if (!entry->try_exec[0]) return 1;
+    char *path = desktop_find_executable(entry->try_exec);
+    free(path);
+    return path != NULL;
+}
+
+static int find_id(const DesktopEntry *entries, int count, const char *id) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(entries[i].id, id) == 0) return i;
+    }
+    return -1;
+}
+
+// Load a directory's entries; ids already present (from a more important
+// directory) are kept as they are
+static int scan_dir(const char *dir, DesktopEntry *entries, int count, int max) {
+    DIR *dp = opendir(dir);
+    if (!dp) return count;
+
+    struct dirent *de;
+    while ((de = readdir(dp)) && count < max) {
+        size_t len = strlen(de->d_name);
+        if (len < 9 || strcmp(de->d_name + len - 8, ".desktop") != 0) continue;
+        if (find_id(entries, count, de->d_name) >= 0) continue;
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        if (desktop_entry_load(path, &entries[count]) == 0) count++;
+    }
+
+    closedir(dp);
+    return count;
+}
+
+int desktop_autostart_list(DesktopEntry *entries, int max) {
+    char dir[512];
+    int count = 0;
+
+    const char *config_home = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    if (config_home && *config_home) {
+        snprintf(dir, sizeof(dir), "%s/autostart", config_home);
+        count = scan_dir(dir, entries, count, max);
+    } else if (home) {
+        snprintf(dir, sizeof(dir), "%s/.config/autostart", home);
+        count = scan_dir(dir, entries, count, max);
+    }
+
+    const char *dirs_env = getenv("XDG_CONFIG_DIRS");
+    char *dirs = strdup(dirs_env && *dirs_env ? dirs_env : "/etc/xdg");
+    if (!dirs) return count;
+
+    // Earlier directories take precedence
+    char *save = NULL;
+    for (char *d = strtok_r(dirs, ":", &save); d; d = strtok_r(NULL, ":", &save)) {
+        snprintf(dir, sizeof(dir), "%s/autostart", d);
+        count = scan_dir(dir, entries, count, max);
+    }
+
+    free(dirs);
+    return count;
+}
@@ -0,0 +1,53 @@
+// cli/src/util/desktop.h
+#ifndef OPENDE_DESKTOP_H
+#define OPENDE_DESKTOP_H
+
+#define DESKTOP_FIELD_MAX 512
+
+// The [Desktop Entry] keys OpenDE cares about
+typedef struct {
+    char id[128];                       // File name, e.g. "nm-applet.desktop"
+    char path[512];
+    char name[128];                     // Localized for $LANG when available
+    char exec[DESKTOP_FIELD_MAX];       // Field codes already stripped
+    char icon[256];
+    char categories[256];               // ';'-separated, as in the file
+    char try_exec[256];
+    char only_show_in[256];             // ';'-separated, as in the file
+    char not_show_in[256];
+    int hidden;                         // Hidden=true: entry is deleted
+    int application;                    // Type=Application
+    int no_display;                     // NoDisplay=true: not in menus
+    int terminal;                       // Terminal=true
+    int autostart_disabled;             // X-GNOME-Autostart-enabled=false
+    int autostart_delay;                // X-GNOME-Autostart-Delay, seconds
+    int low_priority;                   // X-OpenDE-Priority=low
+} DesktopEntry;
+
+// Parse one .desktop file
+// Returns 0 on success, -1 if unreadable or lacking [Desktop Entry]
+int desktop_entry_load(const char *path, DesktopEntry *entry);
+
+// Whether OnlyShowIn/NotShowIn allow the entry in $XDG_CURRENT_DESKTOP
+// (a ':'-separated list; "OpenDE" if unset)
+int desktop_entry_shown_in_current(const DesktopEntry *entry);
+
+// Whether TryExec (if any) names an installed executable
+int desktop_entry_try_exec_ok(const DesktopEntry *entry);
+
+// Effective XDG autostart entries: $XDG_CONFIG_HOME/autostart overrides
+// $XDG_CONFIG_DIRS/autostart by file name. Includes hidden and
+// not-shown entries; callers filter. Returns number found (at most max).
+int desktop_autostart_list(DesktopEntry *entries, int max);
+
+// Split an Exec value into argv following the Desktop Entry quoting rules
+// Returns argc (argv NULL terminated), -1 on malformed quoting. Free with
+// desktop_free_argv().
+int desktop_exec_argv(const char *exec, char **argv, int max);
+void desktop_free_argv(char **argv);
+
+// Find an executable the way execvp would
+// Returns allocated absolute path (caller must free) or NULL
+char *desktop_find_executable(const char *name);
+
+#endif
@@ -0,0 +1,201 @@
+// cli/src/util/elf.c
+#define _DEFAULT_SOURCE
+#include "elf.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
+
+#define MAX_NEEDED      128
+#define MAX_LIB_DIRS    64
+#define MAX_DYNAMIC     (1024 * 1024)
+
+static char *lib_dirs[MAX_LIB_DIRS];
+static int lib_dir_count = -1;
+
+static void add_lib_dir(const char *dir) {
+    for (int i = 0; i < lib_dir_count; i++) {
+        if (strcmp(lib_dirs[i], dir) == 0) return;
+    }
+    if (lib_dir_count < MAX_LIB_DIRS) {
+        char *copy = strdup(dir);
+        if (copy) lib_dirs[lib_dir_count++] = copy;
+    }
+}
+
+// ld.so.conf: one directory per line, "include <glob>" for fragments
+static void parse_ld_conf(const char *path, int depth) {
+    char *text = config_read_file(path);
+    if (!text || depth > 4) {
+        free(text);
+        return;
+    }
+
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        line += strspn(line, " \t");
+        line[strcspn(line, "#")] = '\0';
+        size_t len = strlen(line);
+        while (len > 0 && (line[len - 1] == ' ' || line[len - 1] == '\t')) line[--len] = '\0';
+        if (!*line) continue;
+
+        if (strncmp(line, "include", 7) == 0 && (line[7] == ' ' || line[7] == '\t')) {
+            const char *pattern = line + 8 + strspn(line + 8, " \t");
+            char full[512];
+            if (pattern[0] == '/') snprintf(full, sizeof(full), "%s", pattern);
+            else snprintf(full, sizeof(full), "/etc/%s", pattern);
+
+            glob_t g;
+            if (glob(full, 0, NULL, &g) == 0) {
+                for (size_t i = 0; i < g.gl_pathc; i++) parse_ld_conf(g.gl_pathv[i], depth + 1);
+            }
+            globfree(&g);
+        } else if (line[0] == '/') {
+            add_lib_dir(line);
+        }
+    }
+    free(text);
+}
+
+static void load_lib_dirs(void) {
+    if (lib_dir_count >= 0) return;
+    lib_dir_count = 0;
+    parse_ld_conf("/etc/ld.so.conf", 0);
+
+    static const char *defaults[] = { "/lib64", "/usr/lib64", "/lib", "/usr/lib", NULL };
+    for (int i = 0; defaults[i]; i++) add_lib_dir(defaults[i]);
+}
+
+int elf_is_elf(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    unsigned char magic[SELFMAG];
+    int result = read(fd, magic, SELFMAG) == SELFMAG && memcmp(magic, ELFMAG, SELFMAG) == 0;
+    close(fd);
+    return result;
+}
+
+static int read_at(int fd, void *buf, size_t len, uint64_t offset) {
+    return pread(fd, buf, len, (off_t)offset) == (ssize_t)len ? 0 : -1;
+}
+
+// Virtual address to file offset through the PT_LOAD segments
+static int vaddr_offset(const Elf64_Phdr *ph, int count, uint64_t addr, uint64_t *offset) {
+    for (int i = 0; i < count; i++) {
+        if (ph[i].p_type == PT_LOAD && addr >= ph[i].p_vaddr && addr < ph[i].p_vaddr + ph[i].p_filesz) {
+            *offset = ph[i].p_offset + (addr - ph[i].p_vaddr);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static char *find_in(const char *dir, const char *name, const char *origin) {
+    char path[1024];
+    if (strncmp(dir, "$ORIGIN", 7) == 0) snprintf(path, sizeof(path), "%s%s/%s", origin, dir + 7, name);
+    else if (strncmp(dir, "${ORIGIN}", 9) == 0) snprintf(path, sizeof(path), "%s%s/%s", origin, dir + 9, name);
+    else snprintf(path, sizeof(path), "%s/%s", dir, name);
+    return access(path, R_OK) == 0 ? strdup(path) : NULL;
+}
+
+static char *resolve(const char *name, const char *runpath, const char *origin) {
+    if (strchr(name, '/')) return access(name, R_OK) == 0 ? strdup(name) : NULL;
+
+    char *found = NULL;
+    if (runpath) {
+        char *copy = strdup(runpath);
+        char *save = NULL;
+        for (char *d = copy ? strtok_r(copy, ":", &save) : NULL; d && !found; d = strtok_r(NULL, ":", &save)) {
+            found = find_in(d, name, origin);
+        }
+        free(copy);
+    }
+
+    load_lib_dirs();
+    for (int i = 0; i < lib_dir_count && !found; i++) found = find_in(lib_dirs[i], name, origin);
+    return found;
+}
+
+int elf_dependencies(const char *path, char **out, int max) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    Elf64_Ehdr eh;
+    if (read_at(fd, &eh, sizeof(eh), 0) != 0 || memcmp(eh.e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh.e_ident[EI_CLASS] != ELFCLASS64 || eh.e_phentsize != sizeof(Elf64_Phdr) ||
+        eh.e_phnum == 0 || eh.e_phnum > 256) {
+        close(fd);
+        return -1;
+    }
+
+    Elf64_Phdr ph[256];
+    if (read_at(fd, ph, eh.e_phnum * sizeof(Elf64_Phdr), eh.e_phoff) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    int count = 0;
+    for (int p = 0; p < eh.e_phnum; p++) {
+        if (ph[p].p_type != PT_DYNAMIC || ph[p].p_filesz > MAX_DYNAMIC) continue;
+
+        Elf64_Dyn *dyn = malloc(ph[p].p_filesz);
+        if (!dyn || read_at(fd, dyn, ph[p].p_filesz, ph[p].p_offset) != 0) {
+            free(dyn);
+            break;
+        }
+
+        uint64_t strtab = 0, strsz = 0, runpath = (uint64_t)-1;
+        uint64_t needed[MAX_NEEDED];
+        int needed_count = 0;
+        size_t n = ph[p].p_filesz / sizeof(Elf64_Dyn);
+        for (size_t i = 0; i < n && dyn[i].d_tag != DT_NULL; i++) {
+            switch (dyn[i].d_tag) {
+                case DT_STRTAB: strtab = dyn[i].d_un.d_ptr; break;
+                case DT_STRSZ:  strsz = dyn[i].d_un.d_val; break;
+                case DT_RUNPATH: runpath = dyn[i].d_un.d_val; break;
+                case DT_RPATH:
+                    if (runpath == (uint64_t)-1) runpath = dyn[i].d_un.d_val;
+                    break;
+                case DT_NEEDED:
+                    if (needed_count < MAX_NEEDED) needed[needed_count++] = dyn[i].d_un.d_val;
+                    break;
+                default: break;
+            }
+        }
+        free(dyn);
+
+        uint64_t offset;
+        char *strings = NULL;
+        if (strsz > 0 && strsz <= MAX_DYNAMIC && vaddr_offset(ph, eh.e_phnum, strtab, &offset) == 0) {
+            strings = malloc(strsz + 1);
+            if (strings && read_at(fd, strings, strsz, offset) != 0) {
+                free(strings);
+                strings = NULL;
+            }
+            if (strings) strings[strsz] = '\0';
+        }
+        if (!strings) break;
+
+        // $ORIGIN is the directory of the object itself
+        char origin[512];
+        snprintf(origin, sizeof(origin), "%s", path);
+        char *slash = strrchr(origin, '/');
+        if (slash) *slash = '\0';
+
+        const char *rp = runpath < strsz ? strings + runpath : NULL;
+        for (int i = 0; i < needed_count && count < max; i++) {
+            if (needed[i] >= strsz) continue;
+            char *lib = resolve(strings + needed[i], rp, origin);
+            if (lib) out[count++] = lib;
+        }
+        free(strings);
+        break;
+    }
+
+    close(fd);
+    return count;
+}
@@ -0,0 +1,15 @@
+// cli/src/util/elf.h
+#ifndef OPENDE_ELF_H
+#define OPENDE_ELF_H
+
+// Is the file an ELF object?
+int elf_is_elf(const char *path);
+
+// Shared libraries an ELF binary or library links against (DT_NEEDED),
+// resolved the way the dynamic loader searches: DT_RUNPATH/DT_RPATH with
+// $ORIGIN, /etc/ld.so.conf, then the default directories. 64-bit only.
+// Returns number of paths stored in out (caller must free each), -1 if the
+// file is not a 64-bit ELF object
+int elf_dependencies(const char *path, char **out, int max);
+
+#endif
@@ -0,0 +1,296 @@
+// cli/src/util/image.c
+#define _POSIX_C_SOURCE 200809L
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <math.h>
+#include <jpeglib.h>
+#include <png.h>
+
+typedef enum {
+    FORMAT_UNKNOWN,
+    FORMAT_JPEG,
+    FORMAT_PNG
+} ImageFormat;
+
+static ImageFormat detect_format(FILE *fp) {
+    unsigned char magic[8];
+    size_t n = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+
+    if (n >= 3 && magic[0] == 0xFF && magic[1] == 0xD8 && magic[2] == 0xFF) return FORMAT_JPEG;
+    if (n == 8 && png_sig_cmp(magic, 0, 8) == 0) return FORMAT_PNG;
+    return FORMAT_UNKNOWN;
+}
+
+// libjpeg's default error handler exits the process
+typedef struct {
+    struct jpeg_error_mgr mgr;
+    jmp_buf jump;
+} JpegError;
+
+static void jpeg_error_exit(j_common_ptr cinfo) {
+    JpegError *err = (JpegError *)cinfo->err;
+    longjmp(err->jump, 1);
+}
+
+static int load_jpeg(FILE *fp, int shrink, int header_only, Image *image) {
+    struct jpeg_decompress_struct cinfo;
+    JpegError err;
+    JSAMPLE *volatile row = NULL;  // Set after setjmp, freed by the error path
+
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpeg_error_exit;
+    if (setjmp(err.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        free(row);
+        image_free(image);
+        return -1;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, fp);
+    jpeg_read_header(&cinfo, TRUE);
+
+    if (header_only) {
+        image->width = (int)cinfo.image_width;
+        image->height = (int)cinfo.image_height;
+        jpeg_destroy_decompress(&cinfo);
+        return 0;
+    }
+
+    cinfo.out_color_space = JCS_RGB;
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = (unsigned int)(shrink >= 8 ? 8 : shrink >= 4 ? 4 : shrink >= 2 ? 2 : 1);
+    cinfo.dct_method = JDCT_ISLOW;
+    jpeg_start_decompress(&cinfo);
+
+    image->width = (int)cinfo.output_width;
+    image->height = (int)cinfo.output_height;
+    image->pixels = malloc((size_t)image->width * (size_t)image->height * sizeof(uint32_t));
+    row = malloc((size_t)image->width * (size_t)cinfo.output_components);
+    if (!image->pixels || !row) longjmp(err.jump, 1);
+
+    while (cinfo.output_scanline < cinfo.output_height) {
+        uint32_t *out = image->pixels + (size_t)cinfo.output_scanline * (size_t)image->width;
+        JSAMPLE *line = row;
+        jpeg_read_scanlines(&cinfo, &line, 1);
+
+        if (cinfo.output_components == 1) {
+            for (int x = 0; x < image->width; x++) {
+                out[x] = (uint32_t)row[x] * 0x010101u;
+            }
+        } else {
+            for (int x = 0; x < image->width; x++) {
+                const JSAMPLE *p = row + x * 3;
+                out[x] = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+            }
+        }
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    free(row);
+    return 0;
+}
+
+static int load_png(const char *path, int header_only, Image *image) {
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+
+    if (!png_image_begin_read_from_file(&png, path)) return -1;
+
+    image->width = (int)png.width;
+    image->height = (int)png.height;
+    if (header_only) {
+        png_image_free(&png);
+        return 0;
+    }
+
+    // Flatten any transparency onto black; BGRA bytes are 0xAARRGGBB words
+    png.format = PNG_FORMAT_BGRA;
+    image->pixels = malloc(PNG_IMAGE_SIZE(png));
+    if (!image->pixels || !png_image_finish_read(&png, NULL, image->pixels, 0, NULL)) {
+        png_image_free(&png);
+        image_free(image);
+        return -1;
+    }
+
+    size_t count = (size_t)image->width * (size_t)image->height;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t p = image->pixels[i], a = p >> 24;
+        if (a == 255) {
+            image->pixels[i] = p & 0x00FFFFFFu;
+            continue;
+        }
+        image->pixels[i] = (((p >> 16) & 0xFF) * a / 255) << 16 |
+                           (((p >> 8) & 0xFF) * a / 255) << 8 |
+                           ((p & 0xFF) * a / 255);
+    }
+    return 0;
+}
+
+static int load(const char *path, int shrink, int header_only, Image *image) {
+    memset(image, 0, sizeof(*image));
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+
+    int result = -1;
+    switch (detect_format(fp)) {
+        case FORMAT_JPEG:
+            result = load_jpeg(fp, shrink, header_only, image);
+            break;
+        case FORMAT_PNG:
+            result = load_png(path, header_only, image);
+            break;
+        default:
+            break;
+    }
+
+    fclose(fp);
+    return result;
+}
+
+int image_probe(const char *path, int *width, int *height) {
+    Image image;
+    if (load(path, 1, 1, &image) != 0) return -1;
+    *width = image.width;
+    *height = image.height;
+    return 0;
+}
+
+int image_load(const char *path, int shrink, Image *image) {
+    return load(path, shrink, 0, image);
+}
+
+int image_new(int width, int height, uint32_t color, Image *image) {
+    size_t count = (size_t)width * (size_t)height;
+    image->width = width;
+    image->height = height;
+    image->pixels = malloc(count * sizeof(uint32_t));
+    if (!image->pixels) return -1;
+    for (size_t i = 0; i < count; i++) image->pixels[i] = color;
+    return 0;
+}
+
+void image_free(Image *image) {
+    free(image->pixels);
+    image->pixels = NULL;
+}
+
+// Filter taps for one axis: dst pixel i reads src[first[i] .. first[i]+count[i])
+typedef struct {
+    int *first;
+    int *count;
+    int *weights;            // count[i] weights per pixel, summing to 1 << 14
+    int max_taps;
+} Taps;
+
+#define WEIGHT_ONE (1 << 14)
+
+static int make_taps(int src_len, int dst_len, Taps *t) {
+    double scale = (double)dst_len / src_len;
+    double support = scale < 1 ? 1 / scale : 1;  // Widen the tent when reducing
+    t->max_taps = (int)ceil(support * 2) + 2;
+
+    t->first = malloc((size_t)dst_len * sizeof(int));
+    t->count = malloc((size_t)dst_len * sizeof(int));
+    t->weights = malloc((size_t)dst_len * (size_t)t->max_taps * sizeof(int));
+    if (!t->first || !t->count || !t->weights) return -1;
+
+    for (int i = 0; i < dst_len; i++) {
+        double center = (i + 0.5) / scale - 0.5;
+        int lo = (int)floor(center - support) + 1;
+        int hi = (int)floor(center + support);
+        if (lo < 0) lo = 0;
+        if (hi > src_len - 1) hi = src_len - 1;
+        if (hi - lo + 1 > t->max_taps) hi = lo + t->max_taps - 1;
+        if (hi < lo) hi = lo;
+
+        double w[64], total = 0;
+        int n = hi - lo + 1;
+        for (int k = 0; k < n && k < 64; k++) {
+            double d = fabs(lo + k - center) / support;
+            w[k] = d < 1 ? 1 - d : 0;
+            total += w[k];
+        }
+
+        int *out = t->weights + (size_t)i * (size_t)t->max_taps;
+        int sum = 0;
+        for (int k = 0; k < n; k++) {
+            out[k] = total > 0 ? (int)(w[k] / total * WEIGHT_ONE + 0.5) : (k == 0 ? WEIGHT_ONE : 0);
+            sum += out[k];
+        }
+        out[0] += WEIGHT_ONE - sum;  // Rounding drift
+
+        t->first[i] = lo;
+        t->count[i] = n;
+    }
+    return 0;
+}
+
+static void free_taps(Taps *t) {
+    free(t->first);
+    free(t->count);
+    free(t->weights);
+}
+
+static uint32_t clamp_channel(int v) {
+    v = (v + WEIGHT_ONE / 2) >> 14;
+    return (uint32_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+static uint32_t filter(const uint32_t *src, size_t stride, const Taps *t, int i) {
+    const int *w = t->weights + (size_t)i * (size_t)t->max_taps;
+    const uint32_t *p = src + (size_t)t->first[i] * stride;
+    int r = 0, g = 0, b = 0;
+
+    for (int k = 0; k < t->count[i]; k++, p += stride) {
+        r += (int)((*p >> 16) & 0xFF) * w[k];
+        g += (int)((*p >> 8) & 0xFF) * w[k];
+        b += (int)(*p & 0xFF) * w[k];
+    }
+    return (clamp_channel(r) << 16) | (clamp_channel(g) << 8) | clamp_channel(b);
+}
+
+int image_scale(const Image *src, int src_x, int src_y, int src_w, int src_h,
+                int dst_w, int dst_h, Image *dst) {
+    // The tent never spans more than 64 taps (a 1/31 reduction); larger
+    // reductions are expected to go through the JPEG decoder's shrink
+    if (src_w < 1 || src_h < 1 || dst_w < 1 || dst_h < 1 ||
+        src_w > dst_w * 31 || src_h > dst_h * 31) {
+        return -1;
+    }
+
+    Taps tx = { 0 }, ty = { 0 };
+    uint32_t *tmp = malloc((size_t)dst_w * (size_t)src_h * sizeof(uint32_t));
+
+    if (!tmp || make_taps(src_w, dst_w, &tx) != 0 || make_taps(src_h, dst_h, &ty) != 0 ||
+        image_new(dst_w, dst_h, 0, dst) != 0) {
+        free(tmp);
+        free_taps(&tx);
+        free_taps(&ty);
+        return -1;
+    }
+
+    // Horizontal pass over the rows we need, then vertical
+    for (int y = 0; y < src_h; y++) {
+        const uint32_t *row = src->pixels + (size_t)(src_y + y) * (size_t)src->width + src_x;
+        uint32_t *out = tmp + (size_t)y * (size_t)dst_w;
+        for (int x = 0; x < dst_w; x++) out[x] = filter(row, 1, &tx, x);
+    }
+
+    for (int y = 0; y < dst_h; y++) {
+        uint32_t *out = dst->pixels + (size_t)y * (size_t)dst_w;
+        for (int x = 0; x < dst_w; x++) out[x] = filter(tmp + x, (size_t)dst_w, &ty, y);
+    }
+
+    free(tmp);
+    free_taps(&tx);
+    free_taps(&ty);
+    return 0;
+}
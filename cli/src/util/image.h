@@ -0,0 +1,36 @@
+// cli/src/util/image.h
+#ifndef OPENDE_IMAGE_H
+#define OPENDE_IMAGE_H
+
+#include <stdint.h>
+
+// 32-bit pixels as 0x00RRGGBB, which is also the ZPixmap layout of a
+// depth-24 TrueColor visual on a little-endian host
+typedef struct {
+    int width;
+    int height;
+    uint32_t *pixels;
+} Image;
+
+// Read only the header of a JPEG or PNG file
+// Returns 0 on success, -1 if unreadable or unsupported
+int image_probe(const char *path, int *width, int *height);
+
+// Decode a JPEG or PNG file. JPEGs may be decoded at up to 1/shrink of
+// their size (1, 2, 4 or 8) by the DCT itself, which is far cheaper than
+// decoding at full size and scaling down afterwards.
+// Returns 0 on success, -1 on error
+int image_load(const char *path, int shrink, Image *image);
+
+// Resample the src_w x src_h region at (src_x, src_y) to dst_w x dst_h
+// (tent filter: bilinear when enlarging, area-weighted when reducing)
+// Returns 0 on success, -1 on error
+int image_scale(const Image *src, int src_x, int src_y, int src_w, int src_h,
+                int dst_w, int dst_h, Image *dst);
+
+// Allocate an image filled with one color
+int image_new(int width, int height, uint32_t color, Image *image);
+
+void image_free(Image *image);
+
+#endif
@@ -0,0 +1,191 @@
+// cli/src/util/ini.c
+#define _POSIX_C_SOURCE 200809L
+#include "ini.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INI_INDENT "    "
+
+typedef struct {
+    const char *start;       // First character of the line
+    const char *end;         // The newline, or the terminating NUL
+} Line;
+
+static const char *skip_blank(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+static int next_line(const char **cursor, Line *line) {
+    if (!**cursor) return 0;
+    line->start = *cursor;
+    line->end = strchr(*cursor, '\n');
+    if (!line->end) line->end = *cursor + strlen(*cursor);
+    *cursor = *line->end ? line->end + 1 : line->end;
+    return 1;
+}
+
+// Section name if the line is a header, else NULL (name not terminated)
+static const char *header_name(const Line *line, size_t *len) {
+    const char *p = skip_blank(line->start, line->end);
+    if (p == line->end || *p != '[') return NULL;
+    const char *close = memchr(p, ']', (size_t)(line->end - p));
+    if (!close) return NULL;
+    *len = (size_t)(close - p - 1);
+    return p + 1;
+}
+
+// Start of the value if the line assigns key, else NULL
+static const char *assignment(const Line *line, const char *key) {
+    const char *p = skip_blank(line->start, line->end);
+    size_t len = strlen(key);
+    if ((size_t)(line->end - p) <= len || strncmp(p, key, len) != 0) return NULL;
+
+    p = skip_blank(p + len, line->end);
+    if (p == line->end || *p != '=') return NULL;
+    return skip_blank(p + 1, line->end);
+}
+
+typedef struct {
+    const char *value;       // Assignment's value, NULL if not found
+    Line line;               // The assignment line
+    const char *insert;      // Where a new key goes (after the last content line)
+    const char *indent;      // Indentation of the section's keys
+    size_t indent_len;
+    int section_found;
+} Lookup;
+
+static void lookup(const char *text, const char *section, const char *key, Lookup *out) {
+    memset(out, 0, sizeof(*out));
+    out->indent = INI_INDENT;
+    out->indent_len = strlen(INI_INDENT);
+
+    const char *cursor = text;
+    Line line;
+    int inside = 0;
+    while (next_line(&cursor, &line)) {
+        size_t len;
+        const char *name = header_name(&line, &len);
+        if (name) {
+            if (out->section_found && inside) return;   // Section ended
+            inside = len == strlen(section) && strncmp(name, section, len) == 0;
+            if (inside) {
+                out->section_found = 1;
+                out->insert = cursor;
+            }
+            continue;
+        }
+        if (!inside) continue;
+
+        const char *p = skip_blank(line.start, line.end);
+        if (p == line.end || *p == '#' || *p == ';') continue;
+
+        // A content line: new keys go after it, indented the same way
+        out->insert = cursor;
+        out->indent = line.start;
+        out->indent_len = (size_t)(p - line.start);
+
+        const char *value = assignment(&line, key);
+        if (value && !out->value) {
+            out->value = value;
+            out->line = line;
+        }
+    }
+}
+
+char *ini_get(const char *text, const char *section, const char *key) {
+    Lookup found;
+    lookup(text, section, key, &found);
+    if (!found.value) return NULL;
+
+    const char *end = found.line.end;
+    while (end > found.value && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+    if (end - found.value >= 2 && *found.value == '"' && end[-1] == '"') {
+        return strndup(found.value + 1, (size_t)(end - found.value - 2));
+    }
+    return strndup(found.value, (size_t)(end - found.value));
+}
+
+char *ini_set(const char *text, const char *section, const char *key, const char *value) {
+    Lookup found;
+    lookup(text, section, key, &found);
+
+    size_t size = strlen(text) + strlen(section) + strlen(key) + strlen(value) +
+                  found.indent_len + 16;
+    char *out = malloc(size);
+    if (!out) return NULL;
+
+    if (found.value) {
+        // Keep everything up to the value, replace the rest of the line
+        snprintf(out, size, "%.*s%s%s", (int)(found.value - text), text, value, found.line.end);
+    } else if (found.section_found) {
+        // found.insert follows a newline, or is the end of a text without one
+        const char *newline = found.insert > text && found.insert[-1] != '\n' ? "\n" : "";
+        snprintf(out, size, "%.*s%s%.*s%s = %s\n%s", (int)(found.insert - text), text, newline,
+                 (int)found.indent_len, found.indent, key, value, found.insert);
+    } else {
+        size_t len = strlen(text);
+        const char *newline = len > 0 && text[len - 1] != '\n' ? "\n" : "";
+        snprintf(out, size, "%s%s%s[%s]\n" INI_INDENT "%s = %s\n", text, newline,
+                 len > 0 ? "\n" : "", section, key, value);
+    }
+    return out;
+}
+
+char *ini_remove_section(const char *text, const char *section) {
+    char *out = malloc(strlen(text) + 1);
+    if (!out) return NULL;
+
+    size_t len = 0;
+    const char *cursor = text;
+    Line line;
+    int inside = 0;
+    while (next_line(&cursor, &line)) {
+        size_t name_len;
+        const char *name = header_name(&line, &name_len);
+        if (name) inside = name_len == strlen(section) && strncmp(name, section, name_len) == 0;
+        if (inside) continue;
+
+        memcpy(out + len, line.start, (size_t)(cursor - line.start));
+        len += (size_t)(cursor - line.start);
+    }
+    out[len] = '\0';
+    return out;
+}
+
+void ini_foreach(const char *text, IniEntryFn fn, void *data) {
+    char section[128] = "";
+    const char *cursor = text;
+    Line line;
+    while (next_line(&cursor, &line)) {
+        size_t len;
+        const char *name = header_name(&line, &len);
+        if (name) {
+            snprintf(section, sizeof(section), "%.*s", (int)len, name);
+            continue;
+        }
+
+        const char *p = skip_blank(line.start, line.end);
+        if (p == line.end || *p == '#' || *p == ';') continue;
+        const char *eq = memchr(p, '=', (size_t)(line.end - p));
+        if (!eq) continue;
+
+        const char *key_end = eq;
+        while (key_end > p && (key_end[-1] == ' ' || key_end[-1] == '\t')) key_end--;
+        const char *value = skip_blank(eq + 1, line.end);
+        const char *value_end = line.end;
+        while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t' ||
+                                     value_end[-1] == '\r')) value_end--;
+        if (value_end - value >= 2 && *value == '"' && value_end[-1] == '"') {
+            value++;
+            value_end--;
+        }
+
+        char *key = strndup(p, (size_t)(key_end - p));
+        char *copy = strndup(value, (size_t)(value_end - value));
+        if (key && copy) fn(section, key, copy, data);
+        free(key);
+        free(copy);
+    }
+}
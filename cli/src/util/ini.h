@@ -0,0 +1,26 @@
+// cli/src/util/ini.h
+#ifndef OPENDE_INI_H
+#define OPENDE_INI_H
+
+// Minimal INI editing for files such as dunstrc: `[section]` headers and
+// `key = value` lines, with `#` and `;` comments. Edits touch only the
+// line they change; comments, order and indentation are kept.
+
+// Value of key in section (allocated, surrounding quotes removed), or NULL
+char *ini_get(const char *text, const char *section, const char *key);
+
+// Set key in section: the existing line is replaced, otherwise the key is
+// added after the section's last line, and a missing section is appended.
+// value is written as given (quote it yourself if needed).
+// Returns allocated text, or NULL on allocation failure
+char *ini_set(const char *text, const char *section, const char *key, const char *value);
+
+// Remove a section with all its lines. Returns allocated text (unchanged
+// copy if the section is absent), or NULL on allocation failure
+char *ini_remove_section(const char *text, const char *section);
+
+// Call fn for every assignment, in file order; value has quotes removed
+typedef void (*IniEntryFn)(const char *section, const char *key, const char *value, void *data);
+void ini_foreach(const char *text, IniEntryFn fn, void *data);
+
+#endif
@@ -0,0 +1,226 @@
+// cli/src/util/liveness.c
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include "liveness.h"
+#include "proc.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/Xfixes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+#define MAX_SELECTIONS 16
+#define MAX_PIDS 64
+
+typedef struct {
+    int id;
+    Atom atom;
+    int owned;
+} SelectionWatch;
+
+typedef struct {
+    int id;
+    int fd;
+} PidWatch;
+
+struct Liveness {
+    Display *dpy;
+    int xfixes_event;
+    SelectionWatch selections[MAX_SELECTIONS];
+    int selection_count;
+    PidWatch pids[MAX_PIDS];
+    int pid_count;
+};
+
+int liveness_pidfd_open(pid_t pid) {
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+static Atom selection_atom(Display *dpy, const char *prefix) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s%d", prefix, DefaultScreen(dpy));
+    return XInternAtom(dpy, name, False);
+}
+
+static Display *open_display(void) {
+    const char *display = getenv("DISPLAY");
+    if (!display || !*display) return NULL;
+    return XOpenDisplay(display);
+}
+
+int liveness_selection_owned(const char *prefix) {
+    Display *dpy = open_display();
+    if (!dpy) return -1;
+
+    int owned = XGetSelectionOwner(dpy, selection_atom(dpy, prefix)) != None;
+    XCloseDisplay(dpy);
+    return owned;
+}
+
+pid_t liveness_selection_owner_pid(const char *prefix) {
+    Display *dpy = open_display();
+    if (!dpy) return -1;
+
+    pid_t pid = 0;
+    Window owner = XGetSelectionOwner(dpy, selection_atom(dpy, prefix));
+    if (owner != None) {
+        Atom type;
+        int format;
+        unsigned long count, after;
+        unsigned char *data = NULL;
+        Atom net_wm_pid = XInternAtom(dpy, "_NET_WM_PID", False);
+
+        if (XGetWindowProperty(dpy, owner, net_wm_pid, 0, 1, False, XA_CARDINAL,
+                               &type, &format, &count, &after, &data) == Success &&
+            data && count == 1 && format == 32) {
+            pid = (pid_t)((unsigned long *)data)[0];
+        }
+        if (data) XFree(data);
+    }
+
+    XCloseDisplay(dpy);
+    return pid;
+}
+
+Liveness *liveness_new(void) {
+    Liveness *lv = calloc(1, sizeof(Liveness));
+    if (!lv) return NULL;
+
+    lv->dpy = open_display();
+    if (lv->dpy) {
+        int error_base;
+        if (!XFixesQueryExtension(lv->dpy, &lv->xfixes_event, &error_base)) {
+            XCloseDisplay(lv->dpy);
+            lv->dpy = NULL;
+        }
+    }
+    return lv;
+}
+
+void liveness_free(Liveness *lv) {
+    if (!lv) return;
+    for (int i = 0; i < lv->pid_count; i++) close(lv->pids[i].fd);
+    if (lv->dpy) XCloseDisplay(lv->dpy);
+    free(lv);
+}
+
+int liveness_watch_selection(Liveness *lv, int id, const char *prefix) {
+    if (!lv->dpy || lv->selection_count == MAX_SELECTIONS) return -1;
+
+    SelectionWatch *w = &lv->selections[lv->selection_count++];
+    w->id = id;
+    w->atom = selection_atom(lv->dpy, prefix);
+    XFixesSelectSelectionInput(lv->dpy, DefaultRootWindow(lv->dpy), w->atom,
+                               XFixesSetSelectionOwnerNotifyMask |
+                               XFixesSelectionWindowDestroyNotifyMask |
+                               XFixesSelectionClientCloseNotifyMask);
+    w->owned = XGetSelectionOwner(lv->dpy, w->atom) != None;
+    return w->owned ? LIVENESS_RUNNING : LIVENESS_STOPPED;
+}
+
+int liveness_watch_pid(Liveness *lv, int id, pid_t pid) {
+    if (lv->pid_count == MAX_PIDS) return -1;
+
+    int fd = liveness_pidfd_open(pid);
+    if (fd < 0) return -1;
+
+    lv->pids[lv->pid_count].id = id;
+    lv->pids[lv->pid_count].fd = fd;
+    lv->pid_count++;
+    return 0;
+}
+
+static void remove_pid(Liveness *lv, int index) {
+    close(lv->pids[index].fd);
+    lv->pids[index] = lv->pids[--lv->pid_count];
+}
+
+void liveness_unwatch_pid(Liveness *lv, int id) {
+    for (int i = 0; i < lv->pid_count; i++) {
+        if (lv->pids[i].id == id) {
+            remove_pid(lv, i);
+            return;
+        }
+    }
+}
+
+// Turn queued XFixes notifications into state changes
+static int drain_x_events(Liveness *lv, LivenessEvent *events, int max) {
+    int count = 0;
+
+    while (lv->dpy && XPending(lv->dpy)) {
+        XEvent ev;
+        XNextEvent(lv->dpy, &ev);
+        if (ev.type != lv->xfixes_event + XFixesSelectionNotify) continue;
+
+        XFixesSelectionNotifyEvent *sev = (XFixesSelectionNotifyEvent *)&ev;
+        for (int i = 0; i < lv->selection_count; i++) {
+            SelectionWatch *w = &lv->selections[i];
+            if (w->atom != sev->selection) continue;
+
+            int owned = sev->subtype == XFixesSetSelectionOwnerNotify &&
+                        sev->owner != None;
+            if (owned != w->owned && count < max) {
+                w->owned = owned;
+                events[count].id = w->id;
+                events[count].state = owned ? LIVENESS_RUNNING : LIVENESS_STOPPED;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+int liveness_wait(Liveness *lv, LivenessEvent *events, int max, int timeout_ms) {
+    double deadline = timeout_ms >= 0 ? proc_now_ms() + timeout_ms : 0;
+
+    for (;;) {
+        int count = drain_x_events(lv, events, max);
+        if (count > 0) return count;
+
+        struct pollfd fds[MAX_PIDS + 1];
+        int nfds = 0;
+        for (int i = 0; i < lv->pid_count; i++) {
+            fds[nfds].fd = lv->pids[i].fd;
+            fds[nfds].events = POLLIN;
+            nfds++;
+        }
+        if (lv->dpy) {
+            fds[nfds].fd = ConnectionNumber(lv->dpy);
+            fds[nfds].events = POLLIN;
+            nfds++;
+        }
+
+        int wait = -1;
+        if (timeout_ms >= 0) {
+            double left = deadline - proc_now_ms();
+            if (left <= 0) return 0;
+            wait = (int)left + 1;
+        }
+
+        int ready = poll(fds, (nfds_t)nfds, wait);
+        if (ready < 0) return -1;  // Error or interrupted by a signal
+        if (ready == 0) return 0;
+
+        // A readable pidfd means the process exited
+        for (int i = lv->pid_count - 1; i >= 0 && count < max; i--) {
+            if (fds[i].revents & (POLLIN | POLLHUP)) {
+                events[count].id = lv->pids[i].id;
+                events[count].state = LIVENESS_STOPPED;
+                count++;
+                remove_pid(lv, i);
+            }
+        }
+        if (count > 0) return count;
+
+        if (lv->dpy && (fds[nfds - 1].revents & (POLLERR | POLLHUP))) return -1;
+    }
+}
@@ -0,0 +1,54 @@
+// cli/src/util/liveness.h
+#ifndef OPENDE_LIVENESS_H
+#define OPENDE_LIVENESS_H
+
+#include <sys/types.h>
+
+// Event-driven component liveness.
+//
+// X clients that own a selection on the current $DISPLAY (the compositor owns
+// _NET_WM_CM_S<screen>, the tray host _NET_SYSTEM_TRAY_S<screen>) are tracked
+// with XFixes selection notify; plain processes are tracked with pidfds.
+// Waiting costs nothing until something actually changes.
+
+typedef enum {
+    LIVENESS_STOPPED,
+    LIVENESS_RUNNING
+} LivenessState;
+
+typedef struct {
+    int id;                  // Identifier the caller passed when watching
+    LivenessState state;
+} LivenessEvent;
+
+typedef struct Liveness Liveness;
+
+// Connects to $DISPLAY if set; pid watches work without a display
+Liveness *liveness_new(void);
+void liveness_free(Liveness *lv);
+
+// Watch a selection; the screen number is appended to prefix
+// ("_NET_WM_CM_S" -> "_NET_WM_CM_S0"). Returns current state or -1.
+int liveness_watch_selection(Liveness *lv, int id, const char *prefix);
+
+// Watch a process; a STOPPED event fires once when it exits.
+// Returns 0 on success, -1 if the process is already gone.
+int liveness_watch_pid(Liveness *lv, int id, pid_t pid);
+void liveness_unwatch_pid(Liveness *lv, int id);
+
+// Block until at least one event or timeout_ms passes (-1 = forever).
+// Returns number of events stored (0 on timeout), -1 on error or signal.
+int liveness_wait(Liveness *lv, LivenessEvent *events, int max, int timeout_ms);
+
+// One-shot checks for the current $DISPLAY (no event loop needed)
+// Returns 1 if owned, 0 if not, -1 if there is no display
+int liveness_selection_owned(const char *prefix);
+
+// PID advertised via _NET_WM_PID on the selection owner's window
+// Returns pid, 0 if unknown, -1 if there is no display
+pid_t liveness_selection_owner_pid(const char *prefix);
+
+// Open a pidfd for a process (-1 if gone or unsupported)
+int liveness_pidfd_open(pid_t pid);
+
+#endif
@@ -5,6 +5,8 @@
 #include <unistd.h>
 
 static int use_colors = 0;
+static int quiet = 0;
+static char last_error[256];
 
 #define COLOR_RED     "\033[0;31m"
 #define COLOR_GREEN   "\033[0;32m"
@@ -16,8 +18,17 @@ void output_init(void) {
     use_colors = isatty(STDOUT_FILENO);
 }
 
+void output_set_quiet(int enabled) {
+    quiet = enabled;
+}
+
+const char *output_last_error(void) {
+    return last_error;
+}
+
 void print_info(const char *fmt, ...) {
     va_list args;
+    if (quiet) return;
     if (use_colors) printf("%s[INFO]%s ", COLOR_BLUE, COLOR_RESET);
     else printf("[INFO] ");
     va_start(args, fmt);
@@ -28,6 +39,11 @@ void print_info(const char *fmt, ...) {
 
 void print_error(const char *fmt, ...) {
     va_list args;
+    va_start(args, fmt);
+    vsnprintf(last_error, sizeof(last_error), fmt, args);
+    va_end(args);
+    if (quiet) return;
+
     if (use_colors) fprintf(stderr, "%s[ERROR]%s ", COLOR_RED, COLOR_RESET);
     else fprintf(stderr, "[ERROR] ");
     va_start(args, fmt);
@@ -38,6 +54,7 @@ void print_error(const char *fmt, ...) {
 
 void print_warn(const char *fmt, ...) {
     va_list args;
+    if (quiet) return;
     if (use_colors) printf("%s[WARN]%s ", COLOR_YELLOW, COLOR_RESET);
     else printf("[WARN] ");
     va_start(args, fmt);
@@ -48,6 +65,7 @@ void print_warn(const char *fmt, ...) {
 
 void print_success(const char *fmt, ...) {
     va_list args;
+    if (quiet) return;
     if (use_colors) printf("%s[OK]%s ", COLOR_GREEN, COLOR_RESET);
     else printf("[OK] ");
     va_start(args, fmt);
@@ -56,8 +74,18 @@ void print_success(const char *fmt, ...) {
     printf("\n");
 }
 
+void print_line(const char *fmt, ...) {
+    va_list args;
+    if (quiet) return;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+}
+
 void print_setting(const char *name, const char *value, int enabled) {
     const char *indicator;
+    if (quiet) return;
     if (use_colors) {
         indicator = enabled ? COLOR_GREEN "[ON] " COLOR_RESET
                            : COLOR_RED "[OFF]" COLOR_RESET;
@@ -68,6 +96,7 @@ void print_setting(const char *name, const char *value, int enabled) {
 }
 
 void print_header(const char *title) {
+    if (quiet) return;
     printf("\n%s\n", title);
     for (int i = 0; title[i]; i++) printf("-");
     printf("\n\n");
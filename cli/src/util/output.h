@@ -11,6 +11,14 @@ void print_error(const char *fmt, ...);
 void print_warn(const char *fmt, ...);
 void print_success(const char *fmt, ...);
 
+// Plain text on stdout, such as a list of settings after an error
+void print_line(const char *fmt, ...);
+
+// Library callers: drop everything printed to stdout, and keep errors
+// for output_last_error() instead of writing them to stderr
+void output_set_quiet(int quiet);
+const char *output_last_error(void);
+
 // Status display helpers
 void print_setting(const char *name, const char *value, int enabled);
 void print_header(const char *title);
@@ -0,0 +1,261 @@
+// cli/src/util/proc.c
+#define _POSIX_C_SOURCE 200809L
+#include "proc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/stat.h>
+
+int proc_read_stat(pid_t pid, ProcStat *st) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%ld/stat", (long)pid);
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    buf[n] = '\0';
+
+    // comm is wrapped in parentheses and may itself contain spaces or ')'
+    char *open = strchr(buf, '(');
+    char *close = strrchr(buf, ')');
+    if (!open || !close || close < open) return -1;
+
+    memset(st, 0, sizeof(*st));
+    st->pid = pid;
+
+    size_t clen = (size_t)(close - open - 1);
+    if (clen >= sizeof(st->comm)) clen = sizeof(st->comm) - 1;
+    memcpy(st->comm, open + 1, clen);
+    st->comm[clen] = '\0';
+
+    // Fields after comm, starting at field 3 (state)
+    char *save = NULL;
+    char *tok = strtok_r(close + 2, " ", &save);
+    for (int field = 3; tok; field++, tok = strtok_r(NULL, " ", &save)) {
+        switch (field) {
+            case 3:  st->state = tok[0]; break;
+            case 4:  st->ppid = (pid_t)strtol(tok, NULL, 10); break;
+            case 14: st->utime = strtoull(tok, NULL, 10); break;
+            case 15: st->stime = strtoull(tok, NULL, 10); break;
+            case 22: st->start_time = strtoull(tok, NULL, 10); break;
+            case 24: st->rss_pages = strtol(tok, NULL, 10); return 0;
+            default: break;
+        }
+    }
+
+    return -1;
+}
+
+int proc_read_cmdline(pid_t pid, char *buf, size_t size) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%ld/cmdline", (long)pid);
+
+    FILE *fp = fopen(path, "r");
+    if (!fp || size == 0) {
+        if (fp) fclose(fp);
+        return -1;
+    }
+
+    size_t n = fread(buf, 1, size - 1, fp);
+    fclose(fp);
+
+    // Arguments are NUL separated, with a trailing NUL
+    while (n > 0 && buf[n - 1] == '\0') n--;
+    for (size_t i = 0; i < n; i++) {
+        if (buf[i] == '\0') buf[i] = ' ';
+    }
+    buf[n] = '\0';
+    return 0;
+}
+
+int proc_read_environ(pid_t pid, const char *var, char *buf, size_t size) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%ld/environ", (long)pid);
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    // Entries are NUL separated "NAME=value"
+    size_t vlen = strlen(var);
+    char entry[1024];
+    size_t len = 0;
+    int found = -1, ch;
+
+    while (found != 0 && (ch = fgetc(fp)) != EOF) {
+        if (ch != '\0') {
+            if (len < sizeof(entry) - 1) entry[len++] = (char)ch;
+            continue;
+        }
+        entry[len] = '\0';
+        if (len > vlen && strncmp(entry, var, vlen) == 0 && entry[vlen] == '=') {
+            snprintf(buf, size, "%s", entry + vlen + 1);
+            found = 0;
+        }
+        len = 0;
+    }
+
+    fclose(fp);
+    return found;
+}
+
+// ":0.0" and ":0" name the same display
+static size_t display_len(const char *display) {
+    const char *colon = strrchr(display, ':');
+    const char *dot = colon ? strchr(colon, '.') : NULL;
+    return dot ? (size_t)(dot - display) : strlen(display);
+}
+
+int proc_on_display(pid_t pid, const char *display) {
+    char value[256];
+    if (proc_read_environ(pid, "DISPLAY", value, sizeof(value)) != 0) return 0;
+
+    size_t len = display_len(display);
+    return display_len(value) == len && strncmp(value, display, len) == 0;
+}
+
+// Read a "Key:   123 kB" style field from a /proc file
+static long long read_field(const char *path, const char *key) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char line[256];
+    size_t klen = strlen(key);
+    long long value = -1;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, key, klen) == 0 && line[klen] == ':') {
+            value = strtoll(line + klen + 1, NULL, 10);
+            break;
+        }
+    }
+
+    fclose(fp);
+    return value;
+}
+
+int proc_read_memory(pid_t pid, long *rss_kb, long *pss_kb) {
+    char path[64];
+
+    snprintf(path, sizeof(path), "/proc/%ld/status", (long)pid);
+    long long rss = read_field(path, "VmRSS");
+    if (rss < 0) return -1;
+
+    snprintf(path, sizeof(path), "/proc/%ld/smaps_rollup", (long)pid);
+    *rss_kb = (long)rss;
+    *pss_kb = (long)read_field(path, "Pss");
+    return 0;
+}
+
+long long proc_read_wakeups(pid_t pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%ld/task", (long)pid);
+
+    DIR *dir = opendir(path);
+    if (!dir) return -1;
+
+    long long total = 0;
+    struct dirent *ent;
+    while ((ent = readdir(dir))) {
+        if (ent->d_name[0] == '.') continue;
+
+        char status[96];
+        snprintf(status, sizeof(status), "/proc/%ld/task/%.16s/status", (long)pid, ent->d_name);
+        long long n = read_field(status, "voluntary_ctxt_switches");
+        if (n > 0) total += n;
+    }
+
+    closedir(dir);
+    return total;
+}
+
+double proc_cpu_seconds(const ProcStat *st) {
+    static long ticks = 0;
+    if (ticks <= 0) ticks = sysconf(_SC_CLK_TCK);
+    if (ticks <= 0) ticks = 100;
+    return (double)(st->utime + st->stime) / (double)ticks;
+}
+
+int proc_find_by_name(const char *name, pid_t *pids, int max) {
+    DIR *dir = opendir("/proc");
+    if (!dir) return 0;
+
+    uid_t uid = getuid();
+    int found = 0;
+    struct dirent *ent;
+
+    while (found < max && (ent = readdir(dir))) {
+        char *end;
+        long pid = strtol(ent->d_name, &end, 10);
+        if (*end != '\0' || pid <= 0) continue;
+
+        char path[64];
+        struct stat sb;
+        snprintf(path, sizeof(path), "/proc/%ld", pid);
+        if (stat(path, &sb) != 0 || sb.st_uid != uid) continue;
+
+        ProcStat st;
+        if (proc_read_stat((pid_t)pid, &st) != 0) continue;
+        if (st.state == 'Z') continue;
+
+        if (strcmp(st.comm, name) == 0) {
+            pids[found++] = (pid_t)pid;
+        }
+    }
+
+    closedir(dir);
+    return found;
+}
+
+int proc_find_descendants(pid_t pid, pid_t *pids, int max) {
+    DIR *dir = opendir("/proc");
+    if (!dir) return 0;
+
+    // One pass over /proc for (pid, ppid) pairs, then walk down from pid
+    size_t capacity = 256, count = 0;
+    pid_t (*pairs)[2] = malloc(capacity * sizeof(*pairs));
+    struct dirent *ent;
+    while (pairs && (ent = readdir(dir))) {
+        char *end;
+        long child = strtol(ent->d_name, &end, 10);
+        if (*end != '\0' || child <= 0) continue;
+
+        ProcStat st;
+        if (proc_read_stat((pid_t)child, &st) != 0 || st.state == 'Z') continue;
+
+        if (count == capacity) {
+            capacity *= 2;
+            pid_t (*grown)[2] = realloc(pairs, capacity * sizeof(*pairs));
+            if (!grown) break;
+            pairs = grown;
+        }
+        pairs[count][0] = (pid_t)child;
+        pairs[count][1] = st.ppid;
+        count++;
+    }
+    closedir(dir);
+    if (!pairs) return 0;
+
+    // pids doubles as the BFS queue
+    int found = 0;
+    for (int head = -1; head < found && found < max; head++) {
+        pid_t parent = head < 0 ? pid : pids[head];
+        for (size_t i = 0; i < count && found < max; i++) {
+            if (pairs[i][1] == parent) pids[found++] = pairs[i][0];
+        }
+    }
+
+    free(pairs);
+    return found;
+}
+
+double proc_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
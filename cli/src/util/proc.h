@@ -0,0 +1,56 @@
+// cli/src/util/proc.h
+#ifndef OPENDE_PROC_H
+#define OPENDE_PROC_H
+
+#include <sys/types.h>
+
+// Counters from /proc/<pid>/stat
+typedef struct {
+    pid_t pid;
+    char comm[32];
+    char state;
+    pid_t ppid;
+    unsigned long long utime;       // Clock ticks in user mode
+    unsigned long long stime;       // Clock ticks in kernel mode
+    unsigned long long start_time;  // Clock ticks after boot
+    long rss_pages;
+} ProcStat;
+
+// Read /proc/<pid>/stat; returns 0 on success, -1 if the process is gone
+int proc_read_stat(pid_t pid, ProcStat *st);
+
+// Read /proc/<pid>/cmdline with arguments joined by spaces
+// Returns 0 on success, -1 if the process is gone
+int proc_read_cmdline(pid_t pid, char *buf, size_t size);
+
+// Memory use in KiB. PSS comes from /proc/<pid>/smaps_rollup and is -1 if
+// the kernel doesn't provide it. Returns 0 on success, -1 if the process is gone
+int proc_read_memory(pid_t pid, long *rss_kb, long *pss_kb);
+
+// Voluntary context switches summed over all threads: each one is the
+// process going to sleep, i.e. one wakeup later. Returns -1 if gone
+long long proc_read_wakeups(pid_t pid);
+
+// Look up one variable in /proc/<pid>/environ
+// Returns 0 if found, -1 if unset or unreadable
+int proc_read_environ(pid_t pid, const char *var, char *buf, size_t size);
+
+// Does the process run on the given X display? (":0" matches ":0.0")
+// Processes without DISPLAY in their environment never match
+int proc_on_display(pid_t pid, const char *display);
+
+// Total CPU time (user + system) in seconds
+double proc_cpu_seconds(const ProcStat *st);
+
+// Find processes owned by the current user whose comm equals name
+// Returns number found (at most max)
+int proc_find_by_name(const char *name, pid_t *pids, int max);
+
+// Find every descendant of pid (children, grandchildren, ...)
+// Returns number found (at most max)
+int proc_find_descendants(pid_t pid, pid_t *pids, int max);
+
+// Monotonic clock in milliseconds
+double proc_now_ms(void);
+
+#endif
@@ -0,0 +1,195 @@
+// cli/src/util/snapshot.c
+#define _POSIX_C_SOURCE 200809L
+#include "snapshot.h"
+#include "config.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SNAPSHOT_FILE    "settings.shm"
+#define SNAPSHOT_MAGIC   "OPENDESS"
+#define SNAPSHOT_VERSION 1
+
+// Give up on a writer that died mid-update; the caller then republishes
+#define READ_SPINS 1000000
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;           // sizeof(Region), rejects other layouts
+    uint32_t seq;            // Odd while a writer is updating
+    uint32_t count;
+    uint64_t generation;
+    SnapshotEntry entries[SNAPSHOT_MAX_ENTRIES];
+} Region;
+
+char *snapshot_path(void) {
+    return config_get_runtime_path(SNAPSHOT_FILE);
+}
+
+// Readers map the region once per process
+static const Region *mapped;
+
+static const Region *map_region(void) {
+    if (mapped) return mapped;
+
+    char *path = config_get_runtime_path(SNAPSHOT_FILE);
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    free(path);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(Region)) {
+        map = mmap(NULL, sizeof(Region), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const Region *region = map;
+    if (memcmp(region->magic, SNAPSHOT_MAGIC, 8) != 0 ||
+        region->version != SNAPSHOT_VERSION || region->size != sizeof(Region)) {
+        munmap(map, sizeof(Region));
+        return NULL;
+    }
+
+    mapped = region;
+    return mapped;
+}
+
+// Start of a read section: an even sequence number, or 1 after giving up
+static uint32_t read_begin(const Region *region) {
+    for (int spin = 0; spin < READ_SPINS; spin++) {
+        uint32_t seq = __atomic_load_n(&region->seq, __ATOMIC_ACQUIRE);
+        if (!(seq & 1)) return seq;
+    }
+    return 1;
+}
+
+// Did the section starting at seq see a consistent copy?
+static int read_retry(const Region *region, uint32_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&region->seq, __ATOMIC_RELAXED) != seq;
+}
+
+int snapshot_get(const char *key, char *buf, size_t size) {
+    const Region *region = map_region();
+    if (!region) return -1;
+
+    char value[SNAPSHOT_VALUE_MAX];
+    int found;
+    uint32_t seq;
+    do {
+        seq = read_begin(region);
+        if (seq & 1) return -1;
+
+        found = 0;
+        uint32_t count = region->count;
+        if (count > SNAPSHOT_MAX_ENTRIES) count = SNAPSHOT_MAX_ENTRIES;
+        for (uint32_t i = 0; i < count && !found; i++) {
+            if (strncmp(region->entries[i].key, key, SNAPSHOT_KEY_MAX) == 0) {
+                memcpy(value, region->entries[i].value, sizeof(value));
+                found = 1;
+            }
+        }
+    } while (read_retry(region, seq));
+
+    if (!found) return -1;
+    value[sizeof(value) - 1] = '\0';
+    snprintf(buf, size, "%s", value);
+    return 0;
+}
+
+int snapshot_read_all(SnapshotEntry *entries, int max) {
+    const Region *region = map_region();
+    if (!region) return -1;
+
+    int count;
+    uint32_t seq;
+    do {
+        seq = read_begin(region);
+        if (seq & 1) return -1;
+
+        count = (int)region->count;
+        if (count > SNAPSHOT_MAX_ENTRIES) count = SNAPSHOT_MAX_ENTRIES;
+        if (count > max) count = max;
+        memcpy(entries, region->entries, sizeof(SnapshotEntry) * (size_t)count);
+    } while (read_retry(region, seq));
+
+    for (int i = 0; i < count; i++) {
+        entries[i].key[SNAPSHOT_KEY_MAX - 1] = '\0';
+        entries[i].value[SNAPSHOT_VALUE_MAX - 1] = '\0';
+    }
+    return count;
+}
+
+uint64_t snapshot_generation(void) {
+    const Region *region = map_region();
+    return region ? __atomic_load_n(&region->generation, __ATOMIC_ACQUIRE) : 0;
+}
+
+int snapshot_publish(const SnapshotEntry *entries, int count) {
+    if (count > SNAPSHOT_MAX_ENTRIES) count = SNAPSHOT_MAX_ENTRIES;
+
+    char *path = config_get_runtime_path(SNAPSHOT_FILE);
+    if (!path) return -1;
+
+    // One writer at a time; readers never take this lock
+    int lock = config_lock_file(path);
+    int fd = lock >= 0 ? open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600) : -1;
+    free(path);
+    if (fd < 0) {
+        config_unlock_file(lock);
+        return -1;
+    }
+
+    struct stat st;
+    Region *region = MAP_FAILED;
+    if (fstat(fd, &st) == 0 &&
+        (st.st_size == (off_t)sizeof(Region) || ftruncate(fd, sizeof(Region)) == 0)) {
+        region = mmap(NULL, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (region == MAP_FAILED) {
+        close(fd);
+        config_unlock_file(lock);
+        return -1;
+    }
+
+    // Enter the write section; an odd count left by a writer that died
+    // mid-update is simply continued
+    uint32_t seq = __atomic_load_n(&region->seq, __ATOMIC_RELAXED) | 1;
+    __atomic_store_n(&region->seq, seq, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    int fresh = memcmp(region->magic, SNAPSHOT_MAGIC, 8) != 0 ||
+                region->version != SNAPSHOT_VERSION || region->size != sizeof(Region);
+    region->count = (uint32_t)count;
+    memset(region->entries, 0, sizeof(region->entries));
+    for (int i = 0; i < count; i++) {
+        snprintf(region->entries[i].key, SNAPSHOT_KEY_MAX, "%s", entries[i].key);
+        snprintf(region->entries[i].value, SNAPSHOT_VALUE_MAX, "%s", entries[i].value);
+    }
+    __atomic_store_n(&region->generation, fresh ? 1 : region->generation + 1, __ATOMIC_RELAXED);
+
+    // Header last, so a reader never accepts a half-initialized region
+    if (fresh) {
+        region->version = SNAPSHOT_VERSION;
+        region->size = sizeof(Region);
+        memcpy(region->magic, SNAPSHOT_MAGIC, 8);
+    }
+
+    __atomic_store_n(&region->seq, seq + 1, __ATOMIC_RELEASE);
+
+    // Stores through the mapping raise no inotify events; the timestamp
+    // update (IN_ATTRIB) wakes subscribers
+    futimens(fd, NULL);
+    close(fd);
+
+    munmap(region, sizeof(Region));
+    config_unlock_file(lock);
+    return 0;
+}
@@ -0,0 +1,47 @@
+// cli/src/util/snapshot.h
+#ifndef OPENDE_SNAPSHOT_H
+#define OPENDE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Effective settings published in a small shared-memory region
+// ($XDG_RUNTIME_DIR/opende/settings.shm) so pollers such as panel
+// executors read them without forking opende or parsing any config.
+//
+// The region is fixed size and never replaced, so a mapping stays valid
+// for the life of the reader. Writers serialize on the file's advisory
+// lock and bracket each update with a sequence counter (seqlock): it is
+// odd while an update is in progress, and readers retry if it was odd or
+// changed while they copied. Reads take no locks and make no syscalls
+// once the region is mapped.
+
+#define SNAPSHOT_KEY_MAX     48
+#define SNAPSHOT_VALUE_MAX   464
+#define SNAPSHOT_MAX_ENTRIES 48
+
+typedef struct {
+    char key[SNAPSHOT_KEY_MAX];
+    char value[SNAPSHOT_VALUE_MAX];
+} SnapshotEntry;
+
+// Path of the region (caller must free), for inotify watchers: every
+// publish updates its timestamps (IN_ATTRIB)
+char *snapshot_path(void);
+
+// Replace the whole snapshot. Returns 0 on success, -1 on error
+int snapshot_publish(const SnapshotEntry *entries, int count);
+
+// Copy one value. Returns 0 if found, -1 if the key is absent or there
+// is no snapshot yet
+int snapshot_get(const char *key, char *buf, size_t size);
+
+// Copy every entry (consistent as a whole)
+// Returns number copied, -1 if there is no snapshot yet
+int snapshot_read_all(SnapshotEntry *entries, int max);
+
+// Incremented by every publish; 0 if there is no snapshot. Lets pollers
+// notice changes with a single load.
+uint64_t snapshot_generation(void);
+
+#endif
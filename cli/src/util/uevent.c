@@ -0,0 +1,57 @@
+// cli/src/util/uevent.c
+#define _DEFAULT_SOURCE
+#include "uevent.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+#define UEVENT_KERNEL_GROUP 1
+
+int uevent_open(void) {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) return -1;
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = UEVENT_KERNEL_GROUP;
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void copy_value(char *dst, size_t size, const char *src) {
+    snprintf(dst, size, "%s", src);
+}
+
+int uevent_read(int fd, UEvent *event) {
+    char buf[8192];
+    struct sockaddr_nl from;
+    socklen_t from_len = sizeof(from);
+
+    ssize_t len = recvfrom(fd, buf, sizeof(buf) - 1, 0, (struct sockaddr *)&from, &from_len);
+    if (len < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+
+    // Only trust the kernel (port 0), not other processes on the group
+    if (from.nl_pid != 0) return 0;
+    buf[len] = '\0';
+
+    // "action@devpath\0KEY=value\0KEY=value\0..."
+    memset(event, 0, sizeof(*event));
+    for (char *p = buf; p < buf + len; p += strlen(p) + 1) {
+        if (strncmp(p, "ACTION=", 7) == 0) copy_value(event->action, sizeof(event->action), p + 7);
+        else if (strncmp(p, "SUBSYSTEM=", 10) == 0) copy_value(event->subsystem, sizeof(event->subsystem), p + 10);
+        else if (strncmp(p, "DEVTYPE=", 8) == 0) copy_value(event->devtype, sizeof(event->devtype), p + 8);
+        else if (strncmp(p, "DEVPATH=", 8) == 0) copy_value(event->devpath, sizeof(event->devpath), p + 8);
+        else if (strcmp(p, "DISK_MEDIA_CHANGE=1") == 0) event->disk_media_change = 1;
+    }
+
+    return event->action[0] ? 1 : 0;
+}
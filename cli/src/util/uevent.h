@@ -0,0 +1,23 @@
+// cli/src/util/uevent.h
+#ifndef OPENDE_UEVENT_H
+#define OPENDE_UEVENT_H
+
+// Kernel device hotplug events (NETLINK_KOBJECT_UEVENT). Receiving the
+// kernel's broadcast needs no privileges and no udev.
+
+typedef struct {
+    char action[16];         // "add", "remove", "change", ...
+    char subsystem[32];      // "block", "bluetooth", "drm", ...
+    char devtype[32];        // "disk", "partition", "host", ... or ""
+    char devpath[256];       // Relative to /sys
+    int disk_media_change;   // DISK_MEDIA_CHANGE=1 (optical/card media)
+} UEvent;
+
+// Returns a non-blocking, close-on-exec socket, or -1 on error
+int uevent_open(void);
+
+// Read one event. Returns 1 if an event was read, 0 if none is pending,
+// -1 on error.
+int uevent_read(int fd, UEvent *event);
+
+#endif
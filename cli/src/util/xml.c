@@ -0,0 +1,348 @@
+// cli/src/util/xml.c
+#define _POSIX_C_SOURCE 200809L
+#include "xml.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_DEPTH 64
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    int failed;
+} Out;
+
+static void out_put(Out *o, const char *s, size_t n) {
+    if (o->failed) return;
+    if (o->len + n + 1 > o->cap) {
+        size_t cap = o->cap ? o->cap : 4096;
+        while (cap < o->len + n + 1) cap *= 2;
+        char *data = realloc(o->data, cap);
+        if (!data) {
+            o->failed = 1;
+            return;
+        }
+        o->data = data;
+        o->cap = cap;
+    }
+    memcpy(o->data + o->len, s, n);
+    o->len += n;
+    o->data[o->len] = '\0';
+}
+
+static void out_str(Out *o, const char *s) {
+    out_put(o, s, strlen(s));
+}
+
+static void out_escaped(Out *o, const char *s) {
+    for (; *s; s++) {
+        switch (*s) {
+            case '<': out_str(o, "&lt;"); break;
+            case '>': out_str(o, "&gt;"); break;
+            case '&': out_str(o, "&amp;"); break;
+            default:  out_put(o, s, 1); break;
+        }
+    }
+}
+
+typedef struct {
+    const char *name;        // Local name (after any prefix)
+    size_t len;
+} Frame;
+
+// Scanner over the markup: one call per token
+typedef enum {
+    TOK_TEXT,
+    TOK_OPEN,                // <name ...>
+    TOK_EMPTY,               // <name ... />
+    TOK_CLOSE,               // </name>
+    TOK_OTHER,               // Comment, CDATA, PI, doctype
+    TOK_END,
+    TOK_ERROR
+} Token;
+
+typedef struct {
+    const char *doc;
+    size_t pos;
+    size_t start;            // Of the current token
+    const char *name;
+    size_t name_len;
+} Scanner;
+
+static Token scan(Scanner *s) {
+    const char *p = s->doc + s->pos;
+    s->start = s->pos;
+    if (!*p) return TOK_END;
+
+    if (*p != '<') {
+        const char *lt = strchr(p, '<');
+        s->pos = lt ? (size_t)(lt - s->doc) : s->pos + strlen(p);
+        return TOK_TEXT;
+    }
+
+    static const struct {
+        const char *open, *close;
+    } specials[] = {
+        { "<!--", "-->" }, { "<![CDATA[", "]]>" }, { "<?", "?>" }, { "<!", ">" },
+    };
+    for (size_t i = 0; i < sizeof(specials) / sizeof(specials[0]); i++) {
+        if (strncmp(p, specials[i].open, strlen(specials[i].open)) != 0) continue;
+        const char *end = strstr(p + strlen(specials[i].open), specials[i].close);
+        if (!end) return TOK_ERROR;
+        s->pos = (size_t)(end - s->doc) + strlen(specials[i].close);
+        return TOK_OTHER;
+    }
+
+    // Element tag; '>' may appear inside quoted attribute values
+    int closing = p[1] == '/';
+    const char *q = p + 1 + closing;
+    const char *name = q;
+    while (*q && !strchr(" \t\r\n/>", *q)) q++;
+    if (q == name) return TOK_ERROR;
+
+    const char *colon = memchr(name, ':', (size_t)(q - name));
+    s->name = colon ? colon + 1 : name;
+    s->name_len = (size_t)(q - s->name);
+
+    char quote = 0;
+    for (; *q; q++) {
+        if (quote) {
+            if (*q == quote) quote = 0;
+        } else if (*q == '"' || *q == '\'') {
+            quote = *q;
+        } else if (*q == '>') {
+            break;
+        }
+    }
+    if (!*q) return TOK_ERROR;
+    s->pos = (size_t)(q - s->doc) + 1;
+
+    if (closing) return TOK_CLOSE;
+    return q[-1] == '/' ? TOK_EMPTY : TOK_OPEN;
+}
+
+// Split "a/b/c" into frames; returns depth
+static int split_path(const char *path, Frame *frames, int max) {
+    int depth = 0;
+    const char *p = path;
+    while (*p && depth < max) {
+        const char *slash = strchr(p, '/');
+        size_t len = slash ? (size_t)(slash - p) : strlen(p);
+        frames[depth].name = p;
+        frames[depth].len = len;
+        depth++;
+        if (!slash) break;
+        p = slash + 1;
+    }
+    return depth;
+}
+
+static int stack_matches(const Frame *stack, int depth, const Frame *path, int path_depth) {
+    if (depth != path_depth) return 0;
+    for (int i = 0; i < depth; i++) {
+        if (stack[i].len != path[i].len || strncmp(stack[i].name, path[i].name, path[i].len) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Copy of text with the predefined entities decoded
+static char *unescape(const char *text, size_t len) {
+    static const struct {
+        const char *entity;
+        char c;
+    } entities[] = {
+        { "&lt;", '<' }, { "&gt;", '>' }, { "&amp;", '&' }, { "&quot;", '"' }, { "&apos;", '\'' },
+    };
+    char *out = malloc(len + 1);
+    if (!out) return NULL;
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        size_t k, count = sizeof(entities) / sizeof(entities[0]);
+        for (k = 0; k < count; k++) {
+            size_t elen = strlen(entities[k].entity);
+            if (i + elen <= len && strncmp(text + i, entities[k].entity, elen) == 0) {
+                out[n++] = entities[k].c;
+                i += elen - 1;
+                break;
+            }
+        }
+        if (k == count) out[n++] = text[i];
+    }
+    out[n] = '\0';
+    return out;
+}
+
+char *xml_get_text(const char *doc, const char *path) {
+    Frame target[MAX_DEPTH], stack[MAX_DEPTH];
+    int target_depth = split_path(path, target, MAX_DEPTH);
+    int depth = 0;
+    size_t content = 0;
+    int inside = 0;
+
+    Scanner s = { doc, 0, 0, NULL, 0 };
+    for (Token t = scan(&s); t != TOK_END && t != TOK_ERROR; t = scan(&s)) {
+        if (t == TOK_OPEN) {
+            if (depth >= MAX_DEPTH) return NULL;
+            stack[depth].name = s.name;
+            stack[depth].len = s.name_len;
+            depth++;
+            if (stack_matches(stack, depth, target, target_depth)) {
+                inside = 1;
+                content = s.pos;
+            }
+        } else if (t == TOK_EMPTY) {
+            if (depth < MAX_DEPTH) {
+                stack[depth].name = s.name;
+                stack[depth].len = s.name_len;
+                if (stack_matches(stack, depth + 1, target, target_depth)) return strdup("");
+            }
+        } else if (t == TOK_CLOSE) {
+            if (inside && stack_matches(stack, depth, target, target_depth)) {
+                const char *b = doc + content, *e = doc + s.start;
+                while (b < e && strchr(" \t\r\n", *b)) b++;
+                while (e > b && strchr(" \t\r\n", e[-1])) e--;
+                return unescape(b, (size_t)(e - b));
+            }
+            if (depth > 0) depth--;
+        }
+    }
+    return NULL;
+}
+
+// Whitespace between the last newline written and the end of the output
+static void line_indent(const Out *o, char *indent, size_t size) {
+    size_t end = o->len, start = end;
+    while (start > 0 && (o->data[start - 1] == ' ' || o->data[start - 1] == '\t')) start--;
+    size_t n = end - start < size - 1 ? end - start : size - 1;
+    memcpy(indent, o->data ? o->data + start : "", n);
+    indent[n] = '\0';
+}
+
+// Set the element at target[0..depth) to content (raw markup if raw, else
+// text). Returns the new document, or NULL if malformed or if the parent
+// itself is missing (*missing set).
+static char *edit(const char *doc, const Frame *target, int target_depth,
+                  const char *content, int raw, int *missing) {
+    Frame stack[MAX_DEPTH];
+    int depth = 0, done = 0, skipping = 0;
+    Out o = { NULL, 0, 0, 0 };
+    *missing = 0;
+
+    Scanner s = { doc, 0, 0, NULL, 0 };
+    Token t;
+    for (t = scan(&s); t != TOK_END && t != TOK_ERROR; t = scan(&s)) {
+        const char *token = doc + s.start;
+        size_t len = s.pos - s.start;
+
+        if (t == TOK_OPEN || t == TOK_EMPTY) {
+            if (depth >= MAX_DEPTH) break;
+            stack[depth].name = s.name;
+            stack[depth].len = s.name_len;
+            int hit = !done && !skipping && stack_matches(stack, depth + 1, target, target_depth);
+
+            if (hit && t == TOK_EMPTY) {
+                // <name/> becomes <name>value</name>
+                size_t head = len - 2;
+                while (head > 0 && token[head - 1] == ' ') head--;
+                out_put(&o, token, head);
+                out_str(&o, ">");
+                if (raw) out_str(&o, content);
+                else out_escaped(&o, content);
+                out_str(&o, "</");
+                out_put(&o, token + 1, (size_t)(s.name + s.name_len - token - 1));
+                out_str(&o, ">");
+                done = 1;
+                continue;
+            }
+
+            if (!skipping) out_put(&o, token, len);
+            if (t == TOK_OPEN) depth++;
+            if (hit) {
+                if (raw) out_str(&o, content);
+                else out_escaped(&o, content);
+                skipping = depth;
+                done = 1;
+            }
+            continue;
+        }
+
+        if (t == TOK_CLOSE) {
+            if (skipping && depth == skipping) skipping = 0;
+            if (!skipping) {
+                // Closing the parent without having seen the element: add it
+                if (!done && stack_matches(stack, depth, target, target_depth - 1)) {
+                    char indent[64];
+                    line_indent(&o, indent, sizeof(indent));
+                    const Frame *leaf = &target[target_depth - 1];
+                    out_str(&o, "  ");
+                    out_str(&o, "<");
+                    out_put(&o, leaf->name, leaf->len);
+                    out_str(&o, ">");
+                    if (raw) out_str(&o, content);
+                    else out_escaped(&o, content);
+                    out_str(&o, "</");
+                    out_put(&o, leaf->name, leaf->len);
+                    out_str(&o, ">\n");
+                    out_str(&o, indent);
+                    done = 1;
+                }
+                out_put(&o, token, len);
+            }
+            if (depth > 0) depth--;
+            continue;
+        }
+
+        if (!skipping) out_put(&o, token, len);
+    }
+
+    if (t == TOK_ERROR || o.failed || !done) {
+        *missing = t != TOK_ERROR && !o.failed && !done;
+        free(o.data);
+        return NULL;
+    }
+    return o.data;
+}
+
+char *xml_set_text(const char *doc, const char *path, const char *value) {
+    Frame target[MAX_DEPTH];
+    int depth = split_path(path, target, MAX_DEPTH);
+    if (depth < 2) return NULL;
+
+    // Wrap the value in each missing ancestor until one exists
+    char *content = NULL;
+    const char *current = value;
+    int raw = 0;
+    for (int d = depth; d >= 2; d--) {
+        int missing;
+        char *result = edit(doc, target, d, current, raw, &missing);
+        if (result || !missing) {
+            free(content);
+            return result;
+        }
+
+        Out o = { NULL, 0, 0, 0 };
+        const Frame *leaf = &target[d - 1];
+        out_str(&o, "<");
+        out_put(&o, leaf->name, leaf->len);
+        out_str(&o, ">");
+        if (raw) out_str(&o, current);
+        else out_escaped(&o, current);
+        out_str(&o, "</");
+        out_put(&o, leaf->name, leaf->len);
+        out_str(&o, ">");
+        free(content);
+        if (o.failed) {
+            free(o.data);
+            return NULL;
+        }
+        content = o.data;
+        current = content;
+        raw = 1;
+    }
+    free(content);
+    return NULL;
+}
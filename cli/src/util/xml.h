@@ -0,0 +1,23 @@
+// cli/src/util/xml.h
+#ifndef OPENDE_XML_H
+#define OPENDE_XML_H
+
+// Streaming edits of XML config files such as openbox's rc.xml. The
+// document is scanned once, tracking only the stack of open elements, and
+// copied through unchanged except for the edited element: comments,
+// formatting and everything else survive byte for byte.
+//
+// Paths are element names from the root separated by '/', compared
+// without namespace prefixes, e.g. "openbox_config/focus/followMouse".
+
+// Text of the first element at path, whitespace trimmed
+// Returns allocated string (caller must free) or NULL if absent
+char *xml_get_text(const char *doc, const char *path);
+
+// Replace the content of the first element at path with value (escaped).
+// Missing elements are created, indented like their siblings, inside the
+// deepest ancestor that exists.
+// Returns the new document (caller must free) or NULL if malformed
+char *xml_set_text(const char *doc, const char *path, const char *value);
+
+#endif
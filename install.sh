@@ -70,6 +70,11 @@ if [ -d "$SOURCE_DIR/cli" ]; then
     if [ -f "$SOURCE_DIR/cli/opende" ]; then
         info "Installing CLI tool..."
         install -m 755 "$SOURCE_DIR/cli/opende" /usr/local/bin/
+        info "Installing libopende..."
+        install -m 755 "$SOURCE_DIR/cli/libopende.so.1" /usr/local/lib/
+        ln -sf libopende.so.1 /usr/local/lib/libopende.so
+        install -m 644 "$SOURCE_DIR/cli/include/opende.h" /usr/local/include/
+        ldconfig || true
     else
         warn "CLI build failed, skipping CLI installation"
     fi
@@ -13,45 +13,118 @@ export OPENDE_DIR
 # Ensure local bin is in PATH
 export PATH="/usr/local/bin:$PATH"
 
+# Record session timing for `opende session stats` (bash builtins, no forks)
+# in the CLI's runtime dir: $XDG_RUNTIME_DIR/opende, else /tmp/opende-<uid>
+if [ -n "$XDG_RUNTIME_DIR" ]; then
+    OPENDE_RUNTIME_DIR="$XDG_RUNTIME_DIR/opende"
+else
+    OPENDE_RUNTIME_DIR="/tmp/opende-$(id -u)"
+fi
+mkdir -p -m 700 "$OPENDE_RUNTIME_DIR"
+printf 'start = %s\n' "${EPOCHREALTIME:-$(date +%s)}" > "$OPENDE_RUNTIME_DIR/session.times"
+
 # Load X resources if present
 [ -f ~/.Xresources ] && xrdb -merge ~/.Xresources
 
-# Start compositor (transparency, shadows)
-picom -b --config "$OPENDE_DIR/config/picom.conf" &
-sleep 0.5
+# Keyboard repeat and layout from opende.conf, set over XKB (no setxkbmap)
+command -v opende >/dev/null && opende input restore >/dev/null
+
+# Monitor layout saved for the connected monitors, before anything draws;
+# then follow hotplug (opende display disable hotplug)
+if command -v opende >/dev/null; then
+    opende display apply >/dev/null
+    opende display watch >/dev/null &
+fi
+
+if command -v opende >/dev/null; then
+    # Prefetch, in disk order, the files the last login read; records the
+    # list instead when there is none or packages changed since
+    opende session readahead auto &
+
+    if [ -e "${XDG_CONFIG_HOME:-$HOME/.config}/systemd/user/opende-session.target" ]; then
+        # Units from `opende session install-units`: every component in
+        # opende.slice with its own memory/CPU/IO limits, started in parallel
+        systemctl --user import-environment DISPLAY XAUTHORITY XDG_CURRENT_DESKTOP OPENDE_DIR PATH
+        systemctl --user start opende-session.target
+        OPENDE_UNITS=1
+    else
+        # Session supervisor: starts compositor, notifications, polkit agent,
+        # systray apps, file manager daemon and panel, and restarts them with
+        # backoff if they crash (opende session status)
+        opende session run &
+    fi
+
+    # Adaptive effects governor (opt-in: opende effects enable governor)
+    opende effects governor &
 
-# Set wallpaper (nitrogen remembers last setting)
-nitrogen --restore &
+    # Set wallpaper from the pre-scaled cache; nitrogen if none is configured
+    { opende wallpaper restore --quiet || nitrogen --restore; } &
 
-# Start notification daemon
-dunst -config "$OPENDE_DIR/config/dunstrc" &
+    # Keep the jgmenu index current as applications come and go
+    opende menu watch &
+else
+    # Start compositor (transparency, shadows)
+    picom -b --config "$OPENDE_DIR/config/picom.conf" &
+    sleep 0.5
 
-# Start polkit agent (for password prompts)
-lxpolkit &
+    # Set wallpaper (nitrogen remembers last setting)
+    nitrogen --restore &
 
-# Start systray apps
-nm-applet &                    # Network
-pasystray &                    # Volume
-blueman-applet &               # Bluetooth
+    # Start notification daemon (opende notifications edits a user copy)
+    DUNSTRC="$HOME/.config/opende/dunstrc"
+    [ -f "$DUNSTRC" ] || DUNSTRC="$OPENDE_DIR/config/dunstrc"
+    dunst -config "$DUNSTRC" &
 
-# Start file manager daemon (handles USB automounting)
-pcmanfm -d &
+    # Start polkit agent (for password prompts)
+    lxpolkit &
 
-# Give systray apps time to start before panel
-sleep 1
+    # Start systray apps
+    nm-applet &                    # Network
+    pasystray &                    # Volume
+    blueman-applet &               # Bluetooth
 
-# Start panel via systemd (enables crash recovery and logging)
-# Ensure service is installed
-SYSTEMD_USER_DIR="$HOME/.config/systemd/user"
-mkdir -p "$SYSTEMD_USER_DIR"
-if [ ! -e "$SYSTEMD_USER_DIR/tint2.service" ]; then
-    ln -sf "$OPENDE_DIR/systemd/user/tint2.service" "$SYSTEMD_USER_DIR/tint2.service"
-    systemctl --user daemon-reload
+    # Start file manager daemon (handles USB automounting)
+    pcmanfm -d &
+
+    # Give systray apps time to start before panel
+    sleep 1
+
+    # Start panel via systemd (enables crash recovery and logging)
+    # Ensure service is installed
+    SYSTEMD_USER_DIR="$HOME/.config/systemd/user"
+    mkdir -p "$SYSTEMD_USER_DIR"
+    if [ ! -e "$SYSTEMD_USER_DIR/tint2.service" ]; then
+        ln -sf "$OPENDE_DIR/systemd/user/tint2.service" "$SYSTEMD_USER_DIR/tint2.service"
+        systemctl --user daemon-reload
+    fi
+    systemctl --user start tint2
+fi
+
+# Automatic focus mode for fullscreen apps (opt-in: opende focus enable auto)
+command -v opende >/dev/null && opende focus watch &
+
+# Screen saver/DPMS timeouts from opende.conf; stop only the panel and its
+# executors while the screen saver is on, so a locker still gets composited
+# (opende power disable idle-suspend)
+if command -v opende >/dev/null; then
+    opende power restore
+    opende power watch &
+fi
+
+# Run any .desktop autostart files (the systemd units already cover them)
+if [ -z "$OPENDE_UNITS" ]; then
+    if command -v opende >/dev/null; then
+        # Parallel launch; low-priority entries wait until the session is idle
+        opende session autostart &
+    else
+        dex -a -s ~/.config/autostart/ 2>/dev/null &
+    fi
 fi
-systemctl --user start tint2
 
-# Run any .desktop autostart files
-dex -a -s ~/.config/autostart/ 2>/dev/null &
+# Once idle, cache the files of the most launched applications
+command -v opende >/dev/null && opende session prewarm &
 
 # Small delay to let everything settle before WM starts
 sleep 0.5
+
+printf 'ready = %s\n' "${EPOCHREALTIME:-$(date +%s)}" >> "$OPENDE_RUNTIME_DIR/session.times"
@@ -47,6 +47,14 @@ if [ -f /usr/local/bin/opende ]; then
     rm -f /usr/local/bin/opende
 fi
 
+# Remove libopende
+if [ -f /usr/local/lib/libopende.so.1 ]; then
+    info "Removing libopende..."
+    rm -f /usr/local/lib/libopende.so.1 /usr/local/lib/libopende.so
+    rm -f /usr/local/include/opende.h
+    ldconfig || true
+fi
+
 info "Uninstallation complete!"
 echo ""
 echo "Note: The following were NOT removed:"